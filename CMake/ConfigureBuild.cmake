@@ -98,6 +98,7 @@ set(OGRE_SET_PROFILING_EXHAUSTIVE 0)
 set(OGRE_SET_USE_SIMD 0)
 set(OGRE_SET_RESTRICT_ALIASING 0)
 set(OGRE_SET_IDSTRING_ALWAYS_READABLE 0)
+set(OGRE_SET_IDSTRING_INTERN_TABLE 0)
 set(OGRE_SET_DISABLE_AMD_AGS 0)
 if((OGRE_EMBED_DEBUG_MODE STREQUAL "auto" AND
 		(CMAKE_GENERATOR STREQUAL "Unix Makefiles" OR CMAKE_GENERATOR STREQUAL "Ninja"))
@@ -205,6 +206,9 @@ endif()
 if (OGRE_IDSTRING_ALWAYS_READABLE)
   set(OGRE_SET_IDSTRING_ALWAYS_READABLE 1)
 endif()
+if (OGRE_IDSTRING_INTERN_TABLE)
+  set(OGRE_SET_IDSTRING_INTERN_TABLE 1)
+endif()
 if (NOT OGRE_CONFIG_AMD_AGS)
   set(OGRE_SET_DISABLE_AMD_AGS 1)
 endif()
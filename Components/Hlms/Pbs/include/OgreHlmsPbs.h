@@ -136,6 +136,21 @@ namespace Ogre
             Matrix4 viewMatrix;
         };
 
+        /// Remembers where the bone palette of a skeleton (for a given blend index map)
+        /// was already written in the currently bound tex buffer, so that other draws
+        /// sharing the same SkeletonInstance (e.g. other submeshes of the same Item, or
+        /// Items sharing it via Item::useSkeletonInstanceFrom) can reference it instead
+        /// of uploading it again.
+        struct SkeletonPaletteCacheEntry
+        {
+            SkeletonInstance const *skeleton;
+            void const             *indexMap;
+            uint32                  texBufferOffset;
+            uint32                  generation;
+        };
+
+        static const size_t SkeletonPaletteCacheSize = 64u;  // Must be power of 2
+
         PassData                mPreparedPass;
         ConstBufferPackedVec    mPassBuffers;
         ConstBufferPackedVec    mLight0Buffers;             // lights
@@ -181,7 +196,6 @@ namespace Ogre
 #endif
         TextureGpu             *mAreaLightMasks;
         HlmsSamplerblock const *mAreaLightMasksSamplerblock;
-        LightArray              mAreaLights;
         bool                    mUsingAreaLightMasks;
 
         /// There may be MORE const buffers than mNumPassConstBuffers.
@@ -204,6 +218,12 @@ namespace Ogre
 
         ConstBufferPool::BufferPool const *mLastBoundPool;
 
+        SkeletonPaletteCacheEntry mSkeletonPaletteCache[SkeletonPaletteCacheSize];
+        /// Entries whose generation doesn't match are invalid. Gets incremented
+        /// every time the tex buffer is remapped or rebound at a different offset.
+        uint32       mSkeletonPaletteCacheGeneration;
+        float const *mSkeletonPaletteCacheTexBufferStart;
+
         float mConstantBiasScale;
 
         bool                        mHasSeparateSamplers;
@@ -268,10 +288,31 @@ namespace Ogre
 
         void destroyAllBuffers() override;
 
+        /** Per-draw path. It's specialized at compile time on whether this is a v1 object
+            and whether this is a caster pass, thus the branches on those disappear.
+            fillBuffersForV1 & fillBuffersForV2 dispatch to the right instantiation.
+        */
+        template <bool isV1, bool casterPass>
         FORCEINLINE uint32 fillBuffersFor( const HlmsCache        *cache,
-                                           const QueuedRenderable &queuedRenderable, bool casterPass,
-                                           uint32 lastCacheHash, CommandBuffer *commandBuffer,
-                                           bool isV1 );
+                                           const QueuedRenderable &queuedRenderable,
+                                           uint32 lastCacheHash, CommandBuffer *commandBuffer );
+
+        /// See fillBuffersForBatch. Specialized at compile time on casterPass.
+        template <bool casterPass>
+        size_t fillBuffersForBatch( const HlmsCache *cache, const QueuedRenderable *begin,
+                                    const QueuedRenderable *end, uint32 lastCacheHash,
+                                    CommandBuffer *commandBuffer, uint32 *outBaseInstances );
+
+        /// Writes the world (and worldView, unless casterPass) matrices of a renderable without
+        /// skeleton nor pose animation. Returns dst advanced past the written data.
+        template <bool casterPass>
+        FORCEINLINE float *fillStaticTransforms( float *RESTRICT_ALIAS dst,
+                                                 const Matrix4 &worldMat ) const;
+
+        /// Binds the pass buffers & textures shared by all our draws. Called when the
+        /// previous draw was rendered by a different Hlms type.
+        void bindSharedPassResources( bool casterPass, CommandBuffer *commandBuffer,
+                                      const HlmsDatablock *datablock );
 
     public:
         HlmsPbs( Archive *dataFolder, ArchiveVec *libraryFolders );
@@ -295,6 +336,18 @@ namespace Ogre
                                  bool casterPass, uint32 lastCacheHash,
                                  CommandBuffer *commandBuffer ) override;
 
+        /** See Hlms::fillBuffersForBatch. Consecutive renderables without skeleton nor pose
+            animation that don't need to bind a different material buffer, textures, samplers
+            or planar reflection are packed in a tight loop.
+        @remarks
+            Enabled by default. Derived classes overriding fillBuffersForV2 must call
+            setBatchedFillBuffers( false ) or override this function too.
+        */
+        size_t fillBuffersForBatch( const HlmsCache *cache, const QueuedRenderable *begin,
+                                    const QueuedRenderable *end, bool casterPass,
+                                    uint32 lastCacheHash, CommandBuffer *commandBuffer,
+                                    uint32 *outBaseInstances ) override;
+
         void postCommandBufferExecution( CommandBuffer *commandBuffer ) override;
         void frameEnded() override;
 
@@ -45,6 +45,9 @@ namespace Ogre
         3D texture representation.
 
         This cache can be shared by multiple users (e.g. VctImageVoxelizer)
+
+        Voxelizing is expensive, thus the cache can be saved to disk with saveTo
+        and loaded back with loadFrom in subsequent runs.
     */
     class _OgreHlmsPbsExport VoxelizedMeshCache : IdObject
     {
@@ -56,6 +59,9 @@ namespace Ogre
             TextureGpu *albedoVox;
             TextureGpu *normalVox;
             TextureGpu *emissiveVox;
+            /// True if loaded from disk and not yet verified against the
+            /// current cache resolution. See loadFrom
+            bool needsResolutionCheck;
         };
 
     protected:
@@ -75,6 +81,15 @@ namespace Ogre
         /// texture for all those meshes instead of wasting ton of RAM.
         TextureGpu *mBlankEmissive;
 
+        /// Calculates the resolution the voxelized mesh will have, based on its AABB
+        /// and the settings from setCacheResolution
+        void calculateResolution( const Aabb &aabb, uint32 &outWidth, uint32 &outHeight,
+                                  uint32 &outDepth ) const;
+
+        void destroyVoxelizedMesh( const VoxelizedMesh &voxelizedMesh );
+
+        TextureGpu *loadTexture( DataStreamPtr &dataStream, const String &name );
+
     public:
         /// The number of texture units GL can handle may exceed the hard limit in
         /// ShaderParams::ManualParam::dataBytes so we need to use EX and store
@@ -142,6 +157,28 @@ namespace Ogre
                                  uint32 maxHeight, uint32 maxDepth, const Ogre::Vector3 &dimension );
 
         TextureGpu *getBlankEmissive() { return mBlankEmissive; }
+
+        /** Saves all cached meshes (their hashes and voxel textures) to the stream.
+        @remarks
+            Meshes without hash (see Mesh::getHashForCaches) are not saved,
+            since we wouldn't be able to tell if they're stale when loading.
+
+            This function downloads the textures from GPU, thus it will stall.
+        */
+        void saveTo( DataStreamPtr &dataStream );
+
+        /** Loads cached meshes saved with saveTo, so they don't have to be voxelized again.
+        @remarks
+            Meshes already in the cache are kept and their entries in the stream are skipped.
+
+            Entries are validated in addMeshToCache: those whose mesh hash doesn't match,
+            or which were voxelized at a different resolution than what the current
+            settings (see setCacheResolution) would produce, are voxelized again.
+
+            Textures are streamed in via TextureGpuManager; this function waits for
+            streaming to complete before returning.
+        */
+        void loadFrom( DataStreamPtr &dataStream );
     };
 }  // namespace Ogre
 
@@ -50,6 +50,7 @@ THE SOFTWARE.
 #include "OgreAtmosphereComponent.h"
 #include "OgreCamera.h"
 #include "OgreForward3D.h"
+#include "OgreFrameArena.h"
 #include "OgreHighLevelGpuProgram.h"
 #include "OgreHighLevelGpuProgramManager.h"
 #include "OgreIrradianceVolume.h"
@@ -307,6 +308,8 @@ namespace Ogre
         mDecalsDiffuseMergedEmissive( false ),
         mDecalsSamplerblock( 0 ),
         mLastBoundPool( 0 ),
+        mSkeletonPaletteCacheGeneration( 1u ),
+        mSkeletonPaletteCacheTexBufferStart( 0 ),
         mConstantBiasScale( 0.1f ),
         mHasSeparateSamplers( 0 ),
         mLastDescTexture( 0 ),
@@ -334,9 +337,11 @@ namespace Ogre
         mAmbientLightMode( AmbientAutoNormal )
     {
         memset( mDecalsTextures, 0, sizeof( mDecalsTextures ) );
+        memset( mSkeletonPaletteCache, 0, sizeof( mSkeletonPaletteCache ) );
 
         // Override defaults
         mLightGatheringMode = LightGatherForwardPlus;
+        mBatchedFillBuffers = true;
 
         // It is always 0.
         // (0 is world matrix, we don't need it for particles. 1 is animation matrix)
@@ -2678,8 +2683,8 @@ namespace Ogre
 
             // Send area lights. We need them sorted so textured ones
             // come first, as that what our shader expects
-            mAreaLights.reserve( numAreaApproxLights );
-            mAreaLights.clear();
+            FrameArenaFastArray<Light *>::type areaLights;
+            areaLights.reserve( numAreaApproxLights );
             const LightListInfo &globalLightList = sceneManager->getGlobalLightList();
             size_t areaLightNumber = 0;
             for( size_t idx = mAreaLightsGlobalLightListStart;
@@ -2688,19 +2693,19 @@ namespace Ogre
             {
                 if( globalLightList.lights[idx]->getType() == Light::LT_AREA_APPROX )
                 {
-                    mAreaLights.push_back( globalLightList.lights[idx] );
+                    areaLights.push_back( globalLightList.lights[idx] );
                     ++areaLightNumber;
                 }
             }
 
-            std::sort( mAreaLights.begin(), mAreaLights.end(), SortByTextureLightMaskIdx );
+            std::sort( areaLights.begin(), areaLights.end(), SortByTextureLightMaskIdx );
 
             if( !mUseLightBuffers )
                 light1BufferPtr = passBufferPtr;
 
             for( size_t i = 0u; i < realNumAreaApproxLights; ++i )
             {
-                Light const *light = mAreaLights[i];
+                Light const *light = areaLights[i];
 
                 Vector4 lightPos4 = light->getAs4DVector();
                 Vector3 lightPos = viewMatrix * Vector3( lightPos4.x, lightPos4.y, lightPos4.z );
@@ -2789,27 +2794,27 @@ namespace Ogre
             if( !mUseLightBuffers )
                 passBufferPtr = light1BufferPtr;
 
-            mAreaLights.reserve( numAreaLtcLights );
-            mAreaLights.clear();
+            areaLights.clear();
+            areaLights.reserve( numAreaLtcLights );
             areaLightNumber = 0;
             for( size_t idx = mAreaLightsGlobalLightListStart;
                  idx < globalLightList.lights.size() && areaLightNumber < realNumAreaLtcLights; ++idx )
             {
                 if( globalLightList.lights[idx]->getType() == Light::LT_AREA_LTC )
                 {
-                    mAreaLights.push_back( globalLightList.lights[idx] );
+                    areaLights.push_back( globalLightList.lights[idx] );
                     ++areaLightNumber;
                 }
             }
 
-            // std::sort( mAreaLights.begin(), mAreaLights.end(), SortByTextureLightMaskIdx );
+            // std::sort( areaLights.begin(), areaLights.end(), SortByTextureLightMaskIdx );
 
             if( !mUseLightBuffers )
                 light2BufferPtr = passBufferPtr;
 
             for( size_t i = 0u; i < realNumAreaLtcLights; ++i )
             {
-                Light const *light = mAreaLights[i];
+                Light const *light = areaLights[i];
 
                 Vector4 lightPos4 = light->getAs4DVector();
                 Vector3 lightPos = viewMatrix * Vector3( lightPos4.x, lightPos4.y, lightPos4.z );
@@ -3089,7 +3094,7 @@ namespace Ogre
 #endif
         }
 
-        uploadDirtyDatablocks();
+        uploadDirtyDatablocks( sceneManager );
 
         return retVal;
     }
@@ -3107,238 +3112,297 @@ namespace Ogre
                                       bool casterPass, uint32 lastCacheHash,
                                       CommandBuffer *commandBuffer )
     {
-        return fillBuffersFor( cache, queuedRenderable, casterPass, lastCacheHash, commandBuffer, true );
+        if( casterPass )
+            return fillBuffersFor<true, true>( cache, queuedRenderable, lastCacheHash, commandBuffer );
+        else
+            return fillBuffersFor<true, false>( cache, queuedRenderable, lastCacheHash, commandBuffer );
     }
     //-----------------------------------------------------------------------------------
     uint32 HlmsPbs::fillBuffersForV2( const HlmsCache *cache, const QueuedRenderable &queuedRenderable,
                                       bool casterPass, uint32 lastCacheHash,
                                       CommandBuffer *commandBuffer )
     {
-        return fillBuffersFor( cache, queuedRenderable, casterPass, lastCacheHash, commandBuffer,
-                               false );
+        if( casterPass )
+            return fillBuffersFor<false, true>( cache, queuedRenderable, lastCacheHash, commandBuffer );
+        else
+            return fillBuffersFor<false, false>( cache, queuedRenderable, lastCacheHash, commandBuffer );
     }
     //-----------------------------------------------------------------------------------
-    uint32 HlmsPbs::fillBuffersFor( const HlmsCache *cache, const QueuedRenderable &queuedRenderable,
-                                    bool casterPass, uint32 lastCacheHash, CommandBuffer *commandBuffer,
-                                    bool isV1 )
+    void HlmsPbs::bindSharedPassResources( bool casterPass, CommandBuffer *commandBuffer,
+                                           const HlmsDatablock *datablock )
     {
-        assert( dynamic_cast<const HlmsPbsDatablock *>( queuedRenderable.renderable->getDatablock() ) );
-        const HlmsPbsDatablock *datablock =
-            static_cast<const HlmsPbsDatablock *>( queuedRenderable.renderable->getDatablock() );
+        // layout(binding = 0) uniform PassBuffer {} pass
+        ConstBufferPacked *passBuffer = mPassBuffers[mCurrentPassBuffer - 1];
+        *commandBuffer->addCommand<CbShaderBuffer>() = CbShaderBuffer(
+            VertexShader, 0, passBuffer, 0, (uint32)passBuffer->getTotalSizeBytes() );
+        *commandBuffer->addCommand<CbShaderBuffer>() =
+            CbShaderBuffer( PixelShader, 0, passBuffer, 0, (uint32)passBuffer->getTotalSizeBytes() );
 
-        if( OGRE_EXTRACT_HLMS_TYPE_FROM_CACHE_HASH( lastCacheHash ) != mType )
+        uint32 constBufferSlot = 3u;
+
+        if( mUseLightBuffers )
         {
-            // layout(binding = 0) uniform PassBuffer {} pass
-            ConstBufferPacked *passBuffer = mPassBuffers[mCurrentPassBuffer - 1];
+            ConstBufferPacked *light0Buffer = mLight0Buffers[mCurrentPassBuffer - 1];
             *commandBuffer->addCommand<CbShaderBuffer>() = CbShaderBuffer(
-                VertexShader, 0, passBuffer, 0, (uint32)passBuffer->getTotalSizeBytes() );
-            *commandBuffer->addCommand<CbShaderBuffer>() =
-                CbShaderBuffer( PixelShader, 0, passBuffer, 0, (uint32)passBuffer->getTotalSizeBytes() );
-
-            uint32 constBufferSlot = 3u;
+                VertexShader, 3, light0Buffer, 0, (uint32)light0Buffer->getTotalSizeBytes() );
+            *commandBuffer->addCommand<CbShaderBuffer>() = CbShaderBuffer(
+                PixelShader, 3, light0Buffer, 0, (uint32)light0Buffer->getTotalSizeBytes() );
 
-            if( mUseLightBuffers )
-            {
-                ConstBufferPacked *light0Buffer = mLight0Buffers[mCurrentPassBuffer - 1];
-                *commandBuffer->addCommand<CbShaderBuffer>() = CbShaderBuffer(
-                    VertexShader, 3, light0Buffer, 0, (uint32)light0Buffer->getTotalSizeBytes() );
-                *commandBuffer->addCommand<CbShaderBuffer>() = CbShaderBuffer(
-                    PixelShader, 3, light0Buffer, 0, (uint32)light0Buffer->getTotalSizeBytes() );
+            ConstBufferPacked *light1Buffer = mLight1Buffers[mCurrentPassBuffer - 1];
+            *commandBuffer->addCommand<CbShaderBuffer>() = CbShaderBuffer(
+                VertexShader, 4, light1Buffer, 0, (uint32)light1Buffer->getTotalSizeBytes() );
+            *commandBuffer->addCommand<CbShaderBuffer>() = CbShaderBuffer(
+                PixelShader, 4, light1Buffer, 0, (uint32)light1Buffer->getTotalSizeBytes() );
 
-                ConstBufferPacked *light1Buffer = mLight1Buffers[mCurrentPassBuffer - 1];
-                *commandBuffer->addCommand<CbShaderBuffer>() = CbShaderBuffer(
-                    VertexShader, 4, light1Buffer, 0, (uint32)light1Buffer->getTotalSizeBytes() );
-                *commandBuffer->addCommand<CbShaderBuffer>() = CbShaderBuffer(
-                    PixelShader, 4, light1Buffer, 0, (uint32)light1Buffer->getTotalSizeBytes() );
+            ConstBufferPacked *light2Buffer = mLight2Buffers[mCurrentPassBuffer - 1];
+            *commandBuffer->addCommand<CbShaderBuffer>() = CbShaderBuffer(
+                VertexShader, 5, light2Buffer, 0, (uint32)light2Buffer->getTotalSizeBytes() );
+            *commandBuffer->addCommand<CbShaderBuffer>() = CbShaderBuffer(
+                PixelShader, 5, light2Buffer, 0, (uint32)light2Buffer->getTotalSizeBytes() );
 
-                ConstBufferPacked *light2Buffer = mLight2Buffers[mCurrentPassBuffer - 1];
-                *commandBuffer->addCommand<CbShaderBuffer>() = CbShaderBuffer(
-                    VertexShader, 5, light2Buffer, 0, (uint32)light2Buffer->getTotalSizeBytes() );
-                *commandBuffer->addCommand<CbShaderBuffer>() = CbShaderBuffer(
-                    PixelShader, 5, light2Buffer, 0, (uint32)light2Buffer->getTotalSizeBytes() );
+            constBufferSlot = 6u;
+        }
 
-                constBufferSlot = 6u;
-            }
+        size_t texUnit = mReservedTexBufferSlots;
 
-            size_t texUnit = mReservedTexBufferSlots;
+        if( !casterPass )
+        {
+            constBufferSlot += mAtmosphere->bindConstBuffers( commandBuffer, constBufferSlot );
 
-            if( !casterPass )
+            if( mGridBuffer )
             {
-                constBufferSlot += mAtmosphere->bindConstBuffers( commandBuffer, constBufferSlot );
-
-                if( mGridBuffer )
-                {
-                    *commandBuffer->addCommand<CbShaderBuffer>() =
-                        CbShaderBuffer( PixelShader, (uint16)texUnit++, mGlobalLightListBuffer, 0, 0 );
-                    *commandBuffer->addCommand<CbShaderBuffer>() =
-                        CbShaderBuffer( PixelShader, (uint16)texUnit++, mGridBuffer, 0, 0 );
-                }
+                *commandBuffer->addCommand<CbShaderBuffer>() =
+                    CbShaderBuffer( PixelShader, (uint16)texUnit++, mGlobalLightListBuffer, 0, 0 );
+                *commandBuffer->addCommand<CbShaderBuffer>() =
+                    CbShaderBuffer( PixelShader, (uint16)texUnit++, mGridBuffer, 0, 0 );
+            }
 
-                texUnit += mReservedTexSlots;
+            texUnit += mReservedTexSlots;
 
-                if( !mPrePassTextures->empty() )
-                {
-                    *commandBuffer->addCommand<CbTexture>() =
-                        CbTexture( (uint16)texUnit++, ( *mPrePassTextures )[0], 0 );
-                    *commandBuffer->addCommand<CbTexture>() =
-                        CbTexture( (uint16)texUnit++, ( *mPrePassTextures )[1], 0 );
-                }
+            if( !mPrePassTextures->empty() )
+            {
+                *commandBuffer->addCommand<CbTexture>() =
+                    CbTexture( (uint16)texUnit++, ( *mPrePassTextures )[0], 0 );
+                *commandBuffer->addCommand<CbTexture>() =
+                    CbTexture( (uint16)texUnit++, ( *mPrePassTextures )[1], 0 );
+            }
 
-                if( mPrePassMsaaDepthTexture )
-                {
-                    *commandBuffer->addCommand<CbTexture>() = CbTexture(
-                        (uint16)texUnit++, mPrePassMsaaDepthTexture, 0,
-                        PixelFormatGpuUtils::isDepth( mPrePassMsaaDepthTexture->getPixelFormat() ) );
-                }
+            if( mPrePassMsaaDepthTexture )
+            {
+                *commandBuffer->addCommand<CbTexture>() = CbTexture(
+                    (uint16)texUnit++, mPrePassMsaaDepthTexture, 0,
+                    PixelFormatGpuUtils::isDepth( mPrePassMsaaDepthTexture->getPixelFormat() ) );
+            }
 
-                if( mDepthTexture )
-                {
-                    *commandBuffer->addCommand<CbTexture>() =
-                        CbTexture( (uint16)texUnit++, mDepthTexture, mDecalsSamplerblock,
-                                   PixelFormatGpuUtils::isDepth( mDepthTexture->getPixelFormat() ) );
-                }
+            if( mDepthTexture )
+            {
+                *commandBuffer->addCommand<CbTexture>() =
+                    CbTexture( (uint16)texUnit++, mDepthTexture, mDecalsSamplerblock,
+                               PixelFormatGpuUtils::isDepth( mDepthTexture->getPixelFormat() ) );
+            }
 
-                if( mSsrTexture )
-                {
-                    *commandBuffer->addCommand<CbTexture>() =
-                        CbTexture( (uint16)texUnit++, mSsrTexture, 0 );
-                }
+            if( mSsrTexture )
+            {
+                *commandBuffer->addCommand<CbTexture>() =
+                    CbTexture( (uint16)texUnit++, mSsrTexture, 0 );
+            }
 
-                if( mDepthTextureNoMsaa && mDepthTextureNoMsaa != mPrePassMsaaDepthTexture )
-                {
-                    *commandBuffer->addCommand<CbTexture>() = CbTexture(
-                        (uint16)texUnit++, mDepthTextureNoMsaa, mDecalsSamplerblock,
-                        PixelFormatGpuUtils::isDepth( mDepthTextureNoMsaa->getPixelFormat() ) );
-                }
+            if( mDepthTextureNoMsaa && mDepthTextureNoMsaa != mPrePassMsaaDepthTexture )
+            {
+                *commandBuffer->addCommand<CbTexture>() = CbTexture(
+                    (uint16)texUnit++, mDepthTextureNoMsaa, mDecalsSamplerblock,
+                    PixelFormatGpuUtils::isDepth( mDepthTextureNoMsaa->getPixelFormat() ) );
+            }
 
-                if( mRefractionsTexture )
-                {
-                    *commandBuffer->addCommand<CbTexture>() =
-                        CbTexture( (uint16)texUnit++, mRefractionsTexture, mDecalsSamplerblock );
-                }
+            if( mRefractionsTexture )
+            {
+                *commandBuffer->addCommand<CbTexture>() =
+                    CbTexture( (uint16)texUnit++, mRefractionsTexture, mDecalsSamplerblock );
+            }
 
-                if( mIrradianceVolume )
-                {
-                    TextureGpu *irradianceTex = mIrradianceVolume->getIrradianceVolumeTexture();
-                    const HlmsSamplerblock *samplerblock = mIrradianceVolume->getIrradSamplerblock();
+            if( mIrradianceVolume )
+            {
+                TextureGpu *irradianceTex = mIrradianceVolume->getIrradianceVolumeTexture();
+                const HlmsSamplerblock *samplerblock = mIrradianceVolume->getIrradSamplerblock();
 
-                    *commandBuffer->addCommand<CbTexture>() =
-                        CbTexture( (uint16)texUnit, irradianceTex, samplerblock );
-                    ++texUnit;
-                }
+                *commandBuffer->addCommand<CbTexture>() =
+                    CbTexture( (uint16)texUnit, irradianceTex, samplerblock );
+                ++texUnit;
+            }
 
-                if( mVctLighting )
+            if( mVctLighting )
+            {
+                const size_t numCascades = mVctLighting->getNumCascades();
+                const size_t numVctTextures = mVctLighting->getNumVoxelTextures();
+                const HlmsSamplerblock *samplerblock = mVctLighting->getBindTrilinearSamplerblock();
+                for( size_t i = 0u; i < numVctTextures; ++i )
                 {
-                    const size_t numCascades = mVctLighting->getNumCascades();
-                    const size_t numVctTextures = mVctLighting->getNumVoxelTextures();
-                    const HlmsSamplerblock *samplerblock = mVctLighting->getBindTrilinearSamplerblock();
-                    for( size_t i = 0u; i < numVctTextures; ++i )
+                    for( size_t cascadeIdx = 0; cascadeIdx < numCascades; ++cascadeIdx )
                     {
-                        for( size_t cascadeIdx = 0; cascadeIdx < numCascades; ++cascadeIdx )
-                        {
-                            TextureGpu **lightVoxelTexs =
-                                mVctLighting->getLightVoxelTextures( cascadeIdx );
-                            *commandBuffer->addCommand<CbTexture>() =
-                                CbTexture( (uint16)texUnit, lightVoxelTexs[i], samplerblock );
-                            ++texUnit;
-                        }
+                        TextureGpu **lightVoxelTexs =
+                            mVctLighting->getLightVoxelTextures( cascadeIdx );
+                        *commandBuffer->addCommand<CbTexture>() =
+                            CbTexture( (uint16)texUnit, lightVoxelTexs[i], samplerblock );
+                        ++texUnit;
                     }
                 }
+            }
 
-                if( mIrradianceField )
-                {
-                    TODO_irradianceField_samplerblock;
-                    const HlmsSamplerblock *samplerblock = mDecalsSamplerblock;
-                    *commandBuffer->addCommand<CbTexture>() = CbTexture(
-                        (uint16)texUnit++, mIrradianceField->getIrradianceTex(), samplerblock );
-                    *commandBuffer->addCommand<CbTexture>() = CbTexture(
-                        (uint16)texUnit++, mIrradianceField->getDepthVarianceTex(), samplerblock );
-                }
-
-                if( mUsingAreaLightMasks )
-                {
-                    *commandBuffer->addCommand<CbTexture>() =
-                        CbTexture( (uint16)texUnit, mAreaLightMasks, mAreaLightMasksSamplerblock );
-                    ++texUnit;
-                }
-
-                if( mLightProfilesTexture )
-                {
-                    *commandBuffer->addCommand<CbTexture>() =
-                        CbTexture( (uint16)texUnit, mLightProfilesTexture, mAreaLightMasksSamplerblock );
-                    ++texUnit;
-                }
+            if( mIrradianceField )
+            {
+                TODO_irradianceField_samplerblock;
+                const HlmsSamplerblock *samplerblock = mDecalsSamplerblock;
+                *commandBuffer->addCommand<CbTexture>() = CbTexture(
+                    (uint16)texUnit++, mIrradianceField->getIrradianceTex(), samplerblock );
+                *commandBuffer->addCommand<CbTexture>() = CbTexture(
+                    (uint16)texUnit++, mIrradianceField->getDepthVarianceTex(), samplerblock );
+            }
 
-                if( mLtcMatrixTexture )
-                {
-                    *commandBuffer->addCommand<CbTexture>() =
-                        CbTexture( (uint16)texUnit, mLtcMatrixTexture, mAreaLightMasksSamplerblock );
-                    ++texUnit;
-                }
+            if( mUsingAreaLightMasks )
+            {
+                *commandBuffer->addCommand<CbTexture>() =
+                    CbTexture( (uint16)texUnit, mAreaLightMasks, mAreaLightMasksSamplerblock );
+                ++texUnit;
+            }
 
-                for( size_t i = 0u; i < 3u; ++i )
-                {
-                    if( mDecalsTextures[i] && ( i != 2u || !mDecalsDiffuseMergedEmissive ) )
-                    {
-                        *commandBuffer->addCommand<CbTexture>() =
-                            CbTexture( (uint16)texUnit, mDecalsTextures[i], mDecalsSamplerblock );
-                        ++texUnit;
-                    }
-                }
+            if( mLightProfilesTexture )
+            {
+                *commandBuffer->addCommand<CbTexture>() =
+                    CbTexture( (uint16)texUnit, mLightProfilesTexture, mAreaLightMasksSamplerblock );
+                ++texUnit;
+            }
 
-                // We changed HlmsType, rebind the shared textures.
-                FastArray<TextureGpu *>::const_iterator itor = mPreparedPass.shadowMaps.begin();
-                FastArray<TextureGpu *>::const_iterator end = mPreparedPass.shadowMaps.end();
-                while( itor != end )
-                {
-                    *commandBuffer->addCommand<CbTexture>() =
-                        CbTexture( (uint16)texUnit, *itor, mCurrentShadowmapSamplerblock );
-                    ++texUnit;
-                    ++itor;
-                }
+            if( mLtcMatrixTexture )
+            {
+                *commandBuffer->addCommand<CbTexture>() =
+                    CbTexture( (uint16)texUnit, mLtcMatrixTexture, mAreaLightMasksSamplerblock );
+                ++texUnit;
+            }
 
-                if( mParallaxCorrectedCubemap && !mParallaxCorrectedCubemap->isRendering() )
+            for( size_t i = 0u; i < 3u; ++i )
+            {
+                if( mDecalsTextures[i] && ( i != 2u || !mDecalsDiffuseMergedEmissive ) )
                 {
-                    TextureGpu *pccTexture = mParallaxCorrectedCubemap->getBindTexture();
-                    const HlmsSamplerblock *samplerblock =
-                        mParallaxCorrectedCubemap->getBindTrilinearSamplerblock();
                     *commandBuffer->addCommand<CbTexture>() =
-                        CbTexture( (uint16)texUnit, pccTexture, samplerblock );
+                        CbTexture( (uint16)texUnit, mDecalsTextures[i], mDecalsSamplerblock );
                     ++texUnit;
                 }
             }
 
-            if( mHlmsManager->getBlueNoiseTexture() )
+            // We changed HlmsType, rebind the shared textures.
+            FastArray<TextureGpu *>::const_iterator itor = mPreparedPass.shadowMaps.begin();
+            FastArray<TextureGpu *>::const_iterator end = mPreparedPass.shadowMaps.end();
+            while( itor != end )
             {
                 *commandBuffer->addCommand<CbTexture>() =
-                    CbTexture( (uint16)texUnit, mHlmsManager->getBlueNoiseTexture(), 0 );
+                    CbTexture( (uint16)texUnit, *itor, mCurrentShadowmapSamplerblock );
                 ++texUnit;
+                ++itor;
             }
 
-            mLastDescTexture = 0;
-            mLastDescSampler = 0;
-            mLastBoundPool = 0;
-
-            // layout(binding = 2) uniform InstanceBuffer {} instance
-            if( mCurrentConstBuffer < mConstBuffers.size() &&
-                (size_t)( ( mCurrentMappedConstBuffer - mStartMappedConstBuffer ) + 4 ) <=
-                    mCurrentConstBufferSize )
+            if( mParallaxCorrectedCubemap && !mParallaxCorrectedCubemap->isRendering() )
             {
-                *commandBuffer->addCommand<CbShaderBuffer>() =
-                    CbShaderBuffer( VertexShader, 2, mConstBuffers[mCurrentConstBuffer], 0, 0 );
-                *commandBuffer->addCommand<CbShaderBuffer>() =
-                    CbShaderBuffer( PixelShader, 2, mConstBuffers[mCurrentConstBuffer], 0, 0 );
+                TextureGpu *pccTexture = mParallaxCorrectedCubemap->getBindTexture();
+                const HlmsSamplerblock *samplerblock =
+                    mParallaxCorrectedCubemap->getBindTrilinearSamplerblock();
+                *commandBuffer->addCommand<CbTexture>() =
+                    CbTexture( (uint16)texUnit, pccTexture, samplerblock );
+                ++texUnit;
             }
+        }
 
-            rebindTexBuffer( commandBuffer );
+        if( mHlmsManager->getBlueNoiseTexture() )
+        {
+            *commandBuffer->addCommand<CbTexture>() =
+                CbTexture( (uint16)texUnit, mHlmsManager->getBlueNoiseTexture(), 0 );
+            ++texUnit;
+        }
+
+        mLastDescTexture = 0;
+        mLastDescSampler = 0;
+        mLastBoundPool = 0;
+
+        // layout(binding = 2) uniform InstanceBuffer {} instance
+        if( mCurrentConstBuffer < mConstBuffers.size() &&
+            (size_t)( ( mCurrentMappedConstBuffer - mStartMappedConstBuffer ) + 4 ) <=
+                mCurrentConstBufferSize )
+        {
+            *commandBuffer->addCommand<CbShaderBuffer>() =
+                CbShaderBuffer( VertexShader, 2, mConstBuffers[mCurrentConstBuffer], 0, 0 );
+            *commandBuffer->addCommand<CbShaderBuffer>() =
+                CbShaderBuffer( PixelShader, 2, mConstBuffers[mCurrentConstBuffer], 0, 0 );
+        }
+
+        rebindTexBuffer( commandBuffer );
 
 #ifdef OGRE_BUILD_COMPONENT_PLANAR_REFLECTIONS
-            mLastBoundPlanarReflection = 0u;
-            if( mHasPlanarReflections )
-                ++texUnit;  // We do not bind this texture now, but its slot is reserved.
+        mLastBoundPlanarReflection = 0u;
+        if( mHasPlanarReflections )
+            ++texUnit;  // We do not bind this texture now, but its slot is reserved.
 #endif
-            mListener->hlmsTypeChanged( casterPass, commandBuffer, datablock, texUnit );
+        mListener->hlmsTypeChanged( casterPass, commandBuffer, datablock, texUnit );
+    }
+    //-----------------------------------------------------------------------------------
+    template <bool casterPass>
+    float *HlmsPbs::fillStaticTransforms( float *RESTRICT_ALIAS dst, const Matrix4 &worldMat ) const
+    {
+#if !OGRE_DOUBLE_PRECISION
+        // Node transforms are SIMD aligned, and so is dst (static renderables always advance
+        // it in multiples of 16 floats). Use streaming stores since the region is write-combined.
+
+        // mat4x3 world
+        SimpleMatrixAf4x3 simdMat;
+        simdMat.load( worldMat );
+        simdMat.streamTo4x3( dst );
+        dst += 16;
+
+        if( !casterPass )
+        {
+            // mat4 worldView
+            OGRE_SIMD_ALIGNED_DECL( Matrix4, worldView );
+            worldView = mPreparedPass.viewMatrix.concatenateAffine( worldMat );
+            simdMat.load( worldView );
+            simdMat.streamTo4x4( dst );
+            dst += 16;
         }
+#else
+        // mat4x3 world
+        for( int y = 0; y < 3; ++y )
+        {
+            for( int x = 0; x < 4; ++x )
+            {
+                *dst++ = worldMat[y][x];
+            }
+        }
+        dst += 4;
+
+        // mat4 worldView
+        Matrix4 tmp = mPreparedPass.viewMatrix.concatenateAffine( worldMat );
+        if( !casterPass )
+        {
+            for( int y = 0; y < 4; ++y )
+            {
+                for( int x = 0; x < 4; ++x )
+                {
+                    *dst++ = tmp[y][x];
+                }
+            }
+        }
+#endif
+
+        return dst;
+    }
+    //-----------------------------------------------------------------------------------
+    template <bool isV1, bool casterPass>
+    uint32 HlmsPbs::fillBuffersFor( const HlmsCache *cache, const QueuedRenderable &queuedRenderable,
+                                    uint32 lastCacheHash, CommandBuffer *commandBuffer )
+    {
+        assert( dynamic_cast<const HlmsPbsDatablock *>( queuedRenderable.renderable->getDatablock() ) );
+        const HlmsPbsDatablock *datablock =
+            static_cast<const HlmsPbsDatablock *>( queuedRenderable.renderable->getDatablock() );
+
+        if( OGRE_EXTRACT_HLMS_TYPE_FROM_CACHE_HASH( lastCacheHash ) != mType )
+            bindSharedPassResources( casterPass, commandBuffer, datablock );
 
         // Don't bind the material buffer on caster passes (important to keep
         // MDI & auto-instancing running on shadow map passes)
@@ -3412,38 +3476,8 @@ namespace Ogre
             // uint worldMaterialIdx[]
             *currentMappedConstBuffer = datablock->getAssignedSlot() & 0x1FF;
 
-            // mat4x3 world
-#if !OGRE_DOUBLE_PRECISION
-            memcpy( currentMappedTexBuffer, &worldMat, 4 * 3 * sizeof( float ) );
-            currentMappedTexBuffer += 16;
-#else
-            for( int y = 0; y < 3; ++y )
-            {
-                for( int x = 0; x < 4; ++x )
-                {
-                    *currentMappedTexBuffer++ = worldMat[y][x];
-                }
-            }
-            currentMappedTexBuffer += 4;
-#endif
-
-            // mat4 worldView
-            Matrix4 tmp = mPreparedPass.viewMatrix.concatenateAffine( worldMat );
-#if !OGRE_DOUBLE_PRECISION
-            memcpy( currentMappedTexBuffer, &tmp, sizeof( Matrix4 ) * !casterPass );
-            currentMappedTexBuffer += 16 * !casterPass;
-#else
-            if( !casterPass )
-            {
-                for( int y = 0; y < 4; ++y )
-                {
-                    for( int x = 0; x < 4; ++x )
-                    {
-                        *currentMappedTexBuffer++ = tmp[y][x];
-                    }
-                }
-            }
-#endif
+            currentMappedTexBuffer =
+                fillStaticTransforms<casterPass>( currentMappedTexBuffer, worldMat );
         }
         else
         {
@@ -3517,43 +3551,88 @@ namespace Ogre
                     const RenderableAnimated::IndexMap *indexMap =
                         renderableAnimated->getBlendIndexToBoneIndexMap();
 
-                    const size_t poseDataSize = numPoses > 0u ? ( 4u + poseWeightsNumFloats ) : 0u;
-                    const size_t minimumTexBufferSize = 12 * indexMap->size() + poseDataSize;
-                    bool exceedsTexBuffer =
-                        static_cast<size_t>( currentMappedTexBuffer - mStartMappedTexBuffer ) +
-                            minimumTexBufferSize >=
-                        mCurrentTexBufferSize;
+                    if( mSkeletonPaletteCacheTexBufferStart != mStartMappedTexBuffer )
+                    {
+                        ++mSkeletonPaletteCacheGeneration;
+                        mSkeletonPaletteCacheTexBufferStart = mStartMappedTexBuffer;
+                    }
 
-                    if( exceedsConstBuffer || exceedsTexBuffer )
+                    const size_t paletteCacheIdx =
+                        ( ( reinterpret_cast<uintptr_t>( skeleton ) >> 4u ) ^
+                          ( reinterpret_cast<uintptr_t>( indexMap ) >> 4u ) ) &
+                        ( SkeletonPaletteCacheSize - 1u );
+                    SkeletonPaletteCacheEntry &paletteCache = mSkeletonPaletteCache[paletteCacheIdx];
+
+                    // Pose data must immediately follow the bone matrices, thus the
+                    // palette can only be shared when there is no pose animation.
+                    if( numPoses == 0u && !exceedsConstBuffer &&
+                        paletteCache.generation == mSkeletonPaletteCacheGeneration &&
+                        paletteCache.skeleton == skeleton && paletteCache.indexMap == indexMap )
                     {
-                        currentMappedConstBuffer = mapNextConstBuffer( commandBuffer );
+                        // uint worldMaterialIdx[]
+                        *currentMappedConstBuffer =
+                            uint32( ( paletteCache.texBufferOffset << 9 ) |
+                                    ( datablock->getAssignedSlot() & 0x1FF ) );
+                    }
+                    else
+                    {
+                        const size_t poseDataSize =
+                            numPoses > 0u ? ( 4u + poseWeightsNumFloats ) : 0u;
+                        const size_t minimumTexBufferSize = 12 * indexMap->size() + poseDataSize;
+                        bool exceedsTexBuffer =
+                            static_cast<size_t>( currentMappedTexBuffer - mStartMappedTexBuffer ) +
+                                minimumTexBufferSize >=
+                            mCurrentTexBufferSize;
+
+                        if( exceedsConstBuffer || exceedsTexBuffer )
+                        {
+                            currentMappedConstBuffer = mapNextConstBuffer( commandBuffer );
 
-                        if( exceedsTexBuffer )
-                            mapNextTexBuffer( commandBuffer, minimumTexBufferSize * sizeof( float ) );
-                        else
-                            rebindTexBuffer( commandBuffer, true,
-                                             minimumTexBufferSize * sizeof( float ) );
+                            if( exceedsTexBuffer )
+                            {
+                                mapNextTexBuffer( commandBuffer,
+                                                  minimumTexBufferSize * sizeof( float ) );
+                            }
+                            else
+                            {
+                                rebindTexBuffer( commandBuffer, true,
+                                                 minimumTexBufferSize * sizeof( float ) );
+                            }
 
-                        currentMappedTexBuffer = mCurrentMappedTexBuffer;
-                    }
+                            currentMappedTexBuffer = mCurrentMappedTexBuffer;
 
-                    // uint worldMaterialIdx[]
-                    size_t distToWorldMatStart =
-                        static_cast<size_t>( mCurrentMappedTexBuffer - mStartMappedTexBuffer );
-                    distToWorldMatStart >>= 2;
-                    *currentMappedConstBuffer = uint32( ( distToWorldMatStart << 9 ) |
-                                                        ( datablock->getAssignedSlot() & 0x1FF ) );
+                            ++mSkeletonPaletteCacheGeneration;
+                            mSkeletonPaletteCacheTexBufferStart = mStartMappedTexBuffer;
+                        }
 
-                    RenderableAnimated::IndexMap::const_iterator itBone = indexMap->begin();
-                    RenderableAnimated::IndexMap::const_iterator enBone = indexMap->end();
+                        // uint worldMaterialIdx[]
+                        size_t distToWorldMatStart =
+                            static_cast<size_t>( mCurrentMappedTexBuffer - mStartMappedTexBuffer );
+                        distToWorldMatStart >>= 2;
+                        *currentMappedConstBuffer =
+                            uint32( ( distToWorldMatStart << 9 ) |
+                                    ( datablock->getAssignedSlot() & 0x1FF ) );
 
-                    while( itBone != enBone )
-                    {
-                        const SimpleMatrixAf4x3 &mat4x3 = skeleton->_getBoneFullTransform( *itBone );
-                        mat4x3.streamTo4x3( currentMappedTexBuffer );
-                        currentMappedTexBuffer += 12;
+                        if( numPoses == 0u )
+                        {
+                            paletteCache.skeleton = skeleton;
+                            paletteCache.indexMap = indexMap;
+                            paletteCache.texBufferOffset = static_cast<uint32>( distToWorldMatStart );
+                            paletteCache.generation = mSkeletonPaletteCacheGeneration;
+                        }
+
+                        RenderableAnimated::IndexMap::const_iterator itBone = indexMap->begin();
+                        RenderableAnimated::IndexMap::const_iterator enBone = indexMap->end();
+
+                        while( itBone != enBone )
+                        {
+                            const SimpleMatrixAf4x3 &mat4x3 =
+                                skeleton->_getBoneFullTransform( *itBone );
+                            mat4x3.streamTo4x3( currentMappedTexBuffer );
+                            currentMappedTexBuffer += 12;
 
-                        ++itBone;
+                            ++itBone;
+                        }
                     }
                 }
             }
@@ -3738,6 +3817,111 @@ namespace Ogre
         return uint32( ( ( mCurrentMappedConstBuffer - mStartMappedConstBuffer ) >> 2u ) - 1u );
     }
     //-----------------------------------------------------------------------------------
+    size_t HlmsPbs::fillBuffersForBatch( const HlmsCache *cache, const QueuedRenderable *begin,
+                                         const QueuedRenderable *end, bool casterPass,
+                                         uint32 lastCacheHash, CommandBuffer *commandBuffer,
+                                         uint32 *outBaseInstances )
+    {
+        if( casterPass )
+        {
+            return fillBuffersForBatch<true>( cache, begin, end, lastCacheHash, commandBuffer,
+                                              outBaseInstances );
+        }
+        else
+        {
+            return fillBuffersForBatch<false>( cache, begin, end, lastCacheHash, commandBuffer,
+                                               outBaseInstances );
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    template <bool casterPass>
+    size_t HlmsPbs::fillBuffersForBatch( const HlmsCache *cache, const QueuedRenderable *begin,
+                                         const QueuedRenderable *end, uint32 lastCacheHash,
+                                         CommandBuffer *commandBuffer, uint32 *outBaseInstances )
+    {
+        // The first renderable takes the regular path, which may add commands
+        outBaseInstances[0] =
+            fillBuffersFor<false, casterPass>( cache, *begin, lastCacheHash, commandBuffer );
+
+        uint32 *RESTRICT_ALIAS currentMappedConstBuffer = mCurrentMappedConstBuffer;
+        float *RESTRICT_ALIAS currentMappedTexBuffer = mCurrentMappedTexBuffer;
+
+        // Keep going while the renderables are static (no skeleton nor poses) and nothing
+        // needs to be bound. Stop at the first one that needs a command, the caller
+        // will send it again through fillBuffersFor.
+        const QueuedRenderable *itor = begin + 1;
+        while( itor != end )
+        {
+            const QueuedRenderable &queuedRenderable = *itor;
+            const Renderable *renderable = queuedRenderable.renderable;
+
+            if( renderable->hasSkeletonAnimation() || renderable->getNumPoses() != 0u )
+                break;
+
+            assert( dynamic_cast<const HlmsPbsDatablock *>( renderable->getDatablock() ) );
+            const HlmsPbsDatablock *datablock =
+                static_cast<const HlmsPbsDatablock *>( renderable->getDatablock() );
+
+            if( !casterPass || datablock->getAlphaTest() != CMPF_ALWAYS_PASS ||
+                datablock->getAlphaHashing() )
+            {
+                if( mLastBoundPool != datablock->getAssignedPool() ||
+                    datablock->mTexturesDescSet != mLastDescTexture ||
+                    ( mHasSeparateSamplers && datablock->mSamplersDescSet &&
+                      datablock->mSamplersDescSet != mLastDescSampler ) )
+                {
+                    break;
+                }
+#ifdef OGRE_BUILD_COMPONENT_PLANAR_REFLECTIONS
+                if( !casterPass && mHasPlanarReflections &&
+                    ( renderable->mCustomParameter & 0x80 /* UseActiveActor */ ) &&
+                    mLastBoundPlanarReflection != renderable->mCustomParameter )
+                {
+                    break;
+                }
+#endif
+            }
+
+            const size_t currentConstOffset =
+                static_cast<size_t>( currentMappedTexBuffer - mStartMappedTexBuffer ) >>
+                ( 2u + !casterPass );
+            const size_t minimumTexBufferSize = 16u * ( 1u + !casterPass );
+            if( currentConstOffset + 4u > mCurrentConstBufferSize ||
+                ( static_cast<size_t>( currentMappedTexBuffer - mStartMappedTexBuffer ) +
+                  minimumTexBufferSize ) >= mCurrentTexBufferSize )
+            {
+                // Needs to map the next buffers
+                break;
+            }
+            currentMappedConstBuffer = currentConstOffset + mStartMappedConstBuffer;
+
+            // uint worldMaterialIdx[]
+            *currentMappedConstBuffer = datablock->getAssignedSlot() & 0x1FF;
+
+            currentMappedTexBuffer = fillStaticTransforms<casterPass>(
+                currentMappedTexBuffer, queuedRenderable.movableObject->_getParentNodeFullTransform() );
+
+            *reinterpret_cast<float * RESTRICT_ALIAS>( currentMappedConstBuffer + 1 ) =
+                datablock->mShadowConstantBias * mConstantBiasScale;
+#if !OGRE_NO_FINE_LIGHT_MASK_GRANULARITY
+            *( currentMappedConstBuffer + 2u ) = queuedRenderable.movableObject->getLightMask();
+#endif
+#ifdef OGRE_BUILD_COMPONENT_PLANAR_REFLECTIONS
+            *( currentMappedConstBuffer + 3u ) = renderable->mCustomParameter & 0x7F;
+#endif
+            currentMappedConstBuffer += 4;
+
+            outBaseInstances[itor - begin] = uint32(
+                ( ( currentMappedConstBuffer - mStartMappedConstBuffer ) >> 2u ) - 1u );
+            ++itor;
+        }
+
+        mCurrentMappedConstBuffer = currentMappedConstBuffer;
+        mCurrentMappedTexBuffer = currentMappedTexBuffer;
+
+        return static_cast<size_t>( itor - begin );
+    }
+    //-----------------------------------------------------------------------------------
     void HlmsPbs::destroyAllBuffers()
     {
         HlmsBufferManager::destroyAllBuffers();
@@ -3823,6 +4007,9 @@ namespace Ogre
     {
         HlmsBufferManager::frameEnded();
         mCurrentPassBuffer = 0;
+        // Next frame may map the tex buffers at the same addresses. Invalidate the palettes.
+        ++mSkeletonPaletteCacheGeneration;
+        mSkeletonPaletteCacheTexBufferStart = 0;
     }
     //-----------------------------------------------------------------------------------
     void HlmsPbs::setStaticBranchingLights( bool staticBranchingLights )
@@ -32,6 +32,8 @@ THE SOFTWARE.
 
 #include "Vct/OgreVctVoxelizer.h"
 
+#include "OgreDataStream.h"
+#include "OgreImage2.h"
 #include "OgreItem.h"
 #include "OgreLogManager.h"
 #include "OgreMesh2.h"
@@ -49,6 +51,8 @@ namespace Ogre
     inline float roundf( float x ) { return x >= 0.0f ? floorf( x + 0.5f ) : ceilf( x - 0.5f ); }
 #endif
 
+    static const uint16 c_voxelizedMeshCacheVersion = 1u;
+
     VoxelizedMeshCache::VoxelizedMeshCache( IdType id, TextureGpuManager *textureManager ) :
         IdObject( id ),
         mMeshWidth( 64u ),
@@ -87,10 +91,7 @@ namespace Ogre
 
         while( itor != endt )
         {
-            textureManager->destroyTexture( itor->second.albedoVox );
-            textureManager->destroyTexture( itor->second.normalVox );
-            if( itor->second.emissiveVox != mBlankEmissive )
-                textureManager->destroyTexture( itor->second.emissiveVox );
+            destroyVoxelizedMesh( itor->second );
             ++itor;
         }
         mMeshes.clear();
@@ -99,6 +100,15 @@ namespace Ogre
         mBlankEmissive = 0;
     }
     //-------------------------------------------------------------------------
+    void VoxelizedMeshCache::destroyVoxelizedMesh( const VoxelizedMesh &voxelizedMesh )
+    {
+        TextureGpuManager *textureManager = mBlankEmissive->getTextureManager();
+        textureManager->destroyTexture( voxelizedMesh.albedoVox );
+        textureManager->destroyTexture( voxelizedMesh.normalVox );
+        if( voxelizedMesh.emissiveVox != mBlankEmissive )
+            textureManager->destroyTexture( voxelizedMesh.emissiveVox );
+    }
+    //-------------------------------------------------------------------------
     inline bool isPowerOf2( uint32 x ) { return ( x & ( x - 1u ) ) == 0u; }
     inline uint32 getNextPowerOf2( uint32 x )
     {
@@ -118,6 +128,18 @@ namespace Ogre
         finalRes = std::max( finalRes, 1u );
         return finalRes;
     }
+    //-------------------------------------------------------------------------
+    void VoxelizedMeshCache::calculateResolution( const Aabb &aabb, uint32 &outWidth,
+                                                  uint32 &outHeight, uint32 &outDepth ) const
+    {
+        const Vector3 size = aabb.getSize();
+        outWidth = calculateMeshResolution( mMeshWidth, size.x, mMeshDimensionPerPixel.x,
+                                            mMeshMaxWidth );
+        outHeight = calculateMeshResolution( mMeshHeight, size.y, mMeshDimensionPerPixel.y,
+                                             mMeshMaxHeight );
+        outDepth = calculateMeshResolution( mMeshDepth, size.z, mMeshDimensionPerPixel.z,
+                                            mMeshMaxDepth );
+    }
     /// Returns true if the Item has at least 1 submesh with emissive materials
     /// Note: This is a light check. If the submesh has an emissive texture
     /// but the texture is all black, we will mark it as emissive even though
@@ -175,10 +197,7 @@ namespace Ogre
                 else
                 {
                     // Erase entry
-                    textureManager->destroyTexture( itor->second.albedoVox );
-                    textureManager->destroyTexture( itor->second.normalVox );
-                    if( itor->second.emissiveVox != mBlankEmissive )
-                        textureManager->destroyTexture( itor->second.emissiveVox );
+                    destroyVoxelizedMesh( itor->second );
 
                     MeshCacheMap::iterator toErase = itor++;
                     mMeshes.erase( toErase );
@@ -187,6 +206,32 @@ namespace Ogre
             else if( itor->second.hash[0] == hash[0] && itor->second.hash[1] == hash[1] )
             {
                 bUpToDate = true;
+
+                if( itor->second.needsResolutionCheck )
+                {
+                    // Entry comes from disk. Make sure it was voxelized with the same settings
+                    uint32 width, height, depth;
+                    calculateResolution( mesh->getAabb(), width, height, depth );
+
+                    const TextureGpu *albedoVox = itor->second.albedoVox;
+                    if( albedoVox->getWidth() != width || albedoVox->getHeight() != height ||
+                        albedoVox->getDepthOrSlices() != depth )
+                    {
+                        bUpToDate = false;
+                        destroyVoxelizedMesh( itor->second );
+                        mMeshes.erase( itor );
+                    }
+                    else
+                    {
+                        itor->second.needsResolutionCheck = false;
+                    }
+                }
+            }
+            else
+            {
+                // Stale entry (e.g. loaded from disk but the mesh changed since)
+                destroyVoxelizedMesh( itor->second );
+                mMeshes.erase( itor );
             }
         }
 
@@ -207,14 +252,8 @@ namespace Ogre
 
             sceneManager->getRootSceneNode()->attachObject( tmpItem );
 
-            Aabb aabb = tmpItem->getLocalAabb();
-
-            const uint32 actualWidth = calculateMeshResolution(
-                mMeshWidth, aabb.getSize().x, mMeshDimensionPerPixel.x, mMeshMaxWidth );
-            const uint32 actualHeight = calculateMeshResolution(
-                mMeshHeight, aabb.getSize().y, mMeshDimensionPerPixel.y, mMeshMaxHeight );
-            const uint32 actualDepth = calculateMeshResolution(
-                mMeshDepth, aabb.getSize().z, mMeshDimensionPerPixel.z, mMeshMaxDepth );
+            uint32 actualWidth, actualHeight, actualDepth;
+            calculateResolution( tmpItem->getLocalAabb(), actualWidth, actualHeight, actualDepth );
             voxelizer.setResolution( actualWidth, actualHeight, actualDepth );
 
             tmpItem->getWorldAabbUpdated();  // Force AABB calculation
@@ -229,6 +268,7 @@ namespace Ogre
             voxelizedMesh.hash[0] = mesh->getHashForCaches()[0];
             voxelizedMesh.hash[1] = mesh->getHashForCaches()[1];
             voxelizedMesh.meshName = meshName;
+            voxelizedMesh.needsResolutionCheck = false;
 
             const bool bHasEmissive = hasEmissive( tmpItem );
 
@@ -296,4 +336,147 @@ namespace Ogre
         mMeshMaxDepth = maxDepth;
         mMeshDimensionPerPixel = dimension;
     }
+    //-------------------------------------------------------------------------
+    template <typename T>
+    static void write( DataStreamPtr &dataStream, const T &value )
+    {
+        dataStream->write( &value, sizeof( value ) );
+    }
+    //-------------------------------------------------------------------------
+    template <typename T>
+    static T read( DataStreamPtr &dataStream )
+    {
+        T value;
+        dataStream->read( &value, sizeof( value ) );
+        return value;
+    }
+    //-------------------------------------------------------------------------
+    static void saveTexture( DataStreamPtr &dataStream, TextureGpu *texture )
+    {
+        Image2 image;
+        image.convertFromTexture( texture, 0u, static_cast<uint8>( texture->getNumMipmaps() - 1u ) );
+        DataStreamPtr encoded = image.encode( "oitd", 0u, texture->getNumMipmaps() );
+
+        const size_t encodedSize = encoded->size();
+        write<uint32>( dataStream, static_cast<uint32>( encodedSize ) );
+
+        MemoryDataStream *memStream = static_cast<MemoryDataStream *>( encoded.get() );
+        dataStream->write( memStream->getPtr(), encodedSize );
+    }
+    //-------------------------------------------------------------------------
+    TextureGpu *VoxelizedMeshCache::loadTexture( DataStreamPtr &dataStream, const String &name )
+    {
+        const uint32 encodedSize = read<uint32>( dataStream );
+
+        DataStreamPtr encoded( OGRE_NEW MemoryDataStream( name, encodedSize, true ) );
+        dataStream->read( static_cast<MemoryDataStream *>( encoded.get() )->getPtr(), encodedSize );
+
+        Image2 *image = new Image2();
+        image->load( encoded, "oitd" );
+
+        TextureGpuManager *textureManager = mBlankEmissive->getTextureManager();
+        TextureGpu *texture = textureManager->createTexture( name, GpuPageOutStrategy::Discard, 0u,
+                                                             TextureTypes::Type3D );
+        texture->setResolution( image->getWidth(), image->getHeight(), image->getDepthOrSlices() );
+        texture->setPixelFormat( image->getPixelFormat() );
+        texture->setNumMipmaps( image->getNumMipmaps() );
+        // Ogre will delete the image once it's done streaming
+        texture->scheduleTransitionTo( GpuResidency::Resident, image, true );
+
+        return texture;
+    }
+    //-------------------------------------------------------------------------
+    void VoxelizedMeshCache::saveTo( DataStreamPtr &dataStream )
+    {
+        LogManager::getSingleton().logMessage( "Saving VoxelizedMeshCache to " +
+                                               dataStream->getName() );
+
+        uint32 numEntries = 0u;
+        MeshCacheMap::const_iterator itor = mMeshes.begin();
+        MeshCacheMap::const_iterator endt = mMeshes.end();
+
+        while( itor != endt )
+        {
+            if( itor->second.hash[0] != 0u || itor->second.hash[1] != 0u )
+                ++numEntries;
+            ++itor;
+        }
+
+        write<uint16>( dataStream, c_voxelizedMeshCacheVersion );
+        write<uint32>( dataStream, numEntries );
+
+        itor = mMeshes.begin();
+        while( itor != endt )
+        {
+            const VoxelizedMesh &voxelizedMesh = itor->second;
+            if( voxelizedMesh.hash[0] != 0u || voxelizedMesh.hash[1] != 0u )
+            {
+                write<uint32>( dataStream, static_cast<uint32>( voxelizedMesh.meshName.size() ) );
+                dataStream->write( voxelizedMesh.meshName.c_str(), voxelizedMesh.meshName.size() );
+                write( dataStream, voxelizedMesh.hash );
+
+                const bool bHasEmissive = voxelizedMesh.emissiveVox != mBlankEmissive;
+                write<uint8>( dataStream, bHasEmissive ? 1u : 0u );
+
+                saveTexture( dataStream, voxelizedMesh.albedoVox );
+                saveTexture( dataStream, voxelizedMesh.normalVox );
+                if( bHasEmissive )
+                    saveTexture( dataStream, voxelizedMesh.emissiveVox );
+            }
+            ++itor;
+        }
+    }
+    //-------------------------------------------------------------------------
+    void VoxelizedMeshCache::loadFrom( DataStreamPtr &dataStream )
+    {
+        LogManager::getSingleton().logMessage( "Loading VoxelizedMeshCache from " +
+                                               dataStream->getName() );
+
+        const uint16 version = read<uint16>( dataStream );
+        if( version != c_voxelizedMeshCacheVersion )
+        {
+            LogManager::getSingleton().logMessage(
+                "VoxelizedMeshCache: Version mismatch. Not loading." );
+            return;
+        }
+
+        const String idSuffix = StringConverter::toString( getId() );
+
+        const uint32 numEntries = read<uint32>( dataStream );
+        for( uint32 i = 0u; i < numEntries; ++i )
+        {
+            VoxelizedMesh voxelizedMesh;
+
+            const uint32 nameLength = read<uint32>( dataStream );
+            voxelizedMesh.meshName.resize( nameLength );
+            if( nameLength > 0u )
+                dataStream->read( &voxelizedMesh.meshName[0], nameLength );
+            voxelizedMesh.hash[0] = read<uint64>( dataStream );
+            voxelizedMesh.hash[1] = read<uint64>( dataStream );
+            voxelizedMesh.needsResolutionCheck = true;
+
+            const bool bHasEmissive = read<uint8>( dataStream ) != 0u;
+            const size_t numTextures = bHasEmissive ? 3u : 2u;
+
+            if( mMeshes.find( voxelizedMesh.meshName ) != mMeshes.end() )
+            {
+                // Already in memory. Skip it
+                for( size_t j = 0u; j < numTextures; ++j )
+                    dataStream->skip( static_cast<long>( read<uint32>( dataStream ) ) );
+                continue;
+            }
+
+            const String prefix = "VctImage/" + voxelizedMesh.meshName;
+            voxelizedMesh.albedoVox = loadTexture( dataStream, prefix + "/Albedo" + idSuffix );
+            voxelizedMesh.normalVox = loadTexture( dataStream, prefix + "/Normal" + idSuffix );
+            if( bHasEmissive )
+                voxelizedMesh.emissiveVox = loadTexture( dataStream, prefix + "/Emissive" + idSuffix );
+            else
+                voxelizedMesh.emissiveVox = mBlankEmissive;
+
+            mMeshes.emplace( voxelizedMesh.meshName, voxelizedMesh );
+        }
+
+        mBlankEmissive->getTextureManager()->waitForStreamingCompletion();
+    }
 }  // namespace Ogre
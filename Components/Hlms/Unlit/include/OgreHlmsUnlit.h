@@ -124,6 +124,14 @@ namespace Ogre
                                            uint32 lastCacheHash, CommandBuffer *commandBuffer,
                                            bool isV1 );
 
+        /// Writes the per-object data of a renderable: material index, constant bias &
+        /// identity projection to constBuffer (4 uint32) and worldViewProj to texBuffer.
+        /// Returns texBuffer advanced past the written data.
+        FORCEINLINE float *fillObjectData( uint32 *RESTRICT_ALIAS constBuffer,
+                                           float *RESTRICT_ALIAS   texBuffer,
+                                           const HlmsUnlitDatablock *datablock,
+                                           const QueuedRenderable   &queuedRenderable ) const;
+
         HlmsUnlit( Archive *dataFolder, ArchiveVec *libraryFolders, uint32 constBufferSize );
         HlmsUnlit( Archive *dataFolder, ArchiveVec *libraryFolders, HlmsTypes type,
                    const String &typeName, uint32 constBufferSize );
@@ -153,6 +161,13 @@ namespace Ogre
                                  bool casterPass, uint32 lastCacheHash,
                                  CommandBuffer *commandBuffer ) override;
 
+        /// See Hlms::fillBuffersForBatch. Enabled by default. Derived classes overriding
+        /// fillBuffersForV2 must call setBatchedFillBuffers( false ) or override this too.
+        size_t fillBuffersForBatch( const HlmsCache *cache, const QueuedRenderable *begin,
+                                    const QueuedRenderable *end, bool casterPass,
+                                    uint32 lastCacheHash, CommandBuffer *commandBuffer,
+                                    uint32 *outBaseInstances ) override;
+
         void frameEnded() override;
 
         void setShadowSettings( bool useExponentialShadowMaps );
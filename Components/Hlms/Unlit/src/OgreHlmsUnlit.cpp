@@ -98,6 +98,8 @@ namespace Ogre
         // Always use this strategy, even on mobile
         mOptimizationStrategy = LowerCpuOverhead;
 
+        mBatchedFillBuffers = true;
+
         // Always an identity matrix
         mPreparedPass.viewProjMatrix[4] = Matrix4::IDENTITY;
 
@@ -128,6 +130,8 @@ namespace Ogre
         // Always use this strategy, even on mobile
         mOptimizationStrategy = LowerCpuOverhead;
 
+        mBatchedFillBuffers = true;
+
         // Always an identity matrix
         mPreparedPass.viewProjMatrix[4] = Matrix4::IDENTITY;
 
@@ -960,7 +964,7 @@ namespace Ogre
         mLastDescSampler = 0;
         mLastBoundPool = 0;
 
-        uploadDirtyDatablocks();
+        uploadDirtyDatablocks( sceneManager );
 
         return retVal;
     }
@@ -989,6 +993,38 @@ namespace Ogre
                                false );
     }
     //-----------------------------------------------------------------------------------
+    float *HlmsUnlit::fillObjectData( uint32 *RESTRICT_ALIAS constBuffer,
+                                      float *RESTRICT_ALIAS texBuffer,
+                                      const HlmsUnlitDatablock *datablock,
+                                      const QueuedRenderable &queuedRenderable ) const
+    {
+        const bool useIdentityProjection = queuedRenderable.renderable->getUseIdentityProjection();
+
+        // uint materialIdx[]
+        *constBuffer = datablock->getAssignedSlot();
+        *reinterpret_cast<float * RESTRICT_ALIAS>( constBuffer + 1 ) =
+            datablock->mShadowConstantBias * mConstantBiasScale;
+        *( constBuffer + 2 ) = useIdentityProjection;
+
+        // mat4 worldViewProj
+        const Matrix4 tmp =
+            mPreparedPass.viewProjMatrix[mUsingInstancedStereo ? 4u : useIdentityProjection] *
+            queuedRenderable.movableObject->_getParentNodeFullTransform();
+#if !OGRE_DOUBLE_PRECISION
+        memcpy( texBuffer, &tmp, sizeof( Matrix4 ) );
+        texBuffer += 16;
+#else
+        for( int y = 0; y < 4; ++y )
+        {
+            for( int x = 0; x < 4; ++x )
+            {
+                *texBuffer++ = tmp[y][x];
+            }
+        }
+#endif
+        return texBuffer;
+    }
+    //-----------------------------------------------------------------------------------
     uint32 HlmsUnlit::fillBuffersFor( const HlmsCache *cache, const QueuedRenderable &queuedRenderable,
                                       bool casterPass, uint32 lastCacheHash,
                                       CommandBuffer *commandBuffer, bool isV1 )
@@ -1063,8 +1099,6 @@ namespace Ogre
         uint32 *RESTRICT_ALIAS currentMappedConstBuffer = mCurrentMappedConstBuffer;
         float *RESTRICT_ALIAS currentMappedTexBuffer = mCurrentMappedTexBuffer;
 
-        const Matrix4 &worldMat = queuedRenderable.movableObject->_getParentNodeFullTransform();
-
         bool exceedsConstBuffer = (size_t)( ( currentMappedConstBuffer - mStartMappedConstBuffer ) +
                                             4 ) > mCurrentConstBufferSize;
 
@@ -1088,31 +1122,10 @@ namespace Ogre
         //---------------------------------------------------------------------------
         //                          ---- VERTEX SHADER ----
         //---------------------------------------------------------------------------
-        bool useIdentityProjection = queuedRenderable.renderable->getUseIdentityProjection();
-
-        // uint materialIdx[]
-        *currentMappedConstBuffer = datablock->getAssignedSlot();
-        *reinterpret_cast<float * RESTRICT_ALIAS>( currentMappedConstBuffer + 1 ) =
-            datablock->mShadowConstantBias * mConstantBiasScale;
-        *( currentMappedConstBuffer + 2 ) = useIdentityProjection;
+        currentMappedTexBuffer = fillObjectData( currentMappedConstBuffer, currentMappedTexBuffer,
+                                                 datablock, queuedRenderable );
         currentMappedConstBuffer += 4;
 
-        // mat4 worldViewProj
-        Matrix4 tmp =
-            mPreparedPass.viewProjMatrix[mUsingInstancedStereo ? 4u : useIdentityProjection] * worldMat;
-#if !OGRE_DOUBLE_PRECISION
-        memcpy( currentMappedTexBuffer, &tmp, sizeof( Matrix4 ) );
-        currentMappedTexBuffer += 16;
-#else
-        for( int y = 0; y < 4; ++y )
-        {
-            for( int x = 0; x < 4; ++x )
-            {
-                *currentMappedTexBuffer++ = tmp[y][x];
-            }
-        }
-#endif
-
         //---------------------------------------------------------------------------
         //                          ---- PIXEL SHADER ----
         //---------------------------------------------------------------------------
@@ -1162,6 +1175,69 @@ namespace Ogre
         return uint32( ( ( mCurrentMappedConstBuffer - mStartMappedConstBuffer ) >> 2u ) - 1u );
     }
     //-----------------------------------------------------------------------------------
+    size_t HlmsUnlit::fillBuffersForBatch( const HlmsCache *cache, const QueuedRenderable *begin,
+                                           const QueuedRenderable *end, bool casterPass,
+                                           uint32 lastCacheHash, CommandBuffer *commandBuffer,
+                                           uint32 *outBaseInstances )
+    {
+        // The first renderable takes the regular path, which may add commands
+        outBaseInstances[0] =
+            fillBuffersFor( cache, *begin, casterPass, lastCacheHash, commandBuffer, false );
+
+        uint32 *RESTRICT_ALIAS currentMappedConstBuffer = mCurrentMappedConstBuffer;
+        float *RESTRICT_ALIAS currentMappedTexBuffer = mCurrentMappedTexBuffer;
+
+        const size_t minimumTexBufferSize = 16;
+
+        // Keep going while nothing needs to be bound. Stop at the first
+        // renderable that needs a command, the caller will send it again.
+        const QueuedRenderable *itor = begin + 1;
+        while( itor != end )
+        {
+            const QueuedRenderable &queuedRenderable = *itor;
+
+            assert( dynamic_cast<const HlmsUnlitDatablock *>(
+                queuedRenderable.renderable->getDatablock() ) );
+            const HlmsUnlitDatablock *datablock = static_cast<const HlmsUnlitDatablock *>(
+                queuedRenderable.renderable->getDatablock() );
+
+            if( !casterPass || datablock->getAlphaTest() != CMPF_ALWAYS_PASS ||
+                datablock->getAlphaHashing() )
+            {
+                if( mLastBoundPool != datablock->getAssignedPool() ||
+                    datablock->mTexturesDescSet != mLastDescTexture ||
+                    ( mHasSeparateSamplers && datablock->mSamplersDescSet &&
+                      datablock->mSamplersDescSet != mLastDescSampler ) )
+                {
+                    break;
+                }
+            }
+
+            if( (size_t)( ( currentMappedConstBuffer - mStartMappedConstBuffer ) + 4 ) >
+                    mCurrentConstBufferSize ||
+                static_cast<size_t>( currentMappedTexBuffer - mStartMappedTexBuffer ) +
+                        minimumTexBufferSize >=
+                    mCurrentTexBufferSize )
+            {
+                // Needs to map the next buffers
+                break;
+            }
+
+            currentMappedTexBuffer = fillObjectData(
+                currentMappedConstBuffer, currentMappedTexBuffer, datablock, queuedRenderable );
+            currentMappedConstBuffer += 4;
+
+            outBaseInstances[itor - begin] = uint32(
+                ( ( currentMappedConstBuffer - mStartMappedConstBuffer ) >> 2u ) - 1u );
+            ++itor;
+        }
+
+        mCurrentMappedConstBuffer = currentMappedConstBuffer;
+        mCurrentMappedTexBuffer = currentMappedTexBuffer;
+
+        return static_cast<size_t>( itor - begin );
+    }
+    //-----------------------------------------------------------------------------------
     void HlmsUnlit::destroyAllBuffers()
     {
         HlmsBufferManager::destroyAllBuffers();
@@ -39,10 +39,21 @@ namespace Ogre
     class _OgreLodExport LodCollapseCost
     {
     public:
+        /// Signature of the functions run by parallelFor. Processes the items in range [begin; end).
+        typedef void ( *ParallelForFunc )( LodCollapseCost *collapseCost, LodData *data, size_t begin,
+                                           size_t end, void *userData );
+
         virtual ~LodCollapseCost() {}
-        /// This is called after the LodInputProvider has initialized LodData.
+        /** This is called after the LodInputProvider has initialized LodData.
+        @remarks
+            The cost of every vertex is computed using LodData::mNumThreads threads (see
+            LodConfig::Advanced::numThreads, 1 by default). When that is greater than 1,
+            computeVertexCollapseCost and computeEdgeCollapseCost must be thread safe as long
+            as each thread works on a different vertex. Then the collapse cost heap is built
+            in one go.
+        */
         virtual void initCollapseCosts( LodData *data );
-        /// Called from initCollapseCosts for every edge.
+        /// Computes the cost of a single vertex and inserts it into the collapse cost heap.
         virtual void initVertexCollapseCost( LodData *data, LodData::VertexI vertexi );
         /// Called when edge cost gets invalid.
         virtual void updateVertexCollapseCost( LodData *data, LodData::VertexI vertexi );
@@ -57,6 +68,15 @@ namespace Ogre
     protected:
         // Helper functions:
         bool isBorderVertex( const LodData::Vertex *vertex ) const;
+
+        /** Splits the range [0; numItems) into contiguous blocks and calls func on each block,
+            using up to LodData::mNumThreads threads (the calling thread included).
+            Runs everything on the calling thread if there is too little work.
+        */
+        void parallelFor( LodData *data, size_t numItems, ParallelForFunc func, void *userData );
+
+        static void computeInitialCollapseCosts( LodCollapseCost *costCalculator, LodData *data,
+                                                 size_t begin, size_t end, void *userData );
     };
 
 }  // namespace Ogre
@@ -56,6 +56,12 @@ namespace Ogre
 
         void computeTrianglePlaneQuadric( LodData *data, size_t triangleID );
         void computeVertexQuadric( LodData *data, size_t vertexID );
+
+        /// ParallelForFunc wrappers around computeTrianglePlaneQuadric & computeVertexQuadric
+        static void computeTrianglePlaneQuadrics( LodCollapseCost *costCalculator, LodData *data,
+                                                  size_t begin, size_t end, void *userData );
+        static void computeVertexQuadrics( LodCollapseCost *costCalculator, LodData *data,
+                                           size_t begin, size_t end, void *userData );
     };
 
 }  // namespace Ogre
@@ -168,6 +168,12 @@ namespace Ogre
             Ogre::Real outsideWalkAngle;
             /// If the algorithm makes errors, you can fix it, by adding the edge to the profile.
             LodProfile profile;
+            /// Number of threads used to compute the initial collapse costs of the mesh. 0 means
+            /// one per logical core; 1 does everything on the calling thread.
+            /// Values other than 1 require the LodCollapseCost in use (including custom ones)
+            /// to have thread safe computeVertexCollapseCost and computeEdgeCollapseCost.
+            /// (1 by default)
+            uint32 numThreads;
             Advanced();
         } advanced;
     };
@@ -58,6 +58,7 @@ namespace Ogre
         struct Triangle;
         struct VertexHash;
         struct VertexEqual;
+        class CollapseCostHeap;
 
         typedef unsigned VertexI;    // offset in mVertexList
         typedef unsigned TriangleI;  // offset in mTriangleList
@@ -66,11 +67,10 @@ namespace Ogre
             InvalidIndex = (unsigned)-1
         };
 
-        typedef vector<Vertex>::type          VertexList;
-        typedef vector<Triangle>::type        TriangleList;
-        typedef multimap<Real, VertexI>::type CollapseCostHeap;
-        typedef VectorSet<Edge, 8>            VEdges;
-        typedef VectorSet<TriangleI, 7>       VTriangles;
+        typedef vector<Vertex>::type    VertexList;
+        typedef vector<Triangle>::type  TriangleList;
+        typedef VectorSet<Edge, 8>      VEdges;
+        typedef VectorSet<TriangleI, 7> VTriangles;
 
         // Hash function for UniqueVertexSet.
         struct VertexHash
@@ -114,10 +114,8 @@ namespace Ogre
             VEdges     edges;
             VTriangles triangles;
 
-            VertexI                    collapseToi;
-            bool                       seam;
-            CollapseCostHeap::iterator costHeapPosition;  ///< Iterator pointing to the position in the
-                                                          /// mCollapseCostSet, which allows fast remove.
+            VertexI collapseToi;
+            bool    seam;
 
             void addEdge( const Edge &edge );
             void removeEdge( const Edge &edge );
@@ -164,6 +162,65 @@ namespace Ogre
 
         typedef vector<IndexBufferInfo>::type IndexBufferInfoList;
 
+        /** Indexed binary min-heap of the vertices, sorted by their collapse cost.
+        @remarks
+            The heap is stored in flat arrays (costs and vertices of each slot), plus an array
+            indexed by VertexI with the slot each vertex lives in. This allows to update or
+            remove any vertex in O(log n) without allocating, unlike a multimap.
+            Ties are broken by VertexI so that the collapse order is deterministic.
+        */
+        class _OgreLodExport CollapseCostHeap
+        {
+            vector<Real>::type     mCosts;     ///< Cost of each slot
+            vector<VertexI>::type  mVertices;  ///< Vertex stored in each slot
+            vector<unsigned>::type mSlots;     ///< Slot of each vertex, or InvalidIndex
+
+            bool isLess( size_t slotA, size_t slotB ) const
+            {
+                return mCosts[slotA] < mCosts[slotB] ||
+                       ( mCosts[slotA] == mCosts[slotB] && mVertices[slotA] < mVertices[slotB] );
+            }
+            void swapSlots( size_t slotA, size_t slotB );
+            void siftUp( size_t slot );
+            void siftDown( size_t slot );
+
+        public:
+            /// Removes all vertices and prepares the heap to hold vertices in range [0; numVertices)
+            void reset( size_t numVertices );
+            void clear();
+
+            size_t size() const { return mVertices.size(); }
+            bool   empty() const { return mVertices.empty(); }
+
+            /// Vertex with the smallest collapse cost. Heap must not be empty.
+            VertexI topVertex() const { return mVertices.front(); }
+            Real    topCost() const { return mCosts.front(); }
+
+            bool contains( VertexI vi ) const
+            {
+                return vi < mSlots.size() && mSlots[vi] != (unsigned)InvalidIndex;
+            }
+            /// Collapse cost of the given vertex. It must be in the heap.
+            Real getCost( VertexI vi ) const { return mCosts[mSlots[vi]]; }
+
+            /// Inserts a vertex. It must not be in the heap.
+            void push( VertexI vi, Real cost );
+            /// Changes the cost of a vertex already in the heap.
+            void update( VertexI vi, Real cost );
+            /// Removes a vertex from the heap. It must be in the heap.
+            void erase( VertexI vi );
+
+            /// Inserts a vertex without keeping the heap order. Call makeHeap after
+            /// inserting all of them. Faster than calling push for bulk insertions.
+            void pushUnordered( VertexI vi, Real cost );
+            /// Restores the heap order in O(n) after pushUnordered
+            void makeHeap();
+
+            /// Access to the slots in no particular order. For debugging purposes.
+            VertexI getVertexAt( size_t slot ) const { return mVertices[slot]; }
+            Real    getCostAt( size_t slot ) const { return mCosts[slot]; }
+        };
+
         typedef unordered_set<VertexI, VertexHash, VertexEqual>::type UniqueVertexSet;
 
         /// Provides position based vertex lookup. Position is the real identifier of a vertex.
@@ -185,6 +242,9 @@ namespace Ogre
 #endif
         Real mMeshBoundingSphereRadius;
         bool mUseVertexNormals;
+        /// Number of threads used to compute the initial collapse costs. 0 means one per
+        /// logical core. See LodConfig::Advanced::numThreads.
+        uint32 mNumThreads;
 
         template <typename T, typename A>
         static size_t getVectorIDFromPointer( const std::vector<T, A> &vec, const T *pointer )
@@ -217,7 +277,8 @@ namespace Ogre
                               (const UniqueVertexSet::hasher &)VertexHash( this ),
                               (const UniqueVertexSet::key_equal &)VertexEqual( this ) ),
             mMeshBoundingSphereRadius( 0.0f ),
-            mUseVertexNormals( true )
+            mUseVertexNormals( true ),
+            mNumThreads( 1u )
         {
         }
 #if OGRE_COMPILER == OGRE_COMPILER_MSVC
@@ -29,14 +29,106 @@
 #include "OgreLodCollapseCost.h"
 
 #include "OgreLogManager.h"
+#include "OgrePlatformInformation.h"
+#include "Threading/OgreThreads.h"
 
 #include <sstream>
 
 namespace Ogre
 {
+    /// Below this amount of items per thread, it's not worth spawning threads.
+    static const size_t c_minItemsPerLodThread = 2048u;
+
+    struct LodParallelForJob
+    {
+        LodCollapseCost                 *collapseCost;
+        LodData                         *data;
+        size_t                           numItems;
+        size_t                           numThreads;
+        LodCollapseCost::ParallelForFunc func;
+        void                            *userData;
+
+        void execute( size_t threadIdx ) const
+        {
+            const size_t itemsPerThread = ( numItems + numThreads - 1u ) / numThreads;
+            const size_t begin = std::min( threadIdx * itemsPerThread, numItems );
+            const size_t end = std::min( begin + itemsPerThread, numItems );
+            func( collapseCost, data, begin, end, userData );
+        }
+    };
+
+    static unsigned long lodParallelForThread( ThreadHandle *threadHandle )
+    {
+        const LodParallelForJob *job =
+            reinterpret_cast<const LodParallelForJob *>( threadHandle->getUserParam() );
+        job->execute( threadHandle->getThreadIdx() );
+        return 0;
+    }
+
+    THREAD_DECLARE( lodParallelForThread );
+
+    void LodCollapseCost::parallelFor( LodData *data, size_t numItems, ParallelForFunc func,
+                                       void *userData )
+    {
+        size_t numThreads = data->mNumThreads;
+        if( numThreads == 0u )
+            numThreads = std::max<size_t>( PlatformInformation::getNumLogicalCores(), 1u );
+        numThreads = std::min( numThreads, std::max<size_t>( numItems / c_minItemsPerLodThread, 1u ) );
+
+        LodParallelForJob job;
+        job.collapseCost = this;
+        job.data = data;
+        job.numItems = numItems;
+        job.numThreads = numThreads;
+        job.func = func;
+        job.userData = userData;
+
+        if( numThreads <= 1u )
+        {
+            job.execute( 0u );
+            return;
+        }
+
+        // The calling thread takes care of the first block.
+        ThreadHandleVec workerThreads;
+        workerThreads.reserve( numThreads - 1u );
+        for( size_t i = 1u; i < numThreads; ++i )
+        {
+            workerThreads.push_back(
+                Threads::CreateThread( THREAD_GET( lodParallelForThread ), i, &job ) );
+        }
+        job.execute( 0u );
+        Threads::WaitForThreads( workerThreads );
+    }
+
+    void LodCollapseCost::computeInitialCollapseCosts( LodCollapseCost *costCalculator, LodData *data,
+                                                       size_t begin, size_t end, void *userData )
+    {
+        Real *costs = reinterpret_cast<Real *>( userData );
+        for( size_t i = begin; i < end; ++i )
+        {
+            LodData::Vertex *vertex = &data->mVertexList[i];
+            if( !vertex->edges.empty() )
+            {
+                Real collapseCost = LodData::UNINITIALIZED_COLLAPSE_COST;
+                LodData::VertexI collapseToi = LodData::InvalidIndex;
+                costCalculator->computeVertexCollapseCost( data, static_cast<LodData::VertexI>( i ),
+                                                           collapseCost, collapseToi );
+                vertex->collapseToi = collapseToi;
+                costs[i] = collapseCost;
+            }
+        }
+    }
+
     void LodCollapseCost::initCollapseCosts( LodData *data )
     {
-        data->mCollapseCostHeap.clear();
+        const size_t numVertices = data->mVertexList.size();
+
+        vector<Real>::type costs( numVertices, LodData::UNINITIALIZED_COLLAPSE_COST );
+        if( numVertices > 0u )
+            parallelFor( data, numVertices, computeInitialCollapseCosts, &costs[0] );
+
+        data->mCollapseCostHeap.reset( numVertices );
         LodData::VertexList::iterator it = data->mVertexList.begin();
         LodData::VertexList::iterator itEnd = data->mVertexList.end();
         LodData::VertexI vi = 0;
@@ -44,19 +136,19 @@ namespace Ogre
         {
             if( !it->edges.empty() )
             {
-                initVertexCollapseCost( data, vi );
+                data->mCollapseCostHeap.pushUnordered( vi, costs[vi] );
             }
             else
             {
 #if OGRE_DEBUG_MODE
                 LogManager::getSingleton().stream()
-                    << "In " << data->mMeshName
-                    << " never used vertex found with ID: " << data->mCollapseCostHeap.size() << ". "
+                    << "In " << data->mMeshName << " never used vertex found with ID: " << vi << ". "
                     << "Vertex position: (" << it->position.x << ", " << it->position.y << ", "
                     << it->position.z << ") " << "It will be excluded from Lod level calculations.";
 #endif
             }
         }
+        data->mCollapseCostHeap.makeHeap();
     }
 
     void LodCollapseCost::computeVertexCollapseCost( LodData *data, LodData::VertexI vertexi,
@@ -84,7 +176,7 @@ namespace Ogre
         computeVertexCollapseCost( data, vertexi, collapseCost, collapseToi );
 
         vertex->collapseToi = collapseToi;
-        vertex->costHeapPosition = data->mCollapseCostHeap.emplace( collapseCost, vertexi );
+        data->mCollapseCostHeap.push( vertexi, collapseCost );
     }
 
     void LodCollapseCost::updateVertexCollapseCost( LodData *data, LodData::VertexI vertexi )
@@ -94,20 +186,28 @@ namespace Ogre
         computeVertexCollapseCost( data, vertexi, collapseCost, collapseToi );
 
         LodData::Vertex *vertex = &data->mVertexList[vertexi];
-        if( vertex->collapseToi != collapseToi || collapseCost != vertex->costHeapPosition->first )
+        if( !data->mCollapseCostHeap.contains( vertexi ) )
+        {
+            // Was removed from the heap in a previous update.
+            if( collapseCost != LodData::UNINITIALIZED_COLLAPSE_COST )
+            {
+                vertex->collapseToi = collapseToi;
+                data->mCollapseCostHeap.push( vertexi, collapseCost );
+            }
+        }
+        else if( vertex->collapseToi != collapseToi ||
+            collapseCost != data->mCollapseCostHeap.getCost( vertexi ) )
         {
-            OgreAssert( vertex->costHeapPosition != data->mCollapseCostHeap.end(), "" );
-            data->mCollapseCostHeap.erase( vertex->costHeapPosition );
             if( collapseCost != LodData::UNINITIALIZED_COLLAPSE_COST )
             {
                 vertex->collapseToi = collapseToi;
-                vertex->costHeapPosition = data->mCollapseCostHeap.emplace( collapseCost, vertexi );
+                data->mCollapseCostHeap.update( vertexi, collapseCost );
             }
             else
             {
+                data->mCollapseCostHeap.erase( vertexi );
 #if OGRE_DEBUG_MODE
                 vertex->collapseToi = LodData::InvalidIndex;
-                vertex->costHeapPosition = data->mCollapseCostHeap.end();
 #endif
             }
         }
@@ -41,16 +41,31 @@ namespace Ogre
     void LodCollapseCostQuadric::initCollapseCosts( LodData *data )
     {
         mTrianglePlaneQuadricList.resize( data->mTriangleList.size() );
-        for( size_t i = 0; i < mTrianglePlaneQuadricList.size(); i++ )
+        parallelFor( data, mTrianglePlaneQuadricList.size(), computeTrianglePlaneQuadrics, 0 );
+        mVertexQuadricList.resize( data->mVertexList.size() );
+        parallelFor( data, mVertexQuadricList.size(), computeVertexQuadrics, 0 );
+        LodCollapseCost::initCollapseCosts( data );
+    }
+
+    void LodCollapseCostQuadric::computeTrianglePlaneQuadrics( LodCollapseCost *costCalculator,
+                                                               LodData *data, size_t begin, size_t end,
+                                                               void * )
+    {
+        LodCollapseCostQuadric *quadric = static_cast<LodCollapseCostQuadric *>( costCalculator );
+        for( size_t i = begin; i < end; i++ )
         {
-            computeTrianglePlaneQuadric( data, i );
+            quadric->computeTrianglePlaneQuadric( data, i );
         }
-        mVertexQuadricList.resize( data->mVertexList.size() );
-        for( size_t i = 0; i < mVertexQuadricList.size(); i++ )
+    }
+
+    void LodCollapseCostQuadric::computeVertexQuadrics( LodCollapseCost *costCalculator, LodData *data,
+                                                        size_t begin, size_t end, void * )
+    {
+        LodCollapseCostQuadric *quadric = static_cast<LodCollapseCostQuadric *>( costCalculator );
+        for( size_t i = begin; i < end; i++ )
         {
-            computeVertexQuadric( data, i );
+            quadric->computeVertexQuadric( data, i );
         }
-        LodCollapseCost::initCollapseCosts( data );
     }
 
     void LodCollapseCostQuadric::computeTrianglePlaneQuadric( LodData *data, size_t triangleID )
@@ -132,4 +132,112 @@ namespace Ogre
 
     bool LodData::Edge::operator==( const LodData::Edge &other ) const { return dsti == other.dsti; }
 
+    void LodData::CollapseCostHeap::reset( size_t numVertices )
+    {
+        mCosts.clear();
+        mVertices.clear();
+        mSlots.clear();
+        mSlots.resize( numVertices, (unsigned)InvalidIndex );
+        mCosts.reserve( numVertices );
+        mVertices.reserve( numVertices );
+    }
+
+    void LodData::CollapseCostHeap::clear()
+    {
+        mCosts.clear();
+        mVertices.clear();
+        mSlots.clear();
+    }
+
+    void LodData::CollapseCostHeap::swapSlots( size_t slotA, size_t slotB )
+    {
+        std::swap( mCosts[slotA], mCosts[slotB] );
+        std::swap( mVertices[slotA], mVertices[slotB] );
+        mSlots[mVertices[slotA]] = static_cast<unsigned>( slotA );
+        mSlots[mVertices[slotB]] = static_cast<unsigned>( slotB );
+    }
+
+    void LodData::CollapseCostHeap::siftUp( size_t slot )
+    {
+        while( slot > 0u )
+        {
+            const size_t parent = ( slot - 1u ) >> 1u;
+            if( !isLess( slot, parent ) )
+                break;
+            swapSlots( slot, parent );
+            slot = parent;
+        }
+    }
+
+    void LodData::CollapseCostHeap::siftDown( size_t slot )
+    {
+        const size_t numSlots = mVertices.size();
+        while( true )
+        {
+            const size_t left = ( slot << 1u ) + 1u;
+            if( left >= numSlots )
+                break;
+            size_t smallest = left;
+            if( left + 1u < numSlots && isLess( left + 1u, left ) )
+                smallest = left + 1u;
+            if( !isLess( smallest, slot ) )
+                break;
+            swapSlots( slot, smallest );
+            slot = smallest;
+        }
+    }
+
+    void LodData::CollapseCostHeap::pushUnordered( VertexI vi, Real cost )
+    {
+        if( vi >= mSlots.size() )
+            mSlots.resize( vi + 1u, (unsigned)InvalidIndex );
+        OgreAssert( mSlots[vi] == (unsigned)InvalidIndex, "Vertex is already in the heap" );
+        mSlots[vi] = static_cast<unsigned>( mVertices.size() );
+        mCosts.push_back( cost );
+        mVertices.push_back( vi );
+    }
+
+    void LodData::CollapseCostHeap::makeHeap()
+    {
+        const size_t numSlots = mVertices.size();
+        for( size_t i = numSlots >> 1u; i-- > 0u; )
+            siftDown( i );
+    }
+
+    void LodData::CollapseCostHeap::push( VertexI vi, Real cost )
+    {
+        pushUnordered( vi, cost );
+        siftUp( mVertices.size() - 1u );
+    }
+
+    void LodData::CollapseCostHeap::update( VertexI vi, Real cost )
+    {
+        OgreAssert( contains( vi ), "Vertex is not in the heap" );
+        const size_t slot = mSlots[vi];
+        const Real oldCost = mCosts[slot];
+        mCosts[slot] = cost;
+        if( cost < oldCost )
+            siftUp( slot );
+        else
+            siftDown( slot );
+    }
+
+    void LodData::CollapseCostHeap::erase( VertexI vi )
+    {
+        OgreAssert( contains( vi ), "Vertex is not in the heap" );
+        const size_t slot = mSlots[vi];
+        const size_t lastSlot = mVertices.size() - 1u;
+        if( slot != lastSlot )
+            swapSlots( slot, lastSlot );
+        mSlots[vi] = (unsigned)InvalidIndex;
+        mCosts.pop_back();
+        mVertices.pop_back();
+        if( slot != lastSlot )
+        {
+            // The vertex we moved into slot may need to go either way.
+            siftUp( slot );
+            siftDown( mSlots[mVertices[slot]] );
+        }
+    }
+
 }  // namespace Ogre
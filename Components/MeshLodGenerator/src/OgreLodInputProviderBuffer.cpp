@@ -155,9 +155,6 @@ namespace Ogre
             }
             else
             {
-#if OGRE_DEBUG_MODE
-                v->costHeapPosition = data->mCollapseCostHeap.end();
-#endif
                 v->seam = false;
                 if( data->mUseVertexNormals )
                 {
@@ -214,10 +214,6 @@ namespace Ogre
             }
             else
             {
-#if OGRE_DEBUG_MODE
-                // Needed for an assert, don't remove it.
-                v->costHeapPosition = data->mCollapseCostHeap.end();
-#endif
                 v->seam = false;
             }
             lookup.push_back( vi );
@@ -207,6 +207,7 @@ namespace Ogre
     {
         input->initData( data );
         data->mUseVertexNormals = data->mUseVertexNormals && lodConfig.advanced.useVertexNormals;
+        data->mNumThreads = lodConfig.advanced.numThreads;
         cost->initCollapseCosts( data );
         output->prepare( data );
         computeLods( lodConfig, data, cost, output, collapser );
@@ -108,14 +108,22 @@ namespace Ogre
             String doGet( const void *target ) const override;
             void   doSet( void *target, const String &val ) override;
         };
+        /// Command object for Font - see ParamCommand
+        class _OgreOverlayExport CmdDynamicAtlas final : public ParamCommand
+        {
+        public:
+            String doGet( const void *target ) const override;
+            void   doSet( void *target, const String &val ) override;
+        };
 
         // Command object for setting / getting parameters
-        static CmdType       msTypeCmd;
-        static CmdSource     msSourceCmd;
-        static CmdCharSpacer msCharacterSpacerCmd;
-        static CmdSize       msSizeCmd;
-        static CmdResolution msResolutionCmd;
-        static CmdCodePoints msCodePointsCmd;
+        static CmdType         msTypeCmd;
+        static CmdSource       msSourceCmd;
+        static CmdCharSpacer   msCharacterSpacerCmd;
+        static CmdSize         msSizeCmd;
+        static CmdResolution   msResolutionCmd;
+        static CmdCodePoints   msCodePointsCmd;
+        static CmdDynamicAtlas msDynamicAtlasCmd;
 
         /// The type of font
         FontType mType;
@@ -156,20 +164,30 @@ namespace Ogre
         typedef vector<CodePointRange>::type    CodePointRangeList;
 
     protected:
+        struct DynamicAtlas;
+
         /// Map from unicode code point to texture coordinates
         typedef map<CodePoint, GlyphInfo>::type CodePointMap;
-        CodePointMap                            mCodePointMap;
+        /// Mutable because dynamic atlases load glyphs on demand from const getters
+        mutable CodePointMap mCodePointMap;
 
         /// The material which is generated for this font
         HlmsDatablock *mHlmsDatablock;
 
         /// Texture pointer
-        TextureGpu *mTexture;
-        bool        mTextureLoadingInProgress;
+        mutable TextureGpu *mTexture;
+        bool                mTextureLoadingInProgress;
 
         /// For TRUE_TYPE font only
         bool mAntialiasColour;
 
+        /// See setDynamicAtlas
+        bool           mDynamicAtlasEnabled;
+        uint32         mDynamicAtlasResolution;
+        uint32         mDynamicAtlasMaxResolution;
+        mutable uint32 mAtlasVersion;
+        DynamicAtlas  *mDynamicAtlas;
+
         /// Range of code points to generate glyphs for (truetype only)
         CodePointRangeList mCodePointRangeList;
 
@@ -177,6 +195,34 @@ namespace Ogre
         void createTextureFromFont();
         void loadTextureFromFont( TextureGpuManager *textureManager );
 
+        /// Opens the ttf and creates an empty atlas. Glyphs get rasterized on demand.
+        void createDynamicAtlas();
+        void destroyDynamicAtlas();
+        /// (Re)creates mTexture from the dynamic atlas' CPU copy,
+        /// and assigns it to the datablock if it exists.
+        void createDynamicAtlasTexture() const;
+        /// Returns the index of a free slot in the dynamic atlas, evicting
+        /// the least recently used glyph or growing the atlas if needed.
+        uint32 acquireDynamicAtlasSlot() const;
+        void   growDynamicAtlas() const;
+        /// Rasterizes the glyph into the dynamic atlas. Returns null if it's not in the ttf.
+        const GlyphInfo *loadDynamicGlyph( CodePoint id ) const;
+
+        /// Finds the glyph, rasterizing it if using a dynamic atlas. Returns null if not found.
+        inline const GlyphInfo *findGlyph( CodePoint id ) const
+        {
+            CodePointMap::const_iterator i = mCodePointMap.find( id );
+            if( i != mCodePointMap.end() )
+            {
+                if( mDynamicAtlas )
+                    touchDynamicGlyph( i->second );
+                return &i->second;
+            }
+            return mDynamicAtlas ? loadDynamicGlyph( id ) : 0;
+        }
+        /// Tags the glyph as used this frame, so it won't be evicted.
+        void touchDynamicGlyph( const GlyphInfo &glyphInfo ) const;
+
         /// @copydoc Resource::loadImpl
         void loadImpl() override;
         /// @copydoc Resource::unloadImpl
@@ -275,10 +321,10 @@ namespace Ogre
         */
         inline const UVRect &getGlyphTexCoords( CodePoint id ) const
         {
-            CodePointMap::const_iterator i = mCodePointMap.find( id );
-            if( i != mCodePointMap.end() )
+            const GlyphInfo *glyphInfo = findGlyph( id );
+            if( glyphInfo )
             {
-                return i->second.uvRect;
+                return glyphInfo->uvRect;
             }
             else
             {
@@ -315,10 +361,10 @@ namespace Ogre
         /** Gets the aspect ratio (width / height) of this character. */
         inline Real getGlyphAspectRatio( CodePoint id ) const
         {
-            CodePointMap::const_iterator i = mCodePointMap.find( id );
-            if( i != mCodePointMap.end() )
+            const GlyphInfo *glyphInfo = findGlyph( id );
+            if( glyphInfo )
             {
-                return i->second.aspectRatio;
+                return glyphInfo->aspectRatio;
             }
             else
             {
@@ -362,6 +408,36 @@ namespace Ogre
         */
         const CodePointRangeList &getCodePointRangeList() const { return mCodePointRangeList; }
 
+        /** Rasterizes glyphs on demand into a texture atlas, instead of rasterizing all the
+            code point ranges at load time. Only valid for FT_TRUETYPE. Must be set before loading.
+        @remarks
+            Useful for fonts with huge code point ranges (e.g. CJK) where only a few glyphs
+            are used at a time. The code point ranges are ignored.
+        @par
+            Glyphs are rasterized the first time they're requested (getGlyphTexCoords,
+            getGlyphAspectRatio, getGlyphInfo), and uploaded to the GPU when _uploadDirtyGlyphs
+            is called (TextAreaOverlayElement does it automatically).
+            When the atlas is full, the least recently used glyph gets evicted, as long as it
+            wasn't used in the current frame. Otherwise the atlas doubles its height, up to
+            maxResolution.
+        @par
+            Eviction and growth invalidate UVs previously returned. getAtlasVersion
+            changes every time that happens.
+        @param resolution
+            Initial width & height of the atlas, in pixels.
+        @param maxResolution
+            Max height the atlas can grow to, in pixels.
+        */
+        void setDynamicAtlas( bool bDynamic, uint32 resolution = 512u, uint32 maxResolution = 4096u );
+        bool getDynamicAtlas() const { return mDynamicAtlasEnabled; }
+
+        /// See setDynamicAtlas
+        uint32 getAtlasVersion() const { return mAtlasVersion; }
+
+        /// Uploads to the GPU the glyphs rasterized into the dynamic atlas since the last call.
+        /// Does nothing if the font isn't using a dynamic atlas.
+        void _uploadDirtyGlyphs();
+
         /** Gets the HLMS Datablock generated for this font
         @remarks
             This will only be valid after the Font has been loaded.
@@ -232,6 +232,8 @@ namespace Ogre
             static CmdAlignment    msCmdAlignment;
 
             FontPtr mFont;
+            /// Font::getAtlasVersion when the geometry was built. See Font::setDynamicAtlas
+            uint32  mFontAtlasVersion;
             Real    mCharHeight;
             ushort  mPixelCharHeight;
             bool    mSpaceWidthOverridden;
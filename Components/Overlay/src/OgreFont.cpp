@@ -61,6 +61,64 @@ namespace Ogre
     Font::CmdSize Font::msSizeCmd;
     Font::CmdResolution Font::msResolutionCmd;
     Font::CmdCodePoints Font::msCodePointsCmd;
+    Font::CmdDynamicAtlas Font::msDynamicAtlasCmd;
+
+    /// State of a font using a dynamic atlas. See Font::setDynamicAtlas
+    struct Font::DynamicAtlas
+    {
+        struct Slot
+        {
+            CodePoint     codePoint;
+            unsigned long lastUsedFrame;
+        };
+        typedef vector<Slot>::type Slots;
+        typedef map<CodePoint, uint32>::type SlotIdxMap;
+
+        FT_Library ftLibrary;
+        FT_Face    face;
+        /// FT_New_Memory_Face needs the ttf to stay in memory while the face is alive
+        MemoryDataStreamPtr ttfChunk;
+
+        /// Height of the glyphs, without the spacer
+        uint32 glyphHeight;
+        /// Size of each slot in the atlas, including the spacer
+        uint32 slotWidth;
+        uint32 slotHeight;
+
+        uint32 width;
+        uint32 height;
+        uint32 bytesPerRow;
+        /// CPU copy of the whole atlas
+        uint8 *imageData;
+
+        Slots      slots;
+        SlotIdxMap slotIdxForCodePoint;
+
+        /// Bounding rect (in pixels, exclusive) of the regions that need to be uploaded
+        uint32 dirtyLeft;
+        uint32 dirtyTop;
+        uint32 dirtyRight;
+        uint32 dirtyBottom;
+
+        uint32 getNumSlotsPerRow() const { return width / slotWidth; }
+        uint32 getMaxSlots() const { return getNumSlotsPerRow() * ( height / slotHeight ); }
+
+        void clearDirty()
+        {
+            dirtyLeft = width;
+            dirtyTop = height;
+            dirtyRight = 0u;
+            dirtyBottom = 0u;
+        }
+        void addDirty( uint32 left, uint32 top, uint32 right, uint32 bottom )
+        {
+            dirtyLeft = std::min( dirtyLeft, left );
+            dirtyTop = std::min( dirtyTop, top );
+            dirtyRight = std::max( dirtyRight, right );
+            dirtyBottom = std::max( dirtyBottom, bottom );
+        }
+        bool isDirty() const { return dirtyLeft < dirtyRight && dirtyTop < dirtyBottom; }
+    };
 
     //---------------------------------------------------------------------
     Font::Font( ResourceManager *creator, const String &name, ResourceHandle handle, const String &group,
@@ -74,7 +132,12 @@ namespace Ogre
         mHlmsDatablock( 0 ),
         mTexture( 0 ),
         mTextureLoadingInProgress( false ),
-        mAntialiasColour( false )
+        mAntialiasColour( false ),
+        mDynamicAtlasEnabled( false ),
+        mDynamicAtlasResolution( 512u ),
+        mDynamicAtlasMaxResolution( 4096u ),
+        mAtlasVersion( 0u ),
+        mDynamicAtlas( 0 )
     {
         if( createParamDictionary( "Font" ) )
         {
@@ -93,6 +156,9 @@ namespace Ogre
                                 &msResolutionCmd );
             dict->addParameter( ParameterDef( "code_points", "Add a range of code points", PT_STRING ),
                                 &msCodePointsCmd );
+            dict->addParameter(
+                ParameterDef( "dynamic_atlas", "Rasterize glyphs on demand into an atlas", PT_BOOL ),
+                &msDynamicAtlasCmd );
         }
     }
     //---------------------------------------------------------------------
@@ -125,16 +191,23 @@ namespace Ogre
     //---------------------------------------------------------------------
     int Font::getTrueTypeMaxBearingY() const { return mTtfMaxBearingY; }
     //---------------------------------------------------------------------
+    void Font::setDynamicAtlas( bool bDynamic, uint32 resolution, uint32 maxResolution )
+    {
+        mDynamicAtlasEnabled = bDynamic;
+        mDynamicAtlasResolution = resolution;
+        mDynamicAtlasMaxResolution = std::max( resolution, maxResolution );
+    }
+    //---------------------------------------------------------------------
     const Font::GlyphInfo &Font::getGlyphInfo( CodePoint id ) const
     {
-        CodePointMap::const_iterator i = mCodePointMap.find( id );
-        if( i == mCodePointMap.end() )
+        const GlyphInfo *glyphInfo = findGlyph( id );
+        if( !glyphInfo )
         {
             OGRE_EXCEPT( Exception::ERR_ITEM_NOT_FOUND,
                          "Code point " + StringConverter::toString( id ) + " not found in font " + mName,
                          "Font::getGlyphInfo" );
         }
-        return i->second;
+        return *glyphInfo;
     }
     //---------------------------------------------------------------------
     void Font::loadImpl()
@@ -143,7 +216,10 @@ namespace Ogre
         bool blendByAlpha = true;
         if( mType == FT_TRUETYPE )
         {
-            createTextureFromFont();
+            if( mDynamicAtlasEnabled )
+                createDynamicAtlas();
+            else
+                createTextureFromFont();
             // Always blend by alpha
             blendByAlpha = true;
         }
@@ -220,6 +296,8 @@ namespace Ogre
         mHlmsDatablock->getCreator()->destroyDatablock( mHlmsDatablock->getName() );
         mHlmsDatablock = 0;
 
+        destroyDynamicAtlas();
+
         if( mTexture )
         {
             mTexture->removeListener( this );
@@ -469,6 +547,361 @@ namespace Ogre
         FT_Done_FreeType( ftLibrary );
     }
     //---------------------------------------------------------------------
+    void Font::createDynamicAtlas()
+    {
+        OGRE_ASSERT_LOW( !mDynamicAtlas );
+
+        DynamicAtlas *atlas = new DynamicAtlas();
+        mDynamicAtlas = atlas;
+
+        if( FT_Init_FreeType( &atlas->ftLibrary ) )
+        {
+            OGRE_EXCEPT( Exception::ERR_INTERNAL_ERROR, "Could not init FreeType library!",
+                         "Font::createDynamicAtlas" );
+        }
+
+        DataStreamPtr dataStreamPtr =
+            ResourceGroupManager::getSingleton().openResource( mSource, mGroup, true, this );
+        atlas->ttfChunk = MemoryDataStreamPtr( OGRE_NEW MemoryDataStream( dataStreamPtr ) );
+
+        if( FT_New_Memory_Face( atlas->ftLibrary, atlas->ttfChunk->getPtr(),
+                                (FT_Long)atlas->ttfChunk->size(), 0, &atlas->face ) )
+        {
+            FT_Done_FreeType( atlas->ftLibrary );
+            delete atlas;
+            mDynamicAtlas = 0;
+            OGRE_EXCEPT( Exception::ERR_INTERNAL_ERROR, "Could not open font face!",
+                         "Font::createDynamicAtlas" );
+        }
+
+        FT_Face face = atlas->face;
+
+        // Convert our point size to freetype 26.6 fixed point format
+        FT_F26Dot6 ftSize = (FT_F26Dot6)( mTtfSize * ( 1 << 6 ) );
+        if( FT_Set_Char_Size( face, ftSize, 0, mTtfResolution, mTtfResolution ) )
+        {
+            OGRE_EXCEPT( Exception::ERR_INTERNAL_ERROR, "Could not set char size!",
+                         "Font::createDynamicAtlas" );
+        }
+
+        // We can't iterate all glyphs to find the max sizes (that's what we're trying to avoid)
+        // so we use the face's metrics instead.
+        mTtfMaxBearingY = static_cast<int>( face->size->metrics.ascender );
+        atlas->glyphHeight = static_cast<uint32>(
+            std::max<FT_Pos>( ( face->size->metrics.ascender - face->size->metrics.descender ) >> 6,
+                              1 ) );
+        atlas->slotWidth = static_cast<uint32>(
+            std::max<FT_Pos>( face->size->metrics.max_advance >> 6, 1 ) + mCharacterSpacer );
+        atlas->slotHeight = atlas->glyphHeight + mCharacterSpacer;
+
+        atlas->width = Bitwise::firstPO2From( std::max( mDynamicAtlasResolution, atlas->slotWidth ) );
+        atlas->height = Bitwise::firstPO2From( std::max( mDynamicAtlasResolution, atlas->slotHeight ) );
+
+        atlas->bytesPerRow = static_cast<uint32>( PixelFormatGpuUtils::getSizeBytes(
+            atlas->width, 1u, 1u, 1u, PFG_RG8_UNORM, 4u ) );
+        const size_t dataSize = atlas->bytesPerRow * atlas->height;
+        atlas->imageData =
+            reinterpret_cast<uint8 *>( OGRE_MALLOC_SIMD( dataSize, MEMCATEGORY_RESOURCE ) );
+        // Reset content (White, transparent)
+        for( size_t i = 0; i < dataSize; i += 2u )
+        {
+            atlas->imageData[i + 0] = 0xFF;  // luminance
+            atlas->imageData[i + 1] = 0x00;  // alpha
+        }
+        atlas->clearDirty();
+
+        LogManager::getSingleton().logMessage( "Font " + mName + " using dynamic atlas of size " +
+                                               StringConverter::toString( atlas->width ) + "x" +
+                                               StringConverter::toString( atlas->height ) );
+
+        createDynamicAtlasTexture();
+    }
+    //---------------------------------------------------------------------
+    void Font::destroyDynamicAtlas()
+    {
+        if( !mDynamicAtlas )
+            return;
+
+        FT_Done_Face( mDynamicAtlas->face );
+        FT_Done_FreeType( mDynamicAtlas->ftLibrary );
+        OGRE_FREE_SIMD( mDynamicAtlas->imageData, MEMCATEGORY_RESOURCE );
+
+        delete mDynamicAtlas;
+        mDynamicAtlas = 0;
+
+        mCodePointMap.clear();
+    }
+    //---------------------------------------------------------------------
+    void Font::createDynamicAtlasTexture() const
+    {
+        RenderSystem *renderSystem = Root::getSingleton().getRenderSystem();
+        TextureGpuManager *textureManager = renderSystem->getTextureGpuManager();
+
+        TextureGpu *oldTexture = mTexture;
+        if( oldTexture )
+            oldTexture->removeListener( const_cast<Font *>( this ) );
+
+        const uint32 width = mDynamicAtlas->width;
+        const uint32 height = mDynamicAtlas->height;
+
+        mTexture = textureManager->createTexture(
+            mName + "/Texture/" + StringConverter::toString( mAtlasVersion ),
+            GpuPageOutStrategy::SaveToSystemRam, TextureFlags::ManualTexture, TextureTypes::Type2D );
+        mTexture->setPixelFormat( PFG_RG8_UNORM );
+        mTexture->setTextureType( TextureTypes::Type2D );
+        mTexture->setNumMipmaps( 1u );
+        mTexture->setResolution( width, height );
+        mTexture->addListener( const_cast<Font *>( this ) );
+
+        // Font::notifyTextureChanged would re-upload everything again
+        Font *thisFont = const_cast<Font *>( this );
+        thisFont->mTextureLoadingInProgress = true;
+        mTexture->_transitionTo( GpuResidency::Resident, mDynamicAtlas->imageData );
+        mTexture->_setNextResidencyStatus( GpuResidency::Resident );
+        thisFont->mTextureLoadingInProgress = false;
+
+        StagingTexture *stagingTexture =
+            textureManager->getStagingTexture( width, height, 1u, 1u, mTexture->getPixelFormat() );
+        stagingTexture->startMapRegion();
+        TextureBox texBox =
+            stagingTexture->mapRegion( width, height, 1u, 1u, mTexture->getPixelFormat() );
+        texBox.copyFrom( mDynamicAtlas->imageData, width, height, mDynamicAtlas->bytesPerRow );
+        stagingTexture->stopMapRegion();
+        stagingTexture->upload( texBox, mTexture, 0, 0, 0, true );
+        textureManager->removeStagingTexture( stagingTexture );
+
+        mDynamicAtlas->clearDirty();
+
+        if( mHlmsDatablock )
+        {
+            // Keep the same samplerblock
+            OverlayUnlitDatablock *guiDatablock = static_cast<OverlayUnlitDatablock *>( mHlmsDatablock );
+#ifdef OGRE_BUILD_COMPONENT_HLMS_UNLIT
+            guiDatablock->setTexture( 0, mTexture );
+#else
+            guiDatablock->setTexture( 0, mTexture, OverlayUnlitDatablock::UvAtlasParams() );
+#endif
+        }
+
+        if( oldTexture )
+            textureManager->destroyTexture( oldTexture );
+    }
+    //---------------------------------------------------------------------
+    void Font::growDynamicAtlas() const
+    {
+        DynamicAtlas *atlas = mDynamicAtlas;
+
+        const uint32 oldHeight = atlas->height;
+        const uint32 newHeight = oldHeight << 1u;
+
+        const size_t oldDataSize = atlas->bytesPerRow * oldHeight;
+        const size_t newDataSize = atlas->bytesPerRow * newHeight;
+        uint8 *imageData =
+            reinterpret_cast<uint8 *>( OGRE_MALLOC_SIMD( newDataSize, MEMCATEGORY_RESOURCE ) );
+        memcpy( imageData, atlas->imageData, oldDataSize );
+        for( size_t i = oldDataSize; i < newDataSize; i += 2u )
+        {
+            imageData[i + 0] = 0xFF;  // luminance
+            imageData[i + 1] = 0x00;  // alpha
+        }
+
+        OGRE_FREE_SIMD( atlas->imageData, MEMCATEGORY_RESOURCE );
+        atlas->imageData = imageData;
+        atlas->height = newHeight;
+
+        // Existing glyphs keep their position in pixels, but not in UVs
+        const Real vScale = Real( oldHeight ) / Real( newHeight );
+        CodePointMap::iterator itor = mCodePointMap.begin();
+        CodePointMap::iterator endt = mCodePointMap.end();
+
+        while( itor != endt )
+        {
+            itor->second.uvRect.top *= vScale;
+            itor->second.uvRect.bottom *= vScale;
+            ++itor;
+        }
+
+        ++mAtlasVersion;
+
+        LogManager::getSingleton().logMessage( "Font " + mName + " growing dynamic atlas to " +
+                                               StringConverter::toString( atlas->width ) + "x" +
+                                               StringConverter::toString( atlas->height ) );
+
+        createDynamicAtlasTexture();
+    }
+    //---------------------------------------------------------------------
+    uint32 Font::acquireDynamicAtlasSlot() const
+    {
+        DynamicAtlas *atlas = mDynamicAtlas;
+
+        if( atlas->slots.size() < atlas->getMaxSlots() )
+        {
+            atlas->slots.push_back( DynamicAtlas::Slot() );
+            return static_cast<uint32>( atlas->slots.size() - 1u );
+        }
+
+        const unsigned long currentFrame = Root::getSingleton().getNextFrameNumber();
+
+        // Find the least recently used glyph
+        uint32 lruSlotIdx = 0u;
+        for( uint32 i = 1u; i < atlas->slots.size(); ++i )
+        {
+            if( atlas->slots[i].lastUsedFrame < atlas->slots[lruSlotIdx].lastUsedFrame )
+                lruSlotIdx = i;
+        }
+
+        if( atlas->slots[lruSlotIdx].lastUsedFrame == currentFrame &&
+            atlas->height < mDynamicAtlasMaxResolution )
+        {
+            // Every glyph is being used this frame. Make room instead
+            growDynamicAtlas();
+            atlas->slots.push_back( DynamicAtlas::Slot() );
+            return static_cast<uint32>( atlas->slots.size() - 1u );
+        }
+
+        if( atlas->slots[lruSlotIdx].lastUsedFrame == currentFrame )
+        {
+            LogManager::getSingleton().logMessage(
+                "Font " + mName +
+                    " dynamic atlas is too small to hold all the glyphs used in a single frame. "
+                    "Text may flicker. Increase its max resolution.",
+                LML_CRITICAL );
+        }
+
+        // Evict it
+        const CodePoint evictedCodePoint = atlas->slots[lruSlotIdx].codePoint;
+        mCodePointMap.erase( evictedCodePoint );
+        atlas->slotIdxForCodePoint.erase( evictedCodePoint );
+        ++mAtlasVersion;
+
+        return lruSlotIdx;
+    }
+    //---------------------------------------------------------------------
+    const Font::GlyphInfo *Font::loadDynamicGlyph( CodePoint id ) const
+    {
+        FT_Face face = mDynamicAtlas->face;
+
+        // Load & render glyph
+        if( FT_Load_Char( face, id, FT_LOAD_RENDER ) || !face->glyph->bitmap.buffer )
+        {
+            // Not in this font. Remember it so we don't try again (same result as non-dynamic fonts)
+            CodePointMap::iterator itor =
+                mCodePointMap.emplace( id, GlyphInfo( id, UVRect( 0, 0, 0, 0 ), 1.0f ) ).first;
+            return &itor->second;
+        }
+
+        const uint32 slotIdx = acquireDynamicAtlasSlot();
+
+        // Fetch after acquireDynamicAtlasSlot, the atlas may have grown
+        DynamicAtlas *atlas = mDynamicAtlas;
+        DynamicAtlas::Slot &slot = atlas->slots[slotIdx];
+        slot.codePoint = id;
+        slot.lastUsedFrame = Root::getSingleton().getNextFrameNumber();
+        atlas->slotIdxForCodePoint[id] = slotIdx;
+
+        const uint32 slotsPerRow = atlas->getNumSlotsPerRow();
+        const uint32 l = ( slotIdx % slotsPerRow ) * atlas->slotWidth;
+        const uint32 m = ( slotIdx / slotsPerRow ) * atlas->slotHeight;
+
+        const size_t bytesPerPixel = 2u;
+
+        // Clear the previous glyph in this slot
+        for( uint32 y = 0; y < atlas->slotHeight; ++y )
+        {
+            uint8 *pDest = &atlas->imageData[( m + y ) * atlas->bytesPerRow + l * bytesPerPixel];
+            for( uint32 x = 0; x < atlas->slotWidth; ++x )
+            {
+                *pDest++ = 0xFF;
+                *pDest++ = 0x00;
+            }
+        }
+
+        const FT_Pos advance = std::min<FT_Pos>( face->glyph->advance.x >> 6, atlas->slotWidth );
+        const FT_Pos y_bearing = std::max<FT_Pos>(
+            ( mTtfMaxBearingY >> 6 ) - ( face->glyph->metrics.horiBearingY >> 6 ), 0 );
+        const FT_Pos x_bearing = std::max<FT_Pos>( face->glyph->metrics.horiBearingX >> 6, 0 );
+
+        // Clip the bitmap to the slot
+        const int numRows = static_cast<int>(
+            std::min<FT_Pos>( face->glyph->bitmap.rows, FT_Pos( atlas->slotHeight ) - y_bearing ) );
+        const int numCols = static_cast<int>(
+            std::min<FT_Pos>( face->glyph->bitmap.width, FT_Pos( atlas->slotWidth ) - x_bearing ) );
+
+        for( int j = 0; j < numRows; ++j )
+        {
+            uint8 const *buffer = face->glyph->bitmap.buffer + j * face->glyph->bitmap.pitch;
+            const size_t row = m + static_cast<size_t>( j ) + static_cast<size_t>( y_bearing );
+            uint8 *pDest = &atlas->imageData[( row * atlas->bytesPerRow ) +
+                                             ( l + static_cast<size_t>( x_bearing ) ) * bytesPerPixel];
+            for( int k = 0; k < numCols; k++ )
+            {
+                // See loadTextureFromFont
+                *pDest++ = mAntialiasColour ? *buffer : 0xFF;
+                *pDest++ = *buffer++;
+            }
+        }
+
+        atlas->addDirty( l, m, l + atlas->slotWidth, m + atlas->slotHeight );
+
+        const Real textureAspect = (Real)atlas->width / (Real)atlas->height;
+        const UVRect uvRect( (Real)l / (Real)atlas->width,                                 // u1
+                             (Real)m / (Real)atlas->height,                                // v1
+                             (Real)( l + static_cast<uint32>( advance ) ) / (Real)atlas->width,  // u2
+                             (Real)( m + atlas->glyphHeight ) / (Real)atlas->height );           // v2
+        const Real aspectRatio =
+            textureAspect * ( uvRect.right - uvRect.left ) / ( uvRect.bottom - uvRect.top );
+
+        CodePointMap::iterator itor =
+            mCodePointMap.emplace( id, GlyphInfo( id, uvRect, aspectRatio ) ).first;
+        return &itor->second;
+    }
+    //---------------------------------------------------------------------
+    void Font::touchDynamicGlyph( const GlyphInfo &glyphInfo ) const
+    {
+        DynamicAtlas::SlotIdxMap::const_iterator itor =
+            mDynamicAtlas->slotIdxForCodePoint.find( glyphInfo.codePoint );
+        if( itor != mDynamicAtlas->slotIdxForCodePoint.end() )
+        {
+            mDynamicAtlas->slots[itor->second].lastUsedFrame =
+                Root::getSingleton().getNextFrameNumber();
+        }
+    }
+    //---------------------------------------------------------------------
+    void Font::_uploadDirtyGlyphs()
+    {
+        if( !mDynamicAtlas || !mDynamicAtlas->isDirty() )
+            return;
+
+        RenderSystem *renderSystem = Root::getSingleton().getRenderSystem();
+        TextureGpuManager *textureManager = renderSystem->getTextureGpuManager();
+
+        DynamicAtlas *atlas = mDynamicAtlas;
+
+        // Upload only the bounding rect of what changed
+        const uint32 width = atlas->dirtyRight - atlas->dirtyLeft;
+        const uint32 height = atlas->dirtyBottom - atlas->dirtyTop;
+        const PixelFormatGpu pixelFormat = mTexture->getPixelFormat();
+
+        StagingTexture *stagingTexture =
+            textureManager->getStagingTexture( width, height, 1u, 1u, pixelFormat );
+        stagingTexture->startMapRegion();
+        TextureBox texBox = stagingTexture->mapRegion( width, height, 1u, 1u, pixelFormat );
+        texBox.copyFrom( atlas->imageData + atlas->dirtyTop * atlas->bytesPerRow +
+                             atlas->dirtyLeft * 2u,
+                         width, height, atlas->bytesPerRow );
+        stagingTexture->stopMapRegion();
+
+        TextureBox dstBox = mTexture->getEmptyBox( 0 );
+        dstBox.x = atlas->dirtyLeft;
+        dstBox.y = atlas->dirtyTop;
+        dstBox.width = width;
+        dstBox.height = height;
+        stagingTexture->upload( texBox, mTexture, 0, 0, &dstBox );
+        textureManager->removeStagingTexture( stagingTexture );
+
+        atlas->clearDirty();
+    }
+    //---------------------------------------------------------------------
     void Font::notifyTextureChanged( TextureGpu *texture, TextureGpuListener::Reason reason,
                                      void *extraData )
     {
@@ -476,7 +909,16 @@ namespace Ogre
         {
             RenderSystem *renderSystem = Root::getSingleton().getRenderSystem();
             TextureGpuManager *textureManager = renderSystem->getTextureGpuManager();
-            loadTextureFromFont( textureManager );
+            if( mDynamicAtlas )
+            {
+                // Everything will be uploaded again from our CPU copy
+                mDynamicAtlas->addDirty( 0u, 0u, mDynamicAtlas->width, mDynamicAtlas->height );
+                _uploadDirtyGlyphs();
+            }
+            else
+            {
+                loadTextureFromFont( textureManager );
+            }
         }
     }
     //-----------------------------------------------------------------------
@@ -552,6 +994,17 @@ namespace Ogre
         f->setTrueTypeResolution( StringConverter::parseUnsignedInt( val ) );
     }
     //-----------------------------------------------------------------------
+    String Font::CmdDynamicAtlas::doGet( const void *target ) const
+    {
+        const Font *f = static_cast<const Font *>( target );
+        return StringConverter::toString( f->getDynamicAtlas() );
+    }
+    void Font::CmdDynamicAtlas::doSet( void *target, const String &val )
+    {
+        Font *f = static_cast<Font *>( target );
+        f->setDynamicAtlas( StringConverter::parseBool( val ) );
+    }
+    //-----------------------------------------------------------------------
     String Font::CmdCodePoints::doGet( const void *target ) const
     {
         const Font *f = static_cast<const Font *>( target );
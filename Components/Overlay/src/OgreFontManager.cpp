@@ -241,6 +241,17 @@ namespace Ogre
             // Set
             pFont->setAntialiasColour( StringConverter::parseBool( params[1] ) );
         }
+        else if( attrib == "dynamic_atlas" )
+        {
+            // Check params
+            if( params.size() != 2 )
+            {
+                logBadAttrib( line, pFont );
+                return;
+            }
+            // Set
+            pFont->setDynamicAtlas( StringConverter::parseBool( params[1] ) );
+        }
         else if( attrib == "code_points" )
         {
             for( size_t c = 1; c < params.size(); ++c )
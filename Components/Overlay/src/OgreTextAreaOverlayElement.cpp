@@ -73,6 +73,7 @@ namespace Ogre
 
             mAllocSize = 0;
 
+            mFontAtlasVersion = 0;
             mCharHeight = Real( 0.02 );
             mPixelCharHeight = 12;
             mSpaceWidthOverridden = false;
@@ -180,6 +181,21 @@ namespace Ogre
                 return;
             }
 
+            if( mFont->getDynamicAtlas() )
+            {
+                // Rasterize all the glyphs we need before retrieving any UV, as rasterizing
+                // may evict other glyphs or grow the atlas, invalidating previous UVs.
+                mFont->getGlyphAspectRatio( UNICODE_ZERO );
+                DisplayString::iterator itor = mCaption.begin();
+                DisplayString::iterator endt = mCaption.end();
+                while( itor != endt )
+                {
+                    mFont->getGlyphAspectRatio( OGRE_DEREF_DISPLAYSTRING_ITERATOR( itor ) );
+                    ++itor;
+                }
+                mFontAtlasVersion = mFont->getAtlasVersion();
+            }
+
             size_t charlen = mCaption.size();
             checkMemoryAllocation( charlen );
 
@@ -616,8 +632,15 @@ namespace Ogre
                 break;
             }
 
+            // Glyphs were evicted from the font's atlas, or it was resized. Our UVs are outdated
+            if( mFont && mFont->getDynamicAtlas() && mFontAtlasVersion != mFont->getAtlasVersion() )
+                mGeomPositionsOutOfDate = true;
+
             OverlayElement::_update();
 
+            if( mFont && mFont->isLoaded() )
+                mFont->_uploadDirtyGlyphs();
+
             if( mColoursChanged && mInitialised )
             {
                 updateColours();
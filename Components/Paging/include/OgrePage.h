@@ -67,6 +67,13 @@ namespace Ogre
         {
             ContentCollectionList collectionsToAdd;
         };
+        /// Prepared data waiting for the finalise budget, see PageManager::setFinaliseTimeBudget
+        PageData* mPendingFinalise;
+        /// Time (in microseconds) at which the last load was requested
+        uint64 mLoadRequestTime;
+
+        /// Apply prepared data and load it in the main thread
+        void finaliseLoad(PageData* pageData);
         /// Structure for holding background page requests
         struct PageRequest
         {
@@ -432,6 +432,60 @@ namespace Ogre
         /** Get whether paging operations are currently allowed to happen. */
         bool getPagingOperationsEnabled() const { return mPagingEnabled; }
 
+        /** Statistics about the background page loader.
+        @remarks
+            Latency is measured from the moment a page load is requested until its
+            content has been loaded in the main thread. It therefore includes the time
+            spent waiting in the WorkQueue, preparing in the background, and any frames
+            the page had to wait because of the finalise budget.
+            All times are in microseconds.
+        */
+        struct LoaderStatistics
+        {
+            /// Number of pages which finished loading
+            size_t numPagesLoaded;
+            /// Number of times a prepared page had to wait for the next frame to be loaded
+            size_t numFinaliseDeferrals;
+            /// Request-to-loaded latency of the last page loaded
+            uint64 lastLatency;
+            /// Average request-to-loaded latency
+            uint64 avgLatency;
+            /// Maximum request-to-loaded latency
+            uint64 maxLatency;
+            /// Average time spent loading a prepared page in the main thread
+            uint64 avgFinaliseTime;
+            /// Maximum time spent loading a prepared page in the main thread
+            uint64 maxFinaliseTime;
+
+            LoaderStatistics();
+        };
+
+        /** Get the statistics of the background page loader. */
+        const LoaderStatistics& getLoaderStatistics() const { return mLoaderStats; }
+        /** Reset the statistics of the background page loader. */
+        void resetLoaderStatistics();
+
+        /** Set the maximum time per frame spent loading prepared pages in the main thread.
+        @remarks
+            Pages are prepared in the background, but their final loading step (e.g.
+            creating GPU resources) happens in the main thread. When many pages finish
+            preparing at once this can cause a noticeable hitch. Once this budget is
+            used up in a frame, the remaining pages are loaded in the following frames.
+            At least one page is always loaded per frame.
+        @param microseconds The budget, 0 (the default) for no limit.
+        */
+        void setFinaliseTimeBudget(uint64 microseconds) { mFinaliseTimeBudget = microseconds; }
+        /** Get the maximum time per frame spent loading prepared pages in the main thread. */
+        uint64 getFinaliseTimeBudget() const { return mFinaliseTimeBudget; }
+
+        /// Returns whether there's time left this frame to load a prepared page
+        bool _hasFinaliseBudget() const
+        { return mFinaliseTimeBudget == 0 || mFinaliseTimeThisFrame < mFinaliseTimeBudget; }
+        /// Called by Page when it finished loading
+        void _notifyPageLoaded(uint64 latency, uint64 finaliseTime);
+        /// Called by Page when it had to postpone loading due to the finalise budget
+        void _notifyFinaliseDeferred() { ++mLoaderStats.numFinaliseDeferrals; }
+
 
     protected:
 
@@ -467,6 +521,12 @@ namespace Ogre
         uint8 mDebugDisplayLvl;
         bool mPagingEnabled;
 
+        LoaderStatistics mLoaderStats;
+        uint64 mTotalLatency;
+        uint64 mTotalFinaliseTime;
+        uint64 mFinaliseTimeBudget;
+        uint64 mFinaliseTimeThisFrame;
+
         Grid2DPageStrategy* mGrid2DPageStrategy;
         Grid3DPageStrategy* mGrid3DPageStrategy;
         SimplePageContentCollectionFactory* mSimpleCollectionFactory;
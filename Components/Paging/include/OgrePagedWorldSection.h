@@ -31,7 +31,9 @@ THE SOFTWARE.
 
 #include "OgrePagingPrerequisites.h"
 #include "OgreAxisAlignedBox.h"
+#include "OgreVector3.h"
 #include "ogrestd/map.h"
+#include "ogrestd/vector.h"
 namespace Ogre
 {
     /** \addtogroup Optional Components
@@ -80,6 +82,42 @@ namespace Ogre
         PageProvider* mPageProvider;
         SceneManager* mSceneMgr;
 
+        /// Motion of a camera as observed by this section, used for predictive prefetching
+        struct CameraMotion
+        {
+            Vector3 lastPosition;
+            Vector3 velocity;
+            unsigned long lastFrame;
+        };
+        typedef map<Camera*, CameraMotion>::type CameraMotionMap;
+
+        /// A page load waiting to be issued to the WorkQueue
+        struct QueuedPageLoad
+        {
+            PageID pageID;
+            Real timeToVisible;
+            Real distance;
+
+            bool operator < (const QueuedPageLoad& other) const
+            {
+                if (timeToVisible != other.timeToVisible)
+                    return timeToVisible < other.timeToVisible;
+                return distance < other.distance;
+            }
+        };
+        typedef vector<QueuedPageLoad>::type QueuedPageLoadList;
+
+        CameraMotionMap mCameraMotion;
+        QueuedPageLoadList mQueuedPageLoads;
+        Real mTimeSinceLastFrame;
+        Real mPrefetchTime;
+        Radian mPrefetchConeAngle;
+
+        /// Update the tracked velocity of the given camera
+        void updateCameraMotion(Camera* cam);
+        /// Issue all queued page loads, most urgent first
+        void flushQueuedPageLoads();
+
         /// Load data specific to a subtype of this class (if any)
         virtual void loadSubtypeData(StreamSerialiser& ser) {}
         virtual void saveSubtypeData(StreamSerialiser& ser) {}
@@ -226,6 +264,65 @@ namespace Ogre
         */
         virtual bool _unprepareProceduralPage(Page* page);
 
+        /** Queue a page to be loaded at the end of notifyCamera.
+        @remarks
+            Called by PageStrategy implementations instead of loadPage. Once the
+            strategy is done, all queued pages are requested in ascending order of
+            predicted time-to-visible (ties broken by distance), so that the
+            WorkQueue processes the most urgent pages first.
+        @param pageID The page ID to load
+        @param timeToVisible Seconds until the page is expected to be needed (0 if
+            it's needed now). See _predictTimeToLoadRange.
+        @param distance Distance from the camera, used to order pages needed at the same time
+        */
+        virtual void _queuePageLoad(PageID pageID, Real timeToVisible, Real distance);
+
+        /** Set for how long (in seconds) pages are prefetched ahead of a moving camera.
+        @remarks
+            Pages outside of the load radius which the camera is expected to reach
+            within this time, travelling at its current velocity, and which lie
+            inside the prefetch cone (see setPrefetchConeAngle) are requested early.
+            This prevents fast moving cameras from outrunning the loader.
+            0 (the default) disables prefetching.
+        */
+        virtual void setPrefetchTime(Real seconds) { mPrefetchTime = seconds; }
+        /// Get for how long (in seconds) pages are prefetched ahead of a moving camera
+        virtual Real getPrefetchTime() const { return mPrefetchTime; }
+        /** Set the half-angle of the prefetch cone around the camera's direction of travel.
+        @remarks
+            Default is 45 degrees.
+        */
+        virtual void setPrefetchConeAngle(const Radian& halfAngle) { mPrefetchConeAngle = halfAngle; }
+        /// Get the half-angle of the prefetch cone around the camera's direction of travel
+        virtual const Radian& getPrefetchConeAngle() const { return mPrefetchConeAngle; }
+
+        /** Get the (smoothed) velocity of the camera, in world units per second.
+        @remarks
+            Returns zero if the camera hasn't been notified to this section yet.
+        */
+        virtual Vector3 getCameraVelocity(Camera* cam) const;
+
+        /** Predict how long until a point comes within loadRadius of the camera.
+        @param relPos Position of the point relative to the camera
+        @param velocity Velocity of the camera, in the same space as relPos
+        @param loadRadius Radius at which the point is needed
+        @return 0 if the point is already in range, the predicted time in seconds
+            if the camera is approaching it, or std::numeric_limits<Real>::max()
+            if the camera is not moving towards it.
+        */
+        Real _predictTimeToLoadRange(const Vector3& relPos, const Vector3& velocity,
+            Real loadRadius) const;
+        /** Returns whether a point outside of loadRadius should be prefetched.
+        @remarks
+            The point must lie within the prefetch cone and be reachable within the
+            prefetch time (see setPrefetchTime).
+        @param relPos Position of the point relative to the camera
+        @param velocity Velocity of the camera, in the same space as relPos
+        @param loadRadius Radius at which the point is needed
+        */
+        bool _isInPrefetchRegion(const Vector3& relPos, const Vector3& velocity,
+            Real loadRadius) const;
+
         /** Ask for a page to be kept in memory if it's loaded.
         @remarks
             This method indicates that a page should be retained if it's already
@@ -309,6 +309,23 @@ namespace Ogre
         Real fymin = (Real)y - holdRadius;
         Real fymax = (Real)y + holdRadius;
 
+        // camera velocity in grid space (the world<->grid mapping has no translation)
+        Vector2 gridVelocity;
+        stratData->convertWorldToGridSpace(section->getCameraVelocity(cam), gridVelocity);
+        Vector3 velocity(gridVelocity.x, gridVelocity.y, 0);
+
+        // extend the scan towards where the camera will be at the end of the prefetch time
+        Real prefetchTime = section->getPrefetchTime();
+        if (prefetchTime > 0)
+        {
+            int32 px, py;
+            stratData->determineGridLocation(gridpos + gridVelocity * prefetchTime, &px, &py);
+            fxmin = std::min(fxmin, (Real)px - loadRadius);
+            fxmax = std::max(fxmax, (Real)px + loadRadius);
+            fymin = std::min(fymin, (Real)py - loadRadius);
+            fymax = std::max(fymax, (Real)py + loadRadius);
+        }
+
         int32 xmin = stratData->getCellRangeMinX();
         int32 xmax = stratData->getCellRangeMaxX();
         int32 ymin = stratData->getCellRangeMinY();
@@ -319,6 +336,15 @@ namespace Ogre
         xmax = fxmax > xmax ? xmax : (int32)ceil(fxmax);
         ymin = fymin < ymin ? ymin : (int32)floor(fymin);
         ymax = fymax > ymax ? ymax : (int32)ceil(fymax);
+        // the hold range
+        fxmin = (Real)x - holdRadius;
+        fxmax = (Real)x + holdRadius;
+        fymin = (Real)y - holdRadius;
+        fymax = (Real)y + holdRadius;
+        int32 holdxmin = (int32)floor(fxmin);
+        int32 holdxmax = (int32)ceil(fxmax);
+        int32 holdymin = (int32)floor(fymin);
+        int32 holdymax = (int32)ceil(fymax);
         // the inner, active load range
         fxmin = (Real)x - loadRadius;
         fxmax = (Real)x + loadRadius;
@@ -330,26 +356,38 @@ namespace Ogre
         int32 loadymin = fymin < ymin ? ymin : (int32)floor(fymin);
         int32 loadymax = fymax > ymax ? ymax : (int32)ceil(fymax);
 
+        Real loadRadiusWorld = stratData->getLoadRadius();
+
         for (int32 cy = ymin; cy <= ymax; ++cy)
         {
             for (int32 cx = xmin; cx <= xmax; ++cx)
             {
                 PageID pageID = stratData->calculatePageID(cx, cy);
+
+                Vector2 midPoint;
+                stratData->getMidPointGridSpace(cx, cy, midPoint);
+                Vector3 relPos(midPoint.x - gridpos.x, midPoint.y - gridpos.y, 0);
+
                 if (cx >= loadxmin && cx <= loadxmax && cy >= loadymin && cy <= loadymax)
                 {
                     // in the 'load' range, request it
-                    section->loadPage(pageID);
+                    section->_queuePageLoad(pageID, 0, relPos.length());
                 }
-                else
+                else if (section->_isInPrefetchRegion(relPos, velocity, loadRadiusWorld))
+                {
+                    // ahead of a moving camera, request it early
+                    section->_queuePageLoad(pageID,
+                        section->_predictTimeToLoadRange(relPos, velocity, loadRadiusWorld),
+                        relPos.length());
+                }
+                else if (cx >= holdxmin && cx <= holdxmax && cy >= holdymin && cy <= holdymax)
                 {
                     // in the outer 'hold' range, keep it but don't actively load
                     section->holdPage(pageID);
                 }
                 // other pages will by inference be marked for unloading
             }
-        }   
-        
-
+        }
 
     }
     //---------------------------------------------------------------------
@@ -252,13 +252,37 @@ namespace Ogre
 
         Real loadRadius = stratData->getLoadRadius();
         Real holdRadius = stratData->getHoldRadius();
+        Vector3 cellSize = stratData->getCellSize();
         // scan the whole Hold range
-        Real fxmin = (Real)x - holdRadius/stratData->getCellSize().x;
-        Real fxmax = (Real)x + holdRadius/stratData->getCellSize().x;
-        Real fymin = (Real)y - holdRadius/stratData->getCellSize().y;
-        Real fymax = (Real)y + holdRadius/stratData->getCellSize().y;
-        Real fzmin = (Real)z - holdRadius/stratData->getCellSize().z;
-        Real fzmax = (Real)z + holdRadius/stratData->getCellSize().z;
+        Real fxmin = (Real)x - holdRadius/cellSize.x;
+        Real fxmax = (Real)x + holdRadius/cellSize.x;
+        Real fymin = (Real)y - holdRadius/cellSize.y;
+        Real fymax = (Real)y + holdRadius/cellSize.y;
+        Real fzmin = (Real)z - holdRadius/cellSize.z;
+        Real fzmax = (Real)z + holdRadius/cellSize.z;
+        // the hold range
+        int32 holdxmin = (int32)floor(fxmin);
+        int32 holdxmax = (int32)ceil(fxmax);
+        int32 holdymin = (int32)floor(fymin);
+        int32 holdymax = (int32)ceil(fymax);
+        int32 holdzmin = (int32)floor(fzmin);
+        int32 holdzmax = (int32)ceil(fzmax);
+
+        Vector3 velocity = section->getCameraVelocity(cam);
+
+        // extend the scan towards where the camera will be at the end of the prefetch time
+        Real prefetchTime = section->getPrefetchTime();
+        if (prefetchTime > 0)
+        {
+            int32 px, py, pz;
+            stratData->determineGridLocation(pos + velocity * prefetchTime, &px, &py, &pz);
+            fxmin = std::min(fxmin, (Real)px - loadRadius/cellSize.x);
+            fxmax = std::max(fxmax, (Real)px + loadRadius/cellSize.x);
+            fymin = std::min(fymin, (Real)py - loadRadius/cellSize.y);
+            fymax = std::max(fymax, (Real)py + loadRadius/cellSize.y);
+            fzmin = std::min(fzmin, (Real)pz - loadRadius/cellSize.z);
+            fzmax = std::max(fzmax, (Real)pz + loadRadius/cellSize.z);
+        }
 
         int32 xmin = stratData->getCellRangeMinX();
         int32 xmax = stratData->getCellRangeMaxX();
@@ -275,12 +299,12 @@ namespace Ogre
         zmin = fzmin < zmin ? zmin : (int32)floor(fzmin);
         zmax = fzmax > zmax ? zmax : (int32)ceil(fzmax);
         // the inner, active load range
-        fxmin = (Real)x - loadRadius/stratData->getCellSize().x;
-        fxmax = (Real)x + loadRadius/stratData->getCellSize().x;
-        fymin = (Real)y - loadRadius/stratData->getCellSize().y;
-        fymax = (Real)y + loadRadius/stratData->getCellSize().y;
-        fzmin = (Real)z - loadRadius/stratData->getCellSize().z;
-        fzmax = (Real)z + loadRadius/stratData->getCellSize().z;
+        fxmin = (Real)x - loadRadius/cellSize.x;
+        fxmax = (Real)x + loadRadius/cellSize.x;
+        fymin = (Real)y - loadRadius/cellSize.y;
+        fymax = (Real)y + loadRadius/cellSize.y;
+        fzmin = (Real)z - loadRadius/cellSize.z;
+        fzmax = (Real)z + loadRadius/cellSize.z;
         // Round UP max, round DOWN min
         int32 loadxmin = fxmin < xmin ? xmin : (int32)floor(fxmin);
         int32 loadxmax = fxmax > xmax ? xmax : (int32)ceil(fxmax);
@@ -297,20 +321,38 @@ namespace Ogre
                 {
                     PageID pageID = stratData->calculatePageID(cx, cy, cz);
 
-                    if (cx >= loadxmin && cx <= loadxmax 
-                     && cy >= loadymin && cy <= loadymax
-                     && cz >= loadzmin && cz <= loadzmax )
+                    Vector3 midPoint;
+                    stratData->getMidPointGridSpace(cx, cy, cz, midPoint);
+                    Vector3 relPos = midPoint - pos;
+
+                    bool inLoadRange = cx >= loadxmin && cx <= loadxmax 
+                                    && cy >= loadymin && cy <= loadymax
+                                    && cz >= loadzmin && cz <= loadzmax;
+                    bool visible = false;
+                    if (inLoadRange)
                     {
                         Vector3 bl;
                         stratData->getBottomLeftGridSpace(cx, cy, cz, bl);
-                        Ogre::AxisAlignedBox bbox(bl, bl+stratData->getCellSize());
+                        Ogre::AxisAlignedBox bbox(bl, bl+cellSize);
+                        visible = cam->isVisible(bbox);
+                    }
 
-                        if( cam->isVisible(bbox) )
-                            section->loadPage(pageID);
-                        else
-                            section->holdPage(pageID);
+                    if (visible)
+                    {
+                        // in the 'load' range, request it
+                        section->_queuePageLoad(pageID, 0, relPos.length());
+                    }
+                    else if (section->_isInPrefetchRegion(relPos, velocity, loadRadius))
+                    {
+                        // ahead of a moving camera, request it early
+                        section->_queuePageLoad(pageID,
+                            section->_predictTimeToLoadRange(relPos, velocity, loadRadius),
+                            relPos.length());
                     }
-                    else
+                    else if (inLoadRange
+                          || (cx >= holdxmin && cx <= holdxmax
+                           && cy >= holdymin && cy <= holdymax
+                           && cz >= holdzmin && cz <= holdzmax))
                     {
                         // in the outer 'hold' range, keep it but don't actively load
                         section->holdPage(pageID);
@@ -37,6 +37,7 @@ THE SOFTWARE.
 #include "OgrePageContentCollectionFactory.h"
 #include "OgrePageContentCollection.h"
 #include "OgreLogManager.h"
+#include "OgreTimer.h"
 #include <iomanip>
 
 #if OGRE_PLATFORM == OGRE_PLATFORM_APPLE_IOS
@@ -59,6 +60,8 @@ namespace Ogre
         , mDeferredProcessInProgress(false)
         , mModified(false)
         , mDebugNode(0)
+        , mPendingFinalise(0)
+        , mLoadRequestTime(0)
     {
         WorkQueue* wq = Root::getSingleton().getWorkQueue();
         mWorkQueueChannel = wq->getChannel("Ogre/Page");
@@ -73,6 +76,13 @@ namespace Ogre
         wq->removeRequestHandler(mWorkQueueChannel, this);
         wq->removeResponseHandler(mWorkQueueChannel, this);
 
+        if (mPendingFinalise)
+        {
+            std::swap(mContentCollections, mPendingFinalise->collectionsToAdd);
+            OGRE_DELETE mPendingFinalise;
+            mPendingFinalise = 0;
+        }
+
         destroyAllContentCollections();
         if (mDebugNode)
         {
@@ -188,6 +198,7 @@ namespace Ogre
             destroyAllContentCollections();
             PageRequest req(this);
             mDeferredProcessInProgress = true;
+            mLoadRequestTime = Root::getSingleton().getTimer()->getMicroseconds();
             Root::getSingleton().getWorkQueue()->addRequest(mWorkQueueChannel, WORKQUEUE_PREPARE_REQUEST, 
                 Any(req), 0, synchronous);
         }
@@ -263,10 +274,15 @@ namespace Ogre
         // final loading behaviour
         if (res->succeeded())
         {
-            if(!pres.pageData->collectionsToAdd.empty())
-                std::swap(mContentCollections, pres.pageData->collectionsToAdd);
-
-            loadImpl();
+            if (getManager()->_hasFinaliseBudget())
+                finaliseLoad(pres.pageData);
+            else
+            {
+                // out of time for this frame, finalise in a later frameStart
+                mPendingFinalise = pres.pageData;
+                getManager()->_notifyFinaliseDeferred();
+                return;
+            }
         }
 
         OGRE_DELETE pres.pageData;
@@ -275,6 +291,20 @@ namespace Ogre
 
     }
     //---------------------------------------------------------------------
+    void Page::finaliseLoad(PageData* pageData)
+    {
+        Timer* timer = Root::getSingleton().getTimer();
+        uint64 startTime = timer->getMicroseconds();
+
+        if(!pageData->collectionsToAdd.empty())
+            std::swap(mContentCollections, pageData->collectionsToAdd);
+
+        loadImpl();
+
+        uint64 endTime = timer->getMicroseconds();
+        getManager()->_notifyPageLoaded(endTime - mLoadRequestTime, endTime - startTime);
+    }
+    //---------------------------------------------------------------------
     bool Page::prepareImpl(PageData* dataToPopulate)
     {
         // Procedural preparation
@@ -345,6 +375,14 @@ namespace Ogre
     //---------------------------------------------------------------------
     void Page::frameStart(Real timeSinceLastFrame)
     {
+        if (mPendingFinalise && getManager()->_hasFinaliseBudget())
+        {
+            finaliseLoad(mPendingFinalise);
+            OGRE_DELETE mPendingFinalise;
+            mPendingFinalise = 0;
+            mDeferredProcessInProgress = false;
+        }
+
         updateDebugDisplay();
 
         // content collections
@@ -48,6 +48,10 @@ namespace Ogre
         , mPageResourceGroup(ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME)
         , mDebugDisplayLvl(0)
         , mPagingEnabled(true)
+        , mTotalLatency(0)
+        , mTotalFinaliseTime(0)
+        , mFinaliseTimeBudget(0)
+        , mFinaliseTimeThisFrame(0)
         , mGrid2DPageStrategy(0)
         , mGrid3DPageStrategy(0)
         , mSimpleCollectionFactory(0)
@@ -510,8 +514,43 @@ namespace Ogre
         pManager->removeCamera(cam);
     }
     //---------------------------------------------------------------------
+    PageManager::LoaderStatistics::LoaderStatistics()
+        : numPagesLoaded(0)
+        , numFinaliseDeferrals(0)
+        , lastLatency(0)
+        , avgLatency(0)
+        , maxLatency(0)
+        , avgFinaliseTime(0)
+        , maxFinaliseTime(0)
+    {
+    }
+    //---------------------------------------------------------------------
+    void PageManager::resetLoaderStatistics()
+    {
+        mLoaderStats = LoaderStatistics();
+        mTotalLatency = 0;
+        mTotalFinaliseTime = 0;
+    }
+    //---------------------------------------------------------------------
+    void PageManager::_notifyPageLoaded(uint64 latency, uint64 finaliseTime)
+    {
+        mFinaliseTimeThisFrame += finaliseTime;
+
+        mTotalLatency += latency;
+        mTotalFinaliseTime += finaliseTime;
+
+        ++mLoaderStats.numPagesLoaded;
+        mLoaderStats.lastLatency = latency;
+        mLoaderStats.avgLatency = mTotalLatency / mLoaderStats.numPagesLoaded;
+        mLoaderStats.maxLatency = std::max(mLoaderStats.maxLatency, latency);
+        mLoaderStats.avgFinaliseTime = mTotalFinaliseTime / mLoaderStats.numPagesLoaded;
+        mLoaderStats.maxFinaliseTime = std::max(mLoaderStats.maxFinaliseTime, finaliseTime);
+    }
+    //---------------------------------------------------------------------
     bool PageManager::EventRouter::frameStarted(const FrameEvent& evt)
     {
+        pManager->mFinaliseTimeThisFrame = 0;
+
         if(pWorldMap->empty())
             return true;
 
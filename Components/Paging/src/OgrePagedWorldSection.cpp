@@ -34,6 +34,9 @@ THE SOFTWARE.
 #include "OgreLogManager.h"
 #include "OgreRoot.h"
 #include "OgrePlatformInformation.h"
+#include "OgreCamera.h"
+
+#include <algorithm>
 
 namespace Ogre
 {
@@ -43,6 +46,7 @@ namespace Ogre
     //---------------------------------------------------------------------
     PagedWorldSection::PagedWorldSection(const String& name, PagedWorld* parent, SceneManager* sm)
         : mName(name), mParent(parent), mStrategy(0), mStrategyData(0), mPageProvider(0), mSceneMgr(sm)
+        , mTimeSinceLastFrame(0), mPrefetchTime(0), mPrefetchConeAngle(Degree(45))
     {
     }
     //---------------------------------------------------------------------
@@ -295,6 +299,97 @@ namespace Ogre
 
     }
     //---------------------------------------------------------------------
+    void PagedWorldSection::_queuePageLoad(PageID pageID, Real timeToVisible, Real distance)
+    {
+        QueuedPageLoad queued;
+        queued.pageID = pageID;
+        queued.timeToVisible = timeToVisible;
+        queued.distance = distance;
+        mQueuedPageLoads.push_back(queued);
+    }
+    //---------------------------------------------------------------------
+    void PagedWorldSection::flushQueuedPageLoads()
+    {
+        // The WorkQueue processes requests in order of submission, so issue
+        // the pages which will be needed soonest first
+        std::sort(mQueuedPageLoads.begin(), mQueuedPageLoads.end());
+
+        for (QueuedPageLoadList::iterator i = mQueuedPageLoads.begin(); i != mQueuedPageLoads.end(); ++i)
+            loadPage(i->pageID);
+
+        mQueuedPageLoads.clear();
+    }
+    //---------------------------------------------------------------------
+    void PagedWorldSection::updateCameraMotion(Camera* cam)
+    {
+        const Vector3& pos = cam->getDerivedPosition();
+        unsigned long frame = Root::getSingleton().getNextFrameNumber();
+
+        CameraMotionMap::iterator i = mCameraMotion.find(cam);
+        if (i == mCameraMotion.end())
+        {
+            CameraMotion motion;
+            motion.lastPosition = pos;
+            motion.velocity = Vector3::ZERO;
+            motion.lastFrame = frame;
+            mCameraMotion.insert(CameraMotionMap::value_type(cam, motion));
+        }
+        else if (i->second.lastFrame != frame)
+        {
+            CameraMotion& motion = i->second;
+            if (mTimeSinceLastFrame > 0)
+            {
+                // average with the previous estimate to smooth out uneven frame times
+                Vector3 frameVelocity = (pos - motion.lastPosition) / mTimeSinceLastFrame;
+                motion.velocity = (motion.velocity + frameVelocity) * 0.5f;
+            }
+            motion.lastPosition = pos;
+            motion.lastFrame = frame;
+        }
+    }
+    //---------------------------------------------------------------------
+    Vector3 PagedWorldSection::getCameraVelocity(Camera* cam) const
+    {
+        CameraMotionMap::const_iterator i = mCameraMotion.find(cam);
+        if (i != mCameraMotion.end())
+            return i->second.velocity;
+        else
+            return Vector3::ZERO;
+    }
+    //---------------------------------------------------------------------
+    Real PagedWorldSection::_predictTimeToLoadRange(const Vector3& relPos, const Vector3& velocity,
+        Real loadRadius) const
+    {
+        Real dist = relPos.length();
+        if (dist <= loadRadius)
+            return 0;
+
+        // speed at which the camera closes in on the point
+        Real closingSpeed = velocity.dotProduct(relPos) / dist;
+        if (closingSpeed <= std::numeric_limits<Real>::epsilon())
+            return std::numeric_limits<Real>::max();
+
+        return (dist - loadRadius) / closingSpeed;
+    }
+    //---------------------------------------------------------------------
+    bool PagedWorldSection::_isInPrefetchRegion(const Vector3& relPos, const Vector3& velocity,
+        Real loadRadius) const
+    {
+        if (mPrefetchTime <= 0)
+            return false;
+
+        Real speed = velocity.length();
+        if (speed <= std::numeric_limits<Real>::epsilon())
+            return false;
+
+        Real dist = relPos.length();
+        if (dist <= loadRadius || dist > loadRadius + speed * mPrefetchTime)
+            return false;
+
+        Real cosAngle = velocity.dotProduct(relPos) / (speed * dist);
+        return cosAngle >= Math::Cos(mPrefetchConeAngle);
+    }
+    //---------------------------------------------------------------------
     void PagedWorldSection::holdPage(PageID pageID)
     {
         PageMap::iterator i = mPages.find(pageID);
@@ -326,6 +421,8 @@ namespace Ogre
     //---------------------------------------------------------------------
     void PagedWorldSection::frameStart(Real timeSinceLastFrame)
     {
+        mTimeSinceLastFrame = timeSinceLastFrame;
+
         mStrategy->frameStart(timeSinceLastFrame, this);
 
         for (PageMap::iterator i = mPages.begin(); i != mPages.end(); ++i)
@@ -348,11 +445,24 @@ namespace Ogre
                 p->frameEnd(timeElapsed);
         }
 
+        // forget cameras which are no longer being notified
+        unsigned long nextFrame = Root::getSingleton().getNextFrameNumber();
+        for (CameraMotionMap::iterator i = mCameraMotion.begin(); i != mCameraMotion.end(); )
+        {
+            if (nextFrame - i->second.lastFrame > 5)
+                mCameraMotion.erase(i++);
+            else
+                ++i;
+        }
+
     }
     //---------------------------------------------------------------------
     void PagedWorldSection::notifyCamera(Camera* cam)
     {
+        updateCameraMotion(cam);
+
         mStrategy->notifyCamera(cam, this);
+        flushQueuedPageLoads();
 
         for (PageMap::iterator i = mPages.begin(); i != mPages.end(); ++i)
             i->second->notifyCamera(cam);
@@ -107,11 +107,25 @@ namespace Ogre
         typedef list<BySkeletonDef>::type BySkeletonDefList;
         BySkeletonDefList                 bySkeletonDefs;
 
+        /// See BoneMemoryManager::setIncrementalDefragment. Applied to new definitions too.
+        bool incrementalDefragment;
+
+        SkeletonAnimManager();
+
         /// Creates an instance of a skeleton based on the given definition.
         SkeletonInstance *createSkeletonInstance( const SkeletonDef *skeletonDef,
                                                   size_t             numWorkerThreads );
         void              destroySkeletonInstance( SkeletonInstance *skeletonInstance );
         void              removeSkeletonDef( const SkeletonDef *skeletonDef );
+
+        void setIncrementalDefragment( bool bIncremental );
+
+        /** Finishes pending cleanups of BoneMemoryManagers, one skeleton definition at
+            a time, until the budget is exhausted. See BoneMemoryManager::defragmentIncremental
+        @return
+            True if there is still pending work.
+        */
+        bool defragmentIncremental( ArrayMemoryManager::DefragmentBudget &budget );
     };
 
     /** @} */
@@ -269,7 +269,12 @@ namespace Ogre
         void setEnabled( bool bEnable );
         bool getEnabled() const { return mEnabled; }
 
-        void _applyAnimation( const TransformArray &boneTransforms );
+        /** Applies the animation to the given bone transforms.
+        @param maxDepthLevel
+            Tracks animating bones deeper than this level in the hierarchy are skipped.
+        */
+        void _applyAnimation( const TransformArray &boneTransforms,
+                              size_t maxDepthLevel = std::numeric_limits<size_t>::max() );
 
         void _swapBoneWeightsUniquePtr(
             RawSimdUniquePtr<ArrayReal, MEMCATEGORY_ANIMATION> &inOutBoneWeights );
@@ -61,6 +61,9 @@ namespace Ogre
         SkeletonDef const *mSkeletonDef;
 
         KfTransformArrayMemoryManager *mKfTransformMemoryManager;
+        /// Holds the QuantizedKfRange of all tracks, followed by their quantized keyframes.
+        /// See quantizeKeyFrames.
+        uint8 *mQuantizedKeyFrameData;
 
         typedef vector<Real>::type              TimestampVec;
         typedef map<size_t, TimestampVec>::type TimestampsPerBlock;
@@ -100,6 +103,54 @@ namespace Ogre
 
         void build( const v1::Skeleton *skeleton, const v1::Animation *animation, Real frameRate );
 
+        /** Reduces the memory used by the keyframes of this animation:
+                1. Keyframes that can be reconstructed by interpolating their neighbours
+                   within the given tolerances are removed.
+                2. Tracks whose keyframes are all equal are collapsed into a single keyframe.
+                3. Constant tracks that are the identity transform are removed entirely.
+            The remaining keyframes are then repacked into a new, tightly sized
+            KfTransformArrayMemoryManager preserving the cache friendly layout.
+        @remarks
+            Must be called after build() and before any SkeletonInstance using this
+            animation is created, since SkeletonAnimation caches keyframe iterators
+            and bone weights per track.
+        @param positionTolerance
+            Maximum allowed error in the position, in local units.
+        @param orientationTolerance
+            Maximum allowed error in the orientation.
+        @param scaleTolerance
+            Maximum allowed error in the scale.
+        */
+        void optimizeKeyFrames( Real positionTolerance = 1e-4f,
+                                Radian orientationTolerance = Radian( 1e-3f ),
+                                Real scaleTolerance = 1e-4f );
+
+        /** Converts all tracks to a quantized format, releasing the full precision keyframes:
+                - Positions and scales are stored as 16-bit integers within the range of
+                  each bone.
+                - Orientations use the 'smallest three' encoding in 48 bits.
+                - Tracks with constant scale don't store it per keyframe.
+            Keyframes are decoded using SIMD in SkeletonTrack::applyKeyFrameRigAt.
+            Combined with optimizeKeyFrames (which must be called first, if at all) memory
+            usage is often reduced 4x-8x.
+        @remarks
+            Must be called after build() and before any SkeletonInstance using this
+            animation is created. This operation cannot be undone.
+        @par
+            Keyframes are normalized, thus there may be a subtle change in rotation speed
+            between keyframes added by build() to keep bones of the same SIMD block in sync.
+        */
+        void quantizeKeyFrames();
+
+        bool isQuantized() const { return mQuantizedKeyFrameData != 0; }
+
+        /// Returns the number of bytes used by the keyframes of all tracks.
+        size_t getKeyFrameMemoryUsage() const;
+
+        /// Returns the total number of keyframes across all tracks. Each keyframe
+        /// holds ARRAY_PACKED_REALS KfTransforms.
+        size_t getNumKeyFrames() const;
+
         /// Dumps all the tracks in CSV format to the output string argument.
         /// Mostly for debugging purposes. (also easy example to show how to
         /// enumerate all the tracks and get the bones back from its block index)
@@ -156,6 +156,18 @@ namespace Ogre
         }
         void getBonesPerDepth( vector<size_t>::type &out ) const;
 
+        /** Calls SkeletonAnimationDef::optimizeKeyFrames on all animations.
+            Must be called before any SkeletonInstance is created from this definition.
+        */
+        void optimizeAnimationKeyFrames( Real positionTolerance = 1e-4f,
+                                         Radian orientationTolerance = Radian( 1e-3f ),
+                                         Real scaleTolerance = 1e-4f );
+
+        /** Calls SkeletonAnimationDef::quantizeKeyFrames on all animations.
+            Must be called before any SkeletonInstance is created from this definition.
+        */
+        void quantizeAnimationKeyFrames();
+
         /** Returns the total number of bone blocks to reach the given level. i.e On SSE2,
             If the skeleton has 1 root node, 3 children, and 5 children of children;
             then the total number of blocks is 1 + 1 + 2 = 4
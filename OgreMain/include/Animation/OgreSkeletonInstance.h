@@ -51,6 +51,31 @@ namespace Ogre
      *  @{
      */
 
+    /** Describes how a SkeletonInstance is animated at a given level of detail.
+        See SkeletonInstance::setAnimationLods
+    */
+    struct SkeletonAnimationLod
+    {
+        /// LOD value (as given by the default LodStrategy, e.g. distance or pixel count)
+        /// from which this level is used. Same semantics as the user values of mesh LODs.
+        Real lodValue;
+        /// Animations are evaluated once every updateInterval frames. 1 = every frame.
+        uint32 updateInterval;
+        /// Bones deeper than this depth level in the hierarchy are not animated and
+        /// are kept in the binding pose.
+        uint8 maxDepthLevel;
+
+        SkeletonAnimationLod( Real _lodValue, uint32 _updateInterval,
+                              uint8 _maxDepthLevel = std::numeric_limits<uint8>::max() ) :
+            lodValue( _lodValue ),
+            updateInterval( _updateInterval ),
+            maxDepthLevel( _maxDepthLevel )
+        {
+        }
+    };
+
+    typedef FastArray<SkeletonAnimationLod> SkeletonAnimationLodVec;
+
     /** Instance of a Skeleton, main external interface for retrieving bone positions and applying
         animations.
     @remarks
@@ -114,14 +139,53 @@ namespace Ogre
 
         SceneNodeBonePairVec mCustomParentSceneNodes;
 
+        struct LodSource
+        {
+            MovableObject *object;
+            /// Smallest (i.e. most detailed) LOD value seen since the last update.
+            Real lodValue;
+            bool visibleSinceLastUpdate;
+        };
+        typedef FastArray<LodSource> LodSourceVec;
+
+        /// See setAnimationLods. Its lodValue are already transformed by the LodStrategy.
+        SkeletonAnimationLodVec mAnimationLods;
+        /// The objects (i.e. all the Items sharing us) whose LOD value
+        /// and visibility drive our animation LOD. The best one wins.
+        /// Each entry is only written by the thread processing its object.
+        LodSourceVec mLodSources;
+        uint32       mFramesUntilUpdate;
+        bool         mFreezeWhenNotVisible;
+
+        /// Local pose of all bones, interpolated when animations are throttled by LOD.
+        /// Holds getNumberOfBoneBlocks() KfTransforms with the pose displayed before the
+        /// last evaluation, followed by as many with the pose of the last evaluation.
+        /// Null if no animation LOD has an updateInterval > 1.
+        RawSimdUniquePtr<KfTransform, MEMCATEGORY_ANIMATION> mLodPoses;
+        /// Number of frames we blend from the 1st pose of mLodPoses to the 2nd.
+        uint32 mLodBlendFrames;
+        /// Frames since the last evaluation.
+        uint32 mLodBlendFrame;
+
         uint16 mRefCount;
 
+        /// Returns false if the animations must not be evaluated this frame.
+        /// Outputs the maximum depth level to animate otherwise.
+        bool updateAnimationLod( size_t &outMaxDepthLevel );
+
+        /// Copies the local transforms of all bones to mLodPoses.
+        void saveLodPose( KfTransform *RESTRICT_ALIAS outPose ) const;
+        /// Sets the local transforms of all non-manual bones by interpolating mLodPoses.
+        void blendLodPoses( Real weight );
+
     public:
         SkeletonInstance( const SkeletonDef *skeletonDef, BoneMemoryManager *boneMemoryManager );
         ~SkeletonInstance();
 
         const SkeletonDef *getDefinition() const { return mDefinition; }
 
+        /// Evaluates all enabled animations. If animation LODs are set, the
+        /// evaluation may be skipped or limited to the upper levels of the hierarchy.
         void update();
 
         /// Resets the transform of all bones to the binding pose. Manual bones are not reset
@@ -211,6 +275,46 @@ namespace Ogre
         /// Returns our parent node. May be null.
         Node *getParentNode() const { return mParentNode; }
 
+        /** Sets the animation levels of detail. Distant skeletons can then be animated
+            less often and/or only up to a given depth in the bone hierarchy.
+        @remarks
+            The LOD is driven by the LOD value calculated by the default LodStrategy
+            for the Items using us (the most detailed one wins) during
+            SceneManager::updateAllLods. Because animations are updated before
+            rendering, the values from the previous frame are used.
+        @par
+            When a level has an updateInterval > 1, the local transforms of the bones are
+            interpolated on the frames the animations are not evaluated, from the pose
+            displayed before the last evaluation towards the pose of the last evaluation.
+            This removes visible stepping at the cost of up to updateInterval frames
+            of latency. Derived transforms are still updated every frame.
+        @param lodLevels
+            Levels sorted by ascending user LOD value. The first entry should have a
+            value of 0 (full detail). Pass an empty array to disable animation LOD.
+        */
+        void setAnimationLods( const SkeletonAnimationLodVec &lodLevels );
+        const SkeletonAnimationLodVec &getAnimationLods() const { return mAnimationLods; }
+
+        /** When true, animations are not evaluated while none of the LOD sources were
+            visible by any camera (including shadow cameras) since the last update.
+            Only has effect when a LOD source is set.
+        */
+        void setFreezeWhenNotVisible( bool bFreeze ) { mFreezeWhenNotVisible = bFreeze; }
+        bool getFreezeWhenNotVisible() const { return mFreezeWhenNotVisible; }
+
+        /// Adds a MovableObject that drives our animation LOD. See setAnimationLods.
+        /// Every Item sharing this SkeletonInstance is a LOD source.
+        void _addLodSource( MovableObject *lodSource );
+        void _removeLodSource( MovableObject *lodSource );
+
+        /// Called by the LodStrategy (from worker threads). Each LOD source
+        /// only touches its own entry, thus there are no race conditions.
+        void _notifyLodValue( const MovableObject *lodSource, Real lodValue );
+
+        /// Called from the culling (from worker threads). Each LOD source
+        /// only touches its own entry, thus there are no race conditions.
+        void _notifyVisible( const MovableObject *lodSource );
+
         void getTransforms( SimpleMatrixAf4x3 *RESTRICT_ALIAS outTransform,
                             const FastArray<unsigned short>  &usedBones ) const;
 
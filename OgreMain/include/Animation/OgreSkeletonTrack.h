@@ -46,9 +46,22 @@ namespace Ogre
         Real mInvNextFrameDistance;  // 1.0f / (KeyFrameRig[1].mFrame - KeyFrameRig[0].mFrame)
 
         // SoA variable. Packs posrotscale posrotscale ...
+        // Null when the track is quantized (see SkeletonTrack::isQuantized)
         KfTransform *RESTRICT_ALIAS mBoneTransform;
     };
 
+    /** Dequantization parameters of a quantized SkeletonTrack. Positions and scales are stored
+        as 16-bit integers 'q' per component, and decoded as:
+            value = mMin + q * mStep
+    */
+    struct QuantizedKfRange
+    {
+        ArrayVector3 mPositionMin;
+        ArrayVector3 mPositionStep;
+        ArrayVector3 mScaleMin;
+        ArrayVector3 mScaleStep;
+    };
+
     typedef vector<KeyFrameRig>::type KeyFrameRigVec;
 
     typedef FastArray<BoneTransform> TransformArray;
@@ -81,6 +94,26 @@ namespace Ogre
 
         KfTransformArrayMemoryManager *mLocalMemoryManager;
 
+        /// Not null when quantized. Memory is owned by SkeletonAnimationDef.
+        QuantizedKfRange *RESTRICT_ALIAS mQuantizedRange;
+        /** Quantized keyframes. Each keyframe takes mQuantizedStride uint16, laid out as
+            (each group has ARRAY_PACKED_REALS values, one per slot):
+                position.x, position.y, position.z,
+                rotation a, rotation b, rotation c,
+                scale.x, scale.y, scale.z (only if mQuantizedScale)
+            Rotations use the 'smallest three' encoding: the largest component (in absolute
+            value) is dropped and made positive, the other three are stored in 15 bits each
+            in [-1 / sqrt(2); 1 / sqrt(2)] range. The 2-bit index of the dropped component
+            goes in the top bits of 'a' (bit 0) and 'b' (bit 1). 48 bits per rotation.
+        */
+        uint16 *RESTRICT_ALIAS mQuantizedKeyFrames;
+        uint32                 mQuantizedStride;
+        /// When false, the scale is constant and stored only in mQuantizedRange->mScaleMin
+        bool mQuantizedScale;
+
+        /// Decodes the given quantized keyframe using SIMD.
+        inline void decodeQuantizedKeyFrame( size_t keyFrameIdx, KfTransform &outTransform ) const;
+
     public:
         SkeletonTrack( uint32 boneBlockIdx, KfTransformArrayMemoryManager *kfTransformMemoryManager );
         ~SkeletonTrack();
@@ -127,6 +160,52 @@ namespace Ogre
             mUsedSlots <= (ARRAY_PACKED_REALS >> 1). Otherwise it does nothing.
         */
         void _bakeUnusedSlots();
+
+        /** Removes every keyframe that can be reconstructed by interpolating its neighbours
+            within the given tolerances (error-bounded keyframe reduction).
+            A track whose keyframes are all equal is collapsed into a single keyframe.
+        @remarks
+            The KfTransforms of removed keyframes are not released; the caller is expected
+            to repack the remaining ones (see SkeletonAnimationDef::optimizeKeyFrames)
+        @param positionTolerance
+            Maximum allowed distance between the original and reconstructed position.
+        @param orientationTolerance
+            Maximum allowed angle between the original and reconstructed orientation.
+        @param scaleTolerance
+            Maximum allowed distance between the original and reconstructed scale.
+        */
+        void _reduceKeyFrames( Real positionTolerance, Radian orientationTolerance,
+                               Real scaleTolerance );
+
+        /// Returns the number of uint16 needed by _quantizeKeyFrames per keyframe.
+        uint32 _getQuantizedStride() const;
+
+        /** Converts the keyframes to the quantized format (see mQuantizedKeyFrames).
+            Afterwards KeyFrameRig::mBoneTransform are set to null. The caller is expected
+            to release the KfTransforms.
+        @param outRange
+            Where to store the dequantization parameters. Must be SIMD aligned.
+        @param outKeyFrames
+            Where to store the keyframes. Must hold _getQuantizedStride() * getKeyFrames().size()
+        */
+        void _quantizeKeyFrames( QuantizedKfRange *outRange, uint16 *outKeyFrames );
+
+        bool isQuantized() const { return mQuantizedRange != 0; }
+
+        /// Retrieves the transform of the given keyframe and slot.
+        /// Works whether the track is quantized or not.
+        void getKeyFrameTransform( size_t keyFrameIdx, size_t slot, Vector3 &outPos,
+                                   Quaternion &outRot, Vector3 &outScale ) const;
+
+        /// Returns true if this track has a single keyframe and it is the identity
+        /// transform within the given tolerances, i.e. it has no effect on the bones.
+        bool isConstantIdentity( Real positionTolerance, Radian orientationTolerance,
+                                 Real scaleTolerance ) const;
+
+        void _setMemoryManager( KfTransformArrayMemoryManager *kfTransformMemoryManager )
+        {
+            mLocalMemoryManager = kfTransformMemoryManager;
+        }
     };
 
     typedef vector<SkeletonTrack>::type SkeletonTrackVec;
@@ -111,6 +111,15 @@ namespace Ogre
             Real    minDistance;
             Real    maxDistance;
             Vector2 scenePassesViewportSize[Light::NUM_LIGHT_TYPES];
+
+            /// State used the last time this (static) shadow map was rendered.
+            /// See setStaticShadowMapAutoDirty
+            Matrix4 lastViewProjMatrix;
+            uint32  lastCastersHash;
+            /// False if lastCastersHash wasn't calculated when the map was last rendered
+            bool lastCastersHashValid;
+            /// When true, this shadow map must be rendered even if its light isn't dirty
+            bool isDirty;
         };
 
         typedef vector<ShadowMapCamera>::type ShadowMapCameraVec;
@@ -128,8 +137,7 @@ namespace Ogre
         size_t        mNumActiveShadowMapCastingLights;
         /// mShadowMapCastingLights may have gaps (can happen if no light of
         /// the types the shadow map supports could be assigned at this slot)
-        LightClosestArray    mShadowMapCastingLights;
-        vector<size_t>::type mTmpSortedIndexes;
+        LightClosestArray mShadowMapCastingLights;
 
         /** Cached value. Contains the aabb of all caster-only objects (filtered by
             camera's visibility flags) from the minimum RQ used by our shadow render
@@ -143,6 +151,9 @@ namespace Ogre
         /// Changes with each call to setShadowMapsToPass
         LightList mCurrentLightList;
 
+        bool   mStaticShadowMapAutoDirty;
+        uint32 mStaticCastersVisibilityMask;
+
         /** Called by update to find out which lights are the ones closest to the given
             camera. Early outs if we've already calculated our stuff for that camera in
             a previous call.
@@ -180,6 +191,12 @@ namespace Ogre
         void clearShadowCastingLights( const LightListInfo &globalLightList );
         void restoreStaticShadowCastingLights( const LightListInfo &globalLightList );
 
+        /// Sets shadowMapCamera.isDirty if the casters or the shadow camera
+        /// changed since the last time the map was rendered.
+        void updateStaticShadowMapDirty( ShadowMapCamera &shadowMapCamera, const Light *light,
+                                         bool cameraDependent, uint32 visibilityMask,
+                                         SceneManager *sceneManager );
+
     public:
         CompositorShadowNode( IdType id, const CompositorShadowNodeDef *definition,
                               CompositorWorkspace *workspace, RenderSystem *renderSys,
@@ -331,6 +348,42 @@ namespace Ogre
         /// to call it for every shadow map (otherwise you will trigger a O(N^2) behavior).
         void setStaticShadowMapDirty( size_t shadowMapIdx, bool includeLinked = true );
 
+        /** When enabled, static shadow maps (see setLightFixedToShadowMap) are automatically
+            tagged as dirty when needed, instead of relying on setStaticShadowMapDirty.
+        @remarks
+            Each shadow map (i.e. each PSSM split / cascade) is tracked individually.
+            A shadow map is re-rendered only when its shadow camera changed, or when a caster
+            that touches it entered, left, moved, resized or changed its visibility. Thus
+            cascades whose casters didn't change keep their previous contents.
+            Note that shadow cameras of directional lights follow the main camera, thus
+            their maps still get updated while the main camera moves.
+        @par
+            The check is CPU based and costs a pass over the casters' ObjectData (in the
+            RQ range of this shadow node) per static shadow map, which is a lot cheaper than
+            rendering them. The pass is skipped while the shadow camera changes, since the map
+            must be rendered anyway. For setups that depend on the main camera (directional
+            lights, or techniques other than uniform) the pass is only done once the shadow
+            camera stops changing, which costs one extra render after it stops.
+        @par
+            Because each shadow map may be skipped individually, clear passes must be tied
+            to their shadow map (i.e. shadow_map_idx in the clear pass, or merge the clear
+            with the scene pass), rather than clearing the whole atlas.
+        @par
+            To keep the expensive static casters cached while still having dynamic casters,
+            give them different visibility flags: the static shadow map's scene pass renders
+            the static casters (whose flags are set in staticCastersVisibilityMask), and a
+            second, non-static shadow map, initialized from it every frame with a
+            depth_copy pass, renders the dynamic casters on top.
+        @param bAutoDirty
+            True to enable.
+        @param staticCastersVisibilityMask
+            Only casters whose visibility flags have any of these bits set are tracked.
+            Changes on other casters won't cause static shadow maps to update.
+        */
+        void setStaticShadowMapAutoDirty( bool bAutoDirty,
+                                          uint32 staticCastersVisibilityMask = 0xFFFFFFFF );
+        bool getStaticShadowMapAutoDirty() const { return mStaticShadowMapAutoDirty; }
+
         /// @copydoc CompositorNode::finalTargetResized01
         void finalTargetResized01( const TextureGpu *finalTarget ) override;
     };
@@ -266,6 +266,16 @@ namespace Ogre
             }
         }
 
+        /// Same as streamTo4x3, but also writes the last row (0, 0, 0, 1) of an affine Matrix4.
+        void streamTo4x4( float *RESTRICT_ALIAS dst ) const
+        {
+            streamTo4x3( dst );
+            dst[12] = 0;
+            dst[13] = 0;
+            dst[14] = 0;
+            dst[15] = 1;
+        }
+
         static const SimpleMatrixAf4x3 IDENTITY;
     };
 
@@ -239,6 +239,15 @@ namespace Ogre
 #endif
         }
 
+        /// Same as streamTo4x3, but also writes the last row (0, 0, 0, 1) of an affine Matrix4.
+        void streamTo4x4( float *RESTRICT_ALIAS dst ) const
+        {
+            vst1q_f32( dst, mChunkBase[0] );
+            vst1q_f32( dst + 4, mChunkBase[1] );
+            vst1q_f32( dst + 8, mChunkBase[2] );
+            vst1q_f32( dst + 12, MathlibNEON::LAST_AFFINE_COLUMN );
+        }
+
         static const SimpleMatrixAf4x3 IDENTITY;
     };
 
@@ -415,6 +415,12 @@ namespace Ogre
         /// Converts 32-bit integer to float
         static inline ArrayReal ConvertToF32( ArrayInt a ) { return vcvtq_f32_s32( a ); }
 
+        /// Loads ARRAY_PACKED_REALS unsigned 16-bit integers and converts them to float
+        static inline ArrayReal LoadU16ToF32( const uint16 *RESTRICT_ALIAS src )
+        {
+            return vcvtq_f32_u32( vmovl_u16( vld1_u16( src ) ) );
+        }
+
         /// Returns the maximum value between a and b
         static inline ArrayReal Max( ArrayReal a, ArrayReal b ) { return vmaxq_f32( a, b ); }
 
@@ -139,6 +139,25 @@ namespace Ogre
                                          size_t diffInstances ) = 0;
         };
 
+        /** Work allowance for defragmentIncremental. The same budget is meant to be shared
+            across all the managers that get defragmented in the same frame, so that the
+            total cost of the cleanup is bounded regardless of how many managers there are.
+        */
+        struct DefragmentBudget
+        {
+            /// Number of fragmented slots that can still be reclaimed. Decremented as
+            /// slots are reclaimed.
+            size_t slotsLeft;
+            /// Time (in Timer::getMicroseconds units) after which no new work must be
+            /// started. Ignored if timer is null.
+            uint64 deadlineUs;
+            Timer *timer;
+
+            DefragmentBudget( size_t maxSlots, Timer *_timer = 0, uint64 timeBudgetUs = 0 );
+
+            bool isExhausted() const;
+        };
+
     protected:
         /// One per memory type
         MemoryPoolVec          mMemoryPools;
@@ -152,6 +171,12 @@ namespace Ogre
         size_t                      mMaxMemory;
         size_t                      mMaxHardLimit;
         size_t                      mCleanupThreshold;
+        /// When true, destroySlot won't defragment by itself and the owner is expected to
+        /// call defragmentIncremental periodically instead.
+        bool                        mIncrementalDefragment;
+        /// True once mCleanupThreshold was exceeded while mIncrementalDefragment was on,
+        /// until all fragmented slots have been reclaimed.
+        bool                        mDefragmentPending;
         typedef std::vector<size_t> SlotsVec;  // TODO: Modify for Ogre
         SlotsVec                    mAvailableSlots;
         RebaseListener             *mRebaseListener;
@@ -233,6 +258,33 @@ namespace Ogre
         ///  Prevent defragmentation from ever happening.
         void neverDefragment();
 
+        /** When enabled, destroySlot no longer triggers a full defragment() once the number
+            of fragmented slots reaches mCleanupThreshold. Instead the cleanup is marked as
+            pending and is spread across multiple calls to defragmentIncremental.
+        @remarks
+            Disabling it while a cleanup is pending leaves the slots fragmented until the
+            next destroySlot exceeds the threshold (or defragment is called).
+        */
+        void setIncrementalDefragment( bool bIncremental );
+        bool getIncrementalDefragment() const { return mIncrementalDefragment; }
+
+        /** Performs part of the cleanup done by defragment(), reclaiming the highest
+            fragmented slots first so that the remaining ones stay valid.
+        @remarks
+            Work is done per contiguous range of free slots: each range is shifted and
+            notified to the RebaseListener with a single performCleanup call. At least one
+            range is processed per call (if there is any pending) even if the budget was
+            already exhausted, to guarantee forward progress.
+        @param budget
+            [in/out] Budget shared with other managers. slotsLeft is decremented.
+        @return
+            True if there is still pending work.
+        */
+        bool defragmentIncremental( DefragmentBudget &budget );
+
+        /// True if there is a cleanup waiting to be finished by defragmentIncremental.
+        bool isDefragmentPending() const { return mDefragmentPending; }
+
         /// Defragments memory, then reallocates a smaller pool that tightly fits
         /// the current number of objects. Useful when you know you won't be creating
         /// more slots and you need to reclaim memory.
@@ -61,6 +61,8 @@ namespace Ogre
 
         BySkeletonDef *mBoneRebaseListener;
 
+        bool mIncrementalDefragment;
+
         /** Makes mMemoryManagers big enough to be able to fulfill mMemoryManagers[newDepth]
         @param newDepth
             Hierarchy level depth we wish to grow to.
@@ -76,6 +78,21 @@ namespace Ogre
         */
         void _growToDepth( const vector<size_t>::type &bonesPerDepth );
 
+        /// @copydoc ArrayMemoryManager::setIncrementalDefragment
+        void setIncrementalDefragment( bool bIncremental );
+        bool getIncrementalDefragment() const { return mIncrementalDefragment; }
+
+        /** Finishes the pending cleanups of all depths at once (unlike Nodes & ObjectData,
+            the granularity is the whole skeleton definition, see BySkeletonDef::skeletons).
+            Nothing is done if the budget is already exhausted.
+        @remarks
+            Use SkeletonAnimManager::defragmentIncremental instead, which also updates
+            BySkeletonDef::threadStarts.
+        @return
+            True if there is still pending work.
+        */
+        bool defragmentIncremental( ArrayMemoryManager::DefragmentBudget &budget );
+
         /** Requests memory for the given transform for the first, initializing values.
         @param outTransform
             Transform with filled pointers
@@ -68,6 +68,8 @@ namespace Ogre
         SceneMemoryMgrTypes mMemoryManagerType;
         NodeMemoryManager  *mTwinMemoryManager;
 
+        bool mIncrementalDefragment;
+
         /** Makes mMemoryManagers big enough to be able to fulfill mMemoryManagers[newDepth]
         @param newDepth
             Hierarchy level depth we wish to grow to.
@@ -194,6 +196,17 @@ namespace Ogre
         /// @copydoc ArrayMemoryManager::neverDefragment
         void neverDefragment();
 
+        /// @copydoc ArrayMemoryManager::setIncrementalDefragment
+        void setIncrementalDefragment( bool bIncremental );
+        bool getIncrementalDefragment() const { return mIncrementalDefragment; }
+
+        /** Runs ArrayMemoryManager::defragmentIncremental on every hierarchy depth that has a
+            pending cleanup, until the budget is exhausted.
+        @return
+            True if there is still pending work.
+        */
+        bool defragmentIncremental( ArrayMemoryManager::DefragmentBudget &budget );
+
         /// @copydoc ArrayMemoryManager::shrinkToFit
         void shrinkToFit();
 
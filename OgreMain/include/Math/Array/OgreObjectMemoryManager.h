@@ -74,6 +74,8 @@ namespace Ogre
         SceneMemoryMgrTypes  mMemoryManagerType;
         ObjectMemoryManager *mTwinMemoryManager;
 
+        bool mIncrementalDefragment;
+
         /** Makes mMemoryManagers big enough to be able to fulfill mMemoryManagers[newDepth]
         @param newDepth
             Hierarchy level depth we wish to grow to.
@@ -135,6 +137,17 @@ namespace Ogre
         /// @copydoc ArrayMemoryManager::defragment
         void defragment();
 
+        /// @copydoc ArrayMemoryManager::setIncrementalDefragment
+        void setIncrementalDefragment( bool bIncremental );
+        bool getIncrementalDefragment() const { return mIncrementalDefragment; }
+
+        /** Runs ArrayMemoryManager::defragmentIncremental on every render queue that has a
+            pending cleanup, until the budget is exhausted.
+        @return
+            True if there is still pending work.
+        */
+        bool defragmentIncremental( ArrayMemoryManager::DefragmentBudget &budget );
+
         /// @copydoc ArrayMemoryManager::shrinkToFit
         void shrinkToFit();
 
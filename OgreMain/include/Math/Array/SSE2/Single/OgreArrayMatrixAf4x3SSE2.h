@@ -239,6 +239,22 @@ namespace Ogre
 #endif
         }
 
+        /// Same as streamTo4x3, but also writes the last row (0, 0, 0, 1) of an affine Matrix4.
+        void streamTo4x4( float *RESTRICT_ALIAS dst ) const
+        {
+#ifndef OGRE_RENDERSYSTEM_API_ALIGN_COMPATIBILITY
+            _mm_stream_ps( dst, mChunkBase[0] );
+            _mm_stream_ps( dst + 4, mChunkBase[1] );
+            _mm_stream_ps( dst + 8, mChunkBase[2] );
+            _mm_stream_ps( dst + 12, MathlibSSE2::LAST_AFFINE_COLUMN );
+#else
+            _mm_storeu_ps( dst, mChunkBase[0] );
+            _mm_storeu_ps( dst + 4, mChunkBase[1] );
+            _mm_storeu_ps( dst + 8, mChunkBase[2] );
+            _mm_storeu_ps( dst + 12, MathlibSSE2::LAST_AFFINE_COLUMN );
+#endif
+        }
+
         static const SimpleMatrixAf4x3 IDENTITY;
     };
 
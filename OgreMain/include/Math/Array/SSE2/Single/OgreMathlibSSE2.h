@@ -303,6 +303,13 @@ namespace Ogre
         /// Converts 32-bit integer to float
         static inline ArrayReal ConvertToF32( ArrayInt a ) { return _mm_cvtepi32_ps( a ); }
 
+        /// Loads ARRAY_PACKED_REALS unsigned 16-bit integers and converts them to float
+        static inline ArrayReal LoadU16ToF32( const uint16 *RESTRICT_ALIAS src )
+        {
+            const __m128i asUint16 = _mm_loadl_epi64( reinterpret_cast<const __m128i *>( src ) );
+            return _mm_cvtepi32_ps( _mm_unpacklo_epi16( asUint16, _mm_setzero_si128() ) );
+        }
+
         /// Returns the maximum value between a and b
         static inline ArrayReal Max( ArrayReal a, ArrayReal b ) { return _mm_max_ps( a, b ); }
 
@@ -1123,6 +1123,59 @@ namespace Ogre
         RenderingMetrics();
     };
 
+    /** Statistics of how well the automatic instancing of the RenderQueue managed to merge
+        consecutive draws. See RenderQueue::setInstancingStatsEnabled.
+    @remarks
+        Each queued renderable either gets merged into the previous draw as one more instance,
+        or starts a new draw. In the latter case the reason is classified in mBatchBreaks,
+        which tells which content changes would reduce the number of draws.
+    */
+    struct _OgreExport InstancingStats
+    {
+        /// Reason why a renderable could not be merged with the previous one.
+        /// When more than one applies, the first one (in this order) is reported.
+        enum BatchBreakReason
+        {
+            /// First renderable of the render queue. Not an actual break.
+            BbrFirstDraw,
+            /// Different PSO (shader, macroblock, blendblock, vertex format, etc).
+            BbrPso,
+            /// Same PSO but the Hlms issued a batch-breaking command. Usually caused by a
+            /// different datablock (i.e. different textures), or a full const/tex buffer.
+            BbrHlmsCommand,
+            /// Vertex buffers are in a different VAO pool (or v1 VertexData / IndexData).
+            BbrVaoPool,
+            /// Same VAO pool, different mesh or submesh. It still costs a new draw
+            /// (or a new indirect draw entry).
+            BbrMesh,
+            /// Same submesh, but a different LOD level was selected.
+            BbrLodMismatch,
+            /// The current or previous renderable was split by per-cluster culling.
+            BbrClusterCulling,
+            /// The render queue mode can't instance (i.e. V1_LEGACY).
+            BbrNotSupported,
+            NumBatchBreakReasons
+        };
+
+        size_t mNumRenderables;
+        /// Draw calls or indirect draw entries (whichever applies).
+        size_t mNumDraws;
+        /// Renderables that got merged into the previous draw as an extra instance.
+        size_t mNumMergedInstances;
+        size_t mNumPsoSwitches;
+        /// VAO (or v1 RenderOperation) switches.
+        size_t mNumVaoSwitches;
+        size_t mBatchBreaks[NumBatchBreakReasons];
+
+        InstancingStats();
+
+        void reset();
+
+        InstancingStats &operator+=( const InstancingStats &other );
+
+        static const char *getBatchBreakReasonName( BatchBreakReason reason );
+    };
+
     /// Render window container.
     typedef StdVector<Window *> WindowList;
 
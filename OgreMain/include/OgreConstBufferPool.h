@@ -29,6 +29,7 @@ THE SOFTWARE.
 #define _OgreConstBufferPool_H_
 
 #include "OgrePrerequisites.h"
+#include "Threading/OgreUniformScalableTask.h"
 #include "Vao/OgreBufferPacked.h"
 
 #include "ogrestd/map.h"
@@ -53,8 +54,11 @@ namespace Ogre
 
         When a buffer is full and has used all of its free slots, a new buffer
         is allocated.
+
+        When there are many dirty users, they are packed into the StagingBuffer
+        using the SceneManager's worker threads.
     */
-    class _OgreExport ConstBufferPool
+    class _OgreExport ConstBufferPool : public UniformScalableTask
     {
     public:
         struct BufferPool
@@ -121,12 +125,26 @@ namespace Ogre
         ConstBufferPoolUserVec mDirtyUsersTmp;
         ConstBufferPoolUserVec mUsers;
 
+        /// Dirty flags of each user in mDirtyUsersTmp, while they're being uploaded.
+        /// DirtyNone if the user has already been uploaded from the main thread.
+        vector<uint8>::type mDirtyUsersTmpFlags;
+        /// Start of the mapped StagingBuffer while uploading mDirtyUsersTmp.
+        char *mUploadBufferStart;
+
         OptimizationStrategy mOptimizationStrategy;
 
         void destroyAllPools();
 
-        void uploadDirtyDatablocks();
-        void uploadDirtyDatablocksImpl();
+        /** Uploads all dirty users to GPU.
+        @param sceneManager
+            When not null and there are enough dirty users, its worker threads
+            are used to pack the users in parallel.
+        */
+        void uploadDirtyDatablocks( SceneManager *sceneManager = 0 );
+        void uploadDirtyDatablocksImpl( SceneManager *sceneManager );
+        /// Packs the users in range [start; end) of mDirtyUsersTmp
+        /// that haven't been uploaded yet. See mDirtyUsersTmpFlags.
+        void uploadDirtyUsersRange( size_t start, size_t end );
 
     public:
         ConstBufferPool( uint32 bytesPerSlot, const ExtraBufferParams &extraBufferParams );
@@ -139,6 +157,9 @@ namespace Ogre
 
         void scheduleForUpdate( ConstBufferPoolUser *dirtyUser, uint8 dirtyFlags = DirtyConstBuffer );
 
+        /// @copydoc UniformScalableTask::execute
+        void execute( size_t threadId, size_t numThreads ) override;
+
         /// Gets an ID corresponding to the pool this user was assigned to, unique per hash.
         size_t getPoolIndex( ConstBufferPoolUser *user ) const;
 
@@ -169,8 +190,13 @@ namespace Ogre
         // ConstBufferPool             *mPoolOwner;
         uint8 mDirtyFlags;
 
-        /// Derived class must fill dstPtr. Amount of bytes written can't
-        /// exceed the value passed to ConstBufferPool::uploadDirtyDatablocks
+        /** Derived class must fill dstPtr. Amount of bytes written can't
+            exceed the value passed to ConstBufferPool::uploadDirtyDatablocks
+        @remarks
+            Unless dirtyFlags contains DirtyTextures or DirtySamplers, this function
+            (and uploadToExtraBuffer) may be called from a worker thread, at the same
+            time as other users. Only modify this user's own data.
+        */
         virtual void uploadToConstBuffer( char *dstPtr, uint8 dirtyFlags ) = 0;
         virtual void uploadToExtraBuffer( char *dstPtr ) {}
 
@@ -36,6 +36,13 @@ THE SOFTWARE.
 
 namespace Ogre
 {
+    /// Default allocation policy for FastArray. Uses the global operator new & delete
+    struct FastArrayDefaultAllocPolicy
+    {
+        static void *allocateBytes( size_t count ) { return ::operator new( count ); }
+        static void  deallocateBytes( void *ptr ) { ::operator delete( ptr ); }
+    };
+
     /** Lightweight implementation of std::vector
     @remarks
         The problem with std::vector is that some implementations (eg. Visual Studio's) have a lot
@@ -62,12 +69,16 @@ namespace Ogre
         culled MovableObjects pointers (against the camera) and then iterate through all of
         them. These multiple levels of indirection was causing MS implementation to go mad
         with a huge amount of useless bounds checking & iterator validation.
+    @par
+        The AllocPolicy template parameter follows the same interface as the allocation
+        policies used by STLAllocator (static allocateBytes & deallocateBytes), e.g.
+        FrameArenaAllocPolicy to allocate from the per-frame arena.
     @author
         Matias N. Goldberg
     @version
         1.0
     */
-    template <typename T>
+    template <typename T, typename AllocPolicy = FastArrayDefaultAllocPolicy>
     class FastArray
     {
         T     *mData;
@@ -88,11 +99,11 @@ namespace Ogre
             {
                 mCapacity =
                     std::max<size_t>( mSize + newElements, mCapacity + ( mCapacity >> 1u ) + 1u );
-                T *data = (T *)::operator new( mCapacity * sizeof( T ) );
+                T *data = (T *)AllocPolicy::allocateBytes( mCapacity * sizeof( T ) );
                 if( mData )
                 {
                     silent_memcpy( data, mData, mSize * sizeof( T ) );
-                    ::operator delete( mData );
+                    AllocPolicy::deallocateBytes( mData );
                 }
                 mData = data;
             }
@@ -106,34 +117,34 @@ namespace Ogre
 
         FastArray() : mData( 0 ), mSize( 0 ), mCapacity( 0 ) {}
 
-        void swap( FastArray<T> &other )
+        void swap( FastArray &other )
         {
             std::swap( this->mData, other.mData );
             std::swap( this->mSize, other.mSize );
             std::swap( this->mCapacity, other.mCapacity );
         }
 
-        FastArray( const FastArray<T> &copy ) : mSize( copy.mSize ), mCapacity( copy.mSize )
+        FastArray( const FastArray &copy ) : mSize( copy.mSize ), mCapacity( copy.mSize )
         {
-            mData = (T *)::operator new( mSize * sizeof( T ) );
+            mData = (T *)AllocPolicy::allocateBytes( mSize * sizeof( T ) );
             for( size_t i = 0; i < mSize; ++i )
             {
                 new( &mData[i] ) T( copy.mData[i] );
             }
         }
 
-        void operator=( const FastArray<T> &copy )
+        void operator=( const FastArray &copy )
         {
             if( &copy != this )
             {
                 for( size_t i = 0; i < mSize; ++i )
                     mData[i].~T();
-                ::operator delete( mData );
+                AllocPolicy::deallocateBytes( mData );
 
                 mSize = copy.mSize;
                 mCapacity = copy.mSize;
 
-                mData = (T *)::operator new( mSize * sizeof( T ) );
+                mData = (T *)AllocPolicy::allocateBytes( mSize * sizeof( T ) );
                 for( size_t i = 0; i < mSize; ++i )
                 {
                     new( &mData[i] ) T( copy.mData[i] );
@@ -144,13 +155,13 @@ namespace Ogre
         /// Creates an array reserving the amount of elements (memory is not initialized)
         FastArray( size_t reserveAmount ) : mSize( 0 ), mCapacity( reserveAmount )
         {
-            mData = (T *)::operator new( reserveAmount * sizeof( T ) );
+            mData = (T *)AllocPolicy::allocateBytes( reserveAmount * sizeof( T ) );
         }
 
         /// Creates an array pushing the value N times
         FastArray( size_t count, const T &value ) : mSize( count ), mCapacity( count )
         {
-            mData = (T *)::operator new( count * sizeof( T ) );
+            mData = (T *)AllocPolicy::allocateBytes( count * sizeof( T ) );
             for( size_t i = 0; i < count; ++i )
             {
                 new( &mData[i] ) T( value );
@@ -163,7 +174,7 @@ namespace Ogre
         {
             for( size_t i = 0; i < mSize; ++i )
                 mData[i].~T();
-            ::operator delete( mData );
+            AllocPolicy::deallocateBytes( mData );
             mSize = 0;
             mCapacity = 0;
             mData = 0;
@@ -302,9 +313,9 @@ namespace Ogre
                 // We don't use growToFit because it will try to increase capacity by 50%,
                 // which is not the desire when calling reserve() explicitly
                 mCapacity = reserveAmount;
-                T *data = (T *)::operator new( mCapacity * sizeof( T ) );
+                T *data = (T *)AllocPolicy::allocateBytes( mCapacity * sizeof( T ) );
                 silent_memcpy( data, mData, mSize * sizeof( T ) );
-                ::operator delete( mData );
+                AllocPolicy::deallocateBytes( mData );
                 mData = data;
             }
         }
@@ -86,6 +86,13 @@ namespace Ogre
         bool                     mDebugWireAabbFrozen;
         vector<WireAabb *>::type mDebugWireAabb;
 
+        bool mTemporalReuse;
+        /// Slices that need to be rebuilt this frame. See setTemporalReuse
+        FastArray<bool> mDirtySlices;
+        /// Scratch arrays to avoid reallocating every frame
+        FastArray<TemporalObjState> mTmpLightStates;
+        FastArray<TemporalObjState> mTmpObjStates;
+
         inline size_t getDecalsOffsetStart() const;
         inline size_t getCubemapProbesOffsetStart() const;
 
@@ -107,6 +114,24 @@ namespace Ogre
 
         void collectObjs( const Camera *camera, size_t &outNumDecals, size_t &outNumCubemapProbes );
 
+        /// Fills outState.firstSlice & lastSlice with the slices covered by
+        /// a sphere at outState.position with the given radius.
+        void calculateSliceRange( TemporalObjState &outState, Real radius,
+                                  const Matrix4 &viewMatrix ) const;
+        void getLightTemporalState( const Light *light, const Matrix4 &viewMatrix,
+                                    TemporalObjState &outState ) const;
+        /// For decals & cubemap probes
+        void getObjTemporalState( const MovableObject *obj, const Matrix4 &viewMatrix,
+                                  TemporalObjState &outState ) const;
+        void markDirtySlices( uint32 firstSlice, uint32 lastSlice );
+
+        /** Compares the current camera, lights, decals & cubemap probes against the state
+            the cached grid was built from and fills mDirtySlices.
+        @return
+            Number of slices that need to be rebuilt.
+        */
+        size_t updateDirtySlices( const Camera *camera, CachedGrid *cachedGrid );
+
     public:
         ForwardClustered( uint32 width, uint32 height, uint32 numSlices, uint32 lightsPerCell,
                           uint32 decalsPerCell, uint32 cubemapProbesPerCell, float minDistance,
@@ -121,6 +146,22 @@ namespace Ogre
         void setFreezeDebugFrustum( bool freezeDebugFrustum );
         bool getFreezeDebugFrustum() const;
 
+        /** When enabled, the grid built for a camera is kept in CPU memory and on the
+            next frame only the slices touched by lights, decals or cubemap probes that changed
+            (moved, rotated, resized, etc) are rebuilt.
+        @remarks
+            The whole grid is rebuilt if the camera changed, or if the set of visible lights,
+            decals or probes changed (including their order, which depends on distance to camera).
+            Changes that don't affect the grid (e.g. light colour) don't trigger rebuilds.
+
+            This costs a copy of the grid in RAM per cached camera, and a full memcpy of the
+            grid to the GPU buffer every frame.
+
+            Disabled by default.
+        */
+        void setTemporalReuse( bool bTemporalReuse );
+        bool getTemporalReuse() const { return mTemporalReuse; }
+
         void execute( size_t threadId, size_t numThreads ) override;
 
         void collectLights( Camera *camera ) override;
@@ -83,6 +83,30 @@ namespace Ogre
 
         typedef vector<CachedGridBuffer>::type CachedGridBufferVec;
 
+        /// State of a light, decal or cubemap probe the last time it was added to the grid.
+        /// Used to detect which objects changed between frames.
+        struct TemporalObjState
+        {
+            MovableObject const *object;
+            Vector3              position;
+            Quaternion           orientation;
+            Vector3              scale;
+            Real                 range;
+            Real                 spotTanHalfAngle;
+            uint8                lightType;
+            /// Range of slices (inclusive) the object may touch
+            uint32 firstSlice;
+            uint32 lastSlice;
+
+            bool hasSameState( const TemporalObjState &other ) const
+            {
+                return object == other.object && position == other.position &&
+                       orientation == other.orientation && scale == other.scale &&
+                       range == other.range && spotTanHalfAngle == other.spotTanHalfAngle &&
+                       lightType == other.lightType;
+            }
+        };
+
         static const uint32 MinDecalRq;  // Inclusive
         static const uint32 MaxDecalRq;  // Inclusive
 
@@ -111,6 +135,15 @@ namespace Ogre
 
             uint32              currentBufIdx;
             CachedGridBufferVec gridBuffers;
+
+            /// CPU copy of the grid from the last time it was built, and the state it was
+            /// built from. Empty if there's nothing to reuse. Only used by ForwardClustered.
+            /// See ForwardClustered::setTemporalReuse
+            FastArray<uint16>           gridShadow;
+            Matrix4                     lastViewMatrix;
+            Matrix4                     lastProjMatrix;
+            FastArray<TemporalObjState> lastLights;
+            FastArray<TemporalObjState> lastObjs;
         };
 
         enum ObjTypes
@@ -138,10 +171,6 @@ namespace Ogre
 
         FastArray<LightCount> mLightCountInCell;
 
-        // Used to save and restore visibility of shadow casting lights. Lives here
-        // to reuse memory, otherwise on stack it keeps constantly reallocating memory
-        FastArray<bool> mShadowCastingLightVisibility;
-
         VaoManager   *mVaoManager;
         SceneManager *mSceneManager;
 
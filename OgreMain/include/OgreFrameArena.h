@@ -0,0 +1,167 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef _OgreFrameArena_H_
+#define _OgreFrameArena_H_
+
+#include "OgrePrerequisites.h"
+
+#include "OgreFastArray.h"
+#include "OgreMemorySTLAllocator.h"
+
+#include <limits>
+#include <vector>
+
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre
+{
+    /** \addtogroup Core
+     *  @{
+     */
+    /** \addtogroup Memory
+     *  @{
+     */
+
+    /** Linear allocator for transient memory that only needs to live for about a frame.
+    @remarks
+        Each thread has its own arena (see FrameArena::get) so allocating never contends
+        with other threads. Allocating is just bumping an offset; memory is never freed
+        individually. Instead the whole arena is recycled once per frame.
+    @par
+        The arena is double buffered: memory allocated during frame N stays valid until
+        the end of frame N + 1. After that it will be reused, so never keep pointers
+        into the arena (or containers using FrameArenaAllocPolicy) across frames.
+    @par
+        Root::_fireFrameEnded advances the frame. Each thread's arena notices it the next
+        time it allocates, and recycles the buffer from two frames ago. The memory is
+        retained, thus once warmed up the arena no longer calls the system allocator.
+    */
+    class _OgreExport FrameArena
+    {
+        struct Chunk
+        {
+            uint8 *data;
+            size_t size;
+        };
+
+        struct Buffer
+        {
+            std::vector<Chunk> chunks;
+            /// Offset into chunks.back()
+            size_t offset;
+            /// Total bytes handed out (including alignment padding)
+            size_t bytesUsed;
+
+            Buffer() : offset( 0 ), bytesUsed( 0 ) {}
+        };
+
+        Buffer mBuffers[2];
+        uint8  mCurrentBuffer;
+        uint32 mLastFrame;
+        size_t mDefaultChunkSize;
+        size_t mPeakBytesUsed;
+        size_t mReportedPeakBytesUsed;
+
+        void syncFrame();
+        void resetBuffer( Buffer &buffer );
+        void addChunk( Buffer &buffer, size_t minSize );
+
+    public:
+        FrameArena( size_t defaultChunkSize = 256u * 1024u );
+        ~FrameArena();
+
+        /** Allocates memory valid until the end of the next frame.
+        @param bytes
+            Size in bytes of the allocation.
+        @param alignment
+            Alignment in bytes. Must be a power of 2.
+        */
+        void *allocate( size_t bytes, size_t alignment = OGRE_SIMD_ALIGNMENT );
+
+        /// Bytes allocated from this arena during the current frame
+        size_t getBytesUsed() const { return mBuffers[mCurrentBuffer].bytesUsed; }
+        /// Largest amount of bytes allocated from this arena in a single frame
+        size_t getPeakBytesUsed() const { return mPeakBytesUsed; }
+
+        /// Returns the arena of the calling thread
+        static FrameArena &get();
+
+        /** When enabled, every arena logs a message whenever it reaches a new peak usage.
+            Useful to size chunks (or find a runaway allocation). Default is false.
+        */
+        static void setReportPeakUsage( bool bReport );
+        static bool getReportPeakUsage();
+
+        /// Advances the frame. Called by Root::_fireFrameEnded
+        static void _notifyFrameEnded();
+    };
+
+    /** Allocation policy for use with STLAllocator and FastArray which allocates from
+        the calling thread's FrameArena. Deallocation is a no-op.
+    @remarks
+        See FrameArena on how long the memory stays valid.
+    */
+    class _OgreExport FrameArenaAllocPolicy
+    {
+    public:
+        static inline void *allocateBytes( size_t count, const char * = 0, int = 0, const char * = 0 )
+        {
+            return FrameArena::get().allocate( count );
+        }
+
+        static inline void deallocateBytes( void * ) {}
+
+        /// Get the maximum size of a single allocation
+        static inline size_t getMaxAllocationSize() { return std::numeric_limits<size_t>::max(); }
+
+    private:
+        // no instantiation
+        FrameArenaAllocPolicy() {}
+    };
+
+    /// FastArray allocating from the calling thread's FrameArena
+    template <typename T>
+    struct FrameArenaFastArray
+    {
+        typedef FastArray<T, FrameArenaAllocPolicy> type;
+    };
+
+    /// std::vector allocating from the calling thread's FrameArena
+    template <typename T>
+    struct FrameArenaVector
+    {
+        typedef std::vector<T, STLAllocator<T, FrameArenaAllocPolicy> > type;
+    };
+
+    /** @} */
+    /** @} */
+}  // namespace Ogre
+
+#include "OgreHeaderSuffix.h"
+
+#endif
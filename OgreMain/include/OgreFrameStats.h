@@ -28,6 +28,7 @@ THE SOFTWARE.
 #ifndef __FrameStats_H__
 #define __FrameStats_H__
 
+#include "OgreCommon.h"
 #include "OgreMemoryAllocatorConfig.h"
 
 namespace Ogre
@@ -57,6 +58,8 @@ namespace Ogre
         static constexpr uint32 kNumFrameStats = 1024u;
         uint32                  mFramesCount[kNumFrameStats];
 
+        InstancingStats mInstancingStats;
+
         inline double getPercentileNthFrames( const double percentile ) const
         {
             const uint64 sampleCountToLookFor =
@@ -206,6 +209,16 @@ namespace Ogre
 
         uint64 getLastTimeRawMicroseconds() const { return mLastTimeAbsoluteUS; }
 
+        /** Returns the InstancingStats of the last frame, summed across all SceneManagers.
+        @remarks
+            Only SceneManagers with RenderQueue::setInstancingStatsEnabled contribute.
+            This is not affected by reset().
+        */
+        const InstancingStats &getInstancingStats() const { return mInstancingStats; }
+
+        /// Called by Root when the frame has fully ended.
+        void _setInstancingStats( const InstancingStats &stats ) { mInstancingStats = stats; }
+
         /// Adds a new measured time, in *microseconds*
         void addSample( const uint64 timeUs )
         {
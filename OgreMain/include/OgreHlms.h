@@ -144,6 +144,35 @@ namespace Ogre
 
         typedef std::map<IdString, DatablockEntry> HlmsDatablockMap;
 
+        /// Runtime statistics of a PSO. See Hlms::setPsoStatsEnabled
+        struct PsoStats
+        {
+            /// Frame (VaoManager::getFrameCount) in which the PSO was first requested.
+            uint32 firstUseFrame;
+            /// Number of times this PSO was switched to by getMaterial.
+            uint32 useCount;
+            /// Number of times createShaderCacheEntry ran for it. More than 1 means the
+            /// PSO creation was deferred due to the ParallelHlmsCompileQueue deadline.
+            uint32 numAttempts;
+            /// Accumulated time spent in createShaderCacheEntry (shaders + PSO).
+            uint64 totalTimeUs;
+            /// Accumulated time spent parsing & compiling shaders.
+            /// 0 if the shaders were already in the shader code cache.
+            uint64 shaderTimeUs;
+            /// True if it was created in the main thread while rendering, i.e. it caused a stall.
+            /// False if it was created by the ParallelHlmsCompileQueue.
+            bool synchronous;
+            /// Datablock which first requested this PSO.
+            String datablockName;
+            /// Merged (pass + renderable) properties. These are the same properties
+            /// HlmsDiskCache stores in HlmsDiskCache::SourceCode::mergedCache.
+            HlmsPropertyVec properties;
+
+            PsoStats();
+        };
+
+        typedef map<uint32, PsoStats>::type PsoStatsMap;
+
         /// For single-threaded operations
         static constexpr size_t kNoTid = 0u;
 
@@ -250,6 +279,10 @@ namespace Ogre
         ThreadDataVec    mT;
         LightweightMutex mMutex;
 
+        PsoStatsMap              mPsoStats;       // GUARDED_BY( mPsoStatsMutex )
+        Timer                   *mPsoStatsTimer;  ///< Null when stats are disabled
+        mutable LightweightMutex mPsoStatsMutex;
+
         static LightweightMutex msGlobalMutex;
 
         static bool msHasParticleFX2Plugin;
@@ -316,6 +349,12 @@ namespace Ogre
         bool   mDebugOutputProperties;
         uint8  mPrecisionMode;  ///< See PrecisionMode
         bool   mFastShaderBuildHack;
+        /// When true, RenderQueue sends runs of renderables to fillBuffersForBatch.
+        /// Otherwise each renderable goes through fillBuffersForV2. See setBatchedFillBuffers.
+        bool mBatchedFillBuffers;
+
+        /// See fillBuffersForBatch. Derived classes usually set it from their constructor.
+        void setBatchedFillBuffers( bool bBatched ) { mBatchedFillBuffers = bBatched; }
 
     public:
         struct DatablockCustomPieceFile
@@ -483,6 +522,9 @@ namespace Ogre
         const ShaderCodeCacheVec &getShaderCodeCache() const { return mShaderCodeCache; }
 
     protected:
+        /// Updates PsoStats::useCount & firstUseFrame. Only called when the stats are enabled.
+        void notePsoStatsUse( uint32 finalHash );
+
         /** Creates a shader based on input parameters. Caller is responsible for ensuring
             this shader hasn't already been created.
             Shader template files will be processed and then compiled.
@@ -718,6 +760,31 @@ namespace Ogre
         /// If this value returns false, then HlmsDiskCache doesn't need saving.
         bool isShaderCodeCacheDirty() const { return mShaderCodeCacheDirty; }
 
+        /** Records per-PSO statistics (compile times, first use frame, use count, properties).
+            Useful to find out which variants cause stalls at runtime and prune or pre-warm
+            them (e.g. via HlmsDiskCache).
+        @remarks
+            Disabled by default as it adds a small overhead every time getMaterial switches PSOs.
+            Stats are cleared by clearShaderCache because PSO hashes get reused.
+            Do not toggle it while a ParallelHlmsCompileQueue is compiling.
+        */
+        void setPsoStatsEnabled( bool bEnabled );
+        bool getPsoStatsEnabled() const { return mPsoStatsTimer != 0; }
+
+        void resetPsoStats();
+
+        /// Returns a copy of the stats, keyed by the PSO's final hash. Thread safe.
+        PsoStatsMap getPsoStats() const;
+
+        /** Exports the PSO stats.
+        @param outString [out]
+            Stats are appended to this string.
+        @param bCsv
+            True to export as CSV (one row per PSO, properties separated by ';').
+            False to export as JSON.
+        */
+        void exportPsoStats( String &outString, bool bCsv ) const;
+
         static void _setHasParticleFX2Plugin( bool bHasPfx2Plugin )
         {
             msHasParticleFX2Plugin = bHasPfx2Plugin;
@@ -1030,6 +1097,46 @@ namespace Ogre
                                          const QueuedRenderable &queuedRenderable, bool casterPass,
                                          uint32 lastCacheHash, CommandBuffer *commandBuffer ) = 0;
 
+        /** Batch version of fillBuffersForV2. RenderQueue calls it with runs of consecutive
+            v2 renderables that share the same HlmsCache, so that implementations can
+            amortize per-draw checks and pack the per-object data in a tight loop.
+        @remarks
+            The draws are issued by the caller after this function returns, thus implementations
+            must stop before the first renderable (other than the first one) that would need
+            to add a command to the command buffer (e.g. binding different textures, or mapping
+            a new const buffer).
+        @par
+            Only called if getBatchedFillBuffers returns true, which HlmsPbs and HlmsUnlit
+            enable by default. Derived classes that override fillBuffersForV2 must either call
+            setBatchedFillBuffers( false ) or override this function too, otherwise their
+            fillBuffersForV2 gets skipped.
+            The default implementation only processes the first renderable via fillBuffersForV2.
+        @param cache
+            Current cache of Shaders to be used. It's the same for all renderables in the run.
+        @param begin
+            First renderable of the run.
+        @param end
+            One past the last renderable of the run. Must be greater than begin.
+        @param casterPass
+            Whether this is a shadow mapping caster pass.
+        @param lastCacheHash
+            The hash of the cache of shaders that was used by the renderable before begin.
+        @param commandBuffer
+            See fillBuffersForV2.
+        @param outBaseInstances [out]
+            The value fillBuffersForV2 would've returned, one per processed renderable.
+            Must have room for ( end - begin ) entries.
+        @return
+            Number of renderables processed, in range [1; end - begin].
+        */
+        virtual size_t fillBuffersForBatch( const HlmsCache *cache, const QueuedRenderable *begin,
+                                            const QueuedRenderable *end, bool casterPass,
+                                            uint32 lastCacheHash, CommandBuffer *commandBuffer,
+                                            uint32 *outBaseInstances );
+
+        /// Whether RenderQueue uses fillBuffersForBatch instead of fillBuffersForV2.
+        bool getBatchedFillBuffers() const { return mBatchedFillBuffers; }
+
         /// This gets called right before executing the command buffer.
         virtual void preCommandBufferExecution( CommandBuffer *commandBuffer ) {}
         /// This gets called after executing the command buffer.
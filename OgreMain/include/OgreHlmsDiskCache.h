@@ -44,6 +44,29 @@ namespace Ogre
 
     struct CompilerJobParams;
 
+    /** Listener to track the progress of HlmsDiskCache::applyTo.
+        Useful to drive a progress bar while compiling the cache during a loading screen.
+    */
+    class _OgreExport HlmsDiskCacheListener
+    {
+    public:
+        virtual ~HlmsDiskCacheListener() {}
+
+        /** Called every time a cached shader variant finished compiling.
+        @remarks
+            When applyTo compiles with multiple threads, this function gets called from
+            the worker threads. Calls are serialized (no two calls happen at the same time)
+            and numCompiled is monotonically increasing.
+        @param hlms
+            Hlms the cache is being applied to.
+        @param numCompiled
+            Number of variants compiled so far (including this one).
+        @param numTotal
+            Total number of variants that will be compiled.
+        */
+        virtual void shaderCompiled( Hlms *hlms, uint32 numCompiled, uint32 numTotal ) {}
+    };
+
     /** @class HlmsDiskCache
 
         This class allows saving the current state of an Hlms to disk: both its compiled shaders
@@ -130,6 +153,12 @@ namespace Ogre
                                     some stalls at runtime, due to the driver translating the Microcode
                                     to the internal ISA.
     @endcode
+
+        Caches recorded on several machines (e.g. QA runs) can be combined into a single bundle
+        with mergeFrom (see the OgreHlmsDiskCacheMerge tool). Duplicated variants are collapsed and
+        each variant keeps track of how many caches it was seen in. applyTo compiles the most
+        frequently seen variants first, so that aborting or streaming the loading screen early still
+        covers the most common cases.
     */
     class _OgreExport HlmsDiskCache : public OgreAllocatedObj
     {
@@ -138,6 +167,11 @@ namespace Ogre
         {
             Hlms::RenderableCache mergedCache;
             String                sourceFile[NumShaderTypes];
+            /// Number of caches this variant was seen in. Used as compilation priority.
+            uint32 hitCount;
+            /// Sum of the Hlms::PsoStats::useCount of the PSOs using this variant, if PSO stats
+            /// were enabled when copyFrom was called. Breaks ties between equal hitCount.
+            uint32 useCount;
 
             SourceCode();
             SourceCode( const Hlms::ShaderCodeCache &shaderCodeCache );
@@ -188,6 +222,10 @@ namespace Ogre
         bool         mFastShaderBuildHack;
         uint16       mDebugStrSize;
 
+        HlmsDiskCacheListener *mListener;
+
+        static bool isSamePso( const Pso &a, const Pso &b );
+
         void save( DataStreamPtr &dataStream, const IdString &hashedString );
         void save( DataStreamPtr &dataStream, const String &string );
         void save( DataStreamPtr &dataStream, const HlmsPropertyVec &properties );
@@ -199,14 +237,44 @@ namespace Ogre
         void load( DataStreamPtr &dataStream, Hlms::RenderableCache &renderableCache );
 
     public:
+        /**
+        @param hlmsManager
+            May be null if the cache is only going to be loaded, merged and saved (e.g. offline
+            tools). Such cache can't be applied.
+        */
         HlmsDiskCache( HlmsManager *hlmsManager );
         ~HlmsDiskCache();
 
         void clearCache();
 
         void copyFrom( Hlms *hlms );
+
+        /** Compiles all the shaders in the cache, in order of priority (see SourceCode::hitCount
+            and SourceCode::useCount).
+        @param hlms
+        @param numThreads
+            Number of threads to compile shaders in parallel. Only used if the RenderSystem
+            supports multithreaded shader compilation.
+        */
         void applyTo( Hlms *hlms, size_t numThreads );
 
+        /** Merges the contents of another cache into this one. Variants already present are
+            not duplicated; their hitCount and useCount are increased instead.
+        @remarks
+            Both caches must have been generated for the same Hlms type, shader profile,
+            templates and settings. If this cache is empty, it takes the settings from 'other'.
+        @return
+            False if the caches are incompatible and nothing was merged.
+        */
+        bool mergeFrom( const HlmsDiskCache &other );
+
+        /// Listener to report progress during applyTo. Can be null. Does not take ownership.
+        void                   setListener( HlmsDiskCacheListener *listener );
+        HlmsDiskCacheListener *getListener() const { return mListener; }
+
+        size_t getNumSourceCodeEntries() const { return mCache.sourceCode.size(); }
+        size_t getNumPsoEntries() const { return mCache.pso.size(); }
+
         void saveTo( DataStreamPtr &dataStream );
         void loadFrom( DataStreamPtr &dataStream );
 
@@ -57,8 +57,22 @@ THE SOFTWARE.
 #    include "OgreAssert.h"
 #endif
 
+#if OGRE_IDSTRING_INTERN_TABLE
+#    define OGRE_INTERN_IDSTRING( _String, _Length ) _internIdString( *this, _String, _Length )
+#else
+#    define OGRE_INTERN_IDSTRING( _String, _Length ) ( (void)0 )
+#endif
+
 namespace Ogre
 {
+#if OGRE_IDSTRING_INTERN_TABLE
+    struct IdString;
+    /// Internal use. See IdStringTable
+    _OgreExport void        _internIdString( const IdString &idString, const char *string,
+                                             size_t length );
+    _OgreExport const char *_findInternedIdString( const IdString &idString );
+#endif
+
     /** Hashed string.
         An IdString is meant to be passed by value rather than by reference since in Release
         mode it's just an encapsulated integer. The default implementation uses a 32-bit uint.
@@ -99,6 +113,9 @@ namespace Ogre
     @par
         In practice we truncate to 32 bytes. If your fear this is too little for you and
         also fear about collisions, increase OGRE_DEBUG_STR_SIZE
+    @par
+        When built with OGRE_IDSTRING_INTERN_TABLE, the full string is also recorded in
+        IdStringTable and getFriendlyText returns it (in any build mode) if present.
     @author
         Matias N. Goldberg
     @version
@@ -128,14 +145,17 @@ namespace Ogre
 
         IdString( const char *string ) : mHash{}
         {
-            OGRE_HASH_FUNC( string, static_cast<int>( strlen( string ) ), Seed, &mHash );
+            const size_t length = strlen( string );
+            OGRE_HASH_FUNC( string, static_cast<int>( length ), Seed, &mHash );
             OGRE_COPY_DEBUG_STRING( string );
+            OGRE_INTERN_IDSTRING( string, length );
         }
 
         IdString( const std::string &string ) : mHash{}
         {
             OGRE_HASH_FUNC( string.c_str(), static_cast<int>( string.size() ), Seed, &mHash );
             OGRE_COPY_DEBUG_STRING( string );
+            OGRE_INTERN_IDSTRING( string.c_str(), string.size() );
         }
 
         IdString( uint32 value ) : mHash{}
@@ -288,8 +308,14 @@ namespace Ogre
         }
 
         /// Returns "[Hash 0x0a0100ef]" strings in Release mode, readable string in debug
+        /// (or in any mode if found in IdStringTable)
         std::string getFriendlyText() const
         {
+#if OGRE_IDSTRING_INTERN_TABLE
+            const char *internedString = _findInternedIdString( *this );
+            if( internedString )
+                return std::string( internedString );
+#endif
 #if OGRE_DEBUG_MODE >= OGRE_DEBUG_MEDIUM || OGRE_IDSTRING_ALWAYS_READABLE
             return std::string( mDebugString );
 #else
@@ -318,6 +344,14 @@ namespace Ogre
         */
         void getFriendlyText( char *outCStr, size_t stringSize ) const
         {
+#if OGRE_IDSTRING_INTERN_TABLE
+            const char *internedString = _findInternedIdString( *this );
+            if( internedString )
+            {
+                std::snprintf( outCStr, stringSize, "%s", internedString );
+                return;
+            }
+#endif
 #if OGRE_DEBUG_MODE >= OGRE_DEBUG_MEDIUM || OGRE_IDSTRING_ALWAYS_READABLE
             size_t minSize = std::min<size_t>( OGRE_DEBUG_STR_SIZE, stringSize );
             memcpy( outCStr, mDebugString, minSize );
@@ -0,0 +1,138 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef _OgreIdStringTable_H_
+#define _OgreIdStringTable_H_
+
+#include "OgrePrerequisites.h"
+
+#include "OgreIdString.h"
+
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre
+{
+    /** \addtogroup Core
+     *  @{
+     */
+    /** \addtogroup General
+     *  @{
+     */
+
+    /** Global table that maps IdString hashes back to the full string they were built from.
+    @remarks
+        Only available when Ogre is built with OGRE_IDSTRING_INTERN_TABLE. In that case every
+        IdString constructed from a string inserts it into the table (if not already present),
+        so that getFriendlyText can return readable names even in Release builds; and so that
+        tools (profiling, HlmsDiskCache diagnostics, PSO stats) can translate hashes.
+    @par
+        The table is append-only. Lookups are lock-free; insertions are sharded by hash and only
+        lock the shard they belong to. Strings returned by find remain valid until _clear.
+    @par
+        Memory is bounded: the number of slots is fixed and strings are stored in chunks that
+        can't grow past getMemoryBudget. Once full, new strings are dropped (and counted in
+        Stats::numDropped); their IdStrings keep working, they just won't be readable.
+    @par
+        IdStrings combined via operator+ are not added since there is no string to add.
+    */
+    class _OgreExport IdStringTable
+    {
+    public:
+        struct Stats
+        {
+            size_t numEntries;
+            /// Number of strings that couldn't be added because the table was full
+            size_t numDropped;
+            /// Total memory used by the table, in bytes. Includes the fixed slot arrays
+            size_t memoryUsed;
+            /// See setMemoryBudget
+            size_t memoryBudget;
+        };
+
+        /// Returns true if Ogre was built with OGRE_IDSTRING_INTERN_TABLE
+        static bool isAvailable();
+
+        /** Enables or disables adding new strings. Enabled by default (when available)
+            so that IdStrings constructed during static initialization are captured.
+        @remarks
+            Disabling it does not remove existing entries; they can still be found.
+        */
+        static void setEnabled( bool bEnabled );
+        static bool getEnabled();
+
+        /** Maximum amount of memory in bytes used to store the strings. Does not include
+            the fixed cost of the slots (see Stats::memoryUsed). Default is 4MB.
+        @remarks
+            Lowering the budget below what's already in use does not release memory,
+            it just prevents new strings from being added.
+        */
+        static void   setMemoryBudget( size_t bytes );
+        static size_t getMemoryBudget();
+
+        /** Retrieves the original string of the given IdString.
+        @return
+            Null if not found. Otherwise a null-terminated string that stays valid until _clear.
+        */
+        static const char *find( IdString idString );
+
+        static Stats getStats();
+
+        /// Dumps the stats to the Ogre log.
+        static void logStats();
+
+        /** Writes all strings in the table to the stream.
+        @remarks
+            Only strings are saved; hashes are recomputed on load. Thus the output can be
+            loaded regardless of OGRE_IDSTRING_USE_128. Safe to call while other threads
+            add strings, but those may or may not be included.
+        */
+        static void saveTo( DataStreamPtr &dataStream );
+
+        /** Adds all strings saved with saveTo to the table. Existing entries are kept.
+            Useful to translate hashes found in caches generated by a different process.
+        */
+        static void loadFrom( DataStreamPtr &dataStream );
+
+        /// Adds the string if not present. Called by IdString's constructors.
+        static void _insert( IdString idString, const char *string, size_t length );
+
+        /** Removes all entries and frees all memory.
+        @remarks
+            NOT thread safe. No other thread may be using IdStrings or pointers returned
+            by find at the same time.
+        */
+        static void _clear();
+    };
+
+    /** @} */
+    /** @} */
+
+}  // namespace Ogre
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -86,6 +86,7 @@ namespace Ogre
         // Allow ItemFItemy full access
         friend class ItemFactory;
         friend class SubItem;
+        friend class StaticGeometry;
 
     public:
         // typedef set<Item*>::type ItemSet;
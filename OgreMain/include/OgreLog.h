@@ -34,6 +34,7 @@ THE SOFTWARE.
 #include "OgreCommon.h"
 #include "Threading/OgreLightweightMutex.h"
 
+#include <ctime>
 #include <iosfwd>
 
 #include "ogrestd/vector.h"
@@ -95,6 +96,8 @@ namespace Ogre
                                     const String &logName, bool &skipThisMessage ) = 0;
     };
 
+    struct LogAsyncWriter;
+
     /**
     @remarks
          Log class for writing debug/log data to files.
@@ -114,6 +117,21 @@ namespace Ogre
         typedef vector<LogListener *>::type mtLogListener;
         mtLogListener                       mListeners;
 
+        /// Null when async mode is disabled. See setAsyncEnabled
+        LogAsyncWriter *mAsync;
+
+        /// Guards the file & debugger output. Kept apart from mMutex (which guards
+        /// the listeners) so that threads logging never wait on the async writer's I/O.
+        LightweightMutex mFileMutex;
+
+        /// Calls the listeners. Caller must hold mMutex.
+        /// Returns true if a listener asked to skip this message.
+        bool notifyListeners( const String &message, LogMessageLevel lml, bool maskDebug );
+
+        /// Outputs the message to the debugger & file. Caller must hold mFileMutex.
+        void writeMessage( const String &message, LogMessageLevel lml, bool maskDebug, time_t ctTime,
+                           bool bFlush );
+
     public:
         class Stream;
 
@@ -167,6 +185,47 @@ namespace Ogre
         /** Gets the level of the log detail.
          */
         LoggingLevel getLogDetail() const { return mLogLevel; }
+
+        /** Enables or disables asynchronous logging.
+        @remarks
+            When enabled, logMessage pushes the message into a lock-free ring buffer and returns
+            immediately. A dedicated writer thread formats the time stamps, outputs to the
+            debugger and writes the file in batches, flushing once per batch.
+
+            LML_CRITICAL messages block the caller until the writer thread has written them
+            (and everything logged before them) to disk, so they aren't lost in case of a crash.
+
+            If the ring buffer is full, callers wait until the writer thread makes room.
+
+            Disabling async mode flushes all pending messages. Async mode is disabled
+            automatically when the Log is destroyed.
+
+            This function is not thread safe: no other thread may log to this Log while
+            toggling async mode.
+        @param bAsync
+            True to enable async mode.
+        @param listenersOnWriterThread
+            When true, LogListeners are called from the writer thread, which means
+            skipThisMessage is evaluated there and logMessage never takes mMutex.
+            When false, listeners are called from the thread that logs the message (under mMutex)
+            as in synchronous mode.
+        @param ringBufferSize
+            Maximum number of pending messages. Rounded up to the next power of 2.
+        */
+        void setAsyncEnabled( bool bAsync, bool listenersOnWriterThread = false,
+                              uint32 ringBufferSize = 4096u );
+        bool isAsyncEnabled() const { return mAsync != 0; }
+
+        /// Waits until all the messages logged so far have been written to disk.
+        /// Does nothing if async mode is disabled.
+        void flush();
+
+        /// Internal use.
+        LogAsyncWriter *_getAsyncWriter() const { return mAsync; }
+
+        /// Internal use. Processes pending messages. Called from the writer thread.
+        /// Returns true if at least one message was processed.
+        bool _processAsyncMessages();
         /**
         @remarks
             Register a listener to this log
@@ -137,6 +137,11 @@ namespace Ogre
         /** Sets the level of detail of the default log.
          */
         void setLogDetail( LoggingLevel ll );
+
+        /** Enables or disables asynchronous logging on the default log.
+            See Log::setAsyncEnabled.
+        */
+        void setAsyncEnabled( bool bAsync, bool listenersOnWriterThread = false );
         /** Override standard Singleton retrieval.
         @remarks
         Why do we do this? Well, it's because the Singleton
@@ -416,6 +416,10 @@ namespace Ogre
 
         const LodValueArray *_getLodValueArray() const { return &mLodValues; }
 
+        /// Internal method to copy the LOD schedule of another mesh built with the same
+        /// number of LOD levels (e.g. StaticGeometry). Values must be already transformed.
+        void _setLodValues( const LodValueArray &lodValues ) { mLodValues = lodValues; }
+
         /** Imports a v1 mesh to this mesh, with optional optimization conversions.
             This mesh must be in unloaded state. Resulting mesh would be non-reloadable, use
             MeshManager::createByImportingV1 to create mesh that will survive device lost event.
@@ -464,6 +468,13 @@ namespace Ogre
         /// which are more compatible for doing certain operations vertex operations in the CPU.
         void dearrangeToInefficient();
 
+        /// Calls SubMesh::buildClusters on every SubMesh. The clusters are saved to the mesh
+        /// file, so it's best done offline (e.g. MeshTool); but it can also be called at load time.
+        void buildClusters( uint32 maxTriangles = 124u, uint32 maxVertices = 64u );
+
+        /// Removes the clusters of every SubMesh. See SubMesh::clearClusters
+        void clearClusters();
+
         /// When this bool is false, prepareForShadowMapping will use the same Vaos for
         /// both regular and shadow mapping rendering. When it's true, it will
         /// calculate an optimized version to speed up shadow map rendering (uses a bit
@@ -108,6 +108,7 @@ namespace Ogre
         // Internal methods
         virtual void writeSubMeshNameTable( const Mesh *pMesh );
         virtual void writeMeshHashForCaches( const Mesh *pMesh );
+        virtual void writeMeshClusters( const Mesh *pMesh );
         virtual void writeMesh( const Mesh *pMesh );
         virtual void writeSubMesh( const SubMesh *s, const LodLevelVertexBufferTable &lodVertexTable );
         virtual void writeSubMeshLod( const VertexArrayObject *vao, uint8 lodLevel, uint8 lodSource );
@@ -136,6 +137,7 @@ namespace Ogre
         virtual size_t calcGeometrySize( const VertexBufferPackedVec &vertexData );
         virtual size_t calcVertexDeclSize( const VertexBufferPackedVec &vertexData );
         size_t         calcHashForCachesSize();
+        virtual size_t calcMeshClustersSize( const Mesh *pMesh );
         virtual size_t calcSkeletonLinkSize( const String &skelName );
         virtual size_t calcSubMeshLodOperationSize( const VertexArrayObject *vao );
         virtual size_t calcSubMeshNameTableSize( const Mesh *pMesh );
@@ -157,6 +159,7 @@ namespace Ogre
         virtual void readTextureLayer( DataStreamPtr &stream, Mesh *pMesh, MaterialPtr &pMat );
         virtual void readSubMeshNameTable( DataStreamPtr &stream, Mesh *pMesh );
         virtual void readHashForCaches( DataStreamPtr &stream, Mesh *pMesh );
+        virtual void readMeshClusters( DataStreamPtr &stream, Mesh *pMesh );
         virtual void readMesh( DataStreamPtr &stream, Mesh *pMesh, MeshSerializerListener *listener );
         virtual void readSubMesh( DataStreamPtr &stream, Mesh *pMesh, MeshSerializerListener *listener,
                                   uint8 numVaoPasses );
@@ -219,7 +222,17 @@ namespace Ogre
         VaoManager *mVaoManager;
     };
 
-    class _OgrePrivate MeshSerializerImpl_v2_1_R1 : public MeshSerializerImpl
+    class _OgrePrivate MeshSerializerImpl_v2_1_R2 : public MeshSerializerImpl
+    {
+    public:
+        MeshSerializerImpl_v2_1_R2( VaoManager *vaoManager );
+        ~MeshSerializerImpl_v2_1_R2() override;
+
+    protected:
+        size_t calcMeshClustersSize( const Mesh *pMesh ) override;
+    };
+
+    class _OgrePrivate MeshSerializerImpl_v2_1_R1 : public MeshSerializerImpl_v2_1_R2
     {
     public:
         MeshSerializerImpl_v2_1_R1( VaoManager *vaoManager );
@@ -62,6 +62,18 @@ namespace Ogre
         M_MESH                = 0x3000,
             // Optional hash data for caches
             M_HASH_FOR_CACHES = 0x3200,
+            // Optional cluster (meshlet) data for per-cluster culling. See SubMesh::buildClusters
+            M_MESH_CLUSTERS = 0x3300,
+                M_SUBMESH_CLUSTERS = 0x3310, // Repeating section, one per SubMesh LOD with clusters
+                    // uint16 subMeshIndex
+                    // uint8 lodLevel
+                    // uint32 numClusters
+                    // (the following repeats numClusters times)
+                        // uint32 indexStart
+                        // uint32 indexCount
+                        // float centerX, centerY, centerZ, radius
+                        // float coneApexX, coneApexY, coneApexZ
+                        // float coneAxisX, coneAxisY, coneAxisZ, coneCutoff
 
             // bool skeletallyAnimated   // --removed in 2.1 (flag was never used!)
             // unsigned char numPasses. // Number of caster passes data. Must be 1 or 2.
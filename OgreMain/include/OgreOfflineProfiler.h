@@ -24,6 +24,12 @@ namespace Ogre
         You can use setPaused to halt such growth temporarily, which is
         specially useful if whatever you want to profile is localized to
         particular execution moment.
+    @par
+        Optionally it can also record a timeline (see setTimelineCapacity) which keeps the
+        begin & end timestamps of every sample of every thread in a ring buffer, and
+        export it with dumpTimeline in the Chrome Trace Event format (open it with
+        chrome://tracing or https://ui.perfetto.dev). Unlike the CSV dumps, this shows
+        when each thread was busy or waiting (e.g. on barriers) rather than averages.
     */
     class _OgreExport OfflineProfiler
     {
@@ -38,6 +44,23 @@ namespace Ogre
             FastArray<ProfileSample *> children;
         };
 
+        struct TimelineEvent
+        {
+            uint8  nameStr[OGRE_OFFLINE_PROFILER_NAME_STR_LENGTH];
+            uint64 usStart;
+            /// 0 while the sample hasn't ended yet
+            uint64 usEnd;
+            /// Used to detect if the slot was recycled while the sample was still open
+            uint64 sequence;
+            uint32 frameIdx;
+        };
+
+        struct OpenTimelineEvent
+        {
+            size_t slot;
+            uint64 sequence;
+        };
+
         class PerThreadData
         {
             bool           mPaused;
@@ -49,6 +72,18 @@ namespace Ogre
 
             uint64 mTotalAccumTime;
 
+            /// Added to mTimer so that timestamps from all threads share the same origin
+            uint64 mTimeOffset;
+            uint32 mThreadIdx;
+
+            /// Ring buffer. See OfflineProfiler::setTimelineCapacity
+            TimelineEvent                *mTimeline;
+            size_t                        mTimelineCapacity;
+            size_t                        mTimelineCapacityRequest;
+            uint64                        mTimelineNextSequence;
+            FastArray<OpenTimelineEvent>  mOpenTimelineEvents;
+            uint32 const                 *mFrameIdx;
+
             FastArray<uint8_t *> mMemoryPool;
             size_t               mCurrMemoryPoolOffset;
             size_t               mBytesPerPool;
@@ -58,6 +93,7 @@ namespace Ogre
              * mMemoryPool
              * mCurrMemoryPoolOffset
              * mTotalAccumTime
+             * mTimeline
              */
             LightweightMutex mMutex;
 
@@ -72,18 +108,25 @@ namespace Ogre
 
             void reset();
 
+            void resizeTimeline( size_t capacity );
+
         public:
-            PerThreadData( bool startPaused, size_t bytesPerPool );
+            PerThreadData( bool startPaused, size_t bytesPerPool, uint32 threadIdx,
+                           uint64 timeOffset, size_t timelineCapacity, uint32 const *frameIdx );
             ~PerThreadData();
 
             void setPauseRequest( bool bPause );
             void requestReset();
+            void setTimelineCapacityRequest( size_t capacity );
 
             void profileBegin( const char *name, ProfileSampleFlags::ProfileSampleFlags flags );
             void profileEnd();
 
             void dumpProfileResultsStr( String &outCsvStringPerFrame, String &outCsvStringAccum );
             void dumpProfileResults( const String &fullPathPerFrame, const String &fullPathAccum );
+
+            void dumpTimeline( LwString &tmpStr, String &outJson, uint32 firstFrameIdx,
+                               bool &inOutFirstEvent );
         };
 
         typedef FastArray<PerThreadData *> PerThreadDataArray;
@@ -96,8 +139,14 @@ namespace Ogre
 
         size_t mBytesPerPool;
 
+        /// Shared time origin for all threads
+        Timer *mTimer;
+        uint32 mFrameIdx;
+        size_t mTimelineCapacity;
+
         String mOnShutdownPerFramePath;
         String mOnShutdownAccumPath;
+        String mOnShutdownTimelinePath;
 
         PerThreadData *allocatePerThreadData();
 
@@ -163,6 +212,37 @@ namespace Ogre
         @see    OfflineProfiler::dumpProfileResults
         */
         void setDumpPathsOnShutdown( const String &fullPathPerFrame, const String &fullPathAccum );
+
+        /** Enables recording a timeline of all samples, in addition to the regular collection.
+        @remarks
+            Each thread keeps a ring buffer of the last maxSamplesPerThread samples, thus memory
+            consumption is bounded. Like setPaused, worker threads apply this change the next
+            time they call profileBegin.
+        @param maxSamplesPerThread
+            Capacity of the ring buffer of each thread. 0 disables the timeline and frees
+            its memory.
+        */
+        void   setTimelineCapacity( size_t maxSamplesPerThread );
+        size_t getTimelineCapacity() const { return mTimelineCapacity; }
+
+        /** Exports the timeline in Chrome Trace Event JSON format.
+            Unlike dumpProfileResults, this does not reset the collected data.
+        @param outJson
+            [out] String with the JSON contents.
+        @param lastNumFrames
+            Only samples that started during the last lastNumFrames frames (including the
+            current one) are exported. 0 to export everything still in the ring buffers.
+        */
+        void dumpTimelineStr( String &outJson, uint32 lastNumFrames = 0u );
+
+        /// See dumpTimelineStr. Writes the JSON into the given file.
+        void dumpTimeline( const String &fullPath, uint32 lastNumFrames = 0u );
+
+        /// Ogre will call dumpTimeline for you on shutdown if the path is not empty
+        void setTimelineDumpPathOnShutdown( const String &fullPath );
+
+        /// Called by Root at the end of every frame. See dumpTimelineStr's lastNumFrames
+        void _notifyFrameEnded();
     };
 }  // namespace Ogre
 
@@ -139,6 +139,7 @@ namespace Ogre
     class AxisAlignedBox;
     class AxisAlignedBoxSceneQuery;
     class Barrier;
+    class BillboardChain;
     class BillboardSet;
     class Bone;
     class BoneMemoryManager;
@@ -287,6 +288,7 @@ namespace Ogre
     class ResourceBackgroundQueue;
     class ResourceGroupManager;
     class ResourceManager;
+    class RibbonTrail;
     class Root;
     class RootLayout;
     class SceneManager;
@@ -309,6 +311,7 @@ namespace Ogre
     class SphereSceneQuery;
     class StagingBuffer;
     class StagingTexture;
+    class StaticGeometry;
     class StreamSerialiser;
     class StringConverter;
     class StringInterface;
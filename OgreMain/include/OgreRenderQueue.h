@@ -231,8 +231,13 @@ namespace Ogre
         struct ThreadRenderQueue
         {
             QueuedRenderableArray q;
+            /// Additional draws that may be needed by per-cluster culling, beyond one per
+            /// renderable. See setClusterCullingEnabled
+            size_t numExtraClusterDraws;
             /// The padding prevents false cache sharing when multithreading.
             uint8 padding[128];
+
+            ThreadRenderQueue() : numExtraClusterDraws( 0 ) {}
         };
 
         typedef FastArray<ThreadRenderQueue> QueuedRenderableArrayPerThread;
@@ -283,6 +288,14 @@ namespace Ogre
 
         uint32 mRenderingStarted;
 
+        bool mClusterCullingEnabled;
+
+        bool mInstancingStatsEnabled;
+        /// Stats being collected during the current frame. One per render queue ID.
+        InstancingStats mInstancingStats[256];
+        /// Stats collected during the last frame. One per render queue ID.
+        InstancingStats mLastFrameInstancingStats[256];
+
         std::vector<HlmsCache> mPendingPassCaches;
 
         ParallelHlmsCompileQueue mParallelHlmsCompileQueue;
@@ -323,6 +336,10 @@ namespace Ogre
 
         void warmUpShaders( bool casterPass, const RenderQueueGroup &renderQueueGroup );
 
+        /// Accumulates the stats of a render queue into the current frame, if enabled.
+        void addInstancingStats( const RenderQueueGroup &renderQueueGroup,
+                                 const InstancingStats &stats );
+
     public:
         RenderQueue( HlmsManager *hlmsManager, SceneManager *sceneManager, VaoManager *vaoManager );
         ~RenderQueue();
@@ -434,6 +451,57 @@ namespace Ogre
         */
         void       setSortRenderQueue( uint8 rqId, RqSortMode sortMode );
         RqSortMode getSortRenderQueue( uint8 rqId ) const;
+
+        /** Enables per-cluster culling of meshes that have clusters (see SubMesh::buildClusters).
+            When enabled, the clusters of each queued v2 renderable are tested against the camera
+            frustum and their normal cones (backface culling). Surviving clusters are merged into
+            contiguous index ranges and issued as separate draws in the indirect buffer.
+        @remarks
+            This trades CPU time for GPU vertex & triangle setup time. It pays off for large
+            meshes that are partially visible or seen mostly from one side; and hurts when
+            there are many small meshes, since renderables with clusters can't be instanced
+            together.
+        @par
+            It only applies to the regular (non-shadow caster) passes, and it's not used with
+            instanced stereo. Normal cone culling is only done when the macroblock culls
+            clockwise triangles (the default) and the object isn't mirrored nor
+            non-uniformly scaled.
+        @par
+            Each renderable issues at most 8 draws; ranges beyond that are merged
+            conservatively (i.e. some culled clusters may still be drawn).
+        */
+        void setClusterCullingEnabled( bool bEnabled ) { mClusterCullingEnabled = bEnabled; }
+        bool getClusterCullingEnabled() const { return mClusterCullingEnabled; }
+
+        /** Enables collecting InstancingStats, which tell how many draws each render queue
+            issued, how many renderables got merged together via automatic instancing, and
+            why the rest of them couldn't be merged.
+        @remarks
+            The stats are accumulated across all passes (including shadow passes) and become
+            available once the frame ends, via getInstancingStats. The totals of all
+            SceneManagers are also available in FrameStats::getInstancingStats.
+        @par
+            Particle systems rendered in PARTICLE_SYSTEM mode are not included.
+        */
+        void setInstancingStatsEnabled( bool bEnabled );
+        bool getInstancingStatsEnabled() const { return mInstancingStatsEnabled; }
+
+        /// Returns the InstancingStats collected during the last frame for the given render queue.
+        /// See setInstancingStatsEnabled.
+        const InstancingStats &getInstancingStats( uint8 rqId ) const
+        {
+            return mLastFrameInstancingStats[rqId];
+        }
+
+        /// Returns the sum of the InstancingStats of all render queues during the last frame.
+        InstancingStats getInstancingStatsTotal() const;
+
+        /** Writes a human readable report of the InstancingStats collected during the last frame,
+            listing every render queue that had something to render.
+        @param outReport [out]
+            The report is appended to this string.
+        */
+        void getInstancingStatsReport( String &outReport ) const;
     };
 
 #define OGRE_RQ_MAKE_MASK( x ) ( ( 1 << ( x ) ) - 1 )
@@ -417,6 +417,11 @@ namespace Ogre
         ObjectMemoryManagerVec mForwardPlusMemoryManagerCullList;
         SkeletonAnimManagerVec mSkeletonAnimManagerCulledList;
 
+        /// See setIncrementalDefragment
+        bool   mIncrementalDefragment;
+        size_t mDefragmentMaxSlotsPerFrame;
+        uint64 mDefragmentTimeBudgetUs;
+
         uint32 mNumDecals;
         uint32 mNumCubemapProbes;
 
@@ -495,6 +500,10 @@ namespace Ogre
 
         WireAabbVec mTrackingWireAabbs;
 
+        typedef map<String, StaticGeometry *>::type StaticGeometryMap;
+
+        StaticGeometryMap mStaticGeometryMap;
+
         /** Central list of SceneNodes - for easy memory management.
             @note
                 Note that this list is used only for memory management; the structure of the scene
@@ -1377,6 +1386,33 @@ namespace Ogre
         /// @copydoc ArrayMemoryManager::shrinkToFit
         void shrinkToFitMemoryPools();
 
+        /** Large scenes that destroy many objects in a non-LIFO order at once can stall for
+            a whole frame when the memory pools exceed their cleanup threshold and get
+            defragmented (see ArrayMemoryManager::defragment).
+
+            When enabled, those cleanups get spread across multiple frames instead: every
+            updateSceneGraph compacts at most maxSlotsPerFrame fragmented slots (or stops
+            earlier once timeBudgetUs is exceeded), across all of the memory pools.
+        @remarks
+            Fragmented slots are still reused by newly created objects, and wasted slots
+            keep being processed (i.e. they cost CPU) until they're reclaimed.
+            Skeletons are compacted one SkeletonDef at a time.
+        @param bIncremental
+            True to enable. False to go back to defragmenting everything at once.
+        @param maxSlotsPerFrame
+            Maximum number of fragmented slots to reclaim per frame. Must be > 0.
+            At least one contiguous range is always reclaimed so progress is guaranteed.
+        @param timeBudgetUs
+            Time budget in microseconds. 0 for no time limit.
+        */
+        void setIncrementalDefragment( bool bIncremental, size_t maxSlotsPerFrame = 256u,
+                                       uint64 timeBudgetUs = 0u );
+        bool getIncrementalDefragment() const { return mIncrementalDefragment; }
+
+        /// Called every frame by updateSceneGraph. Does nothing if getIncrementalDefragment
+        /// is false. See setIncrementalDefragment.
+        void _defragmentMemoryPoolsIncremental();
+
         /** Create an Item (instance of a discrete mesh).
             @param
                 meshName The name of the Mesh it is to be based on (e.g. 'knot.oof'). The
@@ -1411,6 +1447,30 @@ namespace Ogre
         void _addWireAabb( WireAabb *wireAabb );
         void _removeWireAabb( WireAabb *wireAabb );
 
+        /** Creates a StaticGeometry instance suitable for use with this SceneManager.
+        @remarks
+            StaticGeometry merges many static Items into a few region-sized Items,
+            see StaticGeometry for details.
+        @param name
+            The name to give the new object. Must be unique.
+        */
+        virtual StaticGeometry *createStaticGeometry( const String &name );
+
+        /// Retrieves a StaticGeometry by name. Throws if not found.
+        virtual StaticGeometry *getStaticGeometry( const String &name ) const;
+
+        /// Returns whether a StaticGeometry instance with the given name exists.
+        virtual bool hasStaticGeometry( const String &name ) const;
+
+        /// Removes & destroys a StaticGeometry and all of its regions.
+        virtual void destroyStaticGeometry( StaticGeometry *geom );
+
+        /// Removes & destroys a StaticGeometry and all of its regions.
+        virtual void destroyStaticGeometry( const String &name );
+
+        /// Removes & destroys all StaticGeometry instances.
+        virtual void destroyAllStaticGeometry();
+
         /** Create an Entity (instance of a discrete mesh).
             @param
                 meshName The name of the Mesh it is to be based on (e.g. 'knot.oof'). The
@@ -1688,6 +1748,15 @@ namespace Ogre
         */
         void destroyAllBillboardSets2();
 
+        /// See ParticleSystemManager2::createBillboardChain.
+        BillboardChain *createBillboardChain2( uint32 maxElements, uint32 numberOfChains );
+
+        /// See ParticleSystemManager2::createRibbonTrail.
+        RibbonTrail *createRibbonTrail2( uint32 maxElements, uint32 numberOfChains );
+
+        /// See ParticleSystemManager2::destroyBillboardChain.
+        void destroyBillboardChain2( BillboardChain *billboardChain );
+
         ParticleSystemManager2 *getParticleSystemManager2() { return mParticleSystemManager2; }
 
         /** Empties the entire scene, inluding all SceneNodes, Entities, Lights,
@@ -2633,6 +2702,17 @@ namespace Ogre
         AxisAlignedBox _calculateCurrentCastersBox( uint32 viewportVisibilityMask, uint8 firstRq,
                                                     uint8 lastRq ) const;
 
+        /** Calculates a hash of all shadow casters (filtered the same way as
+            _calculateCurrentCastersBox) whose world AABB is not fully behind any of the given planes.
+            Casters are hashed by pointer and world AABB, thus the hash changes when a caster
+            enters, leaves, moves, resizes or changes its visibility.
+            Used by CompositorShadowNode to detect when static shadow maps need to be updated.
+        @param planes
+            Array of planes in world space. Can be null if numPlanes == 0.
+        */
+        uint32 _calculateCastersHash( uint32 viewportVisibilityMask, uint8 firstRq, uint8 lastRq,
+                                      const Plane *planes, size_t numPlanes ) const;
+
         /** @see CompositorShadowNode::getCastersBox
         @remarks
             Returns a null box if no active shadow node.
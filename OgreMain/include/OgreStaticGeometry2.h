@@ -0,0 +1,259 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef _OgreStaticGeometry2_H_
+#define _OgreStaticGeometry2_H_
+
+#include "OgrePrerequisites.h"
+
+#include "OgreMesh2.h"
+#include "OgreQuaternion.h"
+#include "OgreVector3.h"
+
+#include "ogrestd/map.h"
+
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre
+{
+    /** \addtogroup Core
+     *  @{
+     */
+    /** \addtogroup Scene
+     *  @{
+     */
+
+    /** Batches large amounts of static geometry into a few Items.
+
+        Each static Item in the scene costs a QueuedRenderable, a cull test and a
+        fillBuffersFor call every frame, even when all of them share the same mesh.
+        StaticGeometry merges the SubMeshes of all the sources added to it into combined
+        VertexArrayObjects, so that thousands of small props become a handful of draws.
+
+        Sources are clustered into regions of a fixed size (see setRegionDimensions), and
+        inside each region they're grouped by datablock, operation type, vertex format and
+        LOD schedule. Each region becomes a single static Item whose SubItems are those
+        groups; and thus each region gets its own Aabb in its ObjectData for culling.
+
+        LODs are preserved: LOD level N of a batch contains LOD level N of each of its
+        sources (or their last level if they have fewer). Because only sources with the
+        same LOD values are batched together, the LOD schedule matches the original meshes.
+        However LOD selection happens per region rather than per source: all the sources
+        merged into an Item switch LOD together, based on the distance to the region (not
+        to each source). Use smaller regions if that is too coarse.
+
+        Regions are rebuilt incrementally: adding, removing or moving a source only marks
+        its region(s) as dirty, and only dirty regions are rebuilt on the next call to
+        build().
+    @remarks
+        Only meshes without skeletons nor poses, using OT_TRIANGLE_LIST, OT_LINE_LIST or
+        OT_POINT_LIST can be added. All the LODs of a SubMesh must use the same vertex format.
+        Positions, normals, tangents and binormals must be in 32-bit or 16-bit floating
+        point; normals may also be QTangents (VET_SHORT4_SNORM).
+    @par
+        Building reads back the vertex and index buffers of the source meshes. This is fast
+        if they have a shadow copy; otherwise it has to download them from the GPU. The data
+        read back is cached for the duration of a build() call, so sharing meshes across
+        sources is cheap.
+    @par
+        The original Items passed to addItem are not modified. You should destroy them
+        (or at least detach them) after adding them, otherwise they will be rendered twice.
+    */
+    class _OgreExport StaticGeometry : public OgreAllocatedObj
+    {
+    public:
+        /// Integer coordinates of a region in the grid
+        struct RegionKey
+        {
+            int32 x;
+            int32 y;
+            int32 z;
+
+            bool operator<( const RegionKey &other ) const
+            {
+                if( this->x != other.x )
+                    return this->x < other.x;
+                if( this->y != other.y )
+                    return this->y < other.y;
+                return this->z < other.z;
+            }
+        };
+
+        struct Source
+        {
+            MeshPtr mesh;
+            /// One per SubMesh
+            FastArray<HlmsDatablock *> datablocks;
+
+            Vector3    position;
+            Quaternion orientation;
+            Vector3    scale;
+
+            RegionKey regionKey;
+            /// False if this slot is free (the source was removed)
+            bool inUse;
+        };
+
+        typedef vector<Source>::type SourceArray;
+
+        struct Region
+        {
+            FastArray<uint32> sources;
+
+            /// One Mesh & Item per LOD schedule found in this region (usually just one)
+            /// The Items are owned by us; they're not known to SceneManager::destroyAllItems
+            vector<MeshPtr>::type meshes;
+            FastArray<Item *>     items;
+            SceneNode            *sceneNode;
+            bool                  dirty;
+        };
+
+        typedef map<RegionKey, Region>::type RegionMap;
+
+    protected:
+        String        mName;
+        SceneManager *mSceneManager;
+
+        Vector3 mRegionDimensions;
+
+        SourceArray       mSources;
+        FastArray<uint32> mFreeSources;
+        RegionMap         mRegions;
+        size_t            mNumDirtyRegions;
+
+        uint32 mVisibilityFlags;
+        uint32 mQueryFlags;
+        uint8  mRenderQueueGroup;
+        bool   mCastShadows;
+        bool   mVisible;
+        Real   mRenderingDistance;
+
+        uint32 mNextMeshId;
+
+        /// Copies of the source buffers read back from the GPU during build(). Defined in cpp
+        struct CpuBufferCache;
+
+        /// Throws if the mesh can't be batched
+        static void validateMesh( const MeshPtr &mesh );
+
+        RegionKey getRegionKey( const Source &source ) const;
+        Vector3   getRegionCenter( const RegionKey &regionKey ) const;
+
+        uint32 allocateSource();
+        void   addToRegion( uint32 sourceId );
+        void   removeFromRegion( uint32 sourceId );
+        void   markDirty( Region &region );
+
+        void destroyRegionGeometry( Region &region );
+        void buildRegion( const RegionKey &regionKey, Region &region, CpuBufferCache &cpuCache );
+        void applySettings( Region &region );
+
+    public:
+        StaticGeometry( const String &name, SceneManager *sceneManager );
+        ~StaticGeometry();
+
+        const String &getName() const { return mName; }
+
+        /** Sets the size of each region. Smaller regions cull better but result in
+            more draws. Changing it marks everything as dirty.
+        @param dimensions
+            Size of each region, in world units. Must be greater than 0.
+        */
+        void           setRegionDimensions( const Vector3 &dimensions );
+        const Vector3 &getRegionDimensions() const { return mRegionDimensions; }
+
+        /** Adds the mesh of the given Item, using its current derived transform and the
+            datablocks assigned to each of its SubItems.
+        @remarks
+            The Item must be attached to a SceneNode. The Item is not modified and no
+            reference to it is kept.
+        @return
+            Id of the source, to be used with setSourceTransform and removeSource.
+        */
+        uint32 addItem( Item *item );
+
+        /** Adds a mesh at the given transform, using the datablocks referenced by the
+            material names of its SubMeshes.
+        @return
+            Id of the source, to be used with setSourceTransform and removeSource.
+        */
+        uint32 addMesh( const MeshPtr &mesh, const Vector3 &position,
+                        const Quaternion &orientation = Quaternion::IDENTITY,
+                        const Vector3    &scale = Vector3::UNIT_SCALE );
+
+        /** Moves a source. Its current region (and its new one, if it changed) will be
+            rebuilt during the next build().
+        */
+        void setSourceTransform( uint32 sourceId, const Vector3 &position,
+                                 const Quaternion &orientation, const Vector3 &scale );
+
+        /// Removes a source. Its region will be rebuilt during the next build().
+        /// The id may be reused by future calls to addItem / addMesh.
+        void removeSource( uint32 sourceId );
+
+        /// Removes all sources and destroys all regions.
+        void removeAllSources();
+
+        /** Rebuilds all the regions which are dirty. Regions that didn't change are
+            left untouched. Call it after you're done adding / removing sources.
+        */
+        void build();
+
+        /// Number of sources currently in use
+        size_t getNumSources() const { return mSources.size() - mFreeSources.size(); }
+        size_t getNumRegions() const { return mRegions.size(); }
+        size_t getNumDirtyRegions() const { return mNumDirtyRegions; }
+
+        const RegionMap &getRegions() const { return mRegions; }
+
+        /// Settings applied to the Items of all regions. See MovableObject.
+        void   setVisibilityFlags( uint32 flags );
+        uint32 getVisibilityFlags() const { return mVisibilityFlags; }
+
+        void   setQueryFlags( uint32 flags );
+        uint32 getQueryFlags() const { return mQueryFlags; }
+
+        void  setRenderQueueGroup( uint8 queueId );
+        uint8 getRenderQueueGroup() const { return mRenderQueueGroup; }
+
+        void setCastShadows( bool castShadows );
+        bool getCastShadows() const { return mCastShadows; }
+
+        void setVisible( bool visible );
+        bool getVisible() const { return mVisible; }
+
+        void setRenderingDistance( Real dist );
+        Real getRenderingDistance() const { return mRenderingDistance; }
+    };
+
+    /** @} */
+    /** @} */
+}  // namespace Ogre
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -117,6 +117,13 @@ namespace Ogre
         std::map<Ogre::String, size_t> mPoseIndexMap;
         TexBufferPacked               *mPoseTexBuffer;
 
+        /// Cluster decomposition of each LOD in mVao[VpNormal]. Empty if there are none.
+        /// An empty entry means that particular LOD has no clusters. See buildClusters.
+        vector<MeshClusterVec>::type mClusters;
+
+        /// Points each Vao in mVao[VpNormal] to its clusters (or to null).
+        void _updateVaoClusters();
+
     public:
         SubMesh();
         ~SubMesh();
@@ -205,6 +212,40 @@ namespace Ogre
 
         void _prepareForShadowMapping( bool forceSameBuffers );
 
+        /** Splits each LOD into clusters (meshlets) of consecutive triangles, and calculates
+            their bounding spheres and normal cones. The RenderQueue can then skip the clusters
+            that are outside the camera's frustum or that are entirely backfacing (see
+            RenderQueue::setClusterCullingEnabled).
+        @remarks
+            Clusters are formed from the existing index order; they don't reorder the triangles.
+            For best results optimize the mesh for the vertex cache first (e.g. MeshTool -I c)
+            so that consecutive triangles are spatially close.
+        @par
+            Only indexed triangle lists are supported. LODs with other operation types are left
+            without clusters. SubMeshes with skeletal or pose animation are skipped entirely,
+            since their bounds would be invalidated by the animation.
+        @par
+            The vertex and index buffers are read back. This is fast if they have a shadow copy,
+            otherwise the data is downloaded from the GPU.
+        @param maxTriangles
+            Maximum number of triangles per cluster.
+        @param maxVertices
+            Maximum number of unique vertices per cluster.
+        */
+        void buildClusters( uint32 maxTriangles = 124u, uint32 maxVertices = 64u );
+
+        /// Removes all the clusters generated by buildClusters
+        void clearClusters();
+
+        bool   hasClusters() const { return !mClusters.empty(); }
+        size_t getNumClusterLods() const { return mClusters.size(); }
+
+        /// Returns the clusters of the given LOD. lodLevel must be < getNumClusterLods()
+        const MeshClusterVec &getClusters( size_t lodLevel ) const { return mClusters[lodLevel]; }
+
+        /// Replaces the clusters of the given LOD. Used by the serializer.
+        void _setClusters( size_t lodLevel, const MeshClusterVec &clusters );
+
         uint16 getNumPoses() { return mNumPoses; }
 
         bool getPoseHalfPrecision() { return mPoseHalfPrecision; }
@@ -0,0 +1,263 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2023 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef OgreBillboardChain2_H
+#define OgreBillboardChain2_H
+
+#include "OgrePrerequisites.h"
+
+#include "Math/Array/OgreArrayConfig.h"
+#include "OgreColourValue.h"
+#include "OgreMovableObject.h"
+#include "OgreRenderable.h"
+
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre
+{
+    OGRE_ASSUME_NONNULL_BEGIN
+
+    class ArrayQuaternion;
+    class ArrayVector4;
+
+    /** v2 version of v1::BillboardChain. Allows the rendering of a chain of connected billboards.
+
+        Terminology is the same as in v1::BillboardChain: a 'chain' (aka segment) has its own
+        head and tail. An 'element' is a single position / width / colour / texcoord entry in
+        a chain. Adding an element to a full chain recycles its tail.
+
+        Unlike its v1 counterpart:
+            - Elements are stored in SoA form (see ArrayVector3) and the vertices are generated
+              by ParticleSystemManager2 from the SceneManager's worker threads, using SIMD.
+            - The vertices are written straight into a BT_DYNAMIC_PERSISTENT buffer, thus
+              there's no locking nor discarding of v1 HardwareVertexBuffers.
+            - The index buffer is immutable. Unused elements collapse into degenerate triangles.
+            - The max number of elements per chain and the number of chains are fixed at
+              creation (they determine the size of the buffers).
+            - Vertices always contain position, colour and texture coordinates.
+            - Camera facing uses ParticleSystemManager2::getCameraPosition(), thus only one
+              camera position per SceneManager is supported.
+
+        Use ParticleSystemManager2::createBillboardChain to create one.
+    */
+    class _OgreExport BillboardChain : public MovableObject, public Renderable
+    {
+        friend class ParticleSystemManager2;
+
+    public:
+        struct _OgreExport Element
+        {
+            Vector3 position;
+            Real    width;
+            /// U or V texture coord depending on options
+            Real        texCoord;
+            ColourValue colour;
+            /// Only used when facing the camera is disabled. See setFaceCamera()
+            Quaternion orientation;
+
+            Element();
+            Element( const Vector3 &position, Real width, Real texCoord, const ColourValue &colour,
+                     const Quaternion &orientation = Quaternion::IDENTITY );
+        };
+
+        /// The direction in which texture coordinates from elements of the chain are used.
+        enum TexCoordDirection
+        {
+            /// Tex coord in elements is treated as the 'u' texture coordinate
+            TCD_U,
+            /// Tex coord in elements is treated as the 'v' texture coordinate
+            TCD_V
+        };
+
+        static const String MOVABLE_TYPE_NAME;
+
+    protected:
+        struct ChainSegment
+        {
+            /// Slot of the 'head' element, relative to the start of the chain.
+            /// The 'tail' is at ( head + numElements - 1 ) % mMaxElementsPerChain
+            uint32 head;
+            uint32 numElements;
+        };
+
+        uint32 mMaxElementsPerChain;
+        /// mMaxElementsPerChain rounded up to a multiple of ARRAY_PACKED_REALS,
+        /// so that each chain starts at its own pack.
+        uint32 mNumSlotsPerChain;
+
+        FastArray<ChainSegment> mChainSegments;
+
+        /// SoA element data. Each array holds mNumSlotsPerChain * numChains entries.
+        ArrayVector3    *ogre_nullable mPositions;
+        ArrayVector3    *ogre_nullable mTangents;
+        ArrayQuaternion *ogre_nullable mOrientations;
+        ArrayReal       *ogre_nullable mWidths;
+        ArrayVector4    *ogre_nullable mColours;
+        Real            *ogre_nullable mTexCoords;
+
+        TexCoordDirection mTexCoordDir;
+        Real              mOtherTexCoordRange[2];
+        bool              mFaceCamera;
+        Vector3           mNormalBase;
+
+        VertexBufferPacked *ogre_nullable mVertexBuffer;
+        /// Valid between ParticleSystemManager2::prepareForUpdate & ParticleSystemManager2::update.
+        uint8 *ogre_nullable mMappedVertices;
+        /// Written by the worker thread that updated us. Local space.
+        Aabb mChainsAabb;
+
+        ParticleSystemManager2 *mParticleSystemManager;
+        size_t                  mGlobalIndex;
+
+        size_t getGlobalSlot( size_t chainIndex, size_t elementIndex ) const;
+
+        void setElement( size_t globalSlot, const Element &element );
+        void getElement( size_t globalSlot, Element &outElement ) const;
+        Vector3 getElementPosition( size_t chainIndex, size_t elementIndex ) const;
+        void setElementPosition( size_t chainIndex, size_t elementIndex, const Vector3 &pos );
+
+        /// Recalculates the tangent of the given element (which depends on its neighbours).
+        void updateTangent( size_t chainIndex, size_t elementIndex );
+        /// Recalculates the tangents of the given element and its neighbours.
+        void updateTangents( size_t chainIndex, size_t elementIndex );
+
+        void createBuffers();
+        void destroyBuffers();
+
+        /// Called from the worker thread, before generating the vertices.
+        /// Derived classes can alter the elements here (e.g. RibbonTrail).
+        virtual void updateElements( Real timeSinceLast );
+
+    public:
+        BillboardChain( IdType id, ObjectMemoryManager *objectMemoryManager, SceneManager *manager,
+                        ParticleSystemManager2 *particleSystemManager, uint32 maxElements,
+                        uint32 numberOfChains );
+        ~BillboardChain() override;
+
+        uint32 getMaxChainElements() const { return mMaxElementsPerChain; }
+        uint32 getNumberOfChains() const { return static_cast<uint32>( mChainSegments.size() ); }
+
+        /** Sets the direction in which texture coords specified on each element
+            are deemed to run along the length of the chain.
+        @param dir
+            The direction, default is TCD_U.
+        */
+        void              setTextureCoordDirection( TexCoordDirection dir ) { mTexCoordDir = dir; }
+        TexCoordDirection getTextureCoordDirection() const { return mTexCoordDir; }
+
+        /** Set the range of the texture coordinates generated across the width of
+            the chain elements.
+        @param start
+            Start coordinate, default 0.0
+        @param end
+            End coordinate, default 1.0
+        */
+        void        setOtherTextureCoordRange( Real start, Real end );
+        const Real *getOtherTextureCoordRange() const { return mOtherTexCoordRange; }
+
+        /** See v1::BillboardChain::setFaceCamera
+        @param faceCamera
+            True to be always facing the camera (Default value: True)
+        @param normalVector
+            Only used when faceCamera == false. Must be a non-zero vector.
+            It gets rotated by the orientation of each element.
+        */
+        void setFaceCamera( bool faceCamera, const Vector3 &normalVector = Vector3::UNIT_X );
+        bool getFaceCamera() const { return mFaceCamera; }
+
+        /** Add an element to the 'head' of a chain.
+        @remarks
+            If this causes the number of elements to exceed the maximum elements
+            per chain, the last element in the chain (the 'tail') will be removed
+            to allow the additional element to be added.
+        @param chainIndex
+            The index of the chain
+        @param element
+            The details to add
+        */
+        void addChainElement( size_t chainIndex, const Element &element );
+
+        /** Remove an element from the 'tail' of a chain.
+        @param chainIndex
+            The index of the chain
+        */
+        void removeChainElement( size_t chainIndex );
+
+        /** Update the details of an existing chain element.
+        @param chainIndex
+            The index of the chain
+        @param elementIndex
+            The element index within the chain, measured from the 'head' of the chain
+        @param element
+            The details to set
+        */
+        void updateChainElement( size_t chainIndex, size_t elementIndex, const Element &element );
+
+        /** Get the detail of a chain element.
+        @param chainIndex
+            The index of the chain
+        @param elementIndex
+            The element index within the chain, measured from the 'head' of the chain
+        */
+        Element getChainElement( size_t chainIndex, size_t elementIndex ) const;
+
+        size_t getNumChainElements( size_t chainIndex ) const;
+
+        /// Remove all elements of a given chain (but leave the chain intact).
+        virtual void clearChain( size_t chainIndex );
+        /// Remove all elements from all chains (but leave the chains themselves intact).
+        void clearAllChains();
+
+        /** Advances derived behaviour and writes the vertices of all chains into the
+            persistently mapped vertex buffer.
+            This function is called from a worker thread. Each thread handles whole BillboardChains.
+        @param camPos
+            Camera position in world space.
+        @param timeSinceLast
+            Time in seconds since last frame.
+        */
+        void _updateParallel( const Vector3 &camPos, Real timeSinceLast );
+
+        /// Main thread. Flushes the vertex buffer and applies the bounds calculated by
+        /// _updateParallel.
+        void _updateSerial();
+
+        const String &getMovableType() const override;
+
+        void             getRenderOperation( v1::RenderOperation &op, bool casterPass ) override;
+        void             getWorldTransforms( Matrix4 *xform ) const override;
+        const LightList &getLights() const override;
+        bool             getCastsShadows() const override;
+    };
+
+    OGRE_ASSUME_NONNULL_END
+}  // namespace Ogre
+
+#include "OgreHeaderSuffix.h"
+
+#endif
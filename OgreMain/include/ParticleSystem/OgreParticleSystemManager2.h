@@ -61,6 +61,8 @@ namespace Ogre
 
         FastArray<BillboardSet *> mBillboardSets;
 
+        FastArray<BillboardChain *> mBillboardChains;
+
         IndexBufferPacked *mSharedIndexBuffer16;
         IndexBufferPacked *mSharedIndexBuffer32;
         uint32             mHighestPossibleQuota16;
@@ -74,6 +76,7 @@ namespace Ogre
         ObjectMemoryManager                  *mMemoryManager;
 
         Vector3                        mCameraPos;
+        Camera const                  *mCameraPosSource;
         FastArray<ParticleSystemDef *> mActiveParticlesLeftToSort;  // GUARDED_BY( mSortMutex )
         LightweightMutex               mSortMutex;
 
@@ -89,6 +92,8 @@ namespace Ogre
 
         void updateSerialPos();
 
+        void addBillboardChain( BillboardChain *billboardChain );
+
     public:
         ParticleSystemManager2( SceneManager *ogre_nullable           sceneManager,
                                 ParticleSystemManager2 *ogre_nullable master );
@@ -182,6 +187,36 @@ namespace Ogre
         /// Do not hold any more references to those pointers as they will become dangling!
         void destroyAllBillboardSets();
 
+        /** Creates a BillboardChain. It is attached to the dynamic root SceneNode.
+        @param maxElements
+            The maximum number of elements per chain. Can't be changed later.
+        @param numberOfChains
+            The number of separate chains contained in this object. Can't be changed later.
+        @return
+            Pointer to newly created BillboardChain.
+        */
+        BillboardChain *createBillboardChain( uint32 maxElements, uint32 numberOfChains );
+
+        /** Creates a RibbonTrail. It is attached to the dynamic root SceneNode.
+        @param maxElements
+            The maximum number of elements per chain. Can't be changed later.
+        @param numberOfChains
+            The maximum number of Nodes that can be tracked. Can't be changed later.
+        @return
+            Pointer to newly created RibbonTrail.
+        */
+        RibbonTrail *createRibbonTrail( uint32 maxElements, uint32 numberOfChains );
+
+        /** Destroys a BillboardChain created with createBillboardChain() or createRibbonTrail().
+        @param billboardChain
+            Chain to destroy.
+        */
+        void destroyBillboardChain( BillboardChain *billboardChain );
+
+        /// Destroys all BillboardChain & RibbonTrails created by us.
+        /// Do not hold any more references to those pointers as they will become dangling!
+        void destroyAllBillboardChains();
+
         /** Instructs us to add all the ParticleSystemDef to the RenderQueue that match the given
             renderQueueId and pass the visibilityMask.
         @param threadIdx
@@ -212,6 +247,12 @@ namespace Ogre
             This value does not control rendering. It's not instantaneous. It merely tells the
             simulation which systems should be prioritized for emission for this frame.
 
+            The exception are BillboardChains & RibbonTrails facing the camera, which are built
+            on the CPU facing this position.
+
+            If a camera was set via setCameraPositionSource, the SceneManager overwrites
+            this value every frame.
+
         @param camPos
             Camera position
         */
@@ -219,6 +260,18 @@ namespace Ogre
 
         const Vector3 &getCameraPosition() const { return mCameraPos; }
 
+        /** Makes SceneManager::updateSceneGraph set the camera position every frame from the
+            derived position of the given camera, so that setCameraPosition doesn't need to be
+            called manually. See setCameraPosition.
+        @remarks
+            Null by default. If the camera is destroyed, the source is reset to null.
+        @param camera
+            Camera to follow. Null to set the position manually with setCameraPosition.
+        */
+        void setCameraPositionSource( const Camera *camera ) { mCameraPosSource = camera; }
+
+        const Camera *getCameraPositionSource() const { return mCameraPosSource; }
+
         /** The order of function calls is:
                 1. manager->prepareForUpdate( timeSinceLast ) (main thread)
                 2. manager->_prepareParallel() (from many threads)
@@ -263,6 +316,8 @@ namespace Ogre
             This function is in charge of advancing the simulation of each particle forward.
             Each thread handles one particle (i.e. 2 threads won't concurrently access the same
             ParticleCpuData).
+            @par
+            It also updates the BillboardChains. Each thread handles whole BillboardChains.
         */
         void _updateParallel02( size_t threadIdx, size_t numThreads );
 
@@ -0,0 +1,147 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2023 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef OgreRibbonTrail2_H
+#define OgreRibbonTrail2_H
+
+#include "ParticleSystem/OgreBillboardChain2.h"
+
+#include "OgreNode.h"
+
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre
+{
+    OGRE_ASSUME_NONNULL_BEGIN
+
+    /** v2 version of v1::RibbonTrail. Leaves a trail behind one or more Nodes.
+
+        Each tracked Node uses its own chain. Every frame the derived position of the Node is
+        polled from the worker threads (there is no need for Node::Listener::nodeUpdated nor
+        a Controller to drive the fading), and the width & colour of the elements are faded
+        using SIMD.
+
+        See v1::RibbonTrail for the remaining behaviour, which is the same.
+
+        Use ParticleSystemManager2::createRibbonTrail to create one.
+    */
+    class _OgreExport RibbonTrail : public BillboardChain, public Node::Listener
+    {
+    protected:
+        /// Ordered by chain index. Null if the chain is not tracking any Node.
+        FastArray<Node *> mTrackedNodes;
+
+        /// Total length of trail in world units
+        Real mTrailLength;
+        /// length of each element
+        Real mElemLength;
+        /// Squared length of each element
+        Real mSquaredElemLength;
+
+        FastArray<ColourValue> mInitialColour;
+        /// Fade amount per second
+        FastArray<ColourValue> mDeltaColour;
+        FastArray<Real>        mInitialWidth;
+        /// Width reduction per second
+        FastArray<Real> mDeltaWidth;
+
+        /// Node has changed position, update. Called from worker thread.
+        void updateTrail( size_t chainIndex, Node *node );
+        /// Apply width & colour fading to a chain. Called from worker thread.
+        void fadeChain( size_t chainIndex, Real timeSinceLast );
+        /// Reset the tracked chain to initial state
+        void resetTrail( size_t chainIndex, Node *node );
+
+        void updateElements( Real timeSinceLast ) override;
+
+    public:
+        static const String MOVABLE_TYPE_NAME;
+
+        RibbonTrail( IdType id, ObjectMemoryManager *objectMemoryManager, SceneManager *manager,
+                     ParticleSystemManager2 *particleSystemManager, uint32 maxElements,
+                     uint32 numberOfChains );
+        ~RibbonTrail() override;
+
+        /** Add a node to be tracked.
+        @remarks
+            The Node must not have a listener already.
+        @param n
+            The node that will be tracked.
+        */
+        void addNode( Node *n );
+        /// Remove tracking on a given node.
+        void removeNode( const Node *n );
+        /// Get the chain index for a given Node being tracked. Throws if not tracked.
+        size_t getChainIndexForNode( const Node *n ) const;
+
+        /** Set the length of the trail.
+        @remarks
+            This sets the length of the trail, in world units. It also sets how
+            far apart each segment will be, ie length / max_elements.
+        @param len
+            The length of the trail in world units
+        */
+        void setTrailLength( Real len );
+        Real getTrailLength() const { return mTrailLength; }
+
+        /// See BillboardChain::clearChain. Tracked chains restart from the Node's position.
+        void clearChain( size_t chainIndex ) override;
+
+        /// Set the starting ribbon colour for a given chain.
+        void               setInitialColour( size_t chainIndex, const ColourValue &col );
+        const ColourValue &getInitialColour( size_t chainIndex ) const;
+
+        /** Enables / disables fading the trail using colour.
+        @param chainIndex
+            The index of the chain
+        @param valuePerSecond
+            The amount to subtract from colour each second
+        */
+        void               setColourChange( size_t chainIndex, const ColourValue &valuePerSecond );
+        const ColourValue &getColourChange( size_t chainIndex ) const;
+
+        /// Set the starting ribbon width in world units.
+        void setInitialWidth( size_t chainIndex, Real width );
+        Real getInitialWidth( size_t chainIndex ) const;
+
+        /// Set the change in ribbon width per second.
+        void setWidthChange( size_t chainIndex, Real widthDeltaPerSecond );
+        Real getWidthChange( size_t chainIndex ) const;
+
+        /// @see Node::Listener::nodeDestroyed
+        void nodeDestroyed( const Node *node ) override;
+
+        const String &getMovableType() const override;
+    };
+
+    OGRE_ASSUME_NONNULL_END
+}  // namespace Ogre
+
+#include "OgreHeaderSuffix.h"
+
+#endif
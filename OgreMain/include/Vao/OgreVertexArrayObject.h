@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "OgrePrerequisites.h"
 
 #include "OgreRenderOperation.h"
+#include "OgreVector3.h"
 #include "OgreVertexBufferPacked.h"
 
 namespace Ogre
@@ -43,6 +44,31 @@ namespace Ogre
     /// to a new VertexBuffer to know when to reuse an existing one while cloning.
     typedef map<VertexBufferPacked *, VertexBufferPacked *>::type SharedVertexBufferMap;
 
+    /** A small group of consecutive triangles (a.k.a. meshlet) with conservative bounds,
+        so that it can be culled independently from the rest of the mesh.
+        See SubMesh::buildClusters.
+    */
+    struct MeshCluster
+    {
+        /// Range in the index buffer. Like VertexArrayObject::mPrimStart, it's absolute
+        /// (i.e. it isn't relative to the primitive start of the Vao).
+        uint32 indexStart;
+        uint32 indexCount;
+
+        /// Bounding sphere, in object space
+        Vector3 center;
+        Real    radius;
+
+        /// Normal cone, in object space. The cluster is entirely backfacing when
+        /// dot( normalise( coneApex - cameraPos ), coneAxis ) >= coneCutoff.
+        /// A degenerate cone has coneCutoff = 1 and coneAxis = 0, which never culls.
+        Vector3 coneApex;
+        Vector3 coneAxis;
+        Real    coneCutoff;
+    };
+
+    typedef vector<MeshCluster>::type MeshClusterVec;
+
     /** Vertex array objects (Vaos) are immutable objects that describe a
         combination of vertex buffers and index buffer with a given operation
         type. Once created, they can't be modified. You have to destroy them
@@ -94,6 +120,9 @@ namespace Ogre
         /// The type of operation to perform
         OperationType mOperationType;
 
+        /// Cluster decomposition of the primitive range. Not owned by us, may be null.
+        MeshClusterVec const *mClusters;
+
     public:
         VertexArrayObject( uint32 vaoName, uint32 renderQueueId, uint16 inputLayoutId,
                            const VertexBufferPackedVec &vertexBuffers, IndexBufferPacked *indexBuffer,
@@ -112,6 +141,17 @@ namespace Ogre
         uint32 getPrimitiveStart() const { return mPrimStart; }
         uint32 getPrimitiveCount() const { return mPrimCount; }
 
+        /// Returns the cluster decomposition of this Vao, if any. See SubMesh::buildClusters.
+        const MeshClusterVec *getClusters() const { return mClusters; }
+
+        /** Sets the cluster decomposition used by the RenderQueue for per-cluster culling.
+            The pointer must stay valid for as long as it's assigned. Set it to null to disable.
+        @remarks
+            The clusters must be built against the current primitive range. If you call
+            setPrimitiveRange afterwards, the clusters must be rebuilt.
+        */
+        void _setClusters( const MeshClusterVec *clusters ) { mClusters = clusters; }
+
         /** Limits the range of triangle primitives that is rendered.
             For VAOs with index buffers, this controls the index start & count,
             akin to indexStart & indexCount from the v1 objects.
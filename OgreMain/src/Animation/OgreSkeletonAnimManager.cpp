@@ -85,6 +85,8 @@ namespace Ogre
         }
     }
 
+    //-----------------------------------------------------------------------
+    SkeletonAnimManager::SkeletonAnimManager() : incrementalDefragment( false ) {}
     //-----------------------------------------------------------------------
     SkeletonInstance *SkeletonAnimManager::createSkeletonInstance( const SkeletonDef *skeletonDef,
                                                                    size_t numWorkerThreads )
@@ -96,6 +98,8 @@ namespace Ogre
         {
             bySkeletonDefs.push_front( BySkeletonDef( skeletonDef, numWorkerThreads ) );
             bySkeletonDefs.front().initializeMemoryManager();
+            bySkeletonDefs.front().boneMemoryManager.setIncrementalDefragment(
+                incrementalDefragment );
             itor = bySkeletonDefs.begin();
         }
 
@@ -206,4 +210,38 @@ namespace Ogre
 
         bySkeletonDefs.erase( itor );
     }
+    //-----------------------------------------------------------------------
+    void SkeletonAnimManager::setIncrementalDefragment( bool bIncremental )
+    {
+        incrementalDefragment = bIncremental;
+
+        BySkeletonDefList::iterator itor = bySkeletonDefs.begin();
+        BySkeletonDefList::iterator endt = bySkeletonDefs.end();
+
+        while( itor != endt )
+        {
+            itor->boneMemoryManager.setIncrementalDefragment( bIncremental );
+            ++itor;
+        }
+    }
+    //-----------------------------------------------------------------------
+    bool SkeletonAnimManager::defragmentIncremental( ArrayMemoryManager::DefragmentBudget &budget )
+    {
+        bool pending = false;
+
+        BySkeletonDefList::iterator itor = bySkeletonDefs.begin();
+        BySkeletonDefList::iterator endt = bySkeletonDefs.end();
+
+        while( itor != endt )
+        {
+            const size_t slotsLeft = budget.slotsLeft;
+            if( itor->boneMemoryManager.defragmentIncremental( budget ) )
+                pending = true;
+            else if( slotsLeft != budget.slotsLeft )
+                itor->updateThreadStarts();  // Memory blocks have changed
+            ++itor;
+        }
+
+        return pending;
+    }
 }  // namespace Ogre
@@ -307,7 +307,8 @@ namespace Ogre
         }
     }
     //-----------------------------------------------------------------------------------
-    void SkeletonAnimation::_applyAnimation( const TransformArray &boneTransforms )
+    void SkeletonAnimation::_applyAnimation( const TransformArray &boneTransforms,
+                                             size_t maxDepthLevel )
     {
         SkeletonTrackVec::const_iterator itor = mDefinition->mTracks.begin();
         SkeletonTrackVec::const_iterator endt = mDefinition->mTracks.end();
@@ -317,7 +318,8 @@ namespace Ogre
         ArrayReal simdWeight = Mathlib::SetAll( mWeight );
         ArrayReal *RESTRICT_ALIAS boneWeights = mBoneWeights.get();
 
-        while( itor != endt )
+        // Tracks are sorted by block index, thus by depth level
+        while( itor != endt && ( itor->getBoneBlockIdx() >> 24u ) <= maxDepthLevel )
         {
             itor->applyKeyFrameRigAt( *itLastKnownKeyFrame, mCurrentFrame, simdWeight, boneWeights,
                                       boneTransforms );
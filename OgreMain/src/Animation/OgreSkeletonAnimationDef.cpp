@@ -43,11 +43,20 @@ THE SOFTWARE.
 
 namespace Ogre
 {
+    struct OrderKeyFrameRigByAddress
+    {
+        bool operator()( const KeyFrameRig *a, const KeyFrameRig *b ) const
+        {
+            return a->mBoneTransform < b->mBoneTransform;
+        }
+    };
+    //-----------------------------------------------------------------------------------
     SkeletonAnimationDef::SkeletonAnimationDef() :
         mNumFrames( 0 ),
         mOriginalFrameRate( 25.0f ),
         mSkeletonDef( 0 ),
-        mKfTransformMemoryManager( 0 )
+        mKfTransformMemoryManager( 0 ),
+        mQuantizedKeyFrameData( 0 )
     {
     }
     //-----------------------------------------------------------------------------------
@@ -61,6 +70,12 @@ namespace Ogre
             delete mKfTransformMemoryManager;
             mKfTransformMemoryManager = 0;
         }
+
+        if( mQuantizedKeyFrameData )
+        {
+            OGRE_FREE_SIMD( mQuantizedKeyFrameData, MEMCATEGORY_ANIMATION );
+            mQuantizedKeyFrameData = 0;
+        }
     }
     //-----------------------------------------------------------------------------------
     void SkeletonAnimationDef::build( const v1::Skeleton *skeleton, const v1::Animation *animation,
@@ -219,6 +234,201 @@ namespace Ogre
         }
     }
     //-----------------------------------------------------------------------------------
+    void SkeletonAnimationDef::optimizeKeyFrames( Real positionTolerance, Radian orientationTolerance,
+                                                  Real scaleTolerance )
+    {
+        if( mQuantizedKeyFrameData )
+        {
+            OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS,
+                         "Animation '" + mName +
+                             "' is already quantized. Call optimizeKeyFrames before "
+                             "quantizeKeyFrames",
+                         "SkeletonAnimationDef::optimizeKeyFrames" );
+        }
+
+        // 1st pass: reduce the keyframes of every track, and discard the tracks that do nothing.
+        vector<size_t>::type oldToNewTrackIdx;
+        oldToNewTrackIdx.reserve( mTracks.size() );
+
+        SkeletonTrackVec newTracks;
+        newTracks.reserve( mTracks.size() );
+
+        size_t numKeyFrames = 0;
+
+        SkeletonTrackVec::iterator itTrack = mTracks.begin();
+        SkeletonTrackVec::iterator enTrack = mTracks.end();
+
+        while( itTrack != enTrack )
+        {
+            itTrack->_reduceKeyFrames( positionTolerance, orientationTolerance, scaleTolerance );
+
+            if( itTrack->isConstantIdentity( positionTolerance, orientationTolerance,
+                                             scaleTolerance ) )
+            {
+                oldToNewTrackIdx.push_back( std::numeric_limits<size_t>::max() );
+            }
+            else
+            {
+                oldToNewTrackIdx.push_back( newTracks.size() );
+                newTracks.push_back( *itTrack );
+                numKeyFrames += itTrack->getKeyFrames().size();
+            }
+
+            ++itTrack;
+        }
+
+        // 2nd pass: repack the surviving keyframes. Sorting them by their old address
+        // preserves the interleaved order set by allocateCacheFriendlyKeyframes.
+        vector<KeyFrameRig *>::type keyFrames;
+        keyFrames.reserve( numKeyFrames );
+
+        itTrack = newTracks.begin();
+        enTrack = newTracks.end();
+        while( itTrack != enTrack )
+        {
+            KeyFrameRigVec &trackKeyFrames = itTrack->_getKeyFrames();
+            KeyFrameRigVec::iterator itKeys = trackKeyFrames.begin();
+            KeyFrameRigVec::iterator enKeys = trackKeyFrames.end();
+            while( itKeys != enKeys )
+                keyFrames.push_back( &( *itKeys++ ) );
+            ++itTrack;
+        }
+
+        std::sort( keyFrames.begin(), keyFrames.end(), OrderKeyFrameRigByAddress() );
+
+        KfTransformArrayMemoryManager *newMemoryManager = 0;
+        if( numKeyFrames > 0u )
+        {
+            newMemoryManager = new KfTransformArrayMemoryManager(
+                0, numKeyFrames * ARRAY_PACKED_REALS, std::numeric_limits<size_t>::max(),
+                numKeyFrames * ARRAY_PACKED_REALS );
+            newMemoryManager->initialize();
+        }
+
+        vector<KeyFrameRig *>::type::const_iterator itKeys = keyFrames.begin();
+        vector<KeyFrameRig *>::type::const_iterator enKeys = keyFrames.end();
+        while( itKeys != enKeys )
+        {
+            KfTransform *newTransform;
+            newMemoryManager->createNewNode( &newTransform );
+            *newTransform = *( *itKeys )->mBoneTransform;
+            ( *itKeys )->mBoneTransform = newTransform;
+            ++itKeys;
+        }
+
+        itTrack = newTracks.begin();
+        enTrack = newTracks.end();
+        while( itTrack != enTrack )
+        {
+            itTrack->_setMemoryManager( newMemoryManager );
+            ++itTrack;
+        }
+
+        mTracks.swap( newTracks );
+
+        if( mKfTransformMemoryManager )
+        {
+            mKfTransformMemoryManager->destroy();
+            delete mKfTransformMemoryManager;
+        }
+        mKfTransformMemoryManager = newMemoryManager;
+
+        // 3rd pass: the track index is encoded in mBoneToWeights. Update it
+        // and remove the bones whose track has been discarded.
+        map<IdString, size_t>::type::iterator itBone = mBoneToWeights.begin();
+        map<IdString, size_t>::type::iterator enBone = mBoneToWeights.end();
+        while( itBone != enBone )
+        {
+            const size_t offset = itBone->second & 0x00FFFFFF;
+            const size_t newTrackIdx = oldToNewTrackIdx[offset / ARRAY_PACKED_REALS];
+
+            if( newTrackIdx == std::numeric_limits<size_t>::max() )
+            {
+                mBoneToWeights.erase( itBone++ );
+            }
+            else
+            {
+                itBone->second = ( itBone->second & 0xFF000000 ) |
+                                 ( newTrackIdx * ARRAY_PACKED_REALS + offset % ARRAY_PACKED_REALS );
+                ++itBone;
+            }
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    void SkeletonAnimationDef::quantizeKeyFrames()
+    {
+        if( mQuantizedKeyFrameData || mTracks.empty() )
+            return;
+
+        size_t numUint16 = 0;
+
+        SkeletonTrackVec::iterator itTrack = mTracks.begin();
+        SkeletonTrackVec::iterator enTrack = mTracks.end();
+        while( itTrack != enTrack )
+        {
+            numUint16 += itTrack->_getQuantizedStride() * itTrack->getKeyFrames().size();
+            ++itTrack;
+        }
+
+        const size_t rangesSize = mTracks.size() * sizeof( QuantizedKfRange );
+        mQuantizedKeyFrameData = reinterpret_cast<uint8 *>(
+            OGRE_MALLOC_SIMD( rangesSize + numUint16 * sizeof( uint16 ), MEMCATEGORY_ANIMATION ) );
+
+        QuantizedKfRange *ranges = reinterpret_cast<QuantizedKfRange *>( mQuantizedKeyFrameData );
+        uint16 *keyFrames = reinterpret_cast<uint16 *>( mQuantizedKeyFrameData + rangesSize );
+
+        itTrack = mTracks.begin();
+        while( itTrack != enTrack )
+        {
+            const size_t trackSize = itTrack->_getQuantizedStride() * itTrack->getKeyFrames().size();
+            itTrack->_quantizeKeyFrames( ranges++, keyFrames );
+            keyFrames += trackSize;
+            ++itTrack;
+        }
+
+        if( mKfTransformMemoryManager )
+        {
+            mKfTransformMemoryManager->destroy();
+            delete mKfTransformMemoryManager;
+            mKfTransformMemoryManager = 0;
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    size_t SkeletonAnimationDef::getKeyFrameMemoryUsage() const
+    {
+        size_t retVal = 0;
+        SkeletonTrackVec::const_iterator itor = mTracks.begin();
+        SkeletonTrackVec::const_iterator endt = mTracks.end();
+        while( itor != endt )
+        {
+            if( itor->isQuantized() )
+            {
+                retVal += sizeof( QuantizedKfRange ) +
+                          itor->_getQuantizedStride() * itor->getKeyFrames().size() * sizeof( uint16 );
+            }
+            else
+            {
+                retVal += itor->getKeyFrames().size() * sizeof( KfTransform );
+            }
+            retVal += itor->getKeyFrames().size() * sizeof( KeyFrameRig );
+            ++itor;
+        }
+        return retVal;
+    }
+    //-----------------------------------------------------------------------------------
+    size_t SkeletonAnimationDef::getNumKeyFrames() const
+    {
+        size_t numKeyFrames = 0;
+        SkeletonTrackVec::const_iterator itor = mTracks.begin();
+        SkeletonTrackVec::const_iterator endt = mTracks.end();
+        while( itor != endt )
+        {
+            numKeyFrames += itor->getKeyFrames().size();
+            ++itor;
+        }
+        return numKeyFrames;
+    }
+    //-----------------------------------------------------------------------------------
     void SkeletonAnimationDef::getInterpolatedUnnormalizedKeyFrame( v1::OldNodeAnimationTrack *oldTrack,
                                                                     const v1::TimeIndex &timeIndex,
                                                                     v1::TransformKeyFrame *kf )
@@ -411,22 +621,14 @@ namespace Ogre
                     outText += boneDef.name;
                     outText += ",";
 
-                    KeyFrameRigVec::const_iterator itKeyFrames = keyFrames.begin();
-                    KeyFrameRigVec::const_iterator enKeyFrames = keyFrames.end();
-
-                    while( itKeyFrames != enKeyFrames )
+                    for( size_t keyFrameIdx = 0; keyFrameIdx < keyFrames.size(); ++keyFrameIdx )
                     {
-                        outText += StringConverter::toString( itKeyFrames->mFrame );
+                        outText += StringConverter::toString( keyFrames[keyFrameIdx].mFrame );
                         outText += ",";
 
-                        const KfTransform *RESTRICT_ALIAS boneTransform = itKeyFrames->mBoneTransform;
-
                         Vector3 vPos, vScale;
                         Quaternion qRot;
-
-                        boneTransform->mPosition.getAsVector3( vPos, i );
-                        boneTransform->mOrientation.getAsQuaternion( qRot, i );
-                        boneTransform->mScale.getAsVector3( vScale, i );
+                        track.getKeyFrameTransform( keyFrameIdx, i, vPos, qRot, vScale );
 
                         outText += StringConverter::toString( vPos.x ) + ",";
                         outText += StringConverter::toString( vPos.y ) + ",";
@@ -438,7 +640,6 @@ namespace Ogre
                         outText += StringConverter::toString( vScale.x ) + ",";
                         outText += StringConverter::toString( vScale.y ) + ",";
                         outText += StringConverter::toString( vScale.z ) + ",";
-                        ++itKeyFrames;
                     }
 
                     outText += "\n";
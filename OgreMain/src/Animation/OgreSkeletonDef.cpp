@@ -310,6 +310,31 @@ namespace Ogre
         }
     }
     //-----------------------------------------------------------------------------------
+    void SkeletonDef::optimizeAnimationKeyFrames( Real positionTolerance, Radian orientationTolerance,
+                                                  Real scaleTolerance )
+    {
+        SkeletonAnimationDefVec::iterator itor = mAnimationDefs.begin();
+        SkeletonAnimationDefVec::iterator endt = mAnimationDefs.end();
+
+        while( itor != endt )
+        {
+            itor->optimizeKeyFrames( positionTolerance, orientationTolerance, scaleTolerance );
+            ++itor;
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    void SkeletonDef::quantizeAnimationKeyFrames()
+    {
+        SkeletonAnimationDefVec::iterator itor = mAnimationDefs.begin();
+        SkeletonAnimationDefVec::iterator endt = mAnimationDefs.end();
+
+        while( itor != endt )
+        {
+            itor->quantizeKeyFrames();
+            ++itor;
+        }
+    }
+    //-----------------------------------------------------------------------------------
     void SkeletonDef::getBonesPerDepth( vector<size_t>::type &out ) const
     {
         out.clear();
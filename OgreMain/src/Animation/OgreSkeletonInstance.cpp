@@ -34,6 +34,8 @@ THE SOFTWARE.
 #include "Animation/OgreSkeletonDef.h"
 #include "Animation/OgreSkeletonManager.h"
 #include "OgreId.h"
+#include "OgreLodStrategy.h"
+#include "OgreLodStrategyManager.h"
 #include "OgreOldBone.h"
 #include "OgreSceneNode.h"
 #include "OgreSkeleton.h"
@@ -49,6 +51,10 @@ namespace Ogre
                                         BoneMemoryManager *boneMemoryManager ) :
         mDefinition( skeletonDef ),
         mParentNode( 0 ),
+        mFramesUntilUpdate( 0 ),
+        mFreezeWhenNotVisible( false ),
+        mLodBlendFrames( 1u ),
+        mLodBlendFrame( 1u ),
         mRefCount( 1 )
     {
         mBones.resize( mDefinition->getBones().size(), Bone() );
@@ -240,19 +246,263 @@ namespace Ogre
     //-----------------------------------------------------------------------------------
     void SkeletonInstance::update()
     {
-        if( !mActiveAnimations.empty() )
-            resetToPose();
+        size_t maxDepthLevel = std::numeric_limits<size_t>::max();
+        if( !updateAnimationLod( maxDepthLevel ) )
+        {
+            // Animations were skipped this frame. Keep moving towards the last evaluated pose.
+            if( mLodBlendFrame < mLodBlendFrames )
+            {
+                ++mLodBlendFrame;
+                blendLodPoses( Real( mLodBlendFrame ) / Real( mLodBlendFrames ) );
+            }
+            return;
+        }
+
+        if( mActiveAnimations.empty() )
+        {
+            mLodBlendFrame = mLodBlendFrames;
+            return;
+        }
+
+        const bool interpolate = mLodBlendFrames > 1u;
+        const size_t numBoneBlocks =
+            mDefinition->getNumberOfBoneBlocks( mDefinition->getDepthLevelInfo().size() );
+
+        if( interpolate )
+            saveLodPose( mLodPoses.get() );
+
+        resetToPose();
 
         ActiveAnimationsVec::iterator itor = mActiveAnimations.begin();
         ActiveAnimationsVec::iterator endt = mActiveAnimations.end();
 
         while( itor != endt )
         {
-            ( *itor )->_applyAnimation( mBoneStartTransforms );
+            ( *itor )->_applyAnimation( mBoneStartTransforms, maxDepthLevel );
+            ++itor;
+        }
+
+        mLodBlendFrame = 1u;
+        if( interpolate )
+        {
+            saveLodPose( mLodPoses.get() + numBoneBlocks );
+            blendLodPoses( Real( 1.0f ) / Real( mLodBlendFrames ) );
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    bool SkeletonInstance::updateAnimationLod( size_t &outMaxDepthLevel )
+    {
+        if( mLodSources.empty() )
+        {
+            mLodBlendFrames = 1u;
+            return true;
+        }
+
+        Real lodValue = std::numeric_limits<Real>::max();
+        bool wasVisible = false;
+
+        LodSourceVec::iterator itSrc = mLodSources.begin();
+        LodSourceVec::iterator enSrc = mLodSources.end();
+
+        while( itSrc != enSrc )
+        {
+            lodValue = std::min( lodValue, itSrc->lodValue );
+            wasVisible |= itSrc->visibleSinceLastUpdate;
+            itSrc->lodValue = std::numeric_limits<Real>::max();
+            itSrc->visibleSinceLastUpdate = false;
+            ++itSrc;
+        }
+
+        if( mFreezeWhenNotVisible && !wasVisible )
+            return false;
+
+        if( mAnimationLods.empty() || lodValue == std::numeric_limits<Real>::max() )
+        {
+            // No LOD info from the last frame. Use full detail.
+            mLodBlendFrames = 1u;
+            return true;
+        }
+
+        SkeletonAnimationLodVec::const_iterator itor = mAnimationLods.begin();
+        SkeletonAnimationLodVec::const_iterator endt = mAnimationLods.end();
+        SkeletonAnimationLodVec::const_iterator selected = itor;
+        while( itor != endt && itor->lodValue <= lodValue )
+            selected = itor++;
+
+        outMaxDepthLevel = selected->maxDepthLevel;
+
+        const uint32 updateInterval = std::max<uint32>( selected->updateInterval, 1u );
+        if( mFramesUntilUpdate >= updateInterval )
+        {
+            // We've just switched to a more frequent LOD level. Stagger the updates
+            // across instances so they don't all happen in the same frame.
+            mFramesUntilUpdate =
+                static_cast<uint32>( reinterpret_cast<uintptr_t>( this ) / sizeof( *this ) ) %
+                updateInterval;
+        }
+
+        if( mFramesUntilUpdate > 0u )
+        {
+            --mFramesUntilUpdate;
+            return false;
+        }
+
+        mFramesUntilUpdate = updateInterval - 1u;
+        mLodBlendFrames = mLodPoses.get() ? updateInterval : 1u;
+        return true;
+    }
+    //-----------------------------------------------------------------------------------
+    void SkeletonInstance::saveLodPose( KfTransform *RESTRICT_ALIAS outPose ) const
+    {
+        SkeletonDef::DepthLevelInfoVec::const_iterator itDepthLevelInfo =
+            mDefinition->getDepthLevelInfo().begin();
+
+        TransformArray::const_iterator itor = mBoneStartTransforms.begin();
+        TransformArray::const_iterator endt = mBoneStartTransforms.end();
+
+        while( itor != endt )
+        {
+            BoneTransform t = *itor;
+            for( size_t i = 0; i < itDepthLevelInfo->numBonesInLevel; i += ARRAY_PACKED_REALS )
+            {
+                outPose->mPosition = *t.mPosition;
+                outPose->mOrientation = *t.mOrientation;
+                outPose->mScale = *t.mScale;
+                t.advancePack();
+
+                ++outPose;
+            }
+
             ++itor;
+            ++itDepthLevelInfo;
         }
     }
     //-----------------------------------------------------------------------------------
+    void SkeletonInstance::blendLodPoses( Real weight )
+    {
+        const size_t numBoneBlocks =
+            mDefinition->getNumberOfBoneBlocks( mDefinition->getDepthLevelInfo().size() );
+
+        KfTransform const *RESTRICT_ALIAS prevPose = mLodPoses.get();
+        KfTransform const *RESTRICT_ALIAS targetPose = mLodPoses.get() + numBoneBlocks;
+        ArrayReal const *RESTRICT_ALIAS manualBones = mManualBones.get();
+
+        const ArrayReal w = Mathlib::SetAll( weight );
+
+        SkeletonDef::DepthLevelInfoVec::const_iterator itDepthLevelInfo =
+            mDefinition->getDepthLevelInfo().begin();
+
+        TransformArray::iterator itor = mBoneStartTransforms.begin();
+        TransformArray::iterator endt = mBoneStartTransforms.end();
+
+        while( itor != endt )
+        {
+            BoneTransform t = *itor;
+            for( size_t i = 0; i < itDepthLevelInfo->numBonesInLevel; i += ARRAY_PACKED_REALS )
+            {
+                const ArrayVector3 vPos =
+                    Math::lerp( prevPose->mPosition, targetPose->mPosition, w );
+                const ArrayQuaternion qRot = ArrayQuaternion::nlerpShortest(
+                    w, prevPose->mOrientation, targetPose->mOrientation );
+                const ArrayVector3 vScale = Math::lerp( prevPose->mScale, targetPose->mScale, w );
+
+                // Leave manual bones untouched (manualBones is 0 for them)
+                *t.mPosition = Math::lerp( *t.mPosition, vPos, *manualBones );
+                *t.mOrientation = Math::lerp( *t.mOrientation, qRot, *manualBones );
+                *t.mScale = Math::lerp( *t.mScale, vScale, *manualBones );
+                t.advancePack();
+
+                ++prevPose;
+                ++targetPose;
+                ++manualBones;
+            }
+
+            ++itor;
+            ++itDepthLevelInfo;
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    void SkeletonInstance::setAnimationLods( const SkeletonAnimationLodVec &lodLevels )
+    {
+        const LodStrategy *lodStrategy = LodStrategyManager::getSingleton().getDefaultStrategy();
+
+        bool needsLodPoses = false;
+
+        mAnimationLods = lodLevels;
+        SkeletonAnimationLodVec::iterator itor = mAnimationLods.begin();
+        SkeletonAnimationLodVec::iterator endt = mAnimationLods.end();
+
+        while( itor != endt )
+        {
+            itor->lodValue = lodStrategy->transformUserValue( itor->lodValue );
+            needsLodPoses |= itor->updateInterval > 1u;
+            ++itor;
+        }
+
+        if( needsLodPoses != ( mLodPoses.get() != 0 ) )
+        {
+            RawSimdUniquePtr<KfTransform, MEMCATEGORY_ANIMATION> lodPoses;
+            if( needsLodPoses )
+            {
+                const size_t numBoneBlocks =
+                    mDefinition->getNumberOfBoneBlocks( mDefinition->getDepthLevelInfo().size() );
+                lodPoses = RawSimdUniquePtr<KfTransform, MEMCATEGORY_ANIMATION>( numBoneBlocks * 2u );
+            }
+            mLodPoses.swap( lodPoses );
+        }
+
+        mLodBlendFrames = 1u;
+        mLodBlendFrame = 1u;
+
+        // Forces updateAnimationLod to stagger the first update
+        mFramesUntilUpdate = std::numeric_limits<uint32>::max();
+    }
+    //-----------------------------------------------------------------------------------
+    void SkeletonInstance::_addLodSource( MovableObject *lodSource )
+    {
+        LodSource entry;
+        entry.object = lodSource;
+        entry.lodValue = std::numeric_limits<Real>::max();
+        entry.visibleSinceLastUpdate = true;
+        mLodSources.push_back( entry );
+    }
+    //-----------------------------------------------------------------------------------
+    void SkeletonInstance::_removeLodSource( MovableObject *lodSource )
+    {
+        LodSourceVec::iterator itor = mLodSources.begin();
+        LodSourceVec::iterator endt = mLodSources.end();
+
+        while( itor != endt && itor->object != lodSource )
+            ++itor;
+
+        if( itor != endt )
+            efficientVectorRemove( mLodSources, itor );
+    }
+    //-----------------------------------------------------------------------------------
+    void SkeletonInstance::_notifyLodValue( const MovableObject *lodSource, Real lodValue )
+    {
+        LodSourceVec::iterator itor = mLodSources.begin();
+        LodSourceVec::iterator endt = mLodSources.end();
+
+        while( itor != endt && itor->object != lodSource )
+            ++itor;
+
+        if( itor != endt )
+            itor->lodValue = std::min( itor->lodValue, lodValue );
+    }
+    //-----------------------------------------------------------------------------------
+    void SkeletonInstance::_notifyVisible( const MovableObject *lodSource )
+    {
+        LodSourceVec::iterator itor = mLodSources.begin();
+        LodSourceVec::iterator endt = mLodSources.end();
+
+        while( itor != endt && itor->object != lodSource )
+            ++itor;
+
+        if( itor != endt )
+            itor->visibleSinceLastUpdate = true;
+    }
+    //-----------------------------------------------------------------------------------
     void SkeletonInstance::resetToPose()
     {
         KfTransform const *RESTRICT_ALIAS bindPose = mDefinition->getBindPose();
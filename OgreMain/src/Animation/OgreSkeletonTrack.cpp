@@ -43,7 +43,11 @@ namespace Ogre
         mNumFrames( 0 ),
         mBoneBlockIdx( boneBlockIdx ),
         mUsedSlots( 0 ),
-        mLocalMemoryManager( kfTransformMemoryManager )
+        mLocalMemoryManager( kfTransformMemoryManager ),
+        mQuantizedRange( 0 ),
+        mQuantizedKeyFrames( 0 ),
+        mQuantizedStride( 0 ),
+        mQuantizedScale( false )
     {
     }
     //-----------------------------------------------------------------------------------
@@ -112,6 +116,62 @@ namespace Ogre
         outNextFrame = nextFrame;
     }
     //-----------------------------------------------------------------------------------
+    inline void SkeletonTrack::decodeQuantizedKeyFrame( size_t keyFrameIdx,
+                                                        KfTransform &outTransform ) const
+    {
+        const uint16 *RESTRICT_ALIAS src = mQuantizedKeyFrames + keyFrameIdx * mQuantizedStride;
+
+        const ArrayVector3 quantizedPos( Mathlib::LoadU16ToF32( src ),
+                                         Mathlib::LoadU16ToF32( src + ARRAY_PACKED_REALS ),
+                                         Mathlib::LoadU16ToF32( src + ARRAY_PACKED_REALS * 2u ) );
+        outTransform.mPosition =
+            mQuantizedRange->mPositionMin + quantizedPos * mQuantizedRange->mPositionStep;
+
+        // Smallest three. The top bit of 'a' and 'b' hold the index of the dropped component.
+        const ArrayReal topBit = Mathlib::SetAll( 32768.0f );
+        ArrayReal a = Mathlib::LoadU16ToF32( src + ARRAY_PACKED_REALS * 3u );
+        ArrayReal b = Mathlib::LoadU16ToF32( src + ARRAY_PACKED_REALS * 4u );
+        ArrayReal c = Mathlib::LoadU16ToF32( src + ARRAY_PACKED_REALS * 5u );
+        const ArrayMaskR idxBit0 = Mathlib::CompareGreaterEqual( a, topBit );
+        const ArrayMaskR idxBit1 = Mathlib::CompareGreaterEqual( b, topBit );
+        a = Mathlib::Cmov4( a - topBit, a, idxBit0 );
+        b = Mathlib::Cmov4( b - topBit, b, idxBit1 );
+
+        // [0; 32767] -> [-1 / sqrt(2); 1 / sqrt(2)]
+        const ArrayReal invSqrt2 = Mathlib::SetAll( 0.70710678f );
+        const ArrayReal toUnit = Mathlib::SetAll( 2.0f * 0.70710678f / 32767.0f );
+        a = a * toUnit - invSqrt2;
+        b = b * toUnit - invSqrt2;
+        c = c * toUnit - invSqrt2;
+
+        // The dropped component was the largest one, thus its square is always >= 0.25
+        // (clamping guards against the quantization error).
+        ArrayReal d = Mathlib::Max( Mathlib::SetAll( 1.0f ) - ( a * a + b * b + c * c ),
+                                    Mathlib::SetAll( 0.25f ) );
+        d = d * Mathlib::InvSqrtNonZero4( d );
+
+        // idx 0: (d, a, b, c)  idx 1: (a, d, b, c)  idx 2: (a, b, d, c)  idx 3: (a, b, c, d)
+        const ArrayReal x = Mathlib::Cmov4( a, Mathlib::Cmov4( a, d, idxBit0 ), idxBit1 );
+        const ArrayReal y = Mathlib::Cmov4( b, Mathlib::Cmov4( d, a, idxBit0 ), idxBit1 );
+        const ArrayReal z = Mathlib::Cmov4( Mathlib::Cmov4( c, d, idxBit0 ), b, idxBit1 );
+        const ArrayReal w = Mathlib::Cmov4( Mathlib::Cmov4( d, c, idxBit0 ), c, idxBit1 );
+        outTransform.mOrientation = ArrayQuaternion( w, x, y, z );
+
+        if( mQuantizedScale )
+        {
+            const ArrayVector3 quantizedScale(
+                Mathlib::LoadU16ToF32( src + ARRAY_PACKED_REALS * 6u ),
+                Mathlib::LoadU16ToF32( src + ARRAY_PACKED_REALS * 7u ),
+                Mathlib::LoadU16ToF32( src + ARRAY_PACKED_REALS * 8u ) );
+            outTransform.mScale =
+                mQuantizedRange->mScaleMin + quantizedScale * mQuantizedRange->mScaleStep;
+        }
+        else
+        {
+            outTransform.mScale = mQuantizedRange->mScaleMin;
+        }
+    }
+    //-----------------------------------------------------------------------------------
     void SkeletonTrack::applyKeyFrameRigAt( KeyFrameRigVec::const_iterator &inOutLastKnownKeyFrameRig,
                                             float frame, ArrayReal animWeight,
                                             const ArrayReal *RESTRICT_ALIAS perBoneWeights,
@@ -131,8 +191,19 @@ namespace Ogre
         ArrayVector3 *RESTRICT_ALIAS finalScale = boneTransforms[level].mScale + offset;
         ArrayQuaternion *RESTRICT_ALIAS finalRot = boneTransforms[level].mOrientation + offset;
 
-        KfTransform *RESTRICT_ALIAS prevTransf = prevFrame->mBoneTransform;
-        KfTransform *RESTRICT_ALIAS nextTransf = nextFrame->mBoneTransform;
+        const KfTransform *RESTRICT_ALIAS prevTransf = prevFrame->mBoneTransform;
+        const KfTransform *RESTRICT_ALIAS nextTransf = nextFrame->mBoneTransform;
+
+        KfTransform decodedTransf[2];
+        if( mQuantizedRange )
+        {
+            decodeQuantizedKeyFrame( static_cast<size_t>( prevFrame - mKeyFrameRigs.begin() ),
+                                     decodedTransf[0] );
+            decodeQuantizedKeyFrame( static_cast<size_t>( nextFrame - mKeyFrameRigs.begin() ),
+                                     decodedTransf[1] );
+            prevTransf = &decodedTransf[0];
+            nextTransf = &decodedTransf[1];
+        }
 
         ArrayVector3 interpPos, interpScale;
         ArrayQuaternion interpRot;
@@ -185,4 +256,303 @@ namespace Ogre
             }
         }
     }
+    //-----------------------------------------------------------------------------------
+    static bool isInterpolationWithinTolerance( const KeyFrameRig &prevFrame,
+                                                const KeyFrameRig &nextFrame,
+                                                const KeyFrameRig &keyFrame, Real fTimeW,
+                                                uint32 usedSlots, Real positionTolerance,
+                                                Radian orientationTolerance, Real scaleTolerance )
+    {
+        const Real cosHalfTolerance = Math::Cos( orientationTolerance * 0.5f );
+
+        bool retVal = true;
+        for( size_t i = 0; i < usedSlots && retVal; ++i )
+        {
+            Vector3 vPrev, vNext, vOriginal;
+            prevFrame.mBoneTransform->mPosition.getAsVector3( vPrev, i );
+            nextFrame.mBoneTransform->mPosition.getAsVector3( vNext, i );
+            keyFrame.mBoneTransform->mPosition.getAsVector3( vOriginal, i );
+            retVal &= Math::lerp( vPrev, vNext, fTimeW ).distance( vOriginal ) <= positionTolerance;
+
+            prevFrame.mBoneTransform->mScale.getAsVector3( vPrev, i );
+            nextFrame.mBoneTransform->mScale.getAsVector3( vNext, i );
+            keyFrame.mBoneTransform->mScale.getAsVector3( vOriginal, i );
+            retVal &= Math::lerp( vPrev, vNext, fTimeW ).distance( vOriginal ) <= scaleTolerance;
+
+            // Keyframes store unnormalized quaternions (see
+            // SkeletonAnimationDef::getInterpolatedUnnormalizedKeyFrame), but
+            // applyKeyFrameRigAt always normalizes the result via nlerp.
+            Quaternion qPrev, qNext, qOriginal;
+            prevFrame.mBoneTransform->mOrientation.getAsQuaternion( qPrev, i );
+            nextFrame.mBoneTransform->mOrientation.getAsQuaternion( qNext, i );
+            keyFrame.mBoneTransform->mOrientation.getAsQuaternion( qOriginal, i );
+            qOriginal.normalise();
+            const Quaternion qInterp = Quaternion::nlerp( fTimeW, qPrev, qNext, true );
+            retVal &= Math::Abs( qInterp.Dot( qOriginal ) ) >= cosHalfTolerance;
+        }
+
+        return retVal;
+    }
+    //-----------------------------------------------------------------------------------
+    void SkeletonTrack::_reduceKeyFrames( Real positionTolerance, Radian orientationTolerance,
+                                          Real scaleTolerance )
+    {
+        if( mKeyFrameRigs.size() <= 1u )
+            return;
+
+        KeyFrameRigVec reducedKeyFrames;
+        reducedKeyFrames.reserve( mKeyFrameRigs.size() );
+        reducedKeyFrames.push_back( mKeyFrameRigs.front() );
+
+        // Greedy pass: try to extend the segment [lastKept; i + 1] as far as possible.
+        // Both position and scale are piecewise linear, thus checking the error at the
+        // original keyframes is enough to bound the error everywhere in between.
+        size_t lastKept = 0;
+        const size_t numKeyFrames = mKeyFrameRigs.size();
+        for( size_t i = 1u; i < numKeyFrames - 1u; ++i )
+        {
+            bool canRemove = true;
+            const KeyFrameRig &prevFrame = mKeyFrameRigs[lastKept];
+            const KeyFrameRig &nextFrame = mKeyFrameRigs[i + 1u];
+            for( size_t j = lastKept + 1u; j <= i && canRemove; ++j )
+            {
+                const Real fTimeW = ( mKeyFrameRigs[j].mFrame - prevFrame.mFrame ) /
+                                    ( nextFrame.mFrame - prevFrame.mFrame );
+                canRemove = isInterpolationWithinTolerance(
+                    prevFrame, nextFrame, mKeyFrameRigs[j], fTimeW, mUsedSlots, positionTolerance,
+                    orientationTolerance, scaleTolerance );
+            }
+
+            if( !canRemove )
+            {
+                reducedKeyFrames.push_back( mKeyFrameRigs[i] );
+                lastKept = i;
+            }
+        }
+
+        reducedKeyFrames.push_back( mKeyFrameRigs.back() );
+
+        if( reducedKeyFrames.size() == 2u )
+        {
+            // The track is constant if every original keyframe matches the first one (the
+            // one we keep). Checking against the kept value, rather than against the
+            // interpolated segment, keeps the error within tolerance.
+            const KeyFrameRig &firstKeyFrame = reducedKeyFrames.front();
+            bool isConstant = true;
+            for( size_t i = 1u; i < numKeyFrames && isConstant; ++i )
+            {
+                isConstant = isInterpolationWithinTolerance(
+                    firstKeyFrame, firstKeyFrame, mKeyFrameRigs[i], 0.0f, mUsedSlots,
+                    positionTolerance, orientationTolerance, scaleTolerance );
+            }
+
+            if( isConstant )
+                reducedKeyFrames.pop_back();
+        }
+
+        for( size_t i = 0; i < reducedKeyFrames.size() - 1u; ++i )
+        {
+            reducedKeyFrames[i].mInvNextFrameDistance =
+                1.0f / ( reducedKeyFrames[i + 1u].mFrame - reducedKeyFrames[i].mFrame );
+        }
+        reducedKeyFrames.back().mInvNextFrameDistance = 1.0f;
+
+        mKeyFrameRigs.swap( reducedKeyFrames );
+    }
+    //-----------------------------------------------------------------------------------
+    bool SkeletonTrack::isConstantIdentity( Real positionTolerance, Radian orientationTolerance,
+                                            Real scaleTolerance ) const
+    {
+        if( mKeyFrameRigs.size() != 1u )
+            return false;
+
+        const Real cosHalfTolerance = Math::Cos( orientationTolerance * 0.5f );
+
+        bool retVal = true;
+        for( size_t i = 0; i < mUsedSlots && retVal; ++i )
+        {
+            Vector3 vPos, vScale;
+            Quaternion qRot;
+            getKeyFrameTransform( 0u, i, vPos, qRot, vScale );
+            qRot.normalise();
+
+            retVal &= vPos.length() <= positionTolerance;
+            retVal &= vScale.distance( Vector3::UNIT_SCALE ) <= scaleTolerance;
+            retVal &= Math::Abs( qRot.Dot( Quaternion::IDENTITY ) ) >= cosHalfTolerance;
+        }
+
+        return retVal;
+    }
+    //-----------------------------------------------------------------------------------
+    uint32 SkeletonTrack::_getQuantizedStride() const
+    {
+        if( mQuantizedRange )
+            return mQuantizedStride;
+
+        bool needsScale = false;
+
+        KeyFrameRigVec::const_iterator itor = mKeyFrameRigs.begin();
+        KeyFrameRigVec::const_iterator endt = mKeyFrameRigs.end();
+
+        while( itor != endt && !needsScale )
+        {
+            for( size_t i = 0; i < ARRAY_PACKED_REALS; ++i )
+            {
+                Vector3 vFirst, vScale;
+                mKeyFrameRigs.front().mBoneTransform->mScale.getAsVector3( vFirst, i );
+                itor->mBoneTransform->mScale.getAsVector3( vScale, i );
+                needsScale |= vFirst != vScale;
+            }
+            ++itor;
+        }
+
+        return ( needsScale ? 9u : 6u ) * ARRAY_PACKED_REALS;
+    }
+    //-----------------------------------------------------------------------------------
+    static uint16 quantizeToU16( Real value, Real minValue, Real invStep )
+    {
+        return static_cast<uint16>(
+            Math::Clamp<Real>( Math::Floor( ( value - minValue ) * invStep + 0.5f ), 0, 65535 ) );
+    }
+    //-----------------------------------------------------------------------------------
+    void SkeletonTrack::_quantizeKeyFrames( QuantizedKfRange *outRange, uint16 *outKeyFrames )
+    {
+        assert( !mQuantizedRange && "Already quantized!" );
+        assert( !mKeyFrameRigs.empty() );
+
+        mQuantizedStride = _getQuantizedStride();
+        mQuantizedScale = mQuantizedStride == 9u * ARRAY_PACKED_REALS;
+
+        // Calculate the range of each slot
+        Vector3 posMin[ARRAY_PACKED_REALS], posMax[ARRAY_PACKED_REALS];
+        Vector3 scaleMin[ARRAY_PACKED_REALS], scaleMax[ARRAY_PACKED_REALS];
+        for( size_t i = 0; i < ARRAY_PACKED_REALS; ++i )
+        {
+            mKeyFrameRigs.front().mBoneTransform->mPosition.getAsVector3( posMin[i], i );
+            mKeyFrameRigs.front().mBoneTransform->mScale.getAsVector3( scaleMin[i], i );
+            posMax[i] = posMin[i];
+            scaleMax[i] = scaleMin[i];
+        }
+
+        KeyFrameRigVec::const_iterator itor = mKeyFrameRigs.begin();
+        KeyFrameRigVec::const_iterator endt = mKeyFrameRigs.end();
+
+        while( itor != endt )
+        {
+            for( size_t i = 0; i < ARRAY_PACKED_REALS; ++i )
+            {
+                Vector3 vPos, vScale;
+                itor->mBoneTransform->mPosition.getAsVector3( vPos, i );
+                itor->mBoneTransform->mScale.getAsVector3( vScale, i );
+                posMin[i].makeFloor( vPos );
+                posMax[i].makeCeil( vPos );
+                scaleMin[i].makeFloor( vScale );
+                scaleMax[i].makeCeil( vScale );
+            }
+            ++itor;
+        }
+
+        Vector3 posInvStep[ARRAY_PACKED_REALS], scaleInvStep[ARRAY_PACKED_REALS];
+        for( size_t i = 0; i < ARRAY_PACKED_REALS; ++i )
+        {
+            const Vector3 posStep = ( posMax[i] - posMin[i] ) / 65535.0f;
+            const Vector3 scaleStep = ( scaleMax[i] - scaleMin[i] ) / 65535.0f;
+            outRange->mPositionMin.setFromVector3( posMin[i], i );
+            outRange->mPositionStep.setFromVector3( posStep, i );
+            outRange->mScaleMin.setFromVector3( scaleMin[i], i );
+            outRange->mScaleStep.setFromVector3( scaleStep, i );
+
+            for( size_t j = 0; j < 3u; ++j )
+            {
+                posInvStep[i][j] = posStep[j] > 0.0f ? 1.0f / posStep[j] : 0.0f;
+                scaleInvStep[i][j] = scaleStep[j] > 0.0f ? 1.0f / scaleStep[j] : 0.0f;
+            }
+        }
+
+        const Real invSqrt2 = 0.70710678f;
+        const Real toQuantized = 32767.0f / ( 2.0f * invSqrt2 );
+
+        uint16 *RESTRICT_ALIAS dst = outKeyFrames;
+
+        KeyFrameRigVec::iterator itKeys = mKeyFrameRigs.begin();
+        KeyFrameRigVec::iterator enKeys = mKeyFrameRigs.end();
+
+        while( itKeys != enKeys )
+        {
+            for( size_t i = 0; i < ARRAY_PACKED_REALS; ++i )
+            {
+                Vector3 vPos, vScale;
+                Quaternion qRot;
+                itKeys->mBoneTransform->mPosition.getAsVector3( vPos, i );
+                itKeys->mBoneTransform->mOrientation.getAsQuaternion( qRot, i );
+                itKeys->mBoneTransform->mScale.getAsVector3( vScale, i );
+
+                for( size_t j = 0; j < 3u; ++j )
+                {
+                    dst[j * ARRAY_PACKED_REALS + i] =
+                        quantizeToU16( vPos[j], posMin[i][j], posInvStep[i][j] );
+                    if( mQuantizedScale )
+                    {
+                        dst[( j + 6u ) * ARRAY_PACKED_REALS + i] =
+                            quantizeToU16( vScale[j], scaleMin[i][j], scaleInvStep[i][j] );
+                    }
+                }
+
+                // Keyframes may be unnormalized; applyKeyFrameRigAt normalizes anyway
+                qRot.normalise();
+                const Real components[4] = { qRot.x, qRot.y, qRot.z, qRot.w };
+                uint16 largestIdx = 0u;
+                for( uint16 j = 1u; j < 4u; ++j )
+                {
+                    if( Math::Abs( components[j] ) > Math::Abs( components[largestIdx] ) )
+                        largestIdx = j;
+                }
+
+                // q and -q represent the same rotation. Make the dropped component positive.
+                const Real sign = components[largestIdx] < 0.0f ? -1.0f : 1.0f;
+
+                uint16 smallest[3];
+                for( uint16 j = 0u, k = 0u; j < 4u; ++j )
+                {
+                    if( j != largestIdx )
+                    {
+                        smallest[k++] = static_cast<uint16>( Math::Clamp<Real>(
+                            Math::Floor( ( components[j] * sign + invSqrt2 ) * toQuantized + 0.5f ),
+                            0, 32767 ) );
+                    }
+                }
+
+                dst[3u * ARRAY_PACKED_REALS + i] =
+                    static_cast<uint16>( smallest[0] | ( ( largestIdx & 0x01u ) << 15u ) );
+                dst[4u * ARRAY_PACKED_REALS + i] =
+                    static_cast<uint16>( smallest[1] | ( ( largestIdx & 0x02u ) << 14u ) );
+                dst[5u * ARRAY_PACKED_REALS + i] = smallest[2];
+            }
+
+            itKeys->mBoneTransform = 0;
+            dst += mQuantizedStride;
+            ++itKeys;
+        }
+
+        mQuantizedRange = outRange;
+        mQuantizedKeyFrames = outKeyFrames;
+        mLocalMemoryManager = 0;
+    }
+    //-----------------------------------------------------------------------------------
+    void SkeletonTrack::getKeyFrameTransform( size_t keyFrameIdx, size_t slot, Vector3 &outPos,
+                                              Quaternion &outRot, Vector3 &outScale ) const
+    {
+        const KfTransform *RESTRICT_ALIAS transform = mKeyFrameRigs[keyFrameIdx].mBoneTransform;
+
+        KfTransform decodedTransform;
+        if( mQuantizedRange )
+        {
+            decodeQuantizedKeyFrame( keyFrameIdx, decodedTransform );
+            transform = &decodedTransform;
+        }
+
+        transform->mPosition.getAsVector3( outPos, slot );
+        transform->mOrientation.getAsQuaternion( outRot, slot );
+        transform->mScale.getAsVector3( outScale, slot );
+    }
 }  // namespace Ogre
@@ -39,6 +39,7 @@ THE SOFTWARE.
 #include "Compositor/Pass/PassScene/OgreCompositorPassSceneDef.h"
 #include "OgreCamera.h"
 #include "OgreDepthBuffer.h"
+#include "OgreFrameArena.h"
 #include "OgreLogManager.h"
 #include "OgrePass.h"
 #include "OgrePixelFormatGpuUtils.h"
@@ -84,7 +85,9 @@ namespace Ogre
         mDefinition( definition ),
         mLastCamera( 0 ),
         mLastFrame( std::numeric_limits<size_t>::max() ),
-        mNumActiveShadowMapCastingLights( 0 )
+        mNumActiveShadowMapCastingLights( 0 ),
+        mStaticShadowMapAutoDirty( false ),
+        mStaticCastersVisibilityMask( 0xFFFFFFFF )
     {
         mShadowMapCameras.reserve( definition->mShadowMapTexDefinitions.size() );
         mLocalTextures.reserve( mLocalTextures.size() + definition->mShadowMapTexDefinitions.size() );
@@ -138,6 +141,10 @@ namespace Ogre
             shadowMapCamera.maxDistance = 100000.0f;
             for( size_t i = 0; i < Light::NUM_LIGHT_TYPES; ++i )
                 shadowMapCamera.scenePassesViewportSize[i] = -Vector2::UNIT_SCALE;
+            shadowMapCamera.lastViewProjMatrix = Matrix4::ZERO;
+            shadowMapCamera.lastCastersHash = 0;
+            shadowMapCamera.lastCastersHashValid = false;
+            shadowMapCamera.isDirty = true;
 
             {
                 // Find out the index to our texture in both mLocalTextures & mContiguousShadowMapTex
@@ -403,18 +410,19 @@ namespace Ogre
         const size_t numTmpSortedLights = std::min( mShadowMapCastingLights.size() - begEmptyLightIdx,
                                                     globalLightList.lights.size() - startIndex );
 
-        mTmpSortedIndexes.resize( numTmpSortedLights, std::numeric_limits<size_t>::max() );
+        FrameArenaVector<size_t>::type tmpSortedIndexes( numTmpSortedLights,
+                                                         std::numeric_limits<size_t>::max() );
         std::partial_sort_copy(
             MemoryLessInputIterator( startIndex ),
-            MemoryLessInputIterator( globalLightList.lights.size() ), mTmpSortedIndexes.begin(),
-            mTmpSortedIndexes.end(),
+            MemoryLessInputIterator( globalLightList.lights.size() ), tmpSortedIndexes.begin(),
+            tmpSortedIndexes.end(),
             ShadowMappingLightCmp( &globalLightList, combinedVisibilityFlags, camPos ) );
 
-        std::sort( mTmpSortedIndexes.begin(), mTmpSortedIndexes.end(),
+        std::sort( tmpSortedIndexes.begin(), tmpSortedIndexes.end(),
                    SortByLightTypeCmp( &globalLightList ) );
 
-        vector<size_t>::type::const_iterator itor = mTmpSortedIndexes.begin();
-        vector<size_t>::type::const_iterator endt = mTmpSortedIndexes.end();
+        FrameArenaVector<size_t>::type::const_iterator itor = tmpSortedIndexes.begin();
+        FrameArenaVector<size_t>::type::const_iterator endt = tmpSortedIndexes.end();
 
         while( itor != endt )
         {
@@ -637,6 +645,16 @@ namespace Ogre
                 const RenderSystemCapabilities *caps = mRenderSystem->getCapabilities();
                 texCamera->_setNeedsDepthClamp( light->getType() == Light::LT_DIRECTIONAL &&
                                                 caps->hasCapability( RSC_DEPTH_CLAMP ) );
+
+                if( mStaticShadowMapAutoDirty && mShadowMapCastingLights[itor->light].isStatic )
+                {
+                    // The shadow camera follows the main camera in these setups
+                    const bool cameraDependent = light->getType() == Light::LT_DIRECTIONAL ||
+                                                 itor->shadowMapTechnique != SHADOWMAP_UNIFORM;
+                    updateStaticShadowMapDirty( *itShadowCamera, light, cameraDependent,
+                                                camera->getLastViewport()->getVisibilityMask(),
+                                                sceneManager );
+                }
             }
             // Else... this shadow map shouldn't be rendered and when used, return a blank one.
             // The Nth closest lights don't cast shadows
@@ -663,6 +681,73 @@ namespace Ogre
                 ++it;
             }
         }
+
+        {
+            ShadowMapCameraVec::iterator it = mShadowMapCameras.begin();
+            ShadowMapCameraVec::iterator en = mShadowMapCameras.end();
+
+            while( it != en )
+            {
+                it->isDirty = false;
+                ++it;
+            }
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    void CompositorShadowNode::updateStaticShadowMapDirty( ShadowMapCamera &shadowMapCamera,
+                                                           const Light *light, bool cameraDependent,
+                                                           uint32 visibilityMask,
+                                                           SceneManager *sceneManager )
+    {
+        const Camera *texCamera = shadowMapCamera.camera;
+
+        const Matrix4 viewProjMatrix =
+            texCamera->getProjectionMatrix() * texCamera->getViewMatrix( true );
+
+        const bool cameraChanged = shadowMapCamera.lastViewProjMatrix != viewProjMatrix;
+        if( cameraChanged )
+        {
+            shadowMapCamera.isDirty = true;
+            shadowMapCamera.lastViewProjMatrix = viewProjMatrix;
+
+            if( cameraDependent )
+            {
+                // Likely to change again next frame (e.g. PSSM while the main camera moves).
+                // Don't waste time scanning the casters until the shadow camera settles down.
+                shadowMapCamera.lastCastersHashValid = false;
+                return;
+            }
+        }
+
+        // Only the side planes are used. Casters in front of the near plane still cast shadows
+        // (i.e. depth clamp) and casters past the far plane don't matter for a conservative test.
+        // Point lights render to all directions, so all casters are considered.
+        uint32 castersHash;
+        if( light->getType() == Light::LT_POINT )
+        {
+            castersHash = sceneManager->_calculateCastersHash(
+                visibilityMask & mStaticCastersVisibilityMask, (uint8)mDefinition->mMinRq,
+                (uint8)mDefinition->mMaxRq, 0, 0u );
+        }
+        else
+        {
+            const Plane *frustumPlanes = texCamera->getFrustumPlanes();
+            const Plane sidePlanes[4] = { frustumPlanes[FRUSTUM_PLANE_LEFT],
+                                          frustumPlanes[FRUSTUM_PLANE_RIGHT],
+                                          frustumPlanes[FRUSTUM_PLANE_TOP],
+                                          frustumPlanes[FRUSTUM_PLANE_BOTTOM] };
+            castersHash = sceneManager->_calculateCastersHash(
+                visibilityMask & mStaticCastersVisibilityMask, (uint8)mDefinition->mMinRq,
+                (uint8)mDefinition->mMaxRq, sidePlanes, 4u );
+        }
+
+        if( cameraChanged || !shadowMapCamera.lastCastersHashValid ||
+            shadowMapCamera.lastCastersHash != castersHash )
+        {
+            shadowMapCamera.isDirty = true;
+            shadowMapCamera.lastCastersHash = castersHash;
+            shadowMapCamera.lastCastersHashValid = true;
+        }
     }
     //-----------------------------------------------------------------------------------
     void CompositorShadowNode::postInitializePass( CompositorPass *pass )
@@ -739,7 +824,8 @@ namespace Ogre
 
             if( !mShadowMapCastingLights[shadowTexDef.light].light ||
                 ( mShadowMapCastingLights[shadowTexDef.light].isStatic &&
-                  !mShadowMapCastingLights[shadowTexDef.light].isDirty ) )
+                  !mShadowMapCastingLights[shadowTexDef.light].isDirty &&
+                  !mShadowMapCameras[shadowMapIdx].isDirty ) )
             {
                 retVal = false;
             }
@@ -955,6 +1041,13 @@ namespace Ogre
         }
     }
     //-----------------------------------------------------------------------------------
+    void CompositorShadowNode::setStaticShadowMapAutoDirty( bool bAutoDirty,
+                                                            uint32 staticCastersVisibilityMask )
+    {
+        mStaticShadowMapAutoDirty = bAutoDirty;
+        mStaticCastersVisibilityMask = staticCastersVisibilityMask;
+    }
+    //-----------------------------------------------------------------------------------
     void CompositorShadowNode::finalTargetResized01( const TextureGpu *finalTarget )
     {
         CompositorNode::finalTargetResized01( finalTarget );
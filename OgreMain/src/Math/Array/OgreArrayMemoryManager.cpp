@@ -38,12 +38,27 @@ THE SOFTWARE.
 #include "Math/Simple/OgreAabb.h"
 #include "OgreException.h"
 #include "OgreMatrix4.h"
+#include "OgreTimer.h"
 
 namespace Ogre
 {
     const size_t ArrayMemoryManager::MAX_MEMORY_SLOTS =
         (size_t)( -ARRAY_PACKED_REALS ) - 1 - OGRE_PREFETCH_SLOT_DISTANCE;
 
+    ArrayMemoryManager::DefragmentBudget::DefragmentBudget( size_t maxSlots, Timer *_timer,
+                                                            uint64 timeBudgetUs ) :
+        slotsLeft( maxSlots ),
+        deadlineUs( _timer ? ( _timer->getMicroseconds() + timeBudgetUs ) : 0u ),
+        timer( _timer )
+    {
+    }
+    //-----------------------------------------------------------------------------------
+    bool ArrayMemoryManager::DefragmentBudget::isExhausted() const
+    {
+        return slotsLeft == 0u || ( timer && timer->getMicroseconds() >= deadlineUs );
+    }
+    //-----------------------------------------------------------------------------------
+
     ArrayMemoryManager::ArrayMemoryManager( size_t const *elementsMemSize,
                                             const CleanupRoutines *initRoutines,
                                             CleanupRoutines const *cleanupRoutines,
@@ -58,6 +73,8 @@ namespace Ogre
         mMaxMemory( hintMaxNodes ),
         mMaxHardLimit( maxHardLimit ),
         mCleanupThreshold( cleanupThreshold ),
+        mIncrementalDefragment( false ),
+        mDefragmentPending( false ),
         mRebaseListener( rebaseListener ),
         mLevel( depthLevel )
     {
@@ -246,7 +263,12 @@ namespace Ogre
             // The pool is getting to big? Do some cleanup (depending
             // on fragmentation, may take a performance hit)
             if( mAvailableSlots.size() > mCleanupThreshold )
-                defragment();
+            {
+                if( mIncrementalDefragment )
+                    mDefragmentPending = true;
+                else
+                    defragment();
+            }
         }
     }
     //-----------------------------------------------------------------------------------
@@ -304,6 +326,72 @@ namespace Ogre
         }
 
         mAvailableSlots.clear();
+        mDefragmentPending = false;
+    }
+    //-----------------------------------------------------------------------------------
+    void ArrayMemoryManager::setIncrementalDefragment( bool bIncremental )
+    {
+        mIncrementalDefragment = bIncremental;
+        if( !bIncremental )
+            mDefragmentPending = false;
+    }
+    //-----------------------------------------------------------------------------------
+    bool ArrayMemoryManager::defragmentIncremental( DefragmentBudget &budget )
+    {
+        if( !mDefragmentPending )
+            return false;
+
+        // Sort, last values at the back. We consume ranges from the back so that shifting
+        // the memory never invalidates the slots that remain in mAvailableSlots (they're
+        // all below the range being removed).
+        std::sort( mAvailableSlots.begin(), mAvailableSlots.end() );
+
+        bool firstRange = true;
+        while( !mAvailableSlots.empty() && ( firstRange || !budget.isExhausted() ) )
+        {
+            firstRange = false;
+
+            // Find the continuous range of unused slots ending at the last one
+            const size_t newEnd = mAvailableSlots.back() + 1u;
+            size_t lastRange = 1;
+            SlotsVec::const_iterator it = mAvailableSlots.end() - 1;
+            while( it != mAvailableSlots.begin() && ( *it - 1u ) == *( it - 1 ) )
+            {
+                ++lastRange;
+                --it;
+            }
+
+            size_t i = 0;
+            MemoryPoolVec::iterator itPools = mMemoryPools.begin();
+            MemoryPoolVec::iterator enPools = mMemoryPools.end();
+
+            // Shift everything N slots (N = lastRange)
+            while( itPools != enPools )
+            {
+                char *dstPtr = *itPools + ( newEnd - lastRange ) * mElementsMemSizes[i];
+                size_t indexDst = ( newEnd - lastRange ) % ARRAY_PACKED_REALS;
+                char *srcPtr = *itPools + newEnd * mElementsMemSizes[i];
+                size_t indexSrc = newEnd % ARRAY_PACKED_REALS;
+                size_t numSlots = ( mUsedMemory - newEnd );
+                size_t numFreeSlots = lastRange;
+                mCleanupRoutines[i]( dstPtr, indexDst, srcPtr, indexSrc, numSlots, numFreeSlots,
+                                     mElementsMemSizes[i] );
+                ++i;
+                ++itPools;
+            }
+
+            mUsedMemory -= lastRange;
+            initializeEmptySlots( mUsedMemory );
+
+            mRebaseListener->performCleanup( mLevel, mMemoryPools, mElementsMemSizes,
+                                             ( newEnd - lastRange ), lastRange );
+
+            mAvailableSlots.resize( mAvailableSlots.size() - lastRange );
+            budget.slotsLeft -= std::min( budget.slotsLeft, lastRange );
+        }
+
+        mDefragmentPending = !mAvailableSlots.empty();
+        return mDefragmentPending;
     }
     //-----------------------------------------------------------------------------------
     void ArrayMemoryManager::shrinkToFit()
@@ -35,7 +35,11 @@ THE SOFTWARE.
 
 namespace Ogre
 {
-    BoneMemoryManager::BoneMemoryManager() : mBoneRebaseListener( 0 ) {}
+    BoneMemoryManager::BoneMemoryManager() :
+        mBoneRebaseListener( 0 ),
+        mIncrementalDefragment( false )
+    {
+    }
     //-----------------------------------------------------------------------------------
     BoneMemoryManager::~BoneMemoryManager()
     {
@@ -61,6 +65,7 @@ namespace Ogre
                 static_cast<uint16>( mMemoryManagers.size() ), 100u, std::numeric_limits<size_t>::max(),
                 ArrayMemoryManager::MAX_MEMORY_SLOTS, this ) );
             mMemoryManagers.back().initialize();
+            mMemoryManagers.back().setIncrementalDefragment( mIncrementalDefragment );
         }
     }
     //-----------------------------------------------------------------------------------
@@ -85,7 +90,56 @@ namespace Ogre
                 BoneArrayMemoryManager( (uint16)mMemoryManagers.size(), 100, cleanupThreshold,
                                         ArrayMemoryManager::MAX_MEMORY_SLOTS, this ) );
             mMemoryManagers.back().initialize();
+            mMemoryManagers.back().setIncrementalDefragment( mIncrementalDefragment );
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    void BoneMemoryManager::setIncrementalDefragment( bool bIncremental )
+    {
+        mIncrementalDefragment = bIncremental;
+
+        ArrayMemoryManagerVec::iterator itor = mMemoryManagers.begin();
+        ArrayMemoryManagerVec::iterator endt = mMemoryManagers.end();
+
+        while( itor != endt )
+        {
+            itor->setIncrementalDefragment( bIncremental );
+            ++itor;
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    bool BoneMemoryManager::defragmentIncremental( ArrayMemoryManager::DefragmentBudget &budget )
+    {
+        bool pending = false;
+
+        ArrayMemoryManagerVec::iterator itor = mMemoryManagers.begin();
+        ArrayMemoryManagerVec::iterator endt = mMemoryManagers.end();
+
+        while( itor != endt && !pending )
+        {
+            pending = itor->isDefragmentPending();
+            ++itor;
+        }
+
+        if( !pending || budget.isExhausted() )
+            return pending;
+
+        // Bones of the same SkeletonInstance must keep the same relative ordering in every
+        // depth (see BySkeletonDef::skeletons), so we don't leave a depth half-compacted.
+        itor = mMemoryManagers.begin();
+        while( itor != endt )
+        {
+            if( itor->isDefragmentPending() )
+            {
+                const size_t usedSlots = itor->getNumUsedSlotsIncludingFragmented();
+                itor->defragment();
+                const size_t reclaimed = usedSlots - itor->getNumUsedSlotsIncludingFragmented();
+                budget.slotsLeft -= std::min( budget.slotsLeft, reclaimed );
+            }
+            ++itor;
         }
+
+        return false;
     }
     //-----------------------------------------------------------------------------------
     void BoneMemoryManager::nodeCreated( BoneTransform &outTransform, size_t depth )
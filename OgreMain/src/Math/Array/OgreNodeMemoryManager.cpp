@@ -37,7 +37,8 @@ namespace Ogre
     NodeMemoryManager::NodeMemoryManager() :
         mDummyNode( 0 ),
         mMemoryManagerType( SCENE_DYNAMIC ),
-        mTwinMemoryManager( 0 )
+        mTwinMemoryManager( 0 ),
+        mIncrementalDefragment( false )
     {
         // Manually allocate the memory for the dummy scene nodes (since we can't pass ourselves
         // or yet another object) We only allocate what's needed to prevent access violations.
@@ -119,6 +120,7 @@ namespace Ogre
                 NodeArrayMemoryManager( (uint16)mMemoryManagers.size(), 100, mDummyNode, 100,
                                         ArrayMemoryManager::MAX_MEMORY_SLOTS, this ) );
             mMemoryManagers.back().initialize();
+            mMemoryManagers.back().setIncrementalDefragment( mIncrementalDefragment );
         }
     }
     //-----------------------------------------------------------------------------------
@@ -194,6 +196,42 @@ namespace Ogre
         }
     }
     //-----------------------------------------------------------------------------------
+    void NodeMemoryManager::setIncrementalDefragment( bool bIncremental )
+    {
+        mIncrementalDefragment = bIncremental;
+
+        ArrayMemoryManagerVec::iterator itor = mMemoryManagers.begin();
+        ArrayMemoryManagerVec::iterator endt = mMemoryManagers.end();
+
+        while( itor != endt )
+        {
+            itor->setIncrementalDefragment( bIncremental );
+            ++itor;
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    bool NodeMemoryManager::defragmentIncremental( ArrayMemoryManager::DefragmentBudget &budget )
+    {
+        bool pending = false;
+
+        ArrayMemoryManagerVec::iterator itor = mMemoryManagers.begin();
+        ArrayMemoryManagerVec::iterator endt = mMemoryManagers.end();
+
+        while( itor != endt )
+        {
+            if( itor->isDefragmentPending() )
+            {
+                if( !budget.isExhausted() )
+                    pending |= itor->defragmentIncremental( budget );
+                else
+                    pending = true;
+            }
+            ++itor;
+        }
+
+        return pending;
+    }
+    //-----------------------------------------------------------------------------------
     void NodeMemoryManager::shrinkToFit()
     {
         ArrayMemoryManagerVec::iterator itor = mMemoryManagers.begin();
@@ -39,7 +39,8 @@ namespace Ogre
         mDummyNode( 0 ),
         mDummyObject( 0 ),
         mMemoryManagerType( SCENE_DYNAMIC ),
-        mTwinMemoryManager( 0 )
+        mTwinMemoryManager( 0 ),
+        mIncrementalDefragment( false )
     {
         // Manually allocate the memory for the dummy scene nodes (since we can't pass ourselves
         // or yet another object) We only allocate what's needed to prevent access violations.
@@ -123,6 +124,7 @@ namespace Ogre
                 (uint16)mMemoryManagers.size(), 100, mDummyNode, mDummyObject, 100,
                 ArrayMemoryManager::MAX_MEMORY_SLOTS, this ) );
             mMemoryManagers.back().initialize();
+            mMemoryManagers.back().setIncrementalDefragment( mIncrementalDefragment );
         }
     }
     //-----------------------------------------------------------------------------------
@@ -182,6 +184,42 @@ namespace Ogre
         }
     }
     //-----------------------------------------------------------------------------------
+    void ObjectMemoryManager::setIncrementalDefragment( bool bIncremental )
+    {
+        mIncrementalDefragment = bIncremental;
+
+        ArrayMemoryManagerVec::iterator itor = mMemoryManagers.begin();
+        ArrayMemoryManagerVec::iterator endt = mMemoryManagers.end();
+
+        while( itor != endt )
+        {
+            itor->setIncrementalDefragment( bIncremental );
+            ++itor;
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    bool ObjectMemoryManager::defragmentIncremental( ArrayMemoryManager::DefragmentBudget &budget )
+    {
+        bool pending = false;
+
+        ArrayMemoryManagerVec::iterator itor = mMemoryManagers.begin();
+        ArrayMemoryManagerVec::iterator endt = mMemoryManagers.end();
+
+        while( itor != endt )
+        {
+            if( itor->isDefragmentPending() )
+            {
+                if( !budget.isExhausted() )
+                    pending |= itor->defragmentIncremental( budget );
+                else
+                    pending = true;
+            }
+            ++itor;
+        }
+
+        return pending;
+    }
+    //-----------------------------------------------------------------------------------
     void ObjectMemoryManager::shrinkToFit()
     {
         ArrayMemoryManagerVec::iterator itor = mMemoryManagers.begin();
@@ -182,5 +182,56 @@ namespace Ogre
         mInstanceCount( 0 )
     {
     }
+    //-----------------------------------------------------------------------------------
+    InstancingStats::InstancingStats() { reset(); }
+    //-----------------------------------------------------------------------------------
+    void InstancingStats::reset()
+    {
+        mNumRenderables = 0u;
+        mNumDraws = 0u;
+        mNumMergedInstances = 0u;
+        mNumPsoSwitches = 0u;
+        mNumVaoSwitches = 0u;
+        for( size_t i = 0u; i < NumBatchBreakReasons; ++i )
+            mBatchBreaks[i] = 0u;
+    }
+    //-----------------------------------------------------------------------------------
+    InstancingStats &InstancingStats::operator+=( const InstancingStats &other )
+    {
+        mNumRenderables += other.mNumRenderables;
+        mNumDraws += other.mNumDraws;
+        mNumMergedInstances += other.mNumMergedInstances;
+        mNumPsoSwitches += other.mNumPsoSwitches;
+        mNumVaoSwitches += other.mNumVaoSwitches;
+        for( size_t i = 0u; i < NumBatchBreakReasons; ++i )
+            mBatchBreaks[i] += other.mBatchBreaks[i];
+        return *this;
+    }
+    //-----------------------------------------------------------------------------------
+    const char *InstancingStats::getBatchBreakReasonName( BatchBreakReason reason )
+    {
+        switch( reason )
+        {
+        case BbrFirstDraw:
+            return "First draw";
+        case BbrPso:
+            return "Different PSO";
+        case BbrHlmsCommand:
+            return "Hlms batch-breaking command (datablock)";
+        case BbrVaoPool:
+            return "Different VAO pool";
+        case BbrMesh:
+            return "Different mesh";
+        case BbrLodMismatch:
+            return "LOD mismatch";
+        case BbrClusterCulling:
+            return "Cluster culling";
+        case BbrNotSupported:
+            return "Instancing not supported by RQ mode";
+        case NumBatchBreakReasons:
+            break;
+        }
+        return "Unknown";
+    }
 
 }  // namespace Ogre
@@ -32,6 +32,7 @@ THE SOFTWARE.
 
 #include "OgreProfiler.h"
 #include "OgreRenderSystem.h"
+#include "OgreSceneManager.h"
 #include "Vao/OgreConstBufferPacked.h"
 #include "Vao/OgreReadOnlyBufferPacked.h"
 #include "Vao/OgreStagingBuffer.h"
@@ -39,12 +40,17 @@ THE SOFTWARE.
 
 namespace Ogre
 {
+    /// Min number of dirty users per worker thread before
+    /// ConstBufferPool::uploadDirtyDatablocks goes multithreaded.
+    static const size_t c_minDirtyUsersPerThread = 64u;
+
     ConstBufferPool::ConstBufferPool( uint32 bytesPerSlot, const ExtraBufferParams &extraBufferParams ) :
         mBytesPerSlot( bytesPerSlot ),
         mSlotsPerPool( 0 ),
         mBufferSize( 0 ),
         mExtraBufferParams( extraBufferParams ),
         _mVaoManager( 0 ),
+        mUploadBufferStart( 0 ),
 #if OGRE_PLATFORM != OGRE_PLATFORM_APPLE_IOS && OGRE_PLATFORM != OGRE_PLATFORM_ANDROID
         mOptimizationStrategy( LowerCpuOverhead )
 #else
@@ -114,7 +120,7 @@ namespace Ogre
         }
     }
     //-----------------------------------------------------------------------------------
-    void ConstBufferPool::uploadDirtyDatablocks()
+    void ConstBufferPool::uploadDirtyDatablocks( SceneManager *sceneManager )
     {
         while( !mDirtyUsers.empty() )
         {
@@ -122,11 +128,11 @@ namespace Ogre
             // itself dirty again, in which case we need to loop again. Move users
             // to a temporary array to avoid iterator invalidation from screwing us.
             mDirtyUsersTmp.swap( mDirtyUsers );
-            uploadDirtyDatablocksImpl();
+            uploadDirtyDatablocksImpl( sceneManager );
         }
     }
     //-----------------------------------------------------------------------------------
-    void ConstBufferPool::uploadDirtyDatablocksImpl()
+    void ConstBufferPool::uploadDirtyDatablocksImpl( SceneManager *sceneManager )
     {
         assert( !mDirtyUsersTmp.empty() );
 
@@ -138,33 +144,55 @@ namespace Ogre
         std::sort( mDirtyUsersTmp.begin(), mDirtyUsersTmp.end(),
                    OrderConstBufferPoolUserByPoolThenSlot );
 
-        const size_t uploadSize = ( materialSizeInGpu + extraBufferSizeInGpu ) * mDirtyUsersTmp.size();
+        const size_t numDirtyUsers = mDirtyUsersTmp.size();
+        const size_t uploadSize = ( materialSizeInGpu + extraBufferSizeInGpu ) * numDirtyUsers;
         StagingBuffer *stagingBuffer = _mVaoManager->getStagingBuffer( uploadSize, true );
 
         StagingBuffer::DestinationVec destinations;
         StagingBuffer::DestinationVec extraDestinations;
 
-        destinations.reserve( mDirtyUsersTmp.size() );
-        extraDestinations.reserve( mDirtyUsersTmp.size() );
+        destinations.reserve( numDirtyUsers );
+        extraDestinations.reserve( numDirtyUsers );
 
-        ConstBufferPoolUserVec::const_iterator itor = mDirtyUsersTmp.begin();
-        ConstBufferPoolUserVec::const_iterator endt = mDirtyUsersTmp.end();
+        mDirtyUsersTmpFlags.resize( numDirtyUsers );
 
         char *bufferStart = reinterpret_cast<char *>( stagingBuffer->map( uploadSize ) );
-        char *data = bufferStart;
-        char *extraData = bufferStart + materialSizeInGpu * mDirtyUsersTmp.size();
+        mUploadBufferStart = bufferStart;
+
+        // Each user gets its own region of the StagingBuffer based on its index, so
+        // that they can be packed in any order (i.e. from multiple threads).
+        // Users from the same pool either all have an extra buffer or none do, thus
+        // the src of users with consecutive slots is contiguous in both regions.
+        size_t numParallelUsers = 0u;
 
-        while( itor != endt )
+        for( size_t i = 0u; i < numDirtyUsers; ++i )
         {
-            const size_t srcOffset = static_cast<size_t>( data - bufferStart );
-            const size_t dstOffset = ( *itor )->getAssignedSlot() * materialSizeInGpu;
+            ConstBufferPoolUser *user = mDirtyUsersTmp[i];
 
-            uint8 dirtyFlags = ( *itor )->mDirtyFlags;
-            ( *itor )->mDirtyFlags = DirtyNone;
-            ( *itor )->uploadToConstBuffer( data, dirtyFlags );
-            data += materialSizeInGpu;
+            const size_t srcOffset = i * materialSizeInGpu;
+            const size_t dstOffset = user->getAssignedSlot() * materialSizeInGpu;
+
+            uint8 dirtyFlags = user->mDirtyFlags;
+            user->mDirtyFlags = DirtyNone;
+
+            const BufferPool *usersPool = user->getAssignedPool();
 
-            const BufferPool *usersPool = ( *itor )->getAssignedPool();
+            if( dirtyFlags & ( DirtyTextures | DirtySamplers ) )
+            {
+                // Updating the descriptor sets is not thread safe. Upload it now.
+                mDirtyUsersTmpFlags[i] = DirtyNone;
+                user->uploadToConstBuffer( bufferStart + srcOffset, dirtyFlags );
+                if( usersPool->extraBuffer )
+                {
+                    user->uploadToExtraBuffer( bufferStart + materialSizeInGpu * numDirtyUsers +
+                                               i * extraBufferSizeInGpu );
+                }
+            }
+            else
+            {
+                mDirtyUsersTmpFlags[i] = dirtyFlags;
+                ++numParallelUsers;
+            }
 
             StagingBuffer::Destination dst( usersPool->materialBuffer, dstOffset, srcOffset,
                                             materialSizeInGpu );
@@ -190,12 +218,9 @@ namespace Ogre
 
             if( usersPool->extraBuffer )
             {
-                ( *itor )->uploadToExtraBuffer( extraData );
-
-                const size_t extraSrcOffset = static_cast<size_t>( extraData - bufferStart );
-                const size_t extraDstOffset = ( *itor )->getAssignedSlot() * extraBufferSizeInGpu;
-
-                extraData += extraBufferSizeInGpu;
+                const size_t extraSrcOffset =
+                    materialSizeInGpu * numDirtyUsers + i * extraBufferSizeInGpu;
+                const size_t extraDstOffset = user->getAssignedSlot() * extraBufferSizeInGpu;
 
                 StagingBuffer::Destination extraDst( usersPool->extraBuffer, extraDstOffset,
                                                      extraSrcOffset, extraBufferSizeInGpu );
@@ -219,10 +244,23 @@ namespace Ogre
                     extraDestinations.push_back( extraDst );
                 }
             }
+        }
 
-            ++itor;
+        if( numParallelUsers > 0u )
+        {
+            if( sceneManager && sceneManager->getNumWorkerThreads() > 1u &&
+                numParallelUsers >= c_minDirtyUsersPerThread * sceneManager->getNumWorkerThreads() )
+            {
+                sceneManager->executeUserScalableTask( this, true );
+            }
+            else
+            {
+                uploadDirtyUsersRange( 0u, numDirtyUsers );
+            }
         }
 
+        mUploadBufferStart = 0;
+
         destinations.insert( destinations.end(), extraDestinations.begin(), extraDestinations.end() );
 
         stagingBuffer->unmap( destinations );
@@ -231,6 +269,41 @@ namespace Ogre
         mDirtyUsersTmp.clear();
     }
     //-----------------------------------------------------------------------------------
+    void ConstBufferPool::uploadDirtyUsersRange( size_t start, size_t end )
+    {
+        const size_t materialSizeInGpu = mBytesPerSlot;
+        const size_t extraBufferSizeInGpu = mExtraBufferParams.bytesPerSlot;
+
+        char *data = mUploadBufferStart + start * materialSizeInGpu;
+        char *extraData = mUploadBufferStart + materialSizeInGpu * mDirtyUsersTmp.size() +
+                          start * extraBufferSizeInGpu;
+
+        for( size_t i = start; i < end; ++i )
+        {
+            const uint8 dirtyFlags = mDirtyUsersTmpFlags[i];
+            if( dirtyFlags != DirtyNone )
+            {
+                ConstBufferPoolUser *user = mDirtyUsersTmp[i];
+                user->uploadToConstBuffer( data, dirtyFlags );
+                if( user->getAssignedPool()->extraBuffer )
+                    user->uploadToExtraBuffer( extraData );
+            }
+
+            data += materialSizeInGpu;
+            extraData += extraBufferSizeInGpu;
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    void ConstBufferPool::execute( size_t threadId, size_t numThreads )
+    {
+        const size_t numDirtyUsers = mDirtyUsersTmp.size();
+        const size_t usersPerThread = ( numDirtyUsers + numThreads - 1u ) / numThreads;
+        const size_t start = std::min( threadId * usersPerThread, numDirtyUsers );
+        const size_t end = std::min( start + usersPerThread, numDirtyUsers );
+
+        uploadDirtyUsersRange( start, end );
+    }
+    //-----------------------------------------------------------------------------------
     void ConstBufferPool::requestSlot( uint32 hash, ConstBufferPoolUser *user, bool wantsExtraBuffer )
     {
         uint8 oldDirtyFlags = 0;
@@ -32,6 +32,7 @@ THE SOFTWARE.
 
 #include "Compositor/OgreCompositorShadowNode.h"
 #include "OgreCamera.h"
+#include "OgreFrameArena.h"
 #include "OgreHlms.h"
 #include "OgreProfiler.h"
 #include "OgreSceneManager.h"
@@ -141,8 +142,9 @@ namespace Ogre
             // Exclude shadow casting lights
             const LightClosestArray &shadowCastingLights = shadowNode->getShadowCastingLights();
 
-            mShadowCastingLightVisibility.clear();
-            mShadowCastingLightVisibility.reserve( shadowCastingLights.size() );
+            // Used to save and restore visibility of shadow casting lights
+            FrameArenaFastArray<bool>::type shadowCastingLightVisibility;
+            shadowCastingLightVisibility.reserve( shadowCastingLights.size() );
 
             LightClosestArray::const_iterator itor = shadowCastingLights.begin();
             LightClosestArray::const_iterator endt = shadowCastingLights.end();
@@ -151,7 +153,7 @@ namespace Ogre
             {
                 if( itor->light )
                 {
-                    mShadowCastingLightVisibility.push_back( itor->light->getVisible() );
+                    shadowCastingLightVisibility.push_back( itor->light->getVisible() );
                     itor->light->setVisible( false );
                 }
                 ++itor;
@@ -161,7 +163,7 @@ namespace Ogre
                                        mCurrentLightList );
 
             // Restore shadow casting lights
-            FastArray<bool>::const_iterator itVis = mShadowCastingLightVisibility.begin();
+            FrameArenaFastArray<bool>::type::const_iterator itVis = shadowCastingLightVisibility.begin();
             itor = shadowCastingLights.begin();
             endt = shadowCastingLights.end();
 
@@ -36,6 +36,7 @@ THE SOFTWARE.
 #include "Math/Array/OgreObjectMemoryManager.h"
 #include "OgreCamera.h"
 #include "OgreDecal.h"
+#include "OgreFrameArena.h"
 #include "OgreHlms.h"
 #include "OgreProfiler.h"
 #include "OgreSceneManager.h"
@@ -74,7 +75,8 @@ namespace Ogre
         mMaxDistance( maxDistance ),
         mObjectMemoryManager( 0 ),
         mNodeMemoryManager( 0 ),
-        mDebugWireAabbFrozen( false )
+        mDebugWireAabbFrozen( false ),
+        mTemporalReuse( false )
     {
         // SIMD optimization restriction.
         assert( ( width % ARRAY_PACKED_REALS ) == 0 && "Width must be multiple of ARRAY_PACKED_REALS!" );
@@ -147,11 +149,19 @@ namespace Ogre
         const size_t slicesPerThread = mNumSlices / numThreads;
 
         for( size_t i = 0; i < slicesPerThread; ++i )
-            collectLightForSlice( i + threadId * slicesPerThread, threadId );
+        {
+            const size_t slice = i + threadId * slicesPerThread;
+            if( mDirtySlices[slice] )
+                collectLightForSlice( slice, threadId );
+        }
 
         const size_t slicesRemainder = mNumSlices % numThreads;
         if( slicesRemainder > threadId )
-            collectLightForSlice( threadId + numThreads * slicesPerThread, threadId );
+        {
+            const size_t slice = threadId + numThreads * slicesPerThread;
+            if( mDirtySlices[slice] )
+                collectLightForSlice( slice, threadId );
+        }
     }
     //-----------------------------------------------------------------------------------
     inline size_t ForwardClustered::getDecalsOffsetStart() const
@@ -895,6 +905,152 @@ namespace Ogre
         outNumCubemapProbes = numCubemapProbes;
     }
     //-----------------------------------------------------------------------------------
+    void ForwardClustered::calculateSliceRange( TemporalObjState &outState, Real radius,
+                                                const Matrix4 &viewMatrix ) const
+    {
+        // Slices are only along the Z axis. The closest point has the biggest (less negative)
+        // depth. Points behind the camera end up in slice 0.
+        const Real viewSpaceDepth = viewMatrix.transformAffine( outState.position ).z;
+        outState.firstSlice = std::min( getSliceAtDepth( viewSpaceDepth + radius ), mNumSlices - 1u );
+        outState.lastSlice = std::min( getSliceAtDepth( viewSpaceDepth - radius ), mNumSlices - 1u );
+    }
+    //-----------------------------------------------------------------------------------
+    void ForwardClustered::getLightTemporalState( const Light *light, const Matrix4 &viewMatrix,
+                                                  TemporalObjState &outState ) const
+    {
+        const Node *lightNode = light->getParentNode();
+
+        outState.object = light;
+        outState.position = lightNode->_getDerivedPosition();
+        outState.orientation = lightNode->_getDerivedOrientation();
+        outState.scale = Vector3::UNIT_SCALE;
+        outState.range = light->getAttenuationRange();
+        outState.spotTanHalfAngle = light->getSpotlightTanHalfAngle();
+        outState.lightType = static_cast<uint8>( light->getType() );
+
+        Real radius = outState.range;
+        if( light->getType() == Light::LT_SPOTLIGHT )
+        {
+            // Sphere enclosing the pyramid (or OBB, for wide spots) used by collectLightForSlice
+            const Real lenOpposite = outState.spotTanHalfAngle <= 1.0f
+                                         ? outState.spotTanHalfAngle
+                                         : light->getSpotlightSinHalfAngle();
+            radius *= Math::Sqrt( 1.0f + 2.0f * lenOpposite * lenOpposite );
+        }
+
+        calculateSliceRange( outState, radius, viewMatrix );
+    }
+    //-----------------------------------------------------------------------------------
+    void ForwardClustered::getObjTemporalState( const MovableObject *obj, const Matrix4 &viewMatrix,
+                                                TemporalObjState &outState ) const
+    {
+        const Node *node = obj->getParentNode();
+
+        outState.object = obj;
+        outState.position = node->_getDerivedPosition();
+        outState.orientation = node->_getDerivedOrientation();
+        outState.scale = node->_getDerivedScale();
+        outState.range = 0;
+        outState.spotTanHalfAngle = 0;
+        outState.lightType = 0;
+
+        calculateSliceRange( outState, ( outState.scale * 0.5f ).length(), viewMatrix );
+    }
+    //-----------------------------------------------------------------------------------
+    void ForwardClustered::markDirtySlices( uint32 firstSlice, uint32 lastSlice )
+    {
+        for( uint32 i = firstSlice; i <= lastSlice; ++i )
+            mDirtySlices[i] = true;
+    }
+    //-----------------------------------------------------------------------------------
+    size_t ForwardClustered::updateDirtySlices( const Camera *camera, CachedGrid *cachedGrid )
+    {
+        const Matrix4 &viewMatrix = camera->getViewMatrix( true );
+        const Matrix4 &projMatrix = camera->getProjectionMatrix();
+
+        // Gather the current state, in the same order collectLightForSlice uses them
+        mTmpLightStates.resizePOD( mCurrentLightList.size() );
+        for( size_t i = 0u; i < mCurrentLightList.size(); ++i )
+            getLightTemporalState( mCurrentLightList[i], viewMatrix, mTmpLightStates[i] );
+
+        mTmpObjStates.clear();
+        const VisibleObjectsPerRq &objsPerRqInThread0 = mSceneManager->_getTmpVisibleObjectsList()[0];
+        const size_t actualMaxDecalRq = std::min<size_t>( MaxDecalRq, objsPerRqInThread0.size() );
+        const size_t actualMaxCubemapProbeRq =
+            std::min<size_t>( MaxCubemapProbeRq, objsPerRqInThread0.size() );
+        for( int i = 0; i < 2; ++i )
+        {
+            const size_t minRq = i == 0 ? MinDecalRq : MinCubemapProbeRq;
+            const size_t maxRq = i == 0 ? actualMaxDecalRq : actualMaxCubemapProbeRq;
+            for( size_t rqId = minRq; rqId <= maxRq && rqId < objsPerRqInThread0.size(); ++rqId )
+            {
+                MovableObject::MovableObjectArray::const_iterator itor =
+                    objsPerRqInThread0[rqId].begin();
+                MovableObject::MovableObjectArray::const_iterator endt = objsPerRqInThread0[rqId].end();
+
+                while( itor != endt )
+                {
+                    mTmpObjStates.push_back( TemporalObjState() );
+                    getObjTemporalState( *itor, viewMatrix, mTmpObjStates.back() );
+                    ++itor;
+                }
+            }
+        }
+
+        // The grid stores indices into the light/decal/probe lists. If the camera changed or
+        // the lists differ in size or order, every slice must be rebuilt. The debug frustum
+        // needs mFrustumRegions for all slices to be up to date.
+        bool fullRebuild = cachedGrid->gridShadow.empty() || !mDebugWireAabb.empty() ||
+                           cachedGrid->lastViewMatrix != viewMatrix ||
+                           cachedGrid->lastProjMatrix != projMatrix ||
+                           cachedGrid->lastLights.size() != mTmpLightStates.size() ||
+                           cachedGrid->lastObjs.size() != mTmpObjStates.size();
+
+        mDirtySlices.resizePOD( mNumSlices, false );
+        memset( mDirtySlices.begin(), 0, mNumSlices * sizeof( bool ) );
+
+        for( int i = 0; i < 2 && !fullRebuild; ++i )
+        {
+            const FastArray<TemporalObjState> &oldStates =
+                i == 0 ? cachedGrid->lastLights : cachedGrid->lastObjs;
+            const FastArray<TemporalObjState> &newStates = i == 0 ? mTmpLightStates : mTmpObjStates;
+
+            FastArray<TemporalObjState>::const_iterator itOld = oldStates.begin();
+            FastArray<TemporalObjState>::const_iterator itor = newStates.begin();
+            FastArray<TemporalObjState>::const_iterator endt = newStates.end();
+
+            while( itor != endt && !fullRebuild )
+            {
+                if( itor->object != itOld->object )
+                {
+                    fullRebuild = true;
+                }
+                else if( !itor->hasSameState( *itOld ) )
+                {
+                    // Rebuild the slices it used to touch, and the ones it touches now
+                    markDirtySlices( itOld->firstSlice, itOld->lastSlice );
+                    markDirtySlices( itor->firstSlice, itor->lastSlice );
+                }
+                ++itOld;
+                ++itor;
+            }
+        }
+
+        if( fullRebuild )
+            memset( mDirtySlices.begin(), 1, mNumSlices * sizeof( bool ) );
+
+        cachedGrid->gridShadow.resizePOD( mWidth * mHeight * mNumSlices * mObjsPerCell );
+        cachedGrid->lastViewMatrix = viewMatrix;
+        cachedGrid->lastProjMatrix = projMatrix;
+        cachedGrid->lastLights.swap( mTmpLightStates );
+        cachedGrid->lastObjs.swap( mTmpObjStates );
+
+        size_t numDirtySlices = 0u;
+        for( size_t i = 0u; i < mNumSlices; ++i )
+            numDirtySlices += mDirtySlices[i] ? 1u : 0u;
+        return numDirtySlices;
+    }
+    //-----------------------------------------------------------------------------------
     inline bool OrderLightByDistanceToCamera( const Light *left, const Light *right )
     {
         if( left->getType() != right->getType() )
@@ -920,8 +1076,9 @@ namespace Ogre
             // Exclude shadow casting lights
             const LightClosestArray &shadowCastingLights = shadowNode->getShadowCastingLights();
 
-            mShadowCastingLightVisibility.clear();
-            mShadowCastingLightVisibility.reserve( shadowCastingLights.size() );
+            // Used to save and restore visibility of shadow casting lights
+            FrameArenaFastArray<bool>::type shadowCastingLightVisibility;
+            shadowCastingLightVisibility.reserve( shadowCastingLights.size() );
 
             LightClosestArray::const_iterator itor = shadowCastingLights.begin();
             LightClosestArray::const_iterator endt = shadowCastingLights.end();
@@ -930,7 +1087,7 @@ namespace Ogre
             {
                 if( itor->light )
                 {
-                    mShadowCastingLightVisibility.push_back( itor->light->getVisible() );
+                    shadowCastingLightVisibility.push_back( itor->light->getVisible() );
                     itor->light->setVisible( false );
                 }
                 ++itor;
@@ -940,7 +1097,7 @@ namespace Ogre
                                        mCurrentLightList );
 
             // Restore shadow casting lights
-            FastArray<bool>::const_iterator itVis = mShadowCastingLightVisibility.begin();
+            FrameArenaFastArray<bool>::type::const_iterator itVis = shadowCastingLightVisibility.begin();
             itor = shadowCastingLights.begin();
             endt = shadowCastingLights.end();
 
@@ -998,17 +1155,38 @@ namespace Ogre
         fillGlobalLightListBuffer( camera, gridBuffers.globalLightListBuffer );
 
         // Fill the indexes buffer
-        mGridBuffer = reinterpret_cast<uint16 * RESTRICT_ALIAS>(
+        uint16 *RESTRICT_ALIAS mappedGridBuffer = reinterpret_cast<uint16 * RESTRICT_ALIAS>(
             gridBuffers.gridBuffer->map( 0, gridBuffers.gridBuffer->getNumElements() ) );
 
         // memset( mLightCountInCell.begin(), 0, mLightCountInCell.size() * sizeof(LightCount) );
 
+        size_t numDirtySlices = mNumSlices;
+        if( mTemporalReuse )
+        {
+            // Build into the CPU copy, as the mapped buffer doesn't contain last frame's data
+            numDirtySlices = updateDirtySlices( camera, cachedGrid );
+            mGridBuffer = cachedGrid->gridShadow.begin();
+        }
+        else
+        {
+            mDirtySlices.resizePOD( mNumSlices, false );
+            memset( mDirtySlices.begin(), 1, mNumSlices * sizeof( bool ) );
+            mGridBuffer = mappedGridBuffer;
+        }
+
         mCurrentCamera = camera;
         // Make sure these are up to date when calling the cached versions from multiple threads.
         mCurrentCamera->getDerivedPosition();
         mCurrentCamera->getWorldSpaceCorners();
 
-        mSceneManager->executeUserScalableTask( this, true );
+        if( numDirtySlices > 0u )
+            mSceneManager->executeUserScalableTask( this, true );
+
+        if( mTemporalReuse )
+        {
+            memcpy( mappedGridBuffer, cachedGrid->gridShadow.begin(),
+                    cachedGrid->gridShadow.size() * sizeof( uint16 ) );
+        }
 
         if( !mDebugWireAabb.empty() && !mDebugWireAabbFrozen )
         {
@@ -1170,4 +1348,21 @@ namespace Ogre
     }
     //-----------------------------------------------------------------------------------
     bool ForwardClustered::getFreezeDebugFrustum() const { return mDebugWireAabbFrozen; }
+    //-----------------------------------------------------------------------------------
+    void ForwardClustered::setTemporalReuse( bool bTemporalReuse )
+    {
+        mTemporalReuse = bTemporalReuse;
+
+        // The CPU copies are not kept up to date while disabled
+        CachedGridVec::iterator itor = mCachedGrid.begin();
+        CachedGridVec::iterator endt = mCachedGrid.end();
+
+        while( itor != endt )
+        {
+            itor->gridShadow.destroy();
+            itor->lastLights.destroy();
+            itor->lastObjs.destroy();
+            ++itor;
+        }
+    }
 }  // namespace Ogre
@@ -0,0 +1,181 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+
+#include "OgreFrameArena.h"
+
+#include "OgreAlignedAllocator.h"
+#include "OgreCommon.h"
+#include "OgreLogManager.h"
+#include "OgreStringConverter.h"
+
+#include <atomic>
+
+namespace Ogre
+{
+    static std::atomic<uint32> gFrameArenaFrameCount( 0u );
+    static std::atomic<bool> gFrameArenaReportPeakUsage( false );
+
+    FrameArena::FrameArena( size_t defaultChunkSize ) :
+        mCurrentBuffer( 0u ),
+        mLastFrame( gFrameArenaFrameCount.load( std::memory_order_relaxed ) ),
+        mDefaultChunkSize( defaultChunkSize ),
+        mPeakBytesUsed( 0u ),
+        mReportedPeakBytesUsed( 0u )
+    {
+    }
+    //-----------------------------------------------------------------------------------
+    FrameArena::~FrameArena()
+    {
+        for( size_t i = 0u; i < 2u; ++i )
+        {
+            std::vector<Chunk>::const_iterator itor = mBuffers[i].chunks.begin();
+            std::vector<Chunk>::const_iterator endt = mBuffers[i].chunks.end();
+
+            while( itor != endt )
+            {
+                AlignedMemory::deallocate( itor->data );
+                ++itor;
+            }
+            mBuffers[i].chunks.clear();
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    void FrameArena::resetBuffer( Buffer &buffer )
+    {
+        if( buffer.chunks.size() > 1u )
+        {
+            // The buffer overflowed its chunk. Merge all chunks into a single
+            // one big enough so that we don't overflow again next time.
+            size_t totalSize = 0u;
+            std::vector<Chunk>::const_iterator itor = buffer.chunks.begin();
+            std::vector<Chunk>::const_iterator endt = buffer.chunks.end();
+
+            while( itor != endt )
+            {
+                totalSize += itor->size;
+                AlignedMemory::deallocate( itor->data );
+                ++itor;
+            }
+            buffer.chunks.clear();
+
+            addChunk( buffer, totalSize );
+        }
+
+        buffer.offset = 0u;
+        buffer.bytesUsed = 0u;
+    }
+    //-----------------------------------------------------------------------------------
+    void FrameArena::addChunk( Buffer &buffer, size_t minSize )
+    {
+        Chunk chunk;
+        chunk.size = std::max( minSize, mDefaultChunkSize );
+        chunk.data = static_cast<uint8 *>( AlignedMemory::allocate( chunk.size ) );
+        buffer.chunks.push_back( chunk );
+        buffer.offset = 0u;
+    }
+    //-----------------------------------------------------------------------------------
+    void FrameArena::syncFrame()
+    {
+        const uint32 currentFrame = gFrameArenaFrameCount.load( std::memory_order_relaxed );
+        if( currentFrame == mLastFrame )
+            return;
+
+        const uint32 framesElapsed = currentFrame - mLastFrame;
+        mLastFrame = currentFrame;
+
+        if( mPeakBytesUsed > mReportedPeakBytesUsed &&
+            gFrameArenaReportPeakUsage.load( std::memory_order_relaxed ) )
+        {
+            mReportedPeakBytesUsed = mPeakBytesUsed;
+            LogManager::getSingleton().logMessage( "FrameArena: new peak usage of " +
+                                                   StringConverter::toString( mPeakBytesUsed ) +
+                                                   " bytes in a single frame" );
+        }
+
+        // The buffer of the previous frame must stay valid during this frame,
+        // so recycle the one from two frames ago (unless we slept more than that)
+        mCurrentBuffer ^= 1u;
+        resetBuffer( mBuffers[mCurrentBuffer] );
+        if( framesElapsed > 1u )
+            resetBuffer( mBuffers[mCurrentBuffer ^ 1u] );
+    }
+    //-----------------------------------------------------------------------------------
+    void *FrameArena::allocate( size_t bytes, size_t alignment )
+    {
+        OGRE_ASSERT_MEDIUM( ( alignment & ( alignment - 1u ) ) == 0u &&
+                            "Alignment must be a power of 2" );
+
+        syncFrame();
+
+        Buffer &buffer = mBuffers[mCurrentBuffer];
+
+        size_t alignedOffset = 0u;
+        if( !buffer.chunks.empty() )
+        {
+            const uintptr_t base = reinterpret_cast<uintptr_t>( buffer.chunks.back().data );
+            alignedOffset = alignToNextMultiple<uintptr_t>( base + buffer.offset, alignment ) - base;
+        }
+
+        if( buffer.chunks.empty() || alignedOffset + bytes > buffer.chunks.back().size )
+        {
+            // Leave enough room to align the allocation within the new chunk
+            addChunk( buffer, bytes + alignment );
+            const uintptr_t base = reinterpret_cast<uintptr_t>( buffer.chunks.back().data );
+            alignedOffset = alignToNextMultiple<uintptr_t>( base, alignment ) - base;
+        }
+
+        const size_t newOffset = alignedOffset + bytes;
+        buffer.bytesUsed += newOffset - buffer.offset;
+        buffer.offset = newOffset;
+        mPeakBytesUsed = std::max( mPeakBytesUsed, buffer.bytesUsed );
+
+        return buffer.chunks.back().data + alignedOffset;
+    }
+    //-----------------------------------------------------------------------------------
+    FrameArena &FrameArena::get()
+    {
+        static thread_local FrameArena t_frameArena;
+        return t_frameArena;
+    }
+    //-----------------------------------------------------------------------------------
+    void FrameArena::setReportPeakUsage( bool bReport )
+    {
+        gFrameArenaReportPeakUsage.store( bReport, std::memory_order_relaxed );
+    }
+    //-----------------------------------------------------------------------------------
+    bool FrameArena::getReportPeakUsage()
+    {
+        return gFrameArenaReportPeakUsage.load( std::memory_order_relaxed );
+    }
+    //-----------------------------------------------------------------------------------
+    void FrameArena::_notifyFrameEnded()
+    {
+        gFrameArenaFrameCount.fetch_add( 1u, std::memory_order_relaxed );
+    }
+}  // namespace Ogre
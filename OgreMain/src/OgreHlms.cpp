@@ -50,6 +50,7 @@ THE SOFTWARE.
 #include "OgreRenderQueue.h"
 #include "OgreRootLayout.h"
 #include "OgreSceneManager.h"
+#include "OgreTimer.h"
 #include "OgreViewport.h"
 #include "ParticleSystem/OgreParticleSystem2.h"
 #include "Vao/OgreVaoManager.h"
@@ -293,6 +294,7 @@ namespace Ogre
 
     Hlms::Hlms( HlmsTypes type, const String &typeName, Archive *dataFolder,
                 ArchiveVec *libraryFolders ) :
+        mPsoStatsTimer( 0 ),
         mDataFolder( dataFolder ),
         mHlmsManager( 0 ),
         mShadersGenerated( 0u ),
@@ -325,6 +327,7 @@ namespace Ogre
 #endif
         mPrecisionMode( PrecisionFull32 ),
         mFastShaderBuildHack( false ),
+        mBatchedFillBuffers( false ),
         mDefaultDatablock( 0 ),
         mType( type ),
         mTypeName( typeName ),
@@ -363,6 +366,7 @@ namespace Ogre
     //-----------------------------------------------------------------------------------
     Hlms::~Hlms()
     {
+        setPsoStatsEnabled( false );
         clearShaderCache();
 
         _destroyAllDatablocks();
@@ -2120,6 +2124,8 @@ namespace Ogre
         mShaderCodeCache.clear();
         mShadersGenerated = 0u;
         mShaderCodeCacheDirty = true;
+
+        resetPsoStats();
     }
     //-----------------------------------------------------------------------------------
     void Hlms::processPieces( Archive *archive, const StringVector &pieceFiles, const size_t tid )
@@ -2741,6 +2747,11 @@ namespace Ogre
     {
         OgreProfileExhaustive( "Hlms::createShaderCacheEntry" );
 
+        Timer *psoStatsTimer = mPsoStatsTimer;
+        const uint64 psoStatsStartTime = psoStatsTimer ? psoStatsTimer->getMicroseconds() : 0u;
+        uint64 psoStatsShaderTime = 0u;
+        HlmsPropertyVec psoStatsProperties;
+
         // Set the properties by merging the cache from the pass, with the cache from renderable
         mT[tid].setProperties.clear();
         // If retVal is null, we did something wrong earlier
@@ -2806,6 +2817,8 @@ namespace Ogre
         unsetProperty( tid, HlmsPsoProp::Macroblock );
         unsetProperty( tid, HlmsPsoProp::Blendblock );
         unsetProperty( tid, HlmsPsoProp::InputLayoutId );
+        if( psoStatsTimer )
+            psoStatsProperties = mT[tid].setProperties;
         codeCache.mergedCache.setProperties.swap( mT[tid].setProperties );
         {
             bool bIsInCache;
@@ -2828,7 +2841,12 @@ namespace Ogre
             }
 
             if( !bIsInCache )
+            {
+                const uint64 shaderStartTime = psoStatsTimer ? psoStatsTimer->getMicroseconds() : 0u;
                 compileShaderCode( codeCache, shaderCounter, tid );
+                if( psoStatsTimer )
+                    psoStatsShaderTime = psoStatsTimer->getMicroseconds() - shaderStartTime;
+            }
             else
             {
                 // This can be done in parallel, as we've copied what itCodeCache needed
@@ -2908,6 +2926,23 @@ namespace Ogre
 
         applyTextureRegisters( retVal, tid );
 
+        if( psoStatsTimer )
+        {
+            const uint64 totalTime = psoStatsTimer->getMicroseconds() - psoStatsStartTime;
+
+            ScopedLock lock( mPsoStatsMutex );
+            PsoStats &stats = mPsoStats[finalHash];
+            if( !stats.numAttempts )
+            {
+                stats.synchronous = reservedStubEntry == 0;
+                stats.datablockName = datablock->getName().getFriendlyText();
+                stats.properties.swap( psoStatsProperties );
+            }
+            ++stats.numAttempts;
+            stats.totalTimeUs += totalTime;
+            stats.shaderTimeUs += psoStatsShaderTime;
+        }
+
         return retVal;
     }
     //-----------------------------------------------------------------------------------
@@ -3948,6 +3983,9 @@ namespace Ogre
 
         if( lastReturnedValue->hash != finalHash )
         {
+            if( mPsoStatsTimer )
+                notePsoStatsUse( finalHash );
+
             lastReturnedValue = this->getShaderCache( finalHash );
 
             if( !lastReturnedValue )
@@ -3982,6 +4020,210 @@ namespace Ogre
         return lastReturnedValue;
     }
     //-----------------------------------------------------------------------------------
+    void Hlms::notePsoStatsUse( uint32 finalHash )
+    {
+        ScopedLock lock( mPsoStatsMutex );
+        PsoStats &stats = mPsoStats[finalHash];
+        if( !stats.useCount )
+            stats.firstUseFrame = mRenderSystem->getVaoManager()->getFrameCount();
+        ++stats.useCount;
+    }
+    //-----------------------------------------------------------------------------------
+    Hlms::PsoStats::PsoStats() :
+        firstUseFrame( 0u ),
+        useCount( 0u ),
+        numAttempts( 0u ),
+        totalTimeUs( 0u ),
+        shaderTimeUs( 0u ),
+        synchronous( false )
+    {
+    }
+    //-----------------------------------------------------------------------------------
+    void Hlms::setPsoStatsEnabled( bool bEnabled )
+    {
+        if( bEnabled && !mPsoStatsTimer )
+        {
+            mPsoStatsTimer = OGRE_NEW Timer();
+        }
+        else if( !bEnabled && mPsoStatsTimer )
+        {
+            OGRE_DELETE mPsoStatsTimer;
+            mPsoStatsTimer = 0;
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    void Hlms::resetPsoStats()
+    {
+        ScopedLock lock( mPsoStatsMutex );
+        mPsoStats.clear();
+    }
+    //-----------------------------------------------------------------------------------
+    Hlms::PsoStatsMap Hlms::getPsoStats() const
+    {
+        ScopedLock lock( mPsoStatsMutex );
+        return mPsoStats;
+    }
+    //-----------------------------------------------------------------------------------
+    /// Appends value as a double-quoted CSV field, doubling any quote inside it.
+    static void appendCsvField( String &outString, const String &value )
+    {
+        outString.push_back( '"' );
+        String::const_iterator itor = value.begin();
+        String::const_iterator endt = value.end();
+        while( itor != endt )
+        {
+            if( *itor == '"' )
+                outString.push_back( '"' );
+            outString.push_back( *itor );
+            ++itor;
+        }
+        outString.push_back( '"' );
+    }
+    //-----------------------------------------------------------------------------------
+    /// Appends value as a double-quoted JSON string, escaping it as necessary.
+    static void appendJsonString( String &outString, const String &value )
+    {
+        outString.push_back( '"' );
+        String::const_iterator itor = value.begin();
+        String::const_iterator endt = value.end();
+        while( itor != endt )
+        {
+            const char c = *itor;
+            switch( c )
+            {
+            case '"':
+                outString += "\\\"";
+                break;
+            case '\\':
+                outString += "\\\\";
+                break;
+            case '\n':
+                outString += "\\n";
+                break;
+            case '\r':
+                outString += "\\r";
+                break;
+            case '\t':
+                outString += "\\t";
+                break;
+            default:
+                if( static_cast<unsigned char>( c ) < 0x20u )
+                {
+                    char tmpBuffer[8];
+                    std::snprintf( tmpBuffer, sizeof( tmpBuffer ), "\\u%04x",
+                                   static_cast<unsigned>( c ) );
+                    outString += tmpBuffer;
+                }
+                else
+                {
+                    outString.push_back( c );
+                }
+                break;
+            }
+            ++itor;
+        }
+        outString.push_back( '"' );
+    }
+    //-----------------------------------------------------------------------------------
+    void Hlms::exportPsoStats( String &outString, bool bCsv ) const
+    {
+        ScopedLock lock( mPsoStatsMutex );
+
+        char tmpBuffer[128];
+        LwString valueStr( LwString::FromEmptyPointer( tmpBuffer, sizeof( tmpBuffer ) ) );
+
+        if( bCsv )
+        {
+            outString +=
+                "hash,datablock,first_use_frame,use_count,attempts,total_us,shader_us,synchronous,"
+                "properties\n";
+        }
+        else
+        {
+            outString += "{\n\t\"hlms\" : ";
+            appendJsonString( outString, mTypeName.getFriendlyText() );
+            outString += ",\n\t\"psos\" :\n\t[";
+        }
+
+        PsoStatsMap::const_iterator itor = mPsoStats.begin();
+        PsoStatsMap::const_iterator endt = mPsoStats.end();
+
+        while( itor != endt )
+        {
+            const PsoStats &stats = itor->second;
+
+            valueStr.clear();
+            if( bCsv )
+            {
+                valueStr.a( itor->first, "," );
+                outString += valueStr.c_str();
+                appendCsvField( outString, stats.datablockName );
+                outString += ",";
+                valueStr.clear();
+                valueStr.a( stats.firstUseFrame, ",", stats.useCount, ",", stats.numAttempts, "," );
+                valueStr.a( stats.totalTimeUs, ",", stats.shaderTimeUs, "," );
+                valueStr.a( stats.synchronous ? "1," : "0," );
+                outString += valueStr.c_str();
+
+                String properties;
+                HlmsPropertyVec::const_iterator itProp = stats.properties.begin();
+                HlmsPropertyVec::const_iterator enProp = stats.properties.end();
+                while( itProp != enProp )
+                {
+                    if( itProp != stats.properties.begin() )
+                        properties += ";";
+                    properties += itProp->keyName.getFriendlyText();
+                    valueStr.clear();
+                    valueStr.a( "=", itProp->value );
+                    properties += valueStr.c_str();
+                    ++itProp;
+                }
+                appendCsvField( outString, properties );
+                outString += "\n";
+            }
+            else
+            {
+                if( itor != mPsoStats.begin() )
+                    outString += ",";
+                outString += "\n\t\t{\n\t\t\t\"hash\" : ";
+                valueStr.a( itor->first );
+                valueStr.a( ",\n\t\t\t\"first_use_frame\" : ", stats.firstUseFrame );
+                valueStr.a( ",\n\t\t\t\"use_count\" : ", stats.useCount );
+                valueStr.a( ",\n\t\t\t\"attempts\" : ", stats.numAttempts );
+                outString += valueStr.c_str();
+                valueStr.clear();
+                valueStr.a( ",\n\t\t\t\"total_us\" : ", stats.totalTimeUs );
+                valueStr.a( ",\n\t\t\t\"shader_us\" : ", stats.shaderTimeUs );
+                valueStr.a( ",\n\t\t\t\"synchronous\" : ", stats.synchronous ? "true" : "false" );
+                outString += valueStr.c_str();
+                outString += ",\n\t\t\t\"datablock\" : ";
+                appendJsonString( outString, stats.datablockName );
+                outString += ",\n\t\t\t\"properties\" :\n\t\t\t{";
+
+                HlmsPropertyVec::const_iterator itProp = stats.properties.begin();
+                HlmsPropertyVec::const_iterator enProp = stats.properties.end();
+                while( itProp != enProp )
+                {
+                    if( itProp != stats.properties.begin() )
+                        outString += ",";
+                    outString += "\n\t\t\t\t";
+                    appendJsonString( outString, itProp->keyName.getFriendlyText() );
+                    outString += " : ";
+                    valueStr.clear();
+                    valueStr.a( itProp->value );
+                    outString += valueStr.c_str();
+                    ++itProp;
+                }
+                outString += "\n\t\t\t}\n\t\t}";
+            }
+
+            ++itor;
+        }
+
+        if( !bCsv )
+            outString += "\n\t]\n}\n";
+    }
+    //-----------------------------------------------------------------------------------
     void Hlms::compileStubEntry( const HlmsCache &passCache, HlmsCache *reservedStubEntry,
                                  uint64 deadline, QueuedRenderable queuedRenderable,
                                  uint32 renderableHash, uint32 finalHash, size_t tid )
@@ -3990,6 +4232,17 @@ namespace Ogre
                                 reservedStubEntry, deadline, tid );
     }
     //-----------------------------------------------------------------------------------
+    size_t Hlms::fillBuffersForBatch( const HlmsCache *cache, const QueuedRenderable *begin,
+                                      const QueuedRenderable *end, bool casterPass,
+                                      uint32 lastCacheHash, CommandBuffer *commandBuffer,
+                                      uint32 *outBaseInstances )
+    {
+        OGRE_ASSERT_LOW( begin < end );
+        outBaseInstances[0] =
+            fillBuffersForV2( cache, *begin, casterPass, lastCacheHash, commandBuffer );
+        return 1u;
+    }
+    //-----------------------------------------------------------------------------------
     uint32 Hlms::getMaterialSerial01( uint32 lastReturnedValue, const HlmsCache &passCache,
                                       const size_t passCacheIdx,
                                       const QueuedRenderable &queuedRenderable, bool casterPass,
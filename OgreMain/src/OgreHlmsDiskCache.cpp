@@ -45,11 +45,12 @@ THE SOFTWARE.
 
 namespace Ogre
 {
-    static const uint16 c_hlmsDiskCacheVersion = 6u;
+    static const uint16 c_hlmsDiskCacheVersion = 7u;
 
     HlmsDiskCache::HlmsDiskCache( HlmsManager *hlmsManager ) :
         mTemplatesOutOfDate( false ),
-        mHlmsManager( hlmsManager )
+        mHlmsManager( hlmsManager ),
+        mListener( 0 )
     {
     }
     //-----------------------------------------------------------------------------------
@@ -72,10 +73,17 @@ namespace Ogre
     //-----------------------------------------------------------------------------------
     //-----------------------------------------------------------------------------------
     //-----------------------------------------------------------------------------------
-    HlmsDiskCache::SourceCode::SourceCode() : mergedCache( HlmsPropertyVec(), 0 ) {}
+    HlmsDiskCache::SourceCode::SourceCode() :
+        mergedCache( HlmsPropertyVec(), 0 ),
+        hitCount( 1u ),
+        useCount( 0u )
+    {
+    }
     //-----------------------------------------------------------------------------------
     HlmsDiskCache::SourceCode::SourceCode( const Hlms::ShaderCodeCache &shaderCodeCache ) :
-        mergedCache( shaderCodeCache.mergedCache )
+        mergedCache( shaderCodeCache.mergedCache ),
+        hitCount( 1u ),
+        useCount( 0u )
     {
         for( size_t i = 0; i < NumShaderTypes; ++i )
         {
@@ -158,6 +166,28 @@ namespace Ogre
             }
         }
 
+        if( hlms->getPsoStatsEnabled() )
+        {
+            // Use the runtime stats to prioritize the variants that were actually used the most.
+            const Hlms::PsoStatsMap psoStats = hlms->getPsoStats();
+            Hlms::PsoStatsMap::const_iterator itStats = psoStats.begin();
+            Hlms::PsoStatsMap::const_iterator enStats = psoStats.end();
+
+            while( itStats != enStats )
+            {
+                SourceCodeVec::iterator itor = mCache.sourceCode.begin();
+                SourceCodeVec::iterator endt = mCache.sourceCode.end();
+
+                while( itor != endt )
+                {
+                    if( itor->mergedCache.setProperties == itStats->second.properties )
+                        itor->useCount += itStats->second.useCount;
+                    ++itor;
+                }
+                ++itStats;
+            }
+        }
+
         {
             // Copy PSOs
             mCache.pso.reserve( hlms->mShaderCache.size() );
@@ -199,6 +229,173 @@ namespace Ogre
         }
     }
     //-----------------------------------------------------------------------------------
+    static bool isRuntimeIdProperty( IdString keyName )
+    {
+        return keyName == HlmsPsoProp::Macroblock || keyName == HlmsPsoProp::Blendblock ||
+               keyName == HlmsPsoProp::InputLayoutId;
+    }
+    //-----------------------------------------------------------------------------------
+    bool HlmsDiskCache::isSamePso( const Pso &a, const Pso &b )
+    {
+        if( a.passProperties != b.passProperties ||                          //
+            a.pso.vertexElements != b.pso.vertexElements ||                  //
+            a.pso.operationType != b.pso.operationType ||                    //
+            a.pso.enablePrimitiveRestart != b.pso.enablePrimitiveRestart ||  //
+            a.pso.sampleMask != b.pso.sampleMask ||                          //
+            a.pso.pass != b.pso.pass ||                                      //
+            a.macroblock != b.macroblock ||                                  //
+            a.blendblock != b.blendblock )
+        {
+            return false;
+        }
+
+        for( size_t i = 0; i < NumShaderTypes; ++i )
+        {
+            if( a.renderableCache.pieces[i] != b.renderableCache.pieces[i] )
+                return false;
+        }
+
+        // Macroblock, Blendblock & InputLayoutId properties hold runtime IDs which depend on the
+        // session that recorded the cache. They're already covered by the comparisons above.
+        HlmsPropertyVec::const_iterator itA = a.renderableCache.setProperties.begin();
+        HlmsPropertyVec::const_iterator enA = a.renderableCache.setProperties.end();
+        HlmsPropertyVec::const_iterator itB = b.renderableCache.setProperties.begin();
+        HlmsPropertyVec::const_iterator enB = b.renderableCache.setProperties.end();
+
+        while( true )
+        {
+            while( itA != enA && isRuntimeIdProperty( itA->keyName ) )
+                ++itA;
+            while( itB != enB && isRuntimeIdProperty( itB->keyName ) )
+                ++itB;
+
+            if( itA == enA || itB == enB )
+                return itA == enA && itB == enB;
+
+            if( !( *itA == *itB ) )
+                return false;
+
+            ++itA;
+            ++itB;
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    bool HlmsDiskCache::mergeFrom( const HlmsDiskCache &other )
+    {
+        if( other.mCache.type == 255u )
+            return true;  // Other cache is empty. Nothing to do.
+
+        if( mCache.type == 255u )
+        {
+            mCache.type = other.mCache.type;
+            mCache.templateHash[0] = other.mCache.templateHash[0];
+            mCache.templateHash[1] = other.mCache.templateHash[1];
+            mShaderProfile = other.mShaderProfile;
+            mNativeShadingLangVer = other.mNativeShadingLangVer;
+            mPrecisionMode = other.mPrecisionMode;
+            mFastShaderBuildHack = other.mFastShaderBuildHack;
+            mDebugStrSize = other.mDebugStrSize;
+        }
+        else if( mCache.type != other.mCache.type ||                        //
+                 mCache.templateHash[0] != other.mCache.templateHash[0] ||  //
+                 mCache.templateHash[1] != other.mCache.templateHash[1] ||  //
+                 mShaderProfile != other.mShaderProfile ||                  //
+                 mNativeShadingLangVer != other.mNativeShadingLangVer ||    //
+                 mPrecisionMode != other.mPrecisionMode ||                  //
+                 mFastShaderBuildHack != other.mFastShaderBuildHack )
+        {
+            LogManager::getSingleton().logMessage(
+                "HlmsDiskCache: Cannot merge caches of Hlms type " +
+                StringConverter::toString( mCache.type ) + " (" + mShaderProfile + ") and " +
+                StringConverter::toString( other.mCache.type ) + " (" + other.mShaderProfile +
+                "). Type, shader profile, templates or settings differ." );
+            return false;
+        }
+
+        for( const DatablockCustomPiecesCache &otherPiece : other.mCache.datablockCustomPieceFiles )
+        {
+            bool bFound = false;
+            for( const DatablockCustomPiecesCache &piece : mCache.datablockCustomPieceFiles )
+            {
+                if( piece.filename == otherPiece.filename &&
+                    piece.resourceGroup == otherPiece.resourceGroup )
+                {
+                    bFound = true;
+                }
+            }
+
+            if( !bFound )
+                mCache.datablockCustomPieceFiles.push_back( otherPiece );
+        }
+
+        size_t numNewSourceCode = 0u;
+        {
+            SourceCodeVec::const_iterator itor = other.mCache.sourceCode.begin();
+            SourceCodeVec::const_iterator endt = other.mCache.sourceCode.end();
+
+            while( itor != endt )
+            {
+                SourceCodeVec::iterator itExisting = mCache.sourceCode.begin();
+                SourceCodeVec::iterator enExisting = mCache.sourceCode.end();
+                while( itExisting != enExisting && !( itExisting->mergedCache == itor->mergedCache ) )
+                    ++itExisting;
+
+                if( itExisting != enExisting )
+                {
+                    itExisting->hitCount += itor->hitCount;
+                    itExisting->useCount += itor->useCount;
+                }
+                else
+                {
+                    mCache.sourceCode.push_back( *itor );
+                    ++numNewSourceCode;
+                }
+                ++itor;
+            }
+        }
+
+        size_t numNewPsos = 0u;
+        {
+            PsoVec::const_iterator itor = other.mCache.pso.begin();
+            PsoVec::const_iterator endt = other.mCache.pso.end();
+
+            while( itor != endt )
+            {
+                PsoVec::const_iterator itExisting = mCache.pso.begin();
+                PsoVec::const_iterator enExisting = mCache.pso.end();
+                while( itExisting != enExisting && !isSamePso( *itExisting, *itor ) )
+                    ++itExisting;
+
+                if( itExisting == enExisting )
+                {
+                    mCache.pso.push_back( *itor );
+                    ++numNewPsos;
+                }
+                ++itor;
+            }
+        }
+
+        LogManager::getSingleton().logMessage(
+            "HlmsDiskCache: Merged " + StringConverter::toString( numNewSourceCode ) +
+            " new shader variants and " + StringConverter::toString( numNewPsos ) +
+            " new PSOs. Total: " + StringConverter::toString( mCache.sourceCode.size() ) +
+            " variants, " + StringConverter::toString( mCache.pso.size() ) + " PSOs." );
+
+        return true;
+    }
+    //-----------------------------------------------------------------------------------
+    void HlmsDiskCache::setListener( HlmsDiskCacheListener *listener ) { mListener = listener; }
+    //-----------------------------------------------------------------------------------
+    struct OrderSourceCodeByHitCount
+    {
+        bool operator()( const HlmsDiskCache::SourceCode &a, const HlmsDiskCache::SourceCode &b ) const
+        {
+            if( a.hitCount != b.hitCount )
+                return a.hitCount > b.hitCount;
+            return a.useCount > b.useCount;
+        }
+    };
+    //-----------------------------------------------------------------------------------
     struct CompilerJobParams
     {
         Hlms *hlms;
@@ -210,14 +407,20 @@ namespace Ogre
         std::exception_ptr threadedException;  // GUARDED_BY( mutex )
         LightweightMutex mutex;
 
+        HlmsDiskCacheListener *listener;
+        uint32 numCompiled;  // GUARDED_BY( listenerMutex )
+        LightweightMutex listenerMutex;
+
         CompilerJobParams( Hlms *_hlms, const HlmsDiskCache::SourceCodeVec &_sourceCode,
-                           bool _templatesOutOfDate ) :
+                           bool _templatesOutOfDate, HlmsDiskCacheListener *_listener ) :
             hlms( _hlms ),
             currentEntry( 0u ),
             numEntries( static_cast<uint32>( _sourceCode.size() ) ),
             sourceCode( _sourceCode.data() ),
             templatesOutOfDate( _templatesOutOfDate ),
-            exceptionFound( false )
+            exceptionFound( false ),
+            listener( _listener ),
+            numCompiled( 0u )
         {
         }
     };
@@ -237,6 +440,8 @@ namespace Ogre
     //-----------------------------------------------------------------------------------
     void HlmsDiskCache::_compileShadersThread( CompilerJobParams &jobParams, const size_t threadIdx )
     {
+        OgreProfile( "HlmsDiskCache::_compileShadersThread" );
+
 #ifdef OGRE_SHADER_THREADING_BACKWARDS_COMPATIBLE_API
 #    ifdef OGRE_SHADER_THREADING_USE_TLS
         Hlms::msThreadId = static_cast<uint32>( threadIdx );
@@ -272,6 +477,13 @@ namespace Ogre
                         sourceCode[idx].mergedCache.setProperties;
                     hlms->compileShaderCode( shaderCodeCache, idx, threadIdx );
                 }
+
+                if( jobParams.listener )
+                {
+                    ScopedLock lock( jobParams.listenerMutex );
+                    ++jobParams.numCompiled;
+                    jobParams.listener->shaderCompiled( hlms, jobParams.numCompiled, numEntries );
+                }
             }
             catch( Exception & )
             {
@@ -390,7 +602,12 @@ namespace Ogre
         }
 
         {
-            CompilerJobParams jobParams( hlms, mCache.sourceCode, mTemplatesOutOfDate );
+            // Compile the most frequently seen variants first. The order in which the entries
+            // are compiled doesn't matter otherwise, as they're matched by their properties.
+            std::stable_sort( mCache.sourceCode.begin(), mCache.sourceCode.end(),
+                              OrderSourceCodeByHitCount() );
+
+            CompilerJobParams jobParams( hlms, mCache.sourceCode, mTemplatesOutOfDate, mListener );
 
             // Compile shaders
             if( hlms->getRenderSystem()->supportsMultithreadedShaderCompilation() && numThreads > 1u )
@@ -568,6 +785,8 @@ namespace Ogre
                 save( dataStream, itor->mergedCache );
                 for( size_t i = 0; i < NumShaderTypes; ++i )
                     save( dataStream, itor->sourceFile[i] );
+                write<uint32>( dataStream, itor->hitCount );
+                write<uint32>( dataStream, itor->useCount );
 
                 ++itor;
             }
@@ -801,6 +1020,8 @@ namespace Ogre
                 load( dataStream, sourceCode.mergedCache );
                 for( size_t j = 0; j < NumShaderTypes; ++j )
                     load( dataStream, sourceCode.sourceFile[j] );
+                read( dataStream, sourceCode.hitCount );
+                read( dataStream, sourceCode.useCount );
                 mCache.sourceCode.push_back( sourceCode );
             }
         }
@@ -863,25 +1084,34 @@ namespace Ogre
                 read( dataStream, pso.blendblock.mBlendOperation );
                 read( dataStream, pso.blendblock.mBlendOperationAlpha );
 
-                // We retrieve the Macroblock & Blendblock from HlmsManager and immediately remove them
-                // This allows us to create a permanent pointer, while the actual internal pointer is
-                // released (i.e. it becomes inactive)
-                pso.pso.macroblock = mHlmsManager->getMacroblock( pso.macroblock );
-                mHlmsManager->destroyMacroblock( pso.pso.macroblock );
-
-                pso.pso.blendblock = mHlmsManager->getBlendblock( pso.blendblock );
-                mHlmsManager->destroyBlendblock( pso.pso.blendblock );
-
-                uint16 inputLayoutId =
-                    mHlmsManager->_getInputLayoutId( pso.pso.vertexElements, pso.pso.operationType );
-
-                // Reset these properties because they may be different now
-                Hlms::setProperty( pso.renderableCache.setProperties, HlmsPsoProp::Macroblock,
-                                   pso.pso.macroblock->mLifetimeId );
-                Hlms::setProperty( pso.renderableCache.setProperties, HlmsPsoProp::Blendblock,
-                                   pso.pso.blendblock->mLifetimeId );
-                Hlms::setProperty( pso.renderableCache.setProperties, HlmsPsoProp::InputLayoutId,
-                                   inputLayoutId );
+                if( mHlmsManager )
+                {
+                    // We retrieve the Macroblock & Blendblock from HlmsManager and immediately
+                    // remove them. This allows us to create a permanent pointer, while the actual
+                    // internal pointer is released (i.e. it becomes inactive)
+                    pso.pso.macroblock = mHlmsManager->getMacroblock( pso.macroblock );
+                    mHlmsManager->destroyMacroblock( pso.pso.macroblock );
+
+                    pso.pso.blendblock = mHlmsManager->getBlendblock( pso.blendblock );
+                    mHlmsManager->destroyBlendblock( pso.pso.blendblock );
+
+                    uint16 inputLayoutId =
+                        mHlmsManager->_getInputLayoutId( pso.pso.vertexElements, pso.pso.operationType );
+
+                    // Reset these properties because they may be different now
+                    Hlms::setProperty( pso.renderableCache.setProperties, HlmsPsoProp::Macroblock,
+                                       pso.pso.macroblock->mLifetimeId );
+                    Hlms::setProperty( pso.renderableCache.setProperties, HlmsPsoProp::Blendblock,
+                                       pso.pso.blendblock->mLifetimeId );
+                    Hlms::setProperty( pso.renderableCache.setProperties, HlmsPsoProp::InputLayoutId,
+                                       inputLayoutId );
+                }
+                else
+                {
+                    // Offline use (e.g. merging caches). Blocks can't be resolved.
+                    pso.pso.macroblock = 0;
+                    pso.pso.blendblock = 0;
+                }
 
                 mCache.pso.push_back( pso );
             }
@@ -0,0 +1,368 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+
+#include "OgreIdStringTable.h"
+
+#include "OgreCommon.h"
+#include "OgreDataStream.h"
+#include "OgreLogManager.h"
+#include "OgreStringConverter.h"
+
+#include <stddef.h>  // offsetof
+#include <atomic>
+#include <mutex>
+
+namespace Ogre
+{
+    static const uint32 c_idStringTableVersion = 1u;
+
+    /// Must be power of 2
+    static const size_t c_idStringTableNumShards = 16u;
+    /// Must be power of 2. A shard is considered full at 75% occupancy.
+    static const size_t c_idStringTableSlotsPerShard = 4096u;
+    static const size_t c_idStringTableMaxEntriesPerShard = c_idStringTableSlotsPerShard * 3u / 4u;
+    static const size_t c_idStringTableChunkSize = 64u * 1024u;
+
+    namespace
+    {
+        struct IdStringEntry
+        {
+            uint64 hash[2];
+            uint32 length;
+            char   name[1];  // Actually 'length + 1' chars, null terminated
+        };
+
+        struct IdStringChunk
+        {
+            IdStringChunk *next;
+            size_t         offset;
+        };
+
+        /// The zero-initialized state must be valid: IdStrings get constructed during
+        /// static initialization, possibly before this TU is initialized.
+        struct IdStringShard
+        {
+            /// Lazily allocated array of c_idStringTableSlotsPerShard slots
+            std::atomic<std::atomic<IdStringEntry *> *> slots;
+            /// Protects everything below, and writes to slots
+            std::mutex     mutex;
+            IdStringChunk *chunks;
+            size_t         numEntries;
+        };
+    }  // namespace
+
+    static IdStringShard gIdStringShards[c_idStringTableNumShards];
+
+#if OGRE_IDSTRING_INTERN_TABLE
+    static std::atomic<bool> gIdStringTableEnabled( true );
+#else
+    static std::atomic<bool> gIdStringTableEnabled( false );
+#endif
+    static std::atomic<size_t> gIdStringTableMemoryBudget( 4u * 1024u * 1024u );
+    static std::atomic<size_t> gIdStringTableStringMemory( 0u );
+    static std::atomic<size_t> gIdStringTableNumDropped( 0u );
+    static std::atomic<bool>   gIdStringTableWarnedFull( false );
+
+    //-----------------------------------------------------------------------------------
+    static bool idStringEntryMatches( const IdStringEntry *entry, const IdString &idString )
+    {
+        return memcmp( entry->hash, &idString.mHash, sizeof( idString.mHash ) ) == 0;
+    }
+    //-----------------------------------------------------------------------------------
+    /// Returns the entry with the same hash, or the empty slot where it should go.
+    /// Returns null if the shard is not allocated or no free slot was found.
+    static std::atomic<IdStringEntry *> *findIdStringSlot( std::atomic<IdStringEntry *> *slots,
+                                                           const IdString &idString )
+    {
+        const size_t mask = c_idStringTableSlotsPerShard - 1u;
+        size_t slotIdx = ( idString.getU32Value() / c_idStringTableNumShards ) & mask;
+
+        for( size_t i = 0u; i < c_idStringTableSlotsPerShard; ++i )
+        {
+            std::atomic<IdStringEntry *> *slot = &slots[slotIdx];
+            const IdStringEntry *entry = slot->load( std::memory_order_acquire );
+            if( !entry || idStringEntryMatches( entry, idString ) )
+                return slot;
+            slotIdx = ( slotIdx + 1u ) & mask;
+        }
+
+        return 0;
+    }
+    //-----------------------------------------------------------------------------------
+    static void notifyIdStringDropped()
+    {
+        gIdStringTableNumDropped.fetch_add( 1u, std::memory_order_relaxed );
+        if( !gIdStringTableWarnedFull.exchange( true ) && LogManager::getSingletonPtr() )
+        {
+            LogManager::getSingleton().logMessage(
+                "WARNING: IdStringTable is full. New IdStrings won't be readable. "
+                "Consider raising IdStringTable::setMemoryBudget",
+                LML_CRITICAL );
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    static void insertIdString( const IdString &idString, const char *string, size_t length )
+    {
+        // Fast path: Most IdStrings are constructed over and over from the same strings
+        if( IdStringTable::find( idString ) )
+            return;
+
+        IdStringShard &shard =
+            gIdStringShards[idString.getU32Value() & ( c_idStringTableNumShards - 1u )];
+
+        std::lock_guard<std::mutex> lock( shard.mutex );
+
+        std::atomic<IdStringEntry *> *slots = shard.slots.load( std::memory_order_relaxed );
+        if( !slots )
+        {
+            slots = new std::atomic<IdStringEntry *>[c_idStringTableSlotsPerShard];
+            for( size_t i = 0u; i < c_idStringTableSlotsPerShard; ++i )
+                slots[i].store( 0, std::memory_order_relaxed );
+            shard.slots.store( slots, std::memory_order_release );
+        }
+
+        std::atomic<IdStringEntry *> *slot = findIdStringSlot( slots, idString );
+        if( slot && slot->load( std::memory_order_relaxed ) )
+            return;  // Another thread added it while we were waiting for the lock
+
+        const size_t entrySize =
+            alignToNextMultiple<size_t>( offsetof( IdStringEntry, name ) + length + 1u, 8u );
+
+        if( !slot || shard.numEntries >= c_idStringTableMaxEntriesPerShard ||
+            entrySize > c_idStringTableChunkSize - sizeof( IdStringChunk ) )
+        {
+            notifyIdStringDropped();
+            return;
+        }
+
+        IdStringChunk *chunk = shard.chunks;
+        if( !chunk || chunk->offset + entrySize > c_idStringTableChunkSize )
+        {
+            if( gIdStringTableStringMemory.load( std::memory_order_relaxed ) +
+                    c_idStringTableChunkSize >
+                gIdStringTableMemoryBudget.load( std::memory_order_relaxed ) )
+            {
+                notifyIdStringDropped();
+                return;
+            }
+
+            chunk = reinterpret_cast<IdStringChunk *>( new uint64[c_idStringTableChunkSize / 8u] );
+            chunk->next = shard.chunks;
+            chunk->offset = alignToNextMultiple<size_t>( sizeof( IdStringChunk ), 8u );
+            shard.chunks = chunk;
+            gIdStringTableStringMemory.fetch_add( c_idStringTableChunkSize,
+                                                  std::memory_order_relaxed );
+        }
+
+        IdStringEntry *entry =
+            reinterpret_cast<IdStringEntry *>( reinterpret_cast<char *>( chunk ) + chunk->offset );
+        chunk->offset += entrySize;
+
+        memset( entry->hash, 0, sizeof( entry->hash ) );
+        memcpy( entry->hash, &idString.mHash, sizeof( idString.mHash ) );
+        entry->length = static_cast<uint32>( length );
+        memcpy( entry->name, string, length );
+        entry->name[length] = '\0';
+
+        ++shard.numEntries;
+        slot->store( entry, std::memory_order_release );
+    }
+    //-----------------------------------------------------------------------------------
+    bool IdStringTable::isAvailable()
+    {
+#if OGRE_IDSTRING_INTERN_TABLE
+        return true;
+#else
+        return false;
+#endif
+    }
+    //-----------------------------------------------------------------------------------
+    void IdStringTable::setEnabled( bool bEnabled ) { gIdStringTableEnabled = bEnabled; }
+    //-----------------------------------------------------------------------------------
+    bool IdStringTable::getEnabled() { return gIdStringTableEnabled; }
+    //-----------------------------------------------------------------------------------
+    void IdStringTable::setMemoryBudget( size_t bytes ) { gIdStringTableMemoryBudget = bytes; }
+    //-----------------------------------------------------------------------------------
+    size_t IdStringTable::getMemoryBudget() { return gIdStringTableMemoryBudget; }
+    //-----------------------------------------------------------------------------------
+    const char *IdStringTable::find( IdString idString )
+    {
+        IdStringShard &shard =
+            gIdStringShards[idString.getU32Value() & ( c_idStringTableNumShards - 1u )];
+
+        std::atomic<IdStringEntry *> *slots = shard.slots.load( std::memory_order_acquire );
+        if( !slots )
+            return 0;
+
+        std::atomic<IdStringEntry *> *slot = findIdStringSlot( slots, idString );
+        if( !slot )
+            return 0;
+
+        const IdStringEntry *entry = slot->load( std::memory_order_acquire );
+        return entry ? entry->name : 0;
+    }
+    //-----------------------------------------------------------------------------------
+    void IdStringTable::_insert( IdString idString, const char *string, size_t length )
+    {
+        if( gIdStringTableEnabled.load( std::memory_order_relaxed ) )
+            insertIdString( idString, string, length );
+    }
+    //-----------------------------------------------------------------------------------
+    IdStringTable::Stats IdStringTable::getStats()
+    {
+        Stats stats;
+        stats.numEntries = 0u;
+        stats.numDropped = gIdStringTableNumDropped.load( std::memory_order_relaxed );
+        stats.memoryUsed = gIdStringTableStringMemory.load( std::memory_order_relaxed );
+        stats.memoryBudget = gIdStringTableMemoryBudget.load( std::memory_order_relaxed );
+
+        for( size_t i = 0u; i < c_idStringTableNumShards; ++i )
+        {
+            IdStringShard &shard = gIdStringShards[i];
+            std::lock_guard<std::mutex> lock( shard.mutex );
+            stats.numEntries += shard.numEntries;
+            if( shard.slots.load( std::memory_order_relaxed ) )
+            {
+                stats.memoryUsed +=
+                    c_idStringTableSlotsPerShard * sizeof( std::atomic<IdStringEntry *> );
+            }
+        }
+
+        return stats;
+    }
+    //-----------------------------------------------------------------------------------
+    void IdStringTable::logStats()
+    {
+        const Stats stats = getStats();
+        LogManager::getSingleton().logMessage(
+            "IdStringTable: " + StringConverter::toString( stats.numEntries ) + " entries, " +
+            StringConverter::toString( stats.numDropped ) + " dropped, " +
+            StringConverter::toString( stats.memoryUsed / 1024u ) + " KB used (string budget " +
+            StringConverter::toString( stats.memoryBudget / 1024u ) + " KB)" );
+    }
+    //-----------------------------------------------------------------------------------
+    void IdStringTable::saveTo( DataStreamPtr &dataStream )
+    {
+        vector<const IdStringEntry *>::type entries;
+
+        for( size_t i = 0u; i < c_idStringTableNumShards; ++i )
+        {
+            std::atomic<IdStringEntry *> *slots =
+                gIdStringShards[i].slots.load( std::memory_order_acquire );
+            if( slots )
+            {
+                for( size_t j = 0u; j < c_idStringTableSlotsPerShard; ++j )
+                {
+                    const IdStringEntry *entry = slots[j].load( std::memory_order_acquire );
+                    if( entry )
+                        entries.push_back( entry );
+                }
+            }
+        }
+
+        const uint32 numEntries = static_cast<uint32>( entries.size() );
+        dataStream->write( &c_idStringTableVersion, sizeof( c_idStringTableVersion ) );
+        dataStream->write( &numEntries, sizeof( numEntries ) );
+
+        vector<const IdStringEntry *>::type::const_iterator itor = entries.begin();
+        vector<const IdStringEntry *>::type::const_iterator endt = entries.end();
+
+        while( itor != endt )
+        {
+            dataStream->write( &( *itor )->length, sizeof( ( *itor )->length ) );
+            dataStream->write( ( *itor )->name, ( *itor )->length );
+            ++itor;
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    void IdStringTable::loadFrom( DataStreamPtr &dataStream )
+    {
+        uint32 version = 0u;
+        dataStream->read( &version, sizeof( version ) );
+        if( version != c_idStringTableVersion )
+        {
+            LogManager::getSingleton().logMessage( "IdStringTable: Version mismatch in " +
+                                                   dataStream->getName() + ". Not loading." );
+            return;
+        }
+
+        uint32 numEntries = 0u;
+        dataStream->read( &numEntries, sizeof( numEntries ) );
+
+        String name;
+        for( uint32 i = 0u; i < numEntries && !dataStream->eof(); ++i )
+        {
+            uint32 length = 0u;
+            dataStream->read( &length, sizeof( length ) );
+            name.resize( length );
+            if( length > 0u )
+                dataStream->read( &name[0], length );
+
+            // Explicitly inserted so that this works even while the table is disabled
+            insertIdString( IdString( name ), name.c_str(), name.size() );
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    void IdStringTable::_clear()
+    {
+        for( size_t i = 0u; i < c_idStringTableNumShards; ++i )
+        {
+            IdStringShard &shard = gIdStringShards[i];
+
+            delete[] shard.slots.exchange( 0 );
+
+            IdStringChunk *chunk = shard.chunks;
+            while( chunk )
+            {
+                IdStringChunk *next = chunk->next;
+                delete[] reinterpret_cast<uint64 *>( chunk );
+                chunk = next;
+            }
+
+            shard.chunks = 0;
+            shard.numEntries = 0u;
+        }
+
+        gIdStringTableStringMemory = 0u;
+        gIdStringTableNumDropped = 0u;
+        gIdStringTableWarnedFull = false;
+    }
+    //-----------------------------------------------------------------------------------
+#if OGRE_IDSTRING_INTERN_TABLE
+    void _internIdString( const IdString &idString, const char *string, size_t length )
+    {
+        IdStringTable::_insert( idString, string, length );
+    }
+    //-----------------------------------------------------------------------------------
+    const char *_findInternedIdString( const IdString &idString )
+    {
+        return IdStringTable::find( idString );
+    }
+#endif
+}  // namespace Ogre
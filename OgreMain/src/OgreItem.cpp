@@ -105,6 +105,7 @@ namespace Ogre
         {
             const SkeletonDef *skeletonDef = mMesh->getSkeleton().get();
             mSkeletonInstance = mManager->createSkeletonInstance( skeletonDef );
+            mSkeletonInstance->_addLodSource( this );
         }
 
         mLodMesh = mMesh->_getLodValueArray();
@@ -148,6 +149,7 @@ namespace Ogre
         assert( mManager || !mSkeletonInstance );
         if( mSkeletonInstance )
         {
+            mSkeletonInstance->_removeLodSource( this );
             mSkeletonInstance->_decrementRefCount();
             if( mSkeletonInstance->_getRefCount() == 0u )
                 mManager->destroySkeletonInstance( mSkeletonInstance );
@@ -255,6 +257,7 @@ namespace Ogre
 
         if( mSkeletonInstance )
         {
+            mSkeletonInstance->_removeLodSource( this );
             mSkeletonInstance->_decrementRefCount();
             if( mSkeletonInstance->_getRefCount() == 0u )
                 mManager->destroySkeletonInstance( mSkeletonInstance );
@@ -262,6 +265,7 @@ namespace Ogre
 
         mSkeletonInstance = master->mSkeletonInstance;
         mSkeletonInstance->_incrementRefCount();
+        mSkeletonInstance->_addLodSource( this );
     }
     //-----------------------------------------------------------------------
     void Item::stopUsingSkeletonInstanceFromMaster()
@@ -271,12 +275,14 @@ namespace Ogre
             assert( mSkeletonInstance->_getRefCount() > 1u &&
                     "This skeleton is Item is not sharing its skeleton!" );
 
+            mSkeletonInstance->_removeLodSource( this );
             mSkeletonInstance->_decrementRefCount();
             if( mSkeletonInstance->_getRefCount() == 0u )
                 mManager->destroySkeletonInstance( mSkeletonInstance );
 
             const SkeletonDef *skeletonDef = mMesh->getSkeleton().get();
             mSkeletonInstance = mManager->createSkeletonInstance( skeletonDef );
+            mSkeletonInstance->_addLodSource( this );
         }
     }
     //-----------------------------------------------------------------------
@@ -290,6 +296,7 @@ namespace Ogre
         OGRE_ASSERT_LOW( !sharesSkeletonInstance() );
         if( mSkeletonInstance && !bEnable )
         {
+            mSkeletonInstance->_removeLodSource( this );
             mSkeletonInstance->_decrementRefCount();
             if( mSkeletonInstance->_getRefCount() == 0u )
                 mManager->destroySkeletonInstance( mSkeletonInstance );
@@ -314,6 +321,7 @@ namespace Ogre
         {
             const SkeletonDef *skeletonDef = mMesh->getSkeleton().get();
             mSkeletonInstance = mManager->createSkeletonInstance( skeletonDef );
+            mSkeletonInstance->_addLodSource( this );
             for( SubItem &subitem : mSubItems )
             {
                 HlmsDatablock *oldDatablock = subitem.getDatablock();
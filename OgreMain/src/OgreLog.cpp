@@ -29,6 +29,10 @@ THE SOFTWARE.
 
 #include "OgreLog.h"
 
+#include "Threading/OgreSemaphore.h"
+#include "Threading/OgreThreads.h"
+
+#include <atomic>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
@@ -40,6 +44,166 @@ THE SOFTWARE.
 
 namespace Ogre
 {
+    struct LogAsyncRecord
+    {
+        String          message;
+        time_t          ctTime;
+        LogMessageLevel lml;
+        bool            maskDebug;
+    };
+
+    struct LogAsyncCell
+    {
+        std::atomic<size_t> sequence;
+        LogAsyncRecord      record;
+    };
+
+    /// Bounded MPSC ring buffer (Vyukov's bounded queue) plus the writer thread that consumes it.
+    struct LogAsyncWriter
+    {
+        LogAsyncCell *cells;
+        size_t        mask;
+
+        std::atomic<size_t> enqueuePos;
+        size_t              dequeuePos;  // Only accessed by the writer thread (or with it stopped)
+        /// Number of messages processed so far. Used to wait for LML_CRITICAL messages.
+        std::atomic<size_t> numWritten;
+
+        std::atomic<bool> writerSleeping;
+        std::atomic<bool> keepRunning;
+        Semaphore         semaphore;
+        ThreadHandlePtr   thread;
+
+        bool listenersOnWriterThread;
+
+        /// Records drained from the ring buffer, waiting to be written. Writer thread only.
+        vector<LogAsyncRecord>::type batch;
+
+        LogAsyncWriter( uint32 ringBufferSize, bool _listenersOnWriterThread ) :
+            cells( 0 ),
+            mask( 0 ),
+            enqueuePos( 0u ),
+            dequeuePos( 0u ),
+            numWritten( 0u ),
+            writerSleeping( false ),
+            keepRunning( true ),
+            semaphore( 0u ),
+            listenersOnWriterThread( _listenersOnWriterThread )
+        {
+            size_t numCells = 2u;
+            while( numCells < ringBufferSize )
+                numCells <<= 1u;
+            mask = numCells - 1u;
+
+            cells = new LogAsyncCell[numCells];
+            for( size_t i = 0u; i < numCells; ++i )
+                cells[i].sequence.store( i, std::memory_order_relaxed );
+        }
+
+        ~LogAsyncWriter() { delete[] cells; }
+
+        /// Returns false if the ring buffer is full.
+        bool tryPush( const String &message, LogMessageLevel lml, bool maskDebug, time_t ctTime,
+                      size_t &outPos )
+        {
+            LogAsyncCell *cell;
+            size_t pos = enqueuePos.load( std::memory_order_relaxed );
+            while( true )
+            {
+                cell = &cells[pos & mask];
+                const size_t seq = cell->sequence.load( std::memory_order_acquire );
+                const intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+                if( diff == 0 )
+                {
+                    if( enqueuePos.compare_exchange_weak( pos, pos + 1u, std::memory_order_relaxed ) )
+                        break;
+                }
+                else if( diff < 0 )
+                {
+                    return false;
+                }
+                else
+                {
+                    pos = enqueuePos.load( std::memory_order_relaxed );
+                }
+            }
+
+            cell->record.message = message;
+            cell->record.ctTime = ctTime;
+            cell->record.lml = lml;
+            cell->record.maskDebug = maskDebug;
+            cell->sequence.store( pos + 1u, std::memory_order_release );
+
+            outPos = pos;
+            return true;
+        }
+
+        /// Returns null if there is nothing (published) to consume. Consumer only.
+        LogAsyncRecord *front()
+        {
+            LogAsyncCell *cell = &cells[dequeuePos & mask];
+            const size_t seq = cell->sequence.load( std::memory_order_acquire );
+            if( seq != dequeuePos + 1u )
+                return 0;
+            return &cell->record;
+        }
+
+        /// Releases the record returned by front(). Consumer only.
+        void popFront()
+        {
+            LogAsyncCell *cell = &cells[dequeuePos & mask];
+            cell->record.message.clear();
+            cell->sequence.store( dequeuePos + mask + 1u, std::memory_order_release );
+            ++dequeuePos;
+        }
+
+        void wakeUpWriter()
+        {
+            if( writerSleeping.exchange( false, std::memory_order_acq_rel ) )
+                semaphore.increment();
+        }
+    };
+
+    /// Set in the writer thread, so we can detect listeners that log from it.
+    static thread_local LogAsyncWriter *t_currentLogWriter = 0;
+    //-----------------------------------------------------------------------
+    static unsigned long logWriterThread( ThreadHandle *threadHandle )
+    {
+        Threads::SetThreadName( threadHandle, "OgreLog" );
+
+        Log *log = reinterpret_cast<Log *>( threadHandle->getUserParam() );
+        LogAsyncWriter *asyncWriter = log->_getAsyncWriter();
+        t_currentLogWriter = asyncWriter;
+
+        while( true )
+        {
+            log->_processAsyncMessages();
+
+            if( !asyncWriter->keepRunning.load() )
+                break;
+
+            asyncWriter->writerSleeping.store( true );
+            // Pairs with the fence in Log::logMessage. Either we see the new message,
+            // or the producer sees writerSleeping = true and wakes us up.
+            std::atomic_thread_fence( std::memory_order_seq_cst );
+
+            if( asyncWriter->front() || !asyncWriter->keepRunning.load() )
+            {
+                // Work arrived while we were going to sleep. If someone already
+                // grabbed the flag, they incremented the semaphore; consume it.
+                if( !asyncWriter->writerSleeping.exchange( false ) )
+                    asyncWriter->semaphore.decrementOrWait();
+            }
+            else
+            {
+                asyncWriter->semaphore.decrementOrWait();
+            }
+        }
+
+        t_currentLogWriter = 0;
+        return 0;
+    }
+    THREAD_DECLARE( logWriterThread );
     //-----------------------------------------------------------------------
     Log::Log( const String &name, bool debuggerOuput, bool suppressFile ) :
         mLog( nullptr ),
@@ -47,7 +211,8 @@ namespace Ogre
         mDebugOut( debuggerOuput ),
         mSuppressFile( suppressFile ),
         mTimeStamp( true ),
-        mLogName( name )
+        mLogName( name ),
+        mAsync( 0 )
     {
         if( !mSuppressFile )
         {
@@ -58,7 +223,9 @@ namespace Ogre
     //-----------------------------------------------------------------------
     Log::~Log()
     {
-        ScopedLock scopedLock( mMutex );
+        setAsyncEnabled( false );
+
+        ScopedLock scopedLock( mFileMutex );
         if( !mSuppressFile )
         {
             mLog->close();
@@ -68,68 +235,232 @@ namespace Ogre
     //-----------------------------------------------------------------------
     void Log::logMessage( const String &message, LogMessageLevel lml, bool maskDebug )
     {
+        if( mAsync )
+        {
+            if( ( mLogLevel + uint32( lml ) ) < OGRE_LOG_THRESHOLD )
+                return;
+
+            if( !mAsync->listenersOnWriterThread )
+            {
+                ScopedLock scopedLock( mMutex );
+                if( notifyListeners( message, lml, maskDebug ) )
+                    return;
+            }
+
+            time_t ctTime;
+            time( &ctTime );
+
+            // A listener running on the writer thread can't wait for the writer thread.
+            const bool bIsWriterThread = t_currentLogWriter == mAsync;
+
+            size_t pos;
+            while( !mAsync->tryPush( message, lml, maskDebug, ctTime, pos ) )
+            {
+                if( bIsWriterThread )
+                    return;  // Ring buffer is full. Drop it.
+                mAsync->wakeUpWriter();
+                Threads::Sleep( 1u );
+            }
+
+            std::atomic_thread_fence( std::memory_order_seq_cst );
+            mAsync->wakeUpWriter();
+
+            if( lml == LML_CRITICAL && !bIsWriterThread )
+            {
+                // Bounded latency: Wait until it's on disk, in case we're about to crash.
+                while( mAsync->numWritten.load( std::memory_order_acquire ) <= pos )
+                    Threads::Sleep( 1u );
+            }
+            return;
+        }
+
         ScopedLock scopedLock( mMutex );
         if( ( mLogLevel + uint32( lml ) ) >= OGRE_LOG_THRESHOLD )
         {
-            bool skipThisMessage = false;
-            for( mtLogListener::iterator i = mListeners.begin(); i != mListeners.end(); ++i )
-                ( *i )->messageLogged( message, lml, maskDebug, mLogName, skipThisMessage );
-
-            if( !skipThisMessage )
+            if( !notifyListeners( message, lml, maskDebug ) )
             {
-                if( mDebugOut && !maskDebug )
-                {
+                time_t ctTime;
+                time( &ctTime );
+                ScopedLock fileLock( mFileMutex );
+                writeMessage( message, lml, maskDebug, ctTime, true );
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    bool Log::notifyListeners( const String &message, LogMessageLevel lml, bool maskDebug )
+    {
+        bool skipThisMessage = false;
+        for( mtLogListener::iterator i = mListeners.begin(); i != mListeners.end(); ++i )
+            ( *i )->messageLogged( message, lml, maskDebug, mLogName, skipThisMessage );
+        return skipThisMessage;
+    }
+    //-----------------------------------------------------------------------
+    void Log::writeMessage( const String &message, LogMessageLevel lml, bool maskDebug, time_t ctTime,
+                            bool bFlush )
+    {
+        if( mDebugOut && !maskDebug )
+        {
 #if( OGRE_PLATFORM == OGRE_PLATFORM_WIN32 || OGRE_PLATFORM == OGRE_PLATFORM_WINRT ) && OGRE_DEBUG_MODE
 #    if OGRE_WCHAR_T_STRINGS
-                    OutputDebugStringW( L"Ogre: " );
-                    OutputDebugStringW( message.c_str() );
-                    OutputDebugStringW( L"\n" );
+            OutputDebugStringW( L"Ogre: " );
+            OutputDebugStringW( message.c_str() );
+            OutputDebugStringW( L"\n" );
 #    else
-                    OutputDebugStringA( "Ogre: " );
-                    OutputDebugStringA( message.c_str() );
-                    OutputDebugStringA( "\n" );
+            OutputDebugStringA( "Ogre: " );
+            OutputDebugStringA( message.c_str() );
+            OutputDebugStringA( "\n" );
 #    endif
 #endif
-                    if( lml == LML_CRITICAL )
-                        std::cerr << message << std::endl;
-                    else
-                        std::cout << message << std::endl;
-                }
+            if( lml == LML_CRITICAL )
+                std::cerr << message << std::endl;
+            else
+                std::cout << message << std::endl;
+        }
+
+        // Write time into log
+        if( !mSuppressFile )
+        {
+            if( mTimeStamp )
+            {
+                struct tm *pTime;
+                pTime = localtime( &ctTime );
+                *mLog << std::setw( 2 ) << std::setfill( '0' ) << pTime->tm_hour << ":"
+                      << std::setw( 2 ) << std::setfill( '0' ) << pTime->tm_min << ":"
+                      << std::setw( 2 ) << std::setfill( '0' ) << pTime->tm_sec << ": ";
+            }
 
-                // Write time into log
-                if( !mSuppressFile )
+            if( bFlush )
+            {
+                *mLog << message << std::endl;
+
+                // Flush stcmdream to ensure it is written (incase of a crash, we need log to be up
+                // to date)
+                mLog->flush();
+            }
+            else
+            {
+                // Async mode flushes once per batch
+                *mLog << message << '\n';
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void Log::setAsyncEnabled( bool bAsync, bool listenersOnWriterThread, uint32 ringBufferSize )
+    {
+        if( bAsync == ( mAsync != 0 ) )
+            return;
+
+        if( bAsync )
+        {
+            mAsync = new LogAsyncWriter( ringBufferSize, listenersOnWriterThread );
+            mAsync->thread = Threads::CreateThread( THREAD_GET( logWriterThread ), 0, this );
+        }
+        else
+        {
+            mAsync->keepRunning.store( false );
+            std::atomic_thread_fence( std::memory_order_seq_cst );
+            mAsync->wakeUpWriter();
+            Threads::WaitForThreads( 1u, &mAsync->thread );
+
+            // Messages pushed after the writer thread finished its last iteration.
+            _processAsyncMessages();
+
+            delete mAsync;
+            mAsync = 0;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void Log::flush()
+    {
+        if( !mAsync || t_currentLogWriter == mAsync )
+            return;
+
+        const size_t numPushed = mAsync->enqueuePos.load( std::memory_order_acquire );
+        mAsync->wakeUpWriter();
+        while( mAsync->numWritten.load( std::memory_order_acquire ) < numPushed )
+            Threads::Sleep( 1u );
+    }
+    //-----------------------------------------------------------------------
+    bool Log::_processAsyncMessages()
+    {
+        LogAsyncWriter *asyncWriter = mAsync;
+
+        // Cap the batch size, so that LML_CRITICAL waiters aren't starved
+        // by a continuous stream of messages.
+        const size_t maxBatchSize = asyncWriter->mask + 1u;
+
+        // Drain the ring buffer into a local batch. This needs no lock, and frees
+        // the slots for producers before we start doing I/O.
+        vector<LogAsyncRecord>::type &batch = asyncWriter->batch;
+        batch.clear();
+
+        LogAsyncRecord *record = asyncWriter->front();
+        while( record && batch.size() < maxBatchSize )
+        {
+            batch.push_back( LogAsyncRecord() );
+            LogAsyncRecord &batchRecord = batch.back();
+            batchRecord.message.swap( record->message );
+            batchRecord.ctTime = record->ctTime;
+            batchRecord.lml = record->lml;
+            batchRecord.maskDebug = record->maskDebug;
+
+            asyncWriter->popFront();
+            record = asyncWriter->front();
+        }
+
+        if( batch.empty() )
+            return false;
+
+        if( asyncWriter->listenersOnWriterThread )
+        {
+            // mMutex only guards the listeners. Producers may be waiting on it.
+            ScopedLock scopedLock( mMutex );
+
+            size_t numKept = 0u;
+            for( size_t i = 0u; i < batch.size(); ++i )
+            {
+                if( !notifyListeners( batch[i].message, batch[i].lml, batch[i].maskDebug ) )
                 {
-                    if( mTimeStamp )
-                    {
-                        struct tm *pTime;
-                        time_t ctTime;
-                        time( &ctTime );
-                        pTime = localtime( &ctTime );
-                        *mLog << std::setw( 2 ) << std::setfill( '0' ) << pTime->tm_hour << ":"
-                              << std::setw( 2 ) << std::setfill( '0' ) << pTime->tm_min << ":"
-                              << std::setw( 2 ) << std::setfill( '0' ) << pTime->tm_sec << ": ";
-                    }
-                    *mLog << message << std::endl;
-
-                    // Flush stcmdream to ensure it is written (incase of a crash, we need log to be up
-                    // to date)
-                    mLog->flush();
+                    if( numKept != i )
+                        std::swap( batch[numKept], batch[i] );
+                    ++numKept;
                 }
             }
+            batch.resize( numKept );
+        }
+
+        {
+            ScopedLock fileLock( mFileMutex );
+
+            vector<LogAsyncRecord>::type::const_iterator itor = batch.begin();
+            vector<LogAsyncRecord>::type::const_iterator endt = batch.end();
+
+            while( itor != endt )
+            {
+                writeMessage( itor->message, itor->lml, itor->maskDebug, itor->ctTime, false );
+                ++itor;
+            }
+
+            if( mLog )
+                mLog->flush();
         }
+
+        asyncWriter->numWritten.store( asyncWriter->dequeuePos, std::memory_order_release );
+
+        return true;
     }
 
     //-----------------------------------------------------------------------
     void Log::setTimeStampEnabled( bool timeStamp )
     {
-        ScopedLock scopedLock( mMutex );
+        ScopedLock scopedLock( mFileMutex );
         mTimeStamp = timeStamp;
     }
 
     //-----------------------------------------------------------------------
     void Log::setDebugOutputEnabled( bool debugOutput )
     {
-        ScopedLock scopedLock( mMutex );
+        ScopedLock scopedLock( mFileMutex );
         mDebugOut = debugOutput;
     }
 
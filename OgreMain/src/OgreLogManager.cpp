@@ -145,6 +145,13 @@ namespace Ogre
         }
     }
     //---------------------------------------------------------------------
+    void LogManager::setAsyncEnabled( bool bAsync, bool listenersOnWriterThread )
+    {
+        OGRE_LOCK_AUTO_MUTEX;
+        if( mDefaultLog )
+            mDefaultLog->setAsyncEnabled( bAsync, listenersOnWriterThread );
+    }
+    //---------------------------------------------------------------------
     Log::Stream LogManager::stream( LogMessageLevel lml, bool maskDebug )
     {
         OGRE_LOCK_AUTO_MUTEX;
@@ -573,6 +573,20 @@ namespace Ogre
             submesh->dearrangeToInefficient();
     }
     //---------------------------------------------------------------------
+    void Mesh::buildClusters( uint32 maxTriangles, uint32 maxVertices )
+    {
+        OgreProfileExhaustive( "Mesh2::buildClusters" );
+
+        for( SubMesh *submesh : mSubMeshes )
+            submesh->buildClusters( maxTriangles, maxVertices );
+    }
+    //---------------------------------------------------------------------
+    void Mesh::clearClusters()
+    {
+        for( SubMesh *submesh : mSubMeshes )
+            submesh->clearClusters();
+    }
+    //---------------------------------------------------------------------
     void Mesh::prepareForShadowMapping( bool forceSameBuffers )
     {
         OgreProfileExhaustive( "Mesh2::prepareForShadowMapping" );
@@ -64,7 +64,7 @@ namespace Ogre
     MeshSerializerImpl::MeshSerializerImpl( VaoManager *vaoManager ) : mVaoManager( vaoManager )
     {
         // Version number
-        mVersion = "[MeshSerializer_v2.1 R2]";
+        mVersion = "[MeshSerializer_v2.1 R3]";
     }
     //---------------------------------------------------------------------
     MeshSerializerImpl::~MeshSerializerImpl() {}
@@ -229,6 +229,14 @@ namespace Ogre
             writeMeshHashForCaches( pMesh );
             LogManager::getSingleton().logMessage( "Exporting hash for caches exported." );
 
+            // Write clusters
+            if( calcMeshClustersSize( pMesh ) > 0u )
+            {
+                LogManager::getSingleton().logMessage( "Exporting clusters..." );
+                writeMeshClusters( pMesh );
+                LogManager::getSingleton().logMessage( "Clusters exported." );
+            }
+
             // Write edge lists
             /*if (pMesh->isEdgeListBuilt())
             {
@@ -280,6 +288,53 @@ namespace Ogre
         writeInts64( mCalculatedHash, 2u );
     }
     //---------------------------------------------------------------------
+    void MeshSerializerImpl::writeMeshClusters( const Mesh *pMesh )
+    {
+        // Header
+        writeChunkHeader( M_MESH_CLUSTERS, calcMeshClustersSize( pMesh ) );
+
+        pushInnerChunk( mStream );
+        for( uint16 i = 0; i < pMesh->getNumSubMeshes(); ++i )
+        {
+            const SubMesh *s = pMesh->getSubMesh( i );
+            for( size_t lodLevel = 0; lodLevel < s->getNumClusterLods(); ++lodLevel )
+            {
+                const MeshClusterVec &clusters = s->getClusters( lodLevel );
+                if( clusters.empty() )
+                    continue;
+
+                // uint16 subMeshIndex, uint8 lodLevel, uint32 numClusters
+                // + per cluster: uint32 indexStart, indexCount + 12 floats
+                const size_t chunkSize =
+                    MSTREAM_OVERHEAD_SIZE + sizeof( uint16 ) + sizeof( uint8 ) + sizeof( uint32 ) +
+                    clusters.size() * ( sizeof( uint32 ) * 2u + sizeof( float ) * 12u );
+                writeChunkHeader( M_SUBMESH_CLUSTERS, chunkSize );
+
+                writeShorts( &i, 1 );
+                const uint8 lod = static_cast<uint8>( lodLevel );
+                writeData( &lod, 1, 1 );
+                const uint32 numClusters = static_cast<uint32>( clusters.size() );
+                writeInts( &numClusters, 1 );
+
+                MeshClusterVec::const_iterator itor = clusters.begin();
+                MeshClusterVec::const_iterator endt = clusters.end();
+
+                while( itor != endt )
+                {
+                    writeInts( &itor->indexStart, 1 );
+                    writeInts( &itor->indexCount, 1 );
+                    writeFloats( itor->center.ptr(), 3 );
+                    writeFloats( &itor->radius, 1 );
+                    writeFloats( itor->coneApex.ptr(), 3 );
+                    writeFloats( itor->coneAxis.ptr(), 3 );
+                    writeFloats( &itor->coneCutoff, 1 );
+                    ++itor;
+                }
+            }
+        }
+        popInnerChunk( mStream );
+    }
+    //---------------------------------------------------------------------
     void MeshSerializerImpl::writeSubMesh( const SubMesh *s,
                                            const LodLevelVertexBufferTable &lodVertexTable )
     {
@@ -558,6 +613,8 @@ namespace Ogre
 
         size += calcHashForCachesSize();
 
+        size += calcMeshClustersSize( pMesh );
+
         size += calcBoundsInfoSize( pMesh );
 
         // Submesh name table
@@ -753,6 +810,64 @@ namespace Ogre
         pMesh->_setHashForCaches( hash );
     }
     //---------------------------------------------------------------------
+    void MeshSerializerImpl::readMeshClusters( DataStreamPtr &stream, Mesh *pMesh )
+    {
+        if( !stream->eof() )
+        {
+            pushInnerChunk( stream );
+            uint16 streamID = readChunk( stream );
+            while( !stream->eof() && streamID == M_SUBMESH_CLUSTERS )
+            {
+                uint16 subMeshIndex;
+                uint8 lodLevel;
+                uint32 numClusters;
+                readShorts( stream, &subMeshIndex, 1 );
+                readChar( stream, &lodLevel );
+                readInts( stream, &numClusters, 1 );
+
+                MeshClusterVec clusters;
+                clusters.resize( numClusters );
+
+                MeshClusterVec::iterator itor = clusters.begin();
+                MeshClusterVec::iterator endt = clusters.end();
+
+                while( itor != endt )
+                {
+                    readInts( stream, &itor->indexStart, 1 );
+                    readInts( stream, &itor->indexCount, 1 );
+                    readFloats( stream, itor->center.ptr(), 3 );
+                    readFloats( stream, &itor->radius, 1 );
+                    readFloats( stream, itor->coneApex.ptr(), 3 );
+                    readFloats( stream, itor->coneAxis.ptr(), 3 );
+                    readFloats( stream, &itor->coneCutoff, 1 );
+                    ++itor;
+                }
+
+                if( subMeshIndex < pMesh->getNumSubMeshes() &&
+                    lodLevel < pMesh->getSubMesh( subMeshIndex )->mVao[VpNormal].size() )
+                {
+                    pMesh->getSubMesh( subMeshIndex )->_setClusters( lodLevel, clusters );
+                }
+                else
+                {
+                    LogManager::getSingleton().logMessage(
+                        "WARNING: Mesh '" + pMesh->getName() + "' has clusters for a SubMesh or LOD " +
+                        "that doesn't exist. Ignoring them." );
+                }
+
+                // If we're not end of file get the next stream ID
+                if( !stream->eof() )
+                    streamID = readChunk( stream );
+            }
+            if( !stream->eof() )
+            {
+                // Backpedal back to start of stream
+                backpedalChunkHeader( stream );
+            }
+            popInnerChunk( stream );
+        }
+    }
+    //---------------------------------------------------------------------
     void MeshSerializerImpl::readMesh( DataStreamPtr &stream, Mesh *pMesh,
                                        MeshSerializerListener *listener )
     {
@@ -775,7 +890,8 @@ namespace Ogre
                  streamID == M_MESH_BOUNDS ||
                  streamID == M_SUBMESH_NAME_TABLE ||
                  streamID == M_MESH_LOD_LEVEL ||
-                 streamID == M_HASH_FOR_CACHES /*||
+                 streamID == M_HASH_FOR_CACHES ||
+                 streamID == M_MESH_CLUSTERS /*||
                  streamID == M_EDGE_LISTS ||
                  streamID == M_POSES ||
                  streamID == M_ANIMATIONS*/))
@@ -800,6 +916,9 @@ namespace Ogre
                 case M_HASH_FOR_CACHES:
                     readHashForCaches( stream, pMesh );
                     break;
+                case M_MESH_CLUSTERS:
+                    readMeshClusters( stream, pMesh );
+                    break;
                     /*case M_EDGE_LISTS:
                         readEdgeList(stream, pMesh);
                         break;
@@ -1235,6 +1354,34 @@ namespace Ogre
         return size;
     }
     //---------------------------------------------------------------------
+    size_t MeshSerializerImpl::calcMeshClustersSize( const Mesh *pMesh )
+    {
+        size_t size = 0;
+
+        for( unsigned i = 0; i < pMesh->getNumSubMeshes(); ++i )
+        {
+            const SubMesh *s = pMesh->getSubMesh( i );
+            for( size_t lodLevel = 0; lodLevel < s->getNumClusterLods(); ++lodLevel )
+            {
+                const size_t numClusters = s->getClusters( lodLevel ).size();
+                if( numClusters > 0u )
+                {
+                    // uint16 subMeshIndex, uint8 lodLevel, uint32 numClusters
+                    size += MSTREAM_OVERHEAD_SIZE + sizeof( uint16 ) + sizeof( uint8 ) +
+                            sizeof( uint32 );
+                    // uint32 indexStart, indexCount + 12 floats
+                    size += numClusters * ( sizeof( uint32 ) * 2u + sizeof( float ) * 12u );
+                }
+            }
+        }
+
+        // The chunk is optional. Don't write it if there's nothing to write.
+        if( size > 0u )
+            size += MSTREAM_OVERHEAD_SIZE;
+
+        return size;
+    }
+    //---------------------------------------------------------------------
     size_t MeshSerializerImpl::calcSkeletonLinkSize( const String &skelName )
     {
         size_t size = MSTREAM_OVERHEAD_SIZE;
@@ -2295,8 +2442,26 @@ edgeData->triangleFaceNormals.begin(); for ( ; t != edgeData->triangles.end(); +
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
-    MeshSerializerImpl_v2_1_R1::MeshSerializerImpl_v2_1_R1( VaoManager *vaoManager ) :
+    MeshSerializerImpl_v2_1_R2::MeshSerializerImpl_v2_1_R2( VaoManager *vaoManager ) :
         MeshSerializerImpl( vaoManager )
+    {
+        // Version number
+        mVersion = "[MeshSerializer_v2.1 R2]";
+    }
+    //---------------------------------------------------------------------
+    MeshSerializerImpl_v2_1_R2::~MeshSerializerImpl_v2_1_R2() {}
+    //---------------------------------------------------------------------
+    size_t MeshSerializerImpl_v2_1_R2::calcMeshClustersSize( const Mesh * )
+    {
+        // M_MESH_CLUSTERS was added in R3
+        return 0u;
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    MeshSerializerImpl_v2_1_R1::MeshSerializerImpl_v2_1_R1( VaoManager *vaoManager ) :
+        MeshSerializerImpl_v2_1_R2( vaoManager )
     {
         // Version number
         mVersion = "[MeshSerializer_v2.1 R1]";
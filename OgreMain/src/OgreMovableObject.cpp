@@ -596,7 +596,11 @@ namespace Ogre
                 // we set mVisibilityFlags to 0 on slot removals
                 if( IS_BIT_SET( j, scalarMask ) )
                 {
-                    culledObjects.push_back( objData.mOwner[j] );
+                    MovableObject *owner = objData.mOwner[j];
+                    culledObjects.push_back( owner );
+
+                    if( owner->mSkeletonInstance )
+                        owner->mSkeletonInstance->_notifyVisible( owner );
                 }
             }
 
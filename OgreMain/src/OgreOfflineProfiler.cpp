@@ -15,13 +15,19 @@ namespace Ogre
     OfflineProfiler::OfflineProfiler() :
         mPaused( false ),
         mTlsHandle( OGRE_TLS_INVALID_HANDLE ),
-        mBytesPerPool( sizeof( ProfileSample ) * 10000 )
+        mBytesPerPool( sizeof( ProfileSample ) * 10000 ),
+        mTimer( OGRE_NEW Ogre::Timer() ),
+        mFrameIdx( 0u ),
+        mTimelineCapacity( 0u )
     {
         Threads::CreateTls( &mTlsHandle );
     }
     //-----------------------------------------------------------------------------------
     OfflineProfiler::~OfflineProfiler()
     {
+        if( !mThreadData.empty() && !mOnShutdownTimelinePath.empty() )
+            dumpTimeline( mOnShutdownTimelinePath );
+
         if( !mThreadData.empty() &&
             ( !mOnShutdownPerFramePath.empty() || !mOnShutdownAccumPath.empty() ) )
         {
@@ -39,9 +45,15 @@ namespace Ogre
 
         Threads::DestroyTls( mTlsHandle );
         mTlsHandle = OGRE_TLS_INVALID_HANDLE;
+
+        OGRE_DELETE mTimer;
+        mTimer = 0;
     }
     //-----------------------------------------------------------------------------------
-    OfflineProfiler::PerThreadData::PerThreadData( bool startPaused, size_t bytesPerPool ) :
+    OfflineProfiler::PerThreadData::PerThreadData( bool startPaused, size_t bytesPerPool,
+                                                   uint32 threadIdx, uint64 timeOffset,
+                                                   size_t timelineCapacity,
+                                                   uint32 const *frameIdx ) :
         mPaused( startPaused ),
         mPauseRequest( startPaused ),
         mResetRequest( false ),
@@ -49,9 +61,17 @@ namespace Ogre
         mCurrentSample( 0 ),
         mTimer( OGRE_NEW Ogre::Timer() ),
         mTotalAccumTime( 0 ),
+        mTimeOffset( timeOffset ),
+        mThreadIdx( threadIdx ),
+        mTimeline( 0 ),
+        mTimelineCapacity( 0 ),
+        mTimelineCapacityRequest( timelineCapacity ),
+        mTimelineNextSequence( 0 ),
+        mFrameIdx( frameIdx ),
         mCurrMemoryPoolOffset( 0 ),
         mBytesPerPool( bytesPerPool )
     {
+        resizeTimeline( timelineCapacity );
         createNewPool();
         mCurrentSample = allocateSample( 0 );
         mRoot = mCurrentSample;
@@ -65,6 +85,7 @@ namespace Ogre
     OfflineProfiler::PerThreadData::~PerThreadData()
     {
         destroyAllPools();
+        resizeTimeline( 0u );
         delete mTimer;
         mTimer = 0;
     }
@@ -129,10 +150,35 @@ namespace Ogre
         return newSample;
     }
     //-----------------------------------------------------------------------------------
+    void OfflineProfiler::PerThreadData::resizeTimeline( size_t capacity )
+    {
+        if( mTimeline )
+        {
+            OGRE_FREE( mTimeline, MEMCATEGORY_GENERAL );
+            mTimeline = 0;
+        }
+
+        mTimelineCapacity = capacity;
+        mTimelineNextSequence = 0;
+        mOpenTimelineEvents.clear();
+
+        if( capacity )
+        {
+            mTimeline = reinterpret_cast<TimelineEvent *>(
+                OGRE_MALLOC( sizeof( TimelineEvent ) * capacity, MEMCATEGORY_GENERAL ) );
+            memset( mTimeline, 0, sizeof( TimelineEvent ) * capacity );
+        }
+    }
+    //-----------------------------------------------------------------------------------
     void OfflineProfiler::PerThreadData::setPauseRequest( bool bPause ) { mPauseRequest = bPause; }
     //-----------------------------------------------------------------------------------
     void OfflineProfiler::PerThreadData::requestReset() { mResetRequest = true; }
     //-----------------------------------------------------------------------------------
+    void OfflineProfiler::PerThreadData::setTimelineCapacityRequest( size_t capacity )
+    {
+        mTimelineCapacityRequest = capacity;
+    }
+    //-----------------------------------------------------------------------------------
     void OfflineProfiler::PerThreadData::reset()
     {
         destroyAllPools();
@@ -141,6 +187,7 @@ namespace Ogre
         mCurrentSample = allocateSample( 0 );
         mRoot = mCurrentSample;
         mResetRequest = false;
+        resizeTimeline( mTimelineCapacity );
     }
     //-----------------------------------------------------------------------------------
     void OfflineProfiler::PerThreadData::profileBegin( const char *name,
@@ -152,12 +199,38 @@ namespace Ogre
         if( mResetRequest )
             reset();
 
+        if( mTimelineCapacity != mTimelineCapacityRequest )
+        {
+            mMutex.lock();
+            resizeTimeline( mTimelineCapacityRequest );
+            mMutex.unlock();
+        }
+
         if( mPaused )
             return;
 
         mMutex.lock();
         IdString nameHash( name );
 
+        if( mTimeline )
+        {
+            const uint64 sequence = mTimelineNextSequence++;
+            const size_t slot = static_cast<size_t>( sequence % mTimelineCapacity );
+
+            TimelineEvent &event = mTimeline[slot];
+            strncpy( (char *)event.nameStr, name, OGRE_OFFLINE_PROFILER_NAME_STR_LENGTH );
+            event.nameStr[OGRE_OFFLINE_PROFILER_NAME_STR_LENGTH - 1u] = '\0';
+            event.usStart = mTimer->getMicroseconds() + mTimeOffset;
+            event.usEnd = 0u;
+            event.sequence = sequence;
+            event.frameIdx = *mFrameIdx;
+
+            OpenTimelineEvent openEvent;
+            openEvent.slot = slot;
+            openEvent.sequence = sequence;
+            mOpenTimelineEvents.push_back( openEvent );
+        }
+
         ProfileSample *sample = 0;
 
         // Look if our last sibling has the same name (i.e. similar behavior to RMTSF_Aggregate)
@@ -200,14 +273,26 @@ namespace Ogre
 
         if( !mCurrentSample->parent )
             mTotalAccumTime += usTaken;
+
+        if( mTimeline && !mOpenTimelineEvents.empty() )
+        {
+            const OpenTimelineEvent openEvent = mOpenTimelineEvents.back();
+            mOpenTimelineEvents.pop_back();
+
+            // If the slot got recycled while this sample was open, the sample is lost
+            TimelineEvent &event = mTimeline[openEvent.slot];
+            if( event.sequence == openEvent.sequence )
+                event.usEnd = usEnd + mTimeOffset;
+        }
         mMutex.unlock();
     }
     //-----------------------------------------------------------------------------------
     OfflineProfiler::PerThreadData *OfflineProfiler::allocatePerThreadData()
     {
-        PerThreadData *perThreadData = new PerThreadData( mPaused, mBytesPerPool );
-
         mMutex.lock();
+        PerThreadData *perThreadData = new PerThreadData(
+            mPaused, mBytesPerPool, static_cast<uint32>( mThreadData.size() ),
+            mTimer->getMicroseconds(), mTimelineCapacity, &mFrameIdx );
         mThreadData.push_back( perThreadData );
         mMutex.unlock();
 
@@ -334,6 +419,49 @@ namespace Ogre
         }
     }
     //-----------------------------------------------------------------------------------
+    void OfflineProfiler::PerThreadData::dumpTimeline( LwString &tmpStr, String &outJson,
+                                                       uint32 firstFrameIdx, bool &inOutFirstEvent )
+    {
+        mMutex.lock();
+
+        tmpStr.clear();
+        tmpStr.a( inOutFirstEvent ? "" : ",\n", "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0," );
+        tmpStr.a( "\"tid\":", mThreadIdx, ",\"args\":{\"name\":\"Thread ", mThreadIdx, "\"}}" );
+        outJson += tmpStr.c_str();
+        inOutFirstEvent = false;
+
+        // Oldest events first
+        const uint64 numEvents = std::min<uint64>( mTimelineNextSequence, mTimelineCapacity );
+        for( uint64 sequence = mTimelineNextSequence - numEvents; sequence < mTimelineNextSequence;
+             ++sequence )
+        {
+            const TimelineEvent &event =
+                mTimeline[static_cast<size_t>( sequence % mTimelineCapacity )];
+
+            // Skip samples that haven't finished yet, or are too old
+            if( event.usEnd == 0u || event.frameIdx < firstFrameIdx )
+                continue;
+
+            outJson += ",\n{\"name\":\"";
+            // Escape the name
+            for( const uint8 *c = event.nameStr; *c; ++c )
+            {
+                if( *c == '"' || *c == '\\' )
+                    outJson.push_back( '\\' );
+                if( *c >= 0x20u )
+                    outJson.push_back( static_cast<char>( *c ) );
+            }
+
+            tmpStr.clear();
+            tmpStr.a( "\",\"ph\":\"X\",\"pid\":0,\"tid\":", mThreadIdx, ",\"ts\":", event.usStart );
+            tmpStr.a( ",\"dur\":", event.usEnd - event.usStart, ",\"args\":{\"frame\":", event.frameIdx,
+                      "}}" );
+            outJson += tmpStr.c_str();
+        }
+
+        mMutex.unlock();
+    }
+    //-----------------------------------------------------------------------------------
     void OfflineProfiler::setPaused( bool bPaused )
     {
         if( mPaused == bPaused )
@@ -437,4 +565,73 @@ namespace Ogre
                                                    fullPathPerFrame + " and " + fullPathAccum );
         }
     }
+    //-----------------------------------------------------------------------------------
+    void OfflineProfiler::setTimelineCapacity( size_t maxSamplesPerThread )
+    {
+        mMutex.lock();
+
+        mTimelineCapacity = maxSamplesPerThread;
+
+        PerThreadDataArray::const_iterator itor = mThreadData.begin();
+        PerThreadDataArray::const_iterator endt = mThreadData.end();
+
+        while( itor != endt )
+        {
+            ( *itor )->setTimelineCapacityRequest( maxSamplesPerThread );
+            ++itor;
+        }
+
+        mMutex.unlock();
+    }
+    //-----------------------------------------------------------------------------------
+    void OfflineProfiler::dumpTimelineStr( String &outJson, uint32 lastNumFrames )
+    {
+        mMutex.lock();
+
+        const uint32 firstFrameIdx =
+            ( lastNumFrames && mFrameIdx >= lastNumFrames ) ? ( mFrameIdx - lastNumFrames + 1u ) : 0u;
+
+        char tmpBuffer[256];
+        LwString tmpStr( LwString::FromEmptyPointer( tmpBuffer, sizeof( tmpBuffer ) ) );
+
+        outJson = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+        bool firstEvent = true;
+
+        PerThreadDataArray::const_iterator itor = mThreadData.begin();
+        PerThreadDataArray::const_iterator endt = mThreadData.end();
+
+        while( itor != endt )
+        {
+            ( *itor )->dumpTimeline( tmpStr, outJson, firstFrameIdx, firstEvent );
+            ++itor;
+        }
+
+        outJson += "\n]}\n";
+
+        mMutex.unlock();
+    }
+    //-----------------------------------------------------------------------------------
+    void OfflineProfiler::dumpTimeline( const String &fullPath, uint32 lastNumFrames )
+    {
+        String json;
+        dumpTimelineStr( json, lastNumFrames );
+
+        std::ofstream outFile( fullPath.c_str(), std::ios::binary | std::ios::out );
+        outFile.write( json.c_str(), static_cast<std::streamsize>( json.size() ) );
+        outFile.close();
+    }
+    //-----------------------------------------------------------------------------------
+    void OfflineProfiler::setTimelineDumpPathOnShutdown( const String &fullPath )
+    {
+        mOnShutdownTimelinePath = fullPath;
+
+        if( !fullPath.empty() )
+        {
+            LogManager::getSingleton().logMessage(
+                "[INFO] Will dump profiling timeline on shutdown to " + fullPath );
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    void OfflineProfiler::_notifyFrameEnded() { ++mFrameIdx; }
 }  // namespace Ogre
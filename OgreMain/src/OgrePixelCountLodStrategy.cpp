@@ -30,6 +30,7 @@ THE SOFTWARE.
 
 #include "OgrePixelCountLodStrategy.h"
 
+#include "Animation/OgreSkeletonInstance.h"
 #include "OgreCamera.h"
 #include "OgreViewport.h"
 
@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "CommandBuffer/OgreCbPipelineStateObject.h"
 #include "CommandBuffer/OgreCbShaderBuffer.h"
 #include "CommandBuffer/OgreCommandBuffer.h"
+#include "OgreCamera.h"
 #include "OgreHardwareBufferManager.h"
 #include "OgreHlms.h"
 #include "OgreHlmsDatablock.h"
@@ -55,12 +56,19 @@ THE SOFTWARE.
 #include "Vao/OgreVaoManager.h"
 #include "Vao/OgreVertexArrayObject.h"
 
+#include <sstream>
+
 namespace Ogre
 {
     AtomicScalar<uint32> v1::RenderOperation::MeshIndexId( 0 );
 
     const HlmsCache c_dummyCache( 0, HLMS_MAX, HLMS_CACHE_FLAGS_NONE, HlmsPso() );
 
+    /// Max number of draws a renderable with clusters can issue. See setClusterCullingEnabled
+    static const uint32 c_maxClusterDrawsPerRenderable = 8u;
+    /// Max number of renderables sent to Hlms::fillBuffersForBatch at once
+    static const size_t c_maxFillBuffersBatch = 64u;
+
     // clang-format off
     const int RqBits::SubRqIdBits           = 3;
     const int RqBits::TransparencyBits      = 1;
@@ -98,7 +106,9 @@ namespace Ogre
         mLastIndexData( 0 ),
         mLastTextureHash( 0 ),
         mCommandBuffer( 0 ),
-        mRenderingStarted( 0u )
+        mRenderingStarted( 0u ),
+        mClusterCullingEnabled( false ),
+        mInstancingStatsEnabled( false )
     {
         mCommandBuffer = new CommandBuffer();
 
@@ -195,6 +205,7 @@ namespace Ogre
             while( itor != endt )
             {
                 itor->q.clear();
+                itor->numExtraClusterDraws = 0u;
                 ++itor;
             }
 
@@ -275,6 +286,17 @@ namespace Ogre
 
             VertexArrayObject *vao = vaos[meshLod];
             meshHash = vao->getRenderQueueId();
+
+            if( !casterPass && vao->getClusters() )
+            {
+                // Reserve room in the indirect buffer for the worst case (every other cluster
+                // is culled, or we run out of draws).
+                const size_t numClusters = vao->getClusters()->size();
+                const size_t maxDraws =
+                    std::min<size_t>( ( numClusters + 1u ) >> 1u, c_maxClusterDrawsPerRenderable );
+                mRenderQueues[rqId].mQueuedRenderablesPerThread[threadIdx].numExtraClusterDraws +=
+                    maxDraws - 1u;
+            }
         }
         // TODO: Account for skeletal animation in any of the hashes (preferently on the material side)
         // TODO: Account for auto instancing animation in any of the hashes
@@ -367,6 +389,8 @@ namespace Ogre
                      mRenderQueues[i].mQueuedRenderablesPerThread )
                 {
                     numNeededV2Draws += threadRenderQueue.q.size();
+                    if( mClusterCullingEnabled && !casterPass )
+                        numNeededV2Draws += threadRenderQueue.numExtraClusterDraws;
                 }
             }
             else if( mRenderQueues[i].mMode == PARTICLE_SYSTEM )
@@ -606,6 +630,8 @@ namespace Ogre
         uint32 lastTextureHash = mLastTextureHash;
         // uint32 lastVertexDataId = ~0;
 
+        InstancingStats instStats;
+
         const QueuedRenderableArray &queuedRenderables = renderQueueGroup.mQueuedRenderables;
 
         QueuedRenderableArray::const_iterator itor = queuedRenderables.begin();
@@ -621,6 +647,9 @@ namespace Ogre
             queuedRenderable.renderable->getRenderOperation(
                 op, casterPass & ( datablock->getAlphaTest() == CMPF_ALWAYS_PASS ) );
 
+            if( lastVertexData != op.vertexData || lastIndexData != op.indexData )
+                ++instStats.mNumVaoSwitches;
+
             if( lastVertexData != op.vertexData )
             {
                 lastVertexData = op.vertexData;
@@ -639,6 +668,7 @@ namespace Ogre
             {
                 rs->_setPipelineStateObject( &hlmsCache->pso );
                 lastHlmsCache = hlmsCache;
+                ++instStats.mNumPsoSwitches;
             }
 
             lastTextureHash = hlms->fillBuffersFor( hlmsCache, queuedRenderable, casterPass,
@@ -649,9 +679,19 @@ namespace Ogre
 
             rs->_render( op );
 
+            // V1_LEGACY issues one draw per renderable
+            const InstancingStats::BatchBreakReason breakReason =
+                instStats.mNumRenderables == 0u ? InstancingStats::BbrFirstDraw
+                                                : InstancingStats::BbrNotSupported;
+            ++instStats.mBatchBreaks[breakReason];
+            ++instStats.mNumRenderables;
+            ++instStats.mNumDraws;
+
             ++itor;
         }
 
+        addInstancingStats( renderQueueGroup, instStats );
+
         mLastVertexData = lastVertexData;
         mLastIndexData = lastIndexData;
         mLastTextureHash = lastTextureHash;
@@ -835,6 +875,109 @@ namespace Ogre
         return indirectDraw;
     }
     //-----------------------------------------------------------------------
+    /** Culls the clusters against the camera's frustum & their normal cones, and merges the
+        surviving ones into contiguous index ranges.
+    @param outRanges [out]
+        Pairs of (indexStart, indexCount). Must have room for c_maxClusterDrawsPerRenderable pairs.
+    @return
+        Number of ranges written. 0 if every cluster was culled.
+    */
+    static uint32 cullClusters( const MeshClusterVec &clusters, const Matrix4 &worldMat,
+                                const Camera *camera, bool allowBackfaceCulling, uint32 *outRanges )
+    {
+        // Bring the frustum planes to object space, i.e. transpose( worldMat ) * plane; so that
+        // we don't have to transform each cluster. The planes aren't normalised, the radius is
+        // scaled by the length of their normal instead.
+        const Plane *worldPlanes = camera->getFrustumPlanes();
+        const bool infiniteFarPlane = camera->getFarClipDistance() == 0;
+
+        Vector3 planeNormals[6];
+        Real planeDs[6];
+        Real planeNormalLengths[6];
+        size_t numPlanes = 0u;
+
+        for( size_t i = 0u; i < 6u; ++i )
+        {
+            if( i == FRUSTUM_PLANE_FAR && infiniteFarPlane )
+                continue;
+
+            const Vector3 &n = worldPlanes[i].normal;
+            planeNormals[numPlanes] =
+                Vector3( worldMat[0][0] * n.x + worldMat[1][0] * n.y + worldMat[2][0] * n.z,
+                         worldMat[0][1] * n.x + worldMat[1][1] * n.y + worldMat[2][1] * n.z,
+                         worldMat[0][2] * n.x + worldMat[1][2] * n.y + worldMat[2][2] * n.z );
+            planeDs[numPlanes] = worldPlanes[i].d + worldMat[0][3] * n.x + worldMat[1][3] * n.y +
+                                 worldMat[2][3] * n.z;
+            planeNormalLengths[numPlanes] = planeNormals[numPlanes].length();
+            ++numPlanes;
+        }
+
+        // Normal cones are only preserved by rotations and uniform scaling.
+        bool cullBackfaces =
+            allowBackfaceCulling && !camera->isReflected() && !worldMat.hasNegativeScale();
+        Vector3 cameraPos( Vector3::ZERO );
+        if( cullBackfaces )
+        {
+            const Real scaleSqX =
+                Vector3( worldMat[0][0], worldMat[1][0], worldMat[2][0] ).squaredLength();
+            const Real scaleSqY =
+                Vector3( worldMat[0][1], worldMat[1][1], worldMat[2][1] ).squaredLength();
+            const Real scaleSqZ =
+                Vector3( worldMat[0][2], worldMat[1][2], worldMat[2][2] ).squaredLength();
+            const Real minScaleSq = std::min( scaleSqX, std::min( scaleSqY, scaleSqZ ) );
+            const Real maxScaleSq = std::max( scaleSqX, std::max( scaleSqY, scaleSqZ ) );
+            cullBackfaces = minScaleSq >= maxScaleSq * Real( 0.98 );
+
+            cameraPos = worldMat.inverseAffine().transformAffine( camera->getDerivedPosition() );
+        }
+
+        uint32 numRanges = 0u;
+
+        MeshClusterVec::const_iterator itor = clusters.begin();
+        MeshClusterVec::const_iterator endt = clusters.end();
+
+        while( itor != endt )
+        {
+            bool visible = true;
+            for( size_t i = 0u; i < numPlanes && visible; ++i )
+            {
+                visible = planeNormals[i].dotProduct( itor->center ) + planeDs[i] >=
+                          -itor->radius * planeNormalLengths[i];
+            }
+
+            if( visible && cullBackfaces && itor->coneCutoff < Real( 1.0 ) )
+            {
+                const Vector3 dir = itor->coneApex - cameraPos;
+                visible = dir.dotProduct( itor->coneAxis ) < itor->coneCutoff * dir.length();
+            }
+
+            if( visible )
+            {
+                uint32 *lastRange = 0;
+                if( numRanges > 0u )
+                    lastRange = outRanges + ( numRanges - 1u ) * 2u;
+
+                if( lastRange && ( lastRange[0] + lastRange[1] == itor->indexStart ||
+                                   numRanges == c_maxClusterDrawsPerRenderable ) )
+                {
+                    // Contiguous with the last range; or we ran out of ranges, in which
+                    // case the culled clusters in between get drawn too.
+                    lastRange[1] = itor->indexStart + itor->indexCount - lastRange[0];
+                }
+                else
+                {
+                    outRanges[numRanges * 2u + 0u] = itor->indexStart;
+                    outRanges[numRanges * 2u + 1u] = itor->indexCount;
+                    ++numRanges;
+                }
+            }
+
+            ++itor;
+        }
+
+        return numRanges;
+    }
+    //-----------------------------------------------------------------------
     unsigned char *RenderQueue::renderGL3( RenderSystem *rs, bool casterPass, bool dualParaboloid,
                                            HlmsCache passCache[],
                                            const RenderQueueGroup &renderQueueGroup,
@@ -862,8 +1005,24 @@ namespace Ogre
         CbDrawCall *drawCmd = 0;
         CbSharedDraw *drawCountPtr = 0;
 
+        const Camera *clusterCullingCamera = 0;
+        if( mClusterCullingEnabled && !casterPass && !isUsingInstancedStereo )
+            clusterCullingCamera = mSceneManager->getCamerasInProgress().cullingCamera;
+        uint32 clusterRanges[c_maxClusterDrawsPerRenderable * 2u];
+
         RenderingMetrics stats;
 
+        InstancingStats instStats;
+        // Previous renderable, to classify why it couldn't be merged with the current one
+        VertexArrayObject const *prevVao = 0;
+        VertexArrayObject const *prevLod0Vao = 0;
+        bool prevWasClustered = false;
+
+        // Renderables whose buffers were already filled by Hlms::fillBuffersForBatch
+        uint32 batchBaseInstances[c_maxFillBuffersBatch];
+        size_t batchIdx = 0u;
+        size_t batchSize = 0u;
+
         const QueuedRenderableArray &queuedRenderables = renderQueueGroup.mQueuedRenderables;
 
         QueuedRenderableArray::const_iterator itor = queuedRenderables.begin();
@@ -879,26 +1038,102 @@ namespace Ogre
             VertexArrayObject *vao = vaos[meshLod];
             const HlmsDatablock *datablock = queuedRenderable.renderable->getDatablock();
 
-            Hlms *hlms = mHlmsManager->getHlms( static_cast<HlmsTypes>( datablock->mType ) );
+            uint32 numClusterRanges = 0u;
+            if( clusterCullingCamera && vao->mClusters )
+            {
+                const bool allowBackfaceCulling =
+                    datablock->getMacroblock()->mCullMode == CULL_CLOCKWISE;
+                numClusterRanges =
+                    cullClusters( *vao->mClusters,
+                                  queuedRenderable.movableObject->_getParentNodeFullTransform(),
+                                  clusterCullingCamera, allowBackfaceCulling, clusterRanges );
+                if( numClusterRanges == 0u )
+                {
+                    // Every cluster was culled. Skip the renderable entirely.
+                    ++itor;
+                    continue;
+                }
+            }
 
-            lastHlmsCacheHash = lastHlmsCache->hash;
-            const HlmsCache *hlmsCache =
-                hlms->getMaterial( lastHlmsCache, passCache[datablock->mType], queuedRenderable,
-                                   casterPass, parallelCompileQueue );
-            if( lastHlmsCacheHash != hlmsCache->hash )
+            bool psoChanged = false;
+            uint32 baseInstance;
+
+            if( batchIdx < batchSize )
             {
-                CbPipelineStateObject *psoCmd = mCommandBuffer->addCommand<CbPipelineStateObject>();
-                *psoCmd = CbPipelineStateObject( &hlmsCache->pso );
-                lastHlmsCache = hlmsCache;
+                // Same HlmsCache as the previous renderable, and its buffers are already filled.
+                baseInstance = batchBaseInstances[batchIdx++];
+            }
+            else
+            {
+                Hlms *hlms = mHlmsManager->getHlms( static_cast<HlmsTypes>( datablock->mType ) );
+
+                lastHlmsCacheHash = lastHlmsCache->hash;
+                const HlmsCache *hlmsCache =
+                    hlms->getMaterial( lastHlmsCache, passCache[datablock->mType], queuedRenderable,
+                                       casterPass, parallelCompileQueue );
+                psoChanged = lastHlmsCacheHash != hlmsCache->hash;
+                if( psoChanged )
+                {
+                    CbPipelineStateObject *psoCmd =
+                        mCommandBuffer->addCommand<CbPipelineStateObject>();
+                    *psoCmd = CbPipelineStateObject( &hlmsCache->pso );
+                    lastHlmsCache = hlmsCache;
+
+                    // Flush the Vao when changing shaders. Needed by D3D11/12 & possibly Vulkan
+                    lastVaoName = 0;
+                    ++instStats.mNumPsoSwitches;
+                }
 
-                // Flush the Vao when changing shaders. Needed by D3D11/12 & possibly Vulkan
-                lastVaoName = 0;
+                if( !hlms->getBatchedFillBuffers() )
+                {
+                    batchBaseInstances[0] = hlms->fillBuffersForV2(
+                        hlmsCache, queuedRenderable, casterPass, lastHlmsCacheHash, mCommandBuffer );
+                    batchSize = 1u;
+                }
+                else
+                {
+                    // Gather the run of following renderables sharing the same HlmsCache (i.e.
+                    // same renderable hash). Renderables with per-cluster culling are left out,
+                    // as they may end up being skipped.
+                    QueuedRenderableArray::const_iterator runEnd = itor + 1;
+                    if( numClusterRanges == 0u )
+                    {
+                        const uint32 renderableHash =
+                            casterPass ? queuedRenderable.renderable->getHlmsCasterHash()
+                                       : queuedRenderable.renderable->getHlmsHash();
+                        while( runEnd != endt && size_t( runEnd - itor ) < c_maxFillBuffersBatch )
+                        {
+                            const Renderable *nextRenderable = runEnd->renderable;
+                            const uint32 nextHash = casterPass ? nextRenderable->getHlmsCasterHash()
+                                                               : nextRenderable->getHlmsHash();
+                            if( nextHash != renderableHash )
+                                break;
+
+                            if( clusterCullingCamera )
+                            {
+                                const VertexArrayObjectArray &nextVaos = nextRenderable->getVaos(
+                                    static_cast<VertexPass>( casterPass ) );
+                                if( nextVaos[runEnd->movableObject->getCurrentMeshLod()]->mClusters )
+                                    break;
+                            }
+
+                            ++runEnd;
+                        }
+                    }
+
+                    batchSize = hlms->fillBuffersForBatch( hlmsCache, itor, runEnd, casterPass,
+                                                           lastHlmsCacheHash, mCommandBuffer,
+                                                           batchBaseInstances );
+                }
+
+                batchIdx = 1u;
+                baseInstance = batchBaseInstances[0];
             }
 
-            uint32 baseInstance = hlms->fillBuffersForV2( hlmsCache, queuedRenderable, casterPass,
-                                                          lastHlmsCacheHash, mCommandBuffer );
+            const bool hlmsBrokeBatch = drawCmd != mCommandBuffer->getLastCommand();
+            bool mergedWithPrev = false;
 
-            if( drawCmd != mCommandBuffer->getLastCommand() || lastVaoName != vao->getVaoName() )
+            if( hlmsBrokeBatch || lastVaoName != vao->getVaoName() )
             {
                 // Different mesh, vertex buffers or layout. Make a new draw call.
                 //(or also the the Hlms made a batch-breaking command)
@@ -912,6 +1147,7 @@ namespace Ogre
                     *mCommandBuffer->addCommand<CbVao>() = CbVao( vao );
                     *mCommandBuffer->addCommand<CbIndirectBuffer>() = CbIndirectBuffer( indirectBuffer );
                     lastVaoName = vao->getVaoName();
+                    ++instStats.mNumVaoSwitches;
                 }
 
                 void *offset = reinterpret_cast<void *>(
@@ -935,7 +1171,37 @@ namespace Ogre
                 stats.mDrawCount += 1u;
             }
 
-            if( lastVao != vao )
+            uint32 primCount = vao->mPrimCount;
+
+            if( numClusterRanges > 0u )
+            {
+                // Per-cluster culling. Each surviving range is a separate draw sharing the same
+                // instance data. Clusters are only built for indexed triangle lists.
+                primCount = 0u;
+                for( uint32 i = 0u; i < numClusterRanges; ++i )
+                {
+                    ++drawCmd->numDraws;
+
+                    CbDrawIndexed *drawIndexedPtr = reinterpret_cast<CbDrawIndexed *>( indirectDraw );
+                    indirectDraw += sizeof( CbDrawIndexed );
+
+                    drawIndexedPtr->primCount = clusterRanges[i * 2u + 1u];
+                    drawIndexedPtr->instanceCount = instancesPerDraw;
+                    drawIndexedPtr->firstVertexIndex = uint32(
+                        vao->mIndexBuffer->_getFinalBufferStart() + clusterRanges[i * 2u + 0u] );
+                    drawIndexedPtr->baseVertex =
+                        uint32( vao->mBaseVertexBuffer->_getFinalBufferStart() );
+                    drawIndexedPtr->baseInstance = baseInstance << baseInstanceShift;
+
+                    primCount += clusterRanges[i * 2u + 1u];
+                }
+
+                // The next renderable can't instance over a partial range of this one
+                lastVao = 0;
+                stats.mInstanceCount += instancesPerDraw;
+                instStats.mNumDraws += numClusterRanges;
+            }
+            else if( lastVao != vao )
             {
                 // Different mesh, but same vertex buffers & layouts. Advance indirection buffer.
                 ++drawCmd->numDraws;
@@ -973,6 +1239,7 @@ namespace Ogre
 
                 lastVao = vao;
                 stats.mInstanceCount += instancesPerDraw;
+                ++instStats.mNumDraws;
             }
             else
             {
@@ -981,27 +1248,54 @@ namespace Ogre
                 instanceCount += instancesPerDraw;
                 drawCountPtr->instanceCount = instanceCount;
                 stats.mInstanceCount += instancesPerDraw;
+                mergedWithPrev = true;
             }
 
+            if( mergedWithPrev )
+                ++instStats.mNumMergedInstances;
+            else
+            {
+                InstancingStats::BatchBreakReason breakReason = InstancingStats::BbrMesh;
+                if( !prevVao )
+                    breakReason = InstancingStats::BbrFirstDraw;
+                else if( psoChanged )
+                    breakReason = InstancingStats::BbrPso;
+                else if( hlmsBrokeBatch )
+                    breakReason = InstancingStats::BbrHlmsCommand;
+                else if( prevVao->getVaoName() != vao->getVaoName() )
+                    breakReason = InstancingStats::BbrVaoPool;
+                else if( prevWasClustered || numClusterRanges > 0u )
+                    breakReason = InstancingStats::BbrClusterCulling;
+                else if( prevLod0Vao == vaos[0] )
+                    breakReason = InstancingStats::BbrLodMismatch;
+                ++instStats.mBatchBreaks[breakReason];
+            }
+            ++instStats.mNumRenderables;
+
+            prevVao = vao;
+            prevLod0Vao = vaos[0];
+            prevWasClustered = numClusterRanges > 0u;
+
             switch( vao->getOperationType() )
             {
             case OT_TRIANGLE_LIST:
-                stats.mFaceCount += ( vao->mPrimCount / 3u ) * instancesPerDraw;
+                stats.mFaceCount += ( primCount / 3u ) * instancesPerDraw;
                 break;
             case OT_TRIANGLE_STRIP:
             case OT_TRIANGLE_FAN:
-                stats.mFaceCount += ( vao->mPrimCount - 2u ) * instancesPerDraw;
+                stats.mFaceCount += ( primCount - 2u ) * instancesPerDraw;
                 break;
             default:
                 break;
             }
 
-            stats.mVertexCount += vao->mPrimCount * instancesPerDraw;
+            stats.mVertexCount += primCount * instancesPerDraw;
 
             ++itor;
         }
 
         rs->_addMetrics( stats );
+        addInstancingStats( renderQueueGroup, instStats );
 
         mLastVaoName = lastVaoName;
         mLastVertexData = 0;
@@ -1030,6 +1324,7 @@ namespace Ogre
         v1::CbDrawCall *drawCmd = 0;
 
         RenderingMetrics stats;
+        InstancingStats instStats;
 
         const QueuedRenderableArray &queuedRenderables = renderQueueGroup.mQueuedRenderables;
 
@@ -1052,7 +1347,8 @@ namespace Ogre
             const HlmsCache *hlmsCache =
                 hlms->getMaterial( lastHlmsCache, passCache[datablock->mType], queuedRenderable,
                                    casterPass, parallelCompileQueue );
-            if( lastHlmsCache != hlmsCache )
+            const bool psoChanged = lastHlmsCache != hlmsCache;
+            if( psoChanged )
             {
                 CbPipelineStateObject *psoCmd = mCommandBuffer->addCommand<CbPipelineStateObject>();
                 *psoCmd = CbPipelineStateObject( &hlmsCache->pso );
@@ -1061,6 +1357,7 @@ namespace Ogre
                 // Flush the RenderOp when changing shaders. Needed by D3D11/12 & possibly Vulkan
                 lastRenderOp.vertexData = 0;
                 lastRenderOp.indexData = 0;
+                ++instStats.mNumPsoSwitches;
             }
 
             uint32 baseInstance = hlms->fillBuffersForV1( hlmsCache, queuedRenderable, casterPass,
@@ -1072,7 +1369,9 @@ namespace Ogre
                                      lastRenderOp.useGlobalInstancingVertexBufferIsAvailable !=
                                          renderOp.useGlobalInstancingVertexBufferIsAvailable;
 
-            if( drawCmd != mCommandBuffer->getLastCommand() || differentRenderOp )
+            const bool hlmsBrokeBatch = drawCmd != mCommandBuffer->getLastCommand();
+
+            if( hlmsBrokeBatch || differentRenderOp )
             {
                 // Different mesh, vertex buffers or layout. If instanced, entities
                 // likely use their own low level materials. Make a new draw call.
@@ -1082,8 +1381,19 @@ namespace Ogre
                 {
                     *mCommandBuffer->addCommand<v1::CbRenderOp>() = v1::CbRenderOp( renderOp );
                     lastRenderOp = renderOp;
+                    ++instStats.mNumVaoSwitches;
                 }
 
+                InstancingStats::BatchBreakReason breakReason = InstancingStats::BbrVaoPool;
+                if( instStats.mNumRenderables == 0u )
+                    breakReason = InstancingStats::BbrFirstDraw;
+                else if( psoChanged )
+                    breakReason = InstancingStats::BbrPso;
+                else if( !differentRenderOp )
+                    breakReason = InstancingStats::BbrHlmsCommand;
+                ++instStats.mBatchBreaks[breakReason];
+                ++instStats.mNumDraws;
+
                 if( renderOp.useIndexes )
                 {
                     v1::CbDrawCallIndexed *drawCall =
@@ -1128,7 +1438,9 @@ namespace Ogre
                 instanceCount += instancesPerDraw;
                 drawCmd->instanceCount = instanceCount;
                 stats.mInstanceCount += instancesPerDraw;
+                ++instStats.mNumMergedInstances;
             }
+            ++instStats.mNumRenderables;
 
             size_t primCount =
                 renderOp.useIndexes ? renderOp.indexData->indexCount : renderOp.vertexData->vertexCount;
@@ -1151,6 +1463,7 @@ namespace Ogre
         }
 
         rs->_addMetrics( stats );
+        addInstancingStats( renderQueueGroup, instStats );
 
         mLastVaoName = 0;
         mLastVertexData = 0;
@@ -1501,6 +1814,71 @@ namespace Ogre
         mUsedIndirectBuffers.clear();
 
         mParallelHlmsCompileQueue.frameEnded();
+
+        if( mInstancingStatsEnabled )
+        {
+            for( size_t i = 0u; i < 256u; ++i )
+            {
+                mLastFrameInstancingStats[i] = mInstancingStats[i];
+                mInstancingStats[i].reset();
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void RenderQueue::addInstancingStats( const RenderQueueGroup &renderQueueGroup,
+                                          const InstancingStats &stats )
+    {
+        if( mInstancingStatsEnabled )
+        {
+            const size_t rqId = static_cast<size_t>( &renderQueueGroup - mRenderQueues );
+            mInstancingStats[rqId] += stats;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void RenderQueue::setInstancingStatsEnabled( bool bEnabled )
+    {
+        mInstancingStatsEnabled = bEnabled;
+        for( size_t i = 0u; i < 256u; ++i )
+        {
+            mInstancingStats[i].reset();
+            mLastFrameInstancingStats[i].reset();
+        }
+    }
+    //-----------------------------------------------------------------------
+    InstancingStats RenderQueue::getInstancingStatsTotal() const
+    {
+        InstancingStats retVal;
+        for( size_t i = 0u; i < 256u; ++i )
+            retVal += mLastFrameInstancingStats[i];
+        return retVal;
+    }
+    //-----------------------------------------------------------------------
+    void RenderQueue::getInstancingStatsReport( String &outReport ) const
+    {
+        StringStream report;
+        for( size_t i = 0u; i < 256u; ++i )
+        {
+            const InstancingStats &stats = mLastFrameInstancingStats[i];
+            if( stats.mNumRenderables == 0u )
+                continue;
+
+            report << "RQ " << i << ": " << stats.mNumRenderables << " renderables, "
+                   << stats.mNumDraws << " draws, " << stats.mNumMergedInstances
+                   << " merged instances, " << stats.mNumPsoSwitches << " PSO switches, "
+                   << stats.mNumVaoSwitches << " VAO switches\n";
+
+            for( size_t j = 0u; j < InstancingStats::NumBatchBreakReasons; ++j )
+            {
+                if( stats.mBatchBreaks[j] == 0u )
+                    continue;
+
+                const InstancingStats::BatchBreakReason reason =
+                    static_cast<InstancingStats::BatchBreakReason>( j );
+                report << "    " << InstancingStats::getBatchBreakReasonName( reason ) << ": "
+                       << stats.mBatchBreaks[j] << "\n";
+            }
+        }
+        outReport += report.str();
     }
     //-----------------------------------------------------------------------
     void RenderQueue::setRenderQueueMode( uint8 rqId, Modes newMode )
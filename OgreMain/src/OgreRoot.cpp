@@ -47,6 +47,7 @@ THE SOFTWARE.
 #include "OgreException.h"
 #include "OgreExternalTextureSourceManager.h"
 #include "OgreFileSystem.h"
+#include "OgreFrameArena.h"
 #include "OgreFrameListener.h"
 #include "OgreFrameStats.h"
 #include "OgreHardwareBufferManager.h"
@@ -72,6 +73,7 @@ THE SOFTWARE.
 #include "OgrePlugin.h"
 #include "OgreProfiler.h"
 #include "OgreRectangle2D2.h"
+#include "OgreRenderQueue.h"
 #include "OgreRenderSystem.h"
 #include "OgreRenderSystemCapabilitiesManager.h"
 #include "OgreResourceBackgroundQueue.h"
@@ -990,6 +992,9 @@ namespace Ogre
         // Tell the queue to process responses
         mWorkQueue->processResponses();
 
+        // Recycle transient memory from two frames ago
+        FrameArena::_notifyFrameEnded();
+
 #if OGRE_PROFILING
         if( OgreProfilerUseStableMarkers )
         {
@@ -1006,6 +1011,9 @@ namespace Ogre
             OgreProfileEndGroup( frameNum.c_str(), OGREPROF_GENERAL );
         }
 #endif
+#if OGRE_PROFILING == OGRE_PROFILING_INTERNAL_OFFLINE
+        Profiler::getSingleton().getOfflineProfiler()._notifyFrameEnded();
+#endif
 
         return ret;
     }
@@ -1625,12 +1633,20 @@ namespace Ogre
         SceneManagerEnumerator::SceneManagerIterator sceneManagerItor =
             mSceneManagerEnum->getSceneManagerIterator();
 
+        InstancingStats instancingStats;
+
         while( sceneManagerItor.hasMoreElements() )
         {
             SceneManager *sceneManager = sceneManagerItor.getNext();
             sceneManager->_frameEnded();
+
+            RenderQueue *renderQueue = sceneManager->getRenderQueue();
+            if( renderQueue->getInstancingStatsEnabled() )
+                instancingStats += renderQueue->getInstancingStatsTotal();
         }
 
+        mFrameStats->_setInstancingStats( instancingStats );
+
         HlmsManager *hlmsManager = mHlmsManager;
 
         for( size_t i = 0; i < HLMS_MAX; ++i )
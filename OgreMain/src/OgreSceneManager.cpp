@@ -71,6 +71,7 @@ THE SOFTWARE.
 #include "OgreRibbonTrail.h"
 #include "OgreRoot.h"
 #include "OgreSceneNode.h"
+#include "OgreStaticGeometry2.h"
 #include "OgreSubEntity.h"
 #include "OgreTechnique.h"
 #include "OgreTextureGpuManager.h"
@@ -116,6 +117,9 @@ namespace Ogre
     //-----------------------------------------------------------------------
     SceneManager::SceneManager( const String &name, size_t numWorkerThreads ) :
         IdObject( Id::generateNewId<SceneManager>() ),
+        mIncrementalDefragment( false ),
+        mDefragmentMaxSlotsPerFrame( 256u ),
+        mDefragmentTimeBudgetUs( 0u ),
         mNumDecals( 0 ),
         mNumCubemapProbes( 0 ),
         mStaticMinDepthLevelDirty( 0 ),
@@ -399,6 +403,9 @@ namespace Ogre
 
         checkMovableObjectIntegrity( mCameras, cam );
 
+        if( mParticleSystemManager2->getCameraPositionSource() == cam )
+            mParticleSystemManager2->setCameraPositionSource( 0 );
+
         {
             FrustumVec::iterator it = std::find( mVisibleCameras.begin(), mVisibleCameras.end(), cam );
             if( it != mVisibleCameras.end() )
@@ -546,6 +553,54 @@ namespace Ogre
         mTagPointNodeMemoryManager.shrinkToFit();
     }
     //-----------------------------------------------------------------------
+    void SceneManager::setIncrementalDefragment( bool bIncremental, size_t maxSlotsPerFrame,
+                                                 uint64 timeBudgetUs )
+    {
+        OGRE_ASSERT_LOW( maxSlotsPerFrame > 0u );
+
+        mIncrementalDefragment = bIncremental;
+        mDefragmentMaxSlotsPerFrame = maxSlotsPerFrame;
+        mDefragmentTimeBudgetUs = timeBudgetUs;
+
+        for( size_t i = 0; i < NUM_SCENE_MEMORY_MANAGER_TYPES; ++i )
+        {
+            mNodeMemoryManager[i].setIncrementalDefragment( bIncremental );
+            mEntityMemoryManager[i].setIncrementalDefragment( bIncremental );
+            mForwardPlusMemoryManager[i].setIncrementalDefragment( bIncremental );
+        }
+
+        mLightMemoryManager.setIncrementalDefragment( bIncremental );
+        // Do not defragment mParticleSysDefMemoryManager
+        mParticleSysMemoryManager.setIncrementalDefragment( bIncremental );
+        mSkeletonAnimationManager.setIncrementalDefragment( bIncremental );
+        mTagPointNodeMemoryManager.setIncrementalDefragment( bIncremental );
+    }
+    //-----------------------------------------------------------------------
+    void SceneManager::_defragmentMemoryPoolsIncremental()
+    {
+        if( !mIncrementalDefragment )
+            return;
+
+        OgreProfile( "SceneManager::_defragmentMemoryPoolsIncremental" );
+
+        Timer *timer = mDefragmentTimeBudgetUs ? Root::getSingleton().getTimer() : 0;
+        ArrayMemoryManager::DefragmentBudget budget( mDefragmentMaxSlotsPerFrame, timer,
+                                                     mDefragmentTimeBudgetUs );
+
+        // SCENE_DYNAMIC goes first, since that's where most of the churn happens
+        for( size_t i = 0; i < NUM_SCENE_MEMORY_MANAGER_TYPES; ++i )
+        {
+            mNodeMemoryManager[i].defragmentIncremental( budget );
+            mEntityMemoryManager[i].defragmentIncremental( budget );
+            mForwardPlusMemoryManager[i].defragmentIncremental( budget );
+        }
+
+        mLightMemoryManager.defragmentIncremental( budget );
+        mParticleSysMemoryManager.defragmentIncremental( budget );
+        mSkeletonAnimationManager.defragmentIncremental( budget );
+        mTagPointNodeMemoryManager.defragmentIncremental( budget );
+    }
+    //-----------------------------------------------------------------------
     Item *SceneManager::createItem(
         const String &meshName,
         const String &groupName,       /*= ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME*/
@@ -597,6 +652,65 @@ namespace Ogre
         efficientVectorRemove( mTrackingWireAabbs, itor );
     }
     //-----------------------------------------------------------------------
+    StaticGeometry *SceneManager::createStaticGeometry( const String &name )
+    {
+        if( mStaticGeometryMap.find( name ) != mStaticGeometryMap.end() )
+        {
+            OGRE_EXCEPT( Exception::ERR_DUPLICATE_ITEM,
+                         "StaticGeometry with name '" + name + "' already exists!",
+                         "SceneManager::createStaticGeometry" );
+        }
+
+        StaticGeometry *retVal = OGRE_NEW StaticGeometry( name, this );
+        mStaticGeometryMap[name] = retVal;
+        return retVal;
+    }
+    //-----------------------------------------------------------------------
+    StaticGeometry *SceneManager::getStaticGeometry( const String &name ) const
+    {
+        StaticGeometryMap::const_iterator itor = mStaticGeometryMap.find( name );
+        if( itor == mStaticGeometryMap.end() )
+        {
+            OGRE_EXCEPT( Exception::ERR_ITEM_NOT_FOUND,
+                         "StaticGeometry with name '" + name + "' not found",
+                         "SceneManager::getStaticGeometry" );
+        }
+        return itor->second;
+    }
+    //-----------------------------------------------------------------------
+    bool SceneManager::hasStaticGeometry( const String &name ) const
+    {
+        return mStaticGeometryMap.find( name ) != mStaticGeometryMap.end();
+    }
+    //-----------------------------------------------------------------------
+    void SceneManager::destroyStaticGeometry( StaticGeometry *geom )
+    {
+        destroyStaticGeometry( geom->getName() );
+    }
+    //-----------------------------------------------------------------------
+    void SceneManager::destroyStaticGeometry( const String &name )
+    {
+        StaticGeometryMap::iterator itor = mStaticGeometryMap.find( name );
+        if( itor != mStaticGeometryMap.end() )
+        {
+            OGRE_DELETE itor->second;
+            mStaticGeometryMap.erase( itor );
+        }
+    }
+    //-----------------------------------------------------------------------
+    void SceneManager::destroyAllStaticGeometry()
+    {
+        StaticGeometryMap::const_iterator itor = mStaticGeometryMap.begin();
+        StaticGeometryMap::const_iterator endt = mStaticGeometryMap.end();
+
+        while( itor != endt )
+        {
+            OGRE_DELETE itor->second;
+            ++itor;
+        }
+        mStaticGeometryMap.clear();
+    }
+    //-----------------------------------------------------------------------
     Decal *SceneManager::createDecal( SceneMemoryMgrTypes sceneType )
     {
         ++mNumDecals;
@@ -841,8 +955,25 @@ namespace Ogre
         return mParticleSystemManager2->destroyAllBillboardSets();
     }
     //-----------------------------------------------------------------------
+    BillboardChain *SceneManager::createBillboardChain2( uint32 maxElements, uint32 numberOfChains )
+    {
+        return mParticleSystemManager2->createBillboardChain( maxElements, numberOfChains );
+    }
+    //-----------------------------------------------------------------------
+    RibbonTrail *SceneManager::createRibbonTrail2( uint32 maxElements, uint32 numberOfChains )
+    {
+        return mParticleSystemManager2->createRibbonTrail( maxElements, numberOfChains );
+    }
+    //-----------------------------------------------------------------------
+    void SceneManager::destroyBillboardChain2( BillboardChain *billboardChain )
+    {
+        mParticleSystemManager2->destroyBillboardChain( billboardChain );
+    }
+    //-----------------------------------------------------------------------
     void SceneManager::clearScene( bool deleteIndestructibleToo, bool reattachCameras )
     {
+        // StaticGeometry owns Items, SceneNodes and Meshes. Let it clean up after itself
+        destroyAllStaticGeometry();
         destroyAllMovableObjects();
 
         // Clear root node of all children
@@ -2715,12 +2846,17 @@ namespace Ogre
 
         OgreProfileGroup( "updateSceneGraph", OGREPROF_GENERAL );
 
+        _defragmentMemoryPoolsIncremental();
+
         // Update controllers
         ControllerManager &controllerManager = ControllerManager::getSingleton();
         controllerManager.updateAllControllers();
 
         {
             const Real timeSinceLast = controllerManager.getFrameTimeSource()->getValue();
+            const Camera *camPosSource = mParticleSystemManager2->getCameraPositionSource();
+            if( camPosSource )
+                mParticleSystemManager2->setCameraPosition( camPosSource->getDerivedPosition() );
             mParticleSystemManager2->prepareForUpdate( timeSinceLast );
             mPrepareParticleFx = true;
         }
@@ -3800,6 +3936,84 @@ namespace Ogre
         return retVal;
     }
     //---------------------------------------------------------------------
+    static uint32 hashCasters( ObjectMemoryManager *objMemoryManager, uint32 sceneVisibilityFlags,
+                               size_t _firstRq, size_t _lastRq, const Plane *planes,
+                               size_t numPlanes, uint32 hashSoFar )
+    {
+        const size_t numRenderQueues = objMemoryManager->getNumRenderQueues();
+
+        size_t firstRq = std::min<size_t>( _firstRq, numRenderQueues );
+        size_t lastRq = std::min<size_t>( _lastRq, numRenderQueues );
+
+        for( size_t i = firstRq; i < lastRq; ++i )
+        {
+            ObjectData objData;
+            const size_t numObjs = objMemoryManager->getFirstObjectData( objData, i );
+
+            for( size_t j = 0; j < numObjs; j += ARRAY_PACKED_REALS )
+            {
+                for( size_t k = 0; k < ARRAY_PACKED_REALS; ++k )
+                {
+                    const uint32 visibilityFlags = objData.mVisibilityFlags[k];
+                    if( !objData.mOwner[k] ||
+                        !( visibilityFlags & VisibilityFlags::LAYER_VISIBILITY ) ||
+                        !( visibilityFlags & VisibilityFlags::LAYER_SHADOW_CASTER ) ||
+                        !( visibilityFlags & sceneVisibilityFlags ) )
+                    {
+                        continue;
+                    }
+
+                    Aabb worldAabb;
+                    objData.mWorldAabb->getAsAabb( worldAabb, k );
+
+                    bool isInside = true;
+                    for( size_t l = 0; l < numPlanes && isInside; ++l )
+                    {
+                        isInside = planes[l].getSide( worldAabb.mCenter, worldAabb.mHalfSize ) !=
+                                   Plane::NEGATIVE_SIDE;
+                    }
+
+                    if( isInside )
+                    {
+                        hashSoFar = HashCombine( hashSoFar, objData.mOwner[k] );
+                        hashSoFar = HashCombine( hashSoFar, worldAabb );
+                    }
+                }
+
+                objData.advancePack();
+            }
+        }
+
+        return hashSoFar;
+    }
+    //---------------------------------------------------------------------
+    uint32 SceneManager::_calculateCastersHash( uint32 viewportVisibilityMask, uint8 firstRq,
+                                                uint8 lastRq, const Plane *planes,
+                                                size_t numPlanes ) const
+    {
+        const uint32 sceneVisibilityFlags =
+            ( viewportVisibilityMask & getVisibilityMask() ) |
+            ( viewportVisibilityMask & ~VisibilityFlags::RESERVED_VISIBILITY_FLAGS );
+
+        uint32 retVal = 0;
+
+        ObjectMemoryManagerVec::const_iterator it = mEntitiesMemoryManagerCulledList.begin();
+        ObjectMemoryManagerVec::const_iterator en = mEntitiesMemoryManagerCulledList.end();
+
+        while( it != en )
+        {
+            retVal = hashCasters( *it, sceneVisibilityFlags, firstRq, lastRq, planes, numPlanes,
+                                  retVal );
+            ++it;
+        }
+
+        // Everything will be treated as const (we have no ConstObjectData structure).
+        retVal = hashCasters( const_cast<ObjectMemoryManager *>( &mParticleSysDefMemoryManager ),
+                              sceneVisibilityFlags, firstRq, lastRq, planes, numPlanes, retVal );
+
+        return retVal;
+    }
+    //---------------------------------------------------------------------
     void SceneManager::propagateRelativeOrigin( SceneNode *sceneNode, const Vector3 &relativeOrigin )
     {
         if( sceneNode->numAttachedObjects() > 0 )
@@ -4735,55 +4949,99 @@ namespace Ogre
     {
         bool exitThread = false;
 
+        // Each case has its own profile marker so that per-thread timelines
+        // (see OfflineProfiler::setTimelineCapacity) show which phase is running
         switch( mRequestType )
         {
         case CULL_FRUSTUM:
+        {
+            OgreProfileGroup( "SceneManager::cullFrustum", OGREPROF_CULLING );
             cullFrustum( mCurrentCullFrustumRequest, threadIdx );
             break;
+        }
         case UPDATE_ALL_ANIMATIONS:
+        {
+            OgreProfileGroup( "SceneManager::updateAllAnimationsThread", OGREPROF_GENERAL );
             updateAllAnimationsThread( threadIdx );
             if( mPrepareParticleFx )
                 mParticleSystemManager2->_prepareParallel();
             break;
+        }
         case UPDATE_ALL_TRANSFORMS:
+        {
+            OgreProfileGroup( "SceneManager::updateAllTransformsThread", OGREPROF_GENERAL );
             updateAllTransformsThread( mUpdateTransformRequest, threadIdx );
             break;
+        }
         case UPDATE_ALL_BONE_TO_TAG_TRANSFORMS:
+        {
+            OgreProfileGroup( "SceneManager::updateAllTransformsBoneToTagThread", OGREPROF_GENERAL );
             updateAllTransformsBoneToTagThread( mUpdateTransformRequest, threadIdx );
             break;
+        }
         case UPDATE_ALL_TAG_ON_TAG_TRANSFORMS:
+        {
+            OgreProfileGroup( "SceneManager::updateAllTransformsTagOnTagThread", OGREPROF_GENERAL );
             updateAllTransformsTagOnTagThread( mUpdateTransformRequest, threadIdx );
             break;
+        }
         case UPDATE_ALL_BOUNDS:
+        {
+            OgreProfileGroup( "SceneManager::updateAllBoundsThread", OGREPROF_GENERAL );
             updateAllBoundsThread( *mUpdateBoundsRequest, threadIdx );
             break;
+        }
         case UPDATE_ALL_LODS:
+        {
+            OgreProfileGroup( "SceneManager::updateAllLodsThread", OGREPROF_GENERAL );
             updateAllLodsThread( mUpdateLodRequest, threadIdx );
             break;
+        }
         case BUILD_LIGHT_LIST01:
+        {
+            OgreProfileGroup( "SceneManager::buildLightListThread01", OGREPROF_GENERAL );
             buildLightListThread01( mBuildLightListRequestPerThread[threadIdx], threadIdx );
             break;
+        }
         case BUILD_LIGHT_LIST02:
+        {
+            OgreProfileGroup( "SceneManager::buildLightListThread02", OGREPROF_GENERAL );
             buildLightListThread02( threadIdx );
             break;
+        }
         case WARM_UP_SHADERS:
+        {
+            OgreProfileGroup( "SceneManager::warmUpShaders", OGREPROF_RENDERING );
             warmUpShaders( mCurrentCullFrustumRequest, threadIdx );
             break;
+        }
         case WARM_UP_SHADERS_COMPILE:
+        {
+            OgreProfileGroup( "RenderQueue::_warmUpShadersThread", OGREPROF_RENDERING );
             mRenderQueue->_warmUpShadersThread( threadIdx );
             break;
+        }
         case PARALLEL_HLMS_COMPILE:
+        {
+            OgreProfileGroup( "RenderQueue::_compileShadersThread", OGREPROF_RENDERING );
             mRenderQueue->_compileShadersThread( threadIdx );
             break;
+        }
         case PARTICLE_SYSTEM_MANAGER2:
+        {
+            OgreProfileGroup( "ParticleSystemManager2::_updateParallel", OGREPROF_GENERAL );
             mParticleSystemManager2->_updateParallel01( threadIdx, mNumWorkerThreads );
             if( !mForceMainThread )
                 mWorkerThreadsBarrier->sync();
             mParticleSystemManager2->_updateParallel02( threadIdx, mNumWorkerThreads );
             break;
+        }
         case USER_UNIFORM_SCALABLE_TASK:
+        {
+            OgreProfileGroup( "SceneManager USER_UNIFORM_SCALABLE_TASK", OGREPROF_GENERAL );
             mUserTask->execute( threadIdx, mNumWorkerThreads );
             break;
+        }
         case STOP_THREADS:
             exitThread = true;
             break;
@@ -0,0 +1,1060 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreStableHeaders.h"
+
+#include "OgreStaticGeometry2.h"
+
+#include "OgreBitwise.h"
+#include "OgreHlmsManager.h"
+#include "OgreItem.h"
+#include "OgreLogManager.h"
+#include "OgreMatrix3.h"
+#include "OgreMatrix4.h"
+#include "OgreMeshManager2.h"
+#include "OgreProfiler.h"
+#include "OgreRoot.h"
+#include "OgreSceneManager.h"
+#include "OgreSceneNode.h"
+#include "OgreStringConverter.h"
+#include "OgreSubItem.h"
+#include "OgreSubMesh2.h"
+#include "Vao/OgreAsyncTicket.h"
+#include "Vao/OgreIndexBufferPacked.h"
+#include "Vao/OgreVaoManager.h"
+#include "Vao/OgreVertexArrayObject.h"
+
+namespace Ogre
+{
+    struct StaticGeometry::CpuBufferCache
+    {
+        typedef map<BufferPacked *, uint8 const *>::type BufferMap;
+
+        BufferMap         buffers;
+        FastArray<void *> ownedCopies;
+
+        ~CpuBufferCache()
+        {
+            FastArray<void *>::const_iterator itor = ownedCopies.begin();
+            FastArray<void *>::const_iterator endt = ownedCopies.end();
+
+            while( itor != endt )
+            {
+                OGRE_FREE_SIMD( *itor, MEMCATEGORY_GEOMETRY );
+                ++itor;
+            }
+        }
+
+        /// Returns the contents of the buffer. Uses the shadow copy if there is one,
+        /// otherwise downloads it from GPU the first time it is requested.
+        uint8 const *get( BufferPacked *buffer )
+        {
+            if( buffer->getShadowCopy() )
+                return reinterpret_cast<uint8 const *>( buffer->getShadowCopy() );
+
+            BufferMap::const_iterator itor = buffers.find( buffer );
+            if( itor != buffers.end() )
+                return itor->second;
+
+            const size_t sizeBytes = buffer->getTotalSizeBytes();
+            void *data = OGRE_MALLOC_SIMD( sizeBytes, MEMCATEGORY_GEOMETRY );
+            ownedCopies.push_back( data );
+
+            AsyncTicketPtr asyncTicket = buffer->readRequest( 0, buffer->getNumElements() );
+            memcpy( data, asyncTicket->map(), sizeBytes );
+            asyncTicket->unmap();
+
+            buffers[buffer] = reinterpret_cast<uint8 const *>( data );
+            return reinterpret_cast<uint8 const *>( data );
+        }
+    };
+
+    /// SubMeshes that can be merged together into the same SubMesh
+    struct StaticGeometryBatchKey
+    {
+        String const              *lodStrategyName;
+        Mesh::LodValueArray const *lodValues;
+        HlmsDatablock             *datablock;
+        OperationType              operationType;
+        VertexElement2VecVec       vertexElements;
+
+        /// Returns <0, 0 or >0 if our LOD schedule is lower, equal or greater than other's
+        int compareLodSchedule( const StaticGeometryBatchKey &other ) const
+        {
+            if( *this->lodStrategyName != *other.lodStrategyName )
+                return *this->lodStrategyName < *other.lodStrategyName ? -1 : 1;
+            if( this->lodValues->size() != other.lodValues->size() )
+                return this->lodValues->size() < other.lodValues->size() ? -1 : 1;
+            for( size_t i = 0u; i < this->lodValues->size(); ++i )
+            {
+                if( ( *this->lodValues )[i] != ( *other.lodValues )[i] )
+                    return ( *this->lodValues )[i] < ( *other.lodValues )[i] ? -1 : 1;
+            }
+            return 0;
+        }
+
+        bool operator<( const StaticGeometryBatchKey &other ) const
+        {
+            // LOD schedule goes first so that batches sharing the same Mesh are contiguous
+            const int lodCmp = compareLodSchedule( other );
+            if( lodCmp != 0 )
+                return lodCmp < 0;
+
+            if( this->datablock != other.datablock )
+                return this->datablock < other.datablock;
+            if( this->operationType != other.operationType )
+                return this->operationType < other.operationType;
+            return this->vertexElements < other.vertexElements;
+        }
+    };
+
+    struct StaticGeometryBatchEntry
+    {
+        uint32   sourceId;
+        SubMesh *subMesh;
+    };
+
+    typedef FastArray<StaticGeometryBatchEntry>                            StaticGeometryBatchEntryArray;
+    typedef map<StaticGeometryBatchKey, StaticGeometryBatchEntryArray>::type StaticGeometryBatchMap;
+
+    /// Transform to apply to a source's vertices
+    struct StaticGeometryTransform
+    {
+        Matrix4 xform;
+        Matrix3 m3x3;
+        Matrix3 normalMatrix;
+        bool    mirrored;
+    };
+    //-----------------------------------------------------------------------------------
+    static void readFloats( uint8 const *src, VertexElementType type, float outValues[4] )
+    {
+        const size_t numComponents = v1::VertexElement::getTypeCount( type );
+        if( v1::VertexElement::getBaseType( type ) == VET_HALF2 )
+        {
+            uint16 const *src16 = reinterpret_cast<uint16 const *>( src );
+            for( size_t i = 0u; i < numComponents; ++i )
+                outValues[i] = Bitwise::halfToFloat( src16[i] );
+        }
+        else
+        {
+            memcpy( outValues, src, numComponents * sizeof( float ) );
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    static void writeFloats( uint8 *dst, VertexElementType type, const float values[4] )
+    {
+        const size_t numComponents = v1::VertexElement::getTypeCount( type );
+        if( v1::VertexElement::getBaseType( type ) == VET_HALF2 )
+        {
+            uint16 *dst16 = reinterpret_cast<uint16 *>( dst );
+            for( size_t i = 0u; i < numComponents; ++i )
+                dst16[i] = Bitwise::floatToHalf( values[i] );
+        }
+        else
+        {
+            memcpy( dst, values, numComponents * sizeof( float ) );
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    static bool isFloatType( VertexElementType type, size_t minComponents )
+    {
+        return ( v1::VertexElement::getBaseType( type ) == VET_FLOAT1 ||
+                 v1::VertexElement::getBaseType( type ) == VET_HALF2 ) &&
+               v1::VertexElement::getTypeCount( type ) >= minComponents;
+    }
+    //-----------------------------------------------------------------------------------
+    /// Transforms a QTangent (see SubMesh::_arrangeEfficient) in place
+    static void transformQTangent( int16 *qTangent16, const StaticGeometryTransform &transform )
+    {
+        Quaternion qTangent( Bitwise::snorm16ToFloat( qTangent16[3] ),
+                             Bitwise::snorm16ToFloat( qTangent16[0] ),
+                             Bitwise::snorm16ToFloat( qTangent16[1] ),
+                             Bitwise::snorm16ToFloat( qTangent16[2] ) );
+        bool reflected = qTangent.w < 0;
+        if( reflected )
+            qTangent = -qTangent;
+
+        Matrix3 tbn;
+        qTangent.ToRotationMatrix( tbn );
+        Vector3 vNormal = tbn.GetColumn( 0 );
+        Vector3 vTangent = tbn.GetColumn( 1 );
+        const Vector3 naturalBinormal = vTangent.crossProduct( vNormal );
+        const Vector3 vBinormal = reflected ? -naturalBinormal : naturalBinormal;
+
+        vNormal = transform.normalMatrix * vNormal;
+        vNormal.normalise();
+        vTangent = transform.m3x3 * vTangent;
+        // Keep it orthogonal in case of non-uniform scaling
+        vTangent -= vNormal * vNormal.dotProduct( vTangent );
+        vTangent.normalise();
+        reflected = vTangent.crossProduct( vNormal ).dotProduct( transform.m3x3 * vBinormal ) <= 0;
+
+        tbn.SetColumn( 0, vNormal );
+        tbn.SetColumn( 1, vTangent );
+        tbn.SetColumn( 2, vNormal.crossProduct( vTangent ) );
+
+        qTangent.FromRotationMatrix( tbn );
+        qTangent.normalise();
+
+        const Real bias = 1.0f / 32767.0f;
+        if( qTangent.w < 0 )
+            qTangent = -qTangent;
+        if( qTangent.w < bias )
+        {
+            Real normFactor = Math::Sqrt( 1 - bias * bias );
+            qTangent.w = bias;
+            qTangent.x *= normFactor;
+            qTangent.y *= normFactor;
+            qTangent.z *= normFactor;
+        }
+        if( reflected )
+            qTangent = -qTangent;
+
+        qTangent16[0] = Bitwise::floatToSnorm16( qTangent.x );
+        qTangent16[1] = Bitwise::floatToSnorm16( qTangent.y );
+        qTangent16[2] = Bitwise::floatToSnorm16( qTangent.z );
+        qTangent16[3] = Bitwise::floatToSnorm16( qTangent.w );
+    }
+    //-----------------------------------------------------------------------------------
+    /// Transforms in place the positions, normals, tangents & binormals of the given vertices
+    static void transformVertices( uint8 *vertexData, size_t numVertices, size_t bytesPerVertex,
+                                   const VertexElement2Vec       &vertexElements,
+                                   const StaticGeometryTransform &transform, Vector3 &inOutMin,
+                                   Vector3 &inOutMax )
+    {
+        for( size_t i = 0u; i < numVertices; ++i )
+        {
+            uint8 *vertex = vertexData + i * bytesPerVertex;
+
+            VertexElement2Vec::const_iterator itor = vertexElements.begin();
+            VertexElement2Vec::const_iterator endt = vertexElements.end();
+
+            while( itor != endt )
+            {
+                float values[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+
+                switch( itor->mSemantic )
+                {
+                case VES_POSITION:
+                {
+                    readFloats( vertex, itor->mType, values );
+                    Vector3 pos = transform.xform * Vector3( values[0], values[1], values[2] );
+                    inOutMin.makeFloor( pos );
+                    inOutMax.makeCeil( pos );
+                    values[0] = pos.x;
+                    values[1] = pos.y;
+                    values[2] = pos.z;
+                    writeFloats( vertex, itor->mType, values );
+                    break;
+                }
+                case VES_NORMAL:
+                    if( itor->mType == VET_SHORT4_SNORM )
+                    {
+                        transformQTangent( reinterpret_cast<int16 *>( vertex ), transform );
+                    }
+                    else
+                    {
+                        readFloats( vertex, itor->mType, values );
+                        Vector3 normal =
+                            transform.normalMatrix * Vector3( values[0], values[1], values[2] );
+                        normal.normalise();
+                        values[0] = normal.x;
+                        values[1] = normal.y;
+                        values[2] = normal.z;
+                        writeFloats( vertex, itor->mType, values );
+                    }
+                    break;
+                case VES_TANGENT:
+                case VES_BINORMAL:
+                {
+                    readFloats( vertex, itor->mType, values );
+                    Vector3 dir = transform.m3x3 * Vector3( values[0], values[1], values[2] );
+                    dir.normalise();
+                    values[0] = dir.x;
+                    values[1] = dir.y;
+                    values[2] = dir.z;
+                    // The 4th component of tangents stores the handedness
+                    if( transform.mirrored )
+                        values[3] = -values[3];
+                    writeFloats( vertex, itor->mType, values );
+                    break;
+                }
+                default:
+                    break;
+                }
+
+                vertex += v1::VertexElement::getTypeSize( itor->mType );
+                ++itor;
+            }
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    static void appendIndices( const VertexArrayObject *vao, uint8 const *indexData, uint32 baseVertex,
+                               bool flipWinding, FastArray<uint32> &outIndices )
+    {
+        const size_t primStart = vao->getPrimitiveStart();
+        const size_t primCount = vao->getPrimitiveCount();
+        const size_t firstNewIdx = outIndices.size();
+
+        outIndices.resize( firstNewIdx + primCount );
+        uint32 *dstIndices = outIndices.begin() + firstNewIdx;
+
+        IndexBufferPacked *indexBuffer = vao->getIndexBuffer();
+        if( !indexBuffer )
+        {
+            for( size_t i = 0u; i < primCount; ++i )
+                dstIndices[i] = static_cast<uint32>( baseVertex + primStart + i );
+        }
+        else if( indexBuffer->getIndexType() == IndexBufferPacked::IT_16BIT )
+        {
+            uint16 const *srcIndices =
+                reinterpret_cast<uint16 const *>( indexData ) + primStart;
+            for( size_t i = 0u; i < primCount; ++i )
+                dstIndices[i] = baseVertex + srcIndices[i];
+        }
+        else
+        {
+            uint32 const *srcIndices =
+                reinterpret_cast<uint32 const *>( indexData ) + primStart;
+            for( size_t i = 0u; i < primCount; ++i )
+                dstIndices[i] = baseVertex + srcIndices[i];
+        }
+
+        if( flipWinding && vao->getOperationType() == OT_TRIANGLE_LIST )
+        {
+            for( size_t i = 0u; i + 2u < primCount; i += 3u )
+                std::swap( dstIndices[i + 1u], dstIndices[i + 2u] );
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    //-----------------------------------------------------------------------------------
+    //-----------------------------------------------------------------------------------
+    StaticGeometry::StaticGeometry( const String &name, SceneManager *sceneManager ) :
+        mName( name ),
+        mSceneManager( sceneManager ),
+        mRegionDimensions( 1000.0f, 1000.0f, 1000.0f ),
+        mNumDirtyRegions( 0u ),
+        mVisibilityFlags( MovableObject::getDefaultVisibilityFlags() ),
+        mQueryFlags( SceneManager::QUERY_STATICGEOMETRY_DEFAULT_MASK ),
+        mRenderQueueGroup( 10u ),
+        mCastShadows( true ),
+        mVisible( true ),
+        mRenderingDistance( 0 ),
+        mNextMeshId( 0u )
+    {
+    }
+    //-----------------------------------------------------------------------------------
+    StaticGeometry::~StaticGeometry() { removeAllSources(); }
+    //-----------------------------------------------------------------------------------
+    void StaticGeometry::validateMesh( const MeshPtr &mesh )
+    {
+        if( mesh->hasSkeleton() )
+        {
+            OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS,
+                         "Mesh '" + mesh->getName() + "' has a skeleton and can't be static",
+                         "StaticGeometry::validateMesh" );
+        }
+
+        const size_t numSubMeshes = mesh->getNumSubMeshes();
+        for( size_t i = 0u; i < numSubMeshes; ++i )
+        {
+            SubMesh *subMesh = mesh->getSubMesh( static_cast<unsigned>( i ) );
+
+            if( subMesh->getNumPoses() )
+            {
+                OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS,
+                             "Mesh '" + mesh->getName() + "' has poses and can't be static",
+                             "StaticGeometry::validateMesh" );
+            }
+
+            VertexArrayObjectArray::const_iterator itVao = subMesh->mVao[VpNormal].begin();
+            VertexArrayObjectArray::const_iterator enVao = subMesh->mVao[VpNormal].end();
+
+            while( itVao != enVao )
+            {
+                const VertexArrayObject *vao = *itVao;
+                const VertexArrayObject *lod0Vao = subMesh->mVao[VpNormal].front();
+
+                // Batches are keyed on the vertex format of LOD 0, and merged LOD N
+                // shares the vertex buffers of the batch. All LODs must match.
+                bool sameLayout = vao->getVertexBuffers().size() == lod0Vao->getVertexBuffers().size() &&
+                                  vao->getOperationType() == lod0Vao->getOperationType();
+                for( size_t j = 0u; j < vao->getVertexBuffers().size() && sameLayout; ++j )
+                {
+                    sameLayout = vao->getVertexBuffers()[j]->getVertexElements() ==
+                                 lod0Vao->getVertexBuffers()[j]->getVertexElements();
+                }
+
+                if( !sameLayout )
+                {
+                    OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS,
+                                 "Mesh '" + mesh->getName() + "' SubMesh #" +
+                                     StringConverter::toString( i ) +
+                                     " has LODs with different vertex formats, which can't be batched",
+                                 "StaticGeometry::validateMesh" );
+                }
+
+                const OperationType opType = vao->getOperationType();
+                if( opType != OT_TRIANGLE_LIST && opType != OT_LINE_LIST && opType != OT_POINT_LIST )
+                {
+                    OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS,
+                                 "Mesh '" + mesh->getName() + "' SubMesh #" +
+                                     StringConverter::toString( i ) +
+                                     " uses strips or fans, which can't be batched",
+                                 "StaticGeometry::validateMesh" );
+                }
+
+                const VertexBufferPackedVec &vertexBuffers = vao->getVertexBuffers();
+                VertexBufferPackedVec::const_iterator itBuffer = vertexBuffers.begin();
+                VertexBufferPackedVec::const_iterator enBuffer = vertexBuffers.end();
+
+                while( itBuffer != enBuffer )
+                {
+                    const VertexElement2Vec &vertexElements = ( *itBuffer )->getVertexElements();
+                    VertexElement2Vec::const_iterator itor = vertexElements.begin();
+                    VertexElement2Vec::const_iterator endt = vertexElements.end();
+
+                    while( itor != endt )
+                    {
+                        bool supported = true;
+                        if( itor->mSemantic == VES_POSITION || itor->mSemantic == VES_TANGENT ||
+                            itor->mSemantic == VES_BINORMAL )
+                        {
+                            supported = isFloatType( itor->mType, 3u );
+                        }
+                        else if( itor->mSemantic == VES_NORMAL )
+                        {
+                            supported =
+                                isFloatType( itor->mType, 3u ) || itor->mType == VET_SHORT4_SNORM;
+                        }
+
+                        if( !supported || itor->mInstancingStepRate != 0u )
+                        {
+                            OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS,
+                                         "Mesh '" + mesh->getName() + "' SubMesh #" +
+                                             StringConverter::toString( i ) +
+                                             " has a vertex format that can't be transformed",
+                                         "StaticGeometry::validateMesh" );
+                        }
+                        ++itor;
+                    }
+                    ++itBuffer;
+                }
+                ++itVao;
+            }
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    StaticGeometry::RegionKey StaticGeometry::getRegionKey( const Source &source ) const
+    {
+        Aabb aabb = source.mesh->getAabb();
+        Matrix4 xform;
+        xform.makeTransform( source.position, source.scale, source.orientation );
+        aabb.transformAffine( xform );
+
+        const Vector3 coords = aabb.mCenter / mRegionDimensions;
+
+        RegionKey retVal;
+        retVal.x = static_cast<int32>( Math::Floor( coords.x ) );
+        retVal.y = static_cast<int32>( Math::Floor( coords.y ) );
+        retVal.z = static_cast<int32>( Math::Floor( coords.z ) );
+        return retVal;
+    }
+    //-----------------------------------------------------------------------------------
+    Vector3 StaticGeometry::getRegionCenter( const RegionKey &regionKey ) const
+    {
+        return ( Vector3( Real( regionKey.x ), Real( regionKey.y ), Real( regionKey.z ) ) +
+                 Vector3( 0.5f ) ) *
+               mRegionDimensions;
+    }
+    //-----------------------------------------------------------------------------------
+    uint32 StaticGeometry::allocateSource()
+    {
+        uint32 sourceId;
+        if( !mFreeSources.empty() )
+        {
+            sourceId = mFreeSources.back();
+            mFreeSources.pop_back();
+        }
+        else
+        {
+            sourceId = static_cast<uint32>( mSources.size() );
+            mSources.push_back( Source() );
+        }
+
+        mSources[sourceId].inUse = true;
+        return sourceId;
+    }
+    //-----------------------------------------------------------------------------------
+    void StaticGeometry::markDirty( Region &region )
+    {
+        if( !region.dirty )
+        {
+            region.dirty = true;
+            ++mNumDirtyRegions;
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    void StaticGeometry::addToRegion( uint32 sourceId )
+    {
+        Source &source = mSources[sourceId];
+        source.regionKey = getRegionKey( source );
+
+        RegionMap::iterator itor = mRegions.find( source.regionKey );
+        if( itor == mRegions.end() )
+        {
+            Region region;
+            region.sceneNode = 0;
+            region.dirty = false;
+            itor = mRegions.insert( std::pair<const RegionKey, Region>( source.regionKey, region ) )
+                       .first;
+        }
+
+        itor->second.sources.push_back( sourceId );
+        markDirty( itor->second );
+    }
+    //-----------------------------------------------------------------------------------
+    void StaticGeometry::removeFromRegion( uint32 sourceId )
+    {
+        RegionMap::iterator itor = mRegions.find( mSources[sourceId].regionKey );
+        OGRE_ASSERT_LOW( itor != mRegions.end() );
+
+        Region &region = itor->second;
+        FastArray<uint32>::iterator itSource =
+            std::find( region.sources.begin(), region.sources.end(), sourceId );
+        OGRE_ASSERT_LOW( itSource != region.sources.end() );
+        efficientVectorRemove( region.sources, itSource );
+
+        markDirty( region );
+    }
+    //-----------------------------------------------------------------------------------
+    void StaticGeometry::setRegionDimensions( const Vector3 &dimensions )
+    {
+        OGRE_ASSERT_LOW( dimensions.x > 0 && dimensions.y > 0 && dimensions.z > 0 );
+
+        if( mRegionDimensions == dimensions )
+            return;
+
+        mRegionDimensions = dimensions;
+
+        // Every source may end up in a different region. Start from scratch
+        RegionMap::iterator itor = mRegions.begin();
+        RegionMap::iterator endt = mRegions.end();
+
+        while( itor != endt )
+        {
+            destroyRegionGeometry( itor->second );
+            ++itor;
+        }
+        mRegions.clear();
+        mNumDirtyRegions = 0u;
+
+        for( size_t i = 0u; i < mSources.size(); ++i )
+        {
+            if( mSources[i].inUse )
+                addToRegion( static_cast<uint32>( i ) );
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    uint32 StaticGeometry::addItem( Item *item )
+    {
+        Node *parentNode = item->getParentNode();
+        if( !parentNode )
+        {
+            OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS, "Item must be attached to a SceneNode",
+                         "StaticGeometry::addItem" );
+        }
+
+        validateMesh( item->getMesh() );
+
+        const uint32 sourceId = allocateSource();
+
+        Source &source = mSources[sourceId];
+        source.mesh = item->getMesh();
+        source.position = parentNode->_getDerivedPositionUpdated();
+        source.orientation = parentNode->_getDerivedOrientationUpdated();
+        source.scale = parentNode->_getDerivedScaleUpdated();
+
+        const size_t numSubItems = item->getNumSubItems();
+        source.datablocks.resize( numSubItems );
+        for( size_t i = 0u; i < numSubItems; ++i )
+            source.datablocks[i] = item->getSubItem( i )->getDatablock();
+
+        addToRegion( sourceId );
+
+        return sourceId;
+    }
+    //-----------------------------------------------------------------------------------
+    uint32 StaticGeometry::addMesh( const MeshPtr &mesh, const Vector3 &position,
+                                    const Quaternion &orientation, const Vector3 &scale )
+    {
+        validateMesh( mesh );
+
+        const uint32 sourceId = allocateSource();
+
+        Source &source = mSources[sourceId];
+        source.mesh = mesh;
+        source.position = position;
+        source.orientation = orientation;
+        source.scale = scale;
+
+        HlmsManager *hlmsManager = Root::getSingleton().getHlmsManager();
+
+        const size_t numSubMeshes = mesh->getNumSubMeshes();
+        source.datablocks.resize( numSubMeshes );
+        for( size_t i = 0u; i < numSubMeshes; ++i )
+        {
+            const String &materialName = mesh->getSubMesh( static_cast<unsigned>( i ) )->mMaterialName;
+            HlmsDatablock *datablock = hlmsManager->getDatablockNoDefault( materialName );
+            if( !datablock )
+                datablock = hlmsManager->getDefaultDatablock();
+            source.datablocks[i] = datablock;
+        }
+
+        addToRegion( sourceId );
+
+        return sourceId;
+    }
+    //-----------------------------------------------------------------------------------
+    void StaticGeometry::setSourceTransform( uint32 sourceId, const Vector3 &position,
+                                             const Quaternion &orientation, const Vector3 &scale )
+    {
+        OGRE_ASSERT_LOW( sourceId < mSources.size() && mSources[sourceId].inUse );
+
+        removeFromRegion( sourceId );
+
+        Source &source = mSources[sourceId];
+        source.position = position;
+        source.orientation = orientation;
+        source.scale = scale;
+
+        addToRegion( sourceId );
+    }
+    //-----------------------------------------------------------------------------------
+    void StaticGeometry::removeSource( uint32 sourceId )
+    {
+        OGRE_ASSERT_LOW( sourceId < mSources.size() && mSources[sourceId].inUse );
+
+        removeFromRegion( sourceId );
+
+        Source &source = mSources[sourceId];
+        source.mesh.reset();
+        source.datablocks.clear();
+        source.inUse = false;
+
+        if( sourceId + 1u == mSources.size() )
+            mSources.pop_back();
+        else
+            mFreeSources.push_back( sourceId );
+    }
+    //-----------------------------------------------------------------------------------
+    void StaticGeometry::removeAllSources()
+    {
+        RegionMap::iterator itor = mRegions.begin();
+        RegionMap::iterator endt = mRegions.end();
+
+        while( itor != endt )
+        {
+            destroyRegionGeometry( itor->second );
+            ++itor;
+        }
+
+        mRegions.clear();
+        mSources.clear();
+        mFreeSources.clear();
+        mNumDirtyRegions = 0u;
+    }
+    //-----------------------------------------------------------------------------------
+    void StaticGeometry::destroyRegionGeometry( Region &region )
+    {
+        FastArray<Item *>::const_iterator itItem = region.items.begin();
+        FastArray<Item *>::const_iterator enItem = region.items.end();
+
+        while( itItem != enItem )
+        {
+            Item *item = *itItem;
+            item->detachFromParent();
+            OGRE_DELETE item;
+            ++itItem;
+        }
+        region.items.clear();
+
+        vector<MeshPtr>::type::iterator itMesh = region.meshes.begin();
+        vector<MeshPtr>::type::iterator enMesh = region.meshes.end();
+
+        while( itMesh != enMesh )
+        {
+            MeshManager::getSingleton().remove( *itMesh );
+            ++itMesh;
+        }
+        region.meshes.clear();
+
+        if( region.sceneNode )
+        {
+            mSceneManager->destroySceneNode( region.sceneNode );
+            region.sceneNode = 0;
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    void StaticGeometry::buildRegion( const RegionKey &regionKey, Region &region,
+                                      CpuBufferCache &cpuCache )
+    {
+        destroyRegionGeometry( region );
+
+        const Vector3 regionCenter = getRegionCenter( regionKey );
+
+        StaticGeometryBatchMap batches;
+
+        {
+            FastArray<uint32>::const_iterator itor = region.sources.begin();
+            FastArray<uint32>::const_iterator endt = region.sources.end();
+
+            while( itor != endt )
+            {
+                const Source &source = mSources[*itor];
+
+                const size_t numSubMeshes = source.mesh->getNumSubMeshes();
+                for( size_t i = 0u; i < numSubMeshes; ++i )
+                {
+                    SubMesh *subMesh = source.mesh->getSubMesh( static_cast<unsigned>( i ) );
+                    if( subMesh->mVao[VpNormal].empty() )
+                        continue;
+
+                    const VertexArrayObject *vao = subMesh->mVao[VpNormal][0];
+
+                    StaticGeometryBatchKey key;
+                    key.lodStrategyName = &source.mesh->getLodStrategyName();
+                    key.lodValues = source.mesh->_getLodValueArray();
+                    key.datablock = source.datablocks[i];
+                    key.operationType = vao->getOperationType();
+
+                    const VertexBufferPackedVec &vertexBuffers = vao->getVertexBuffers();
+                    key.vertexElements.reserve( vertexBuffers.size() );
+                    for( size_t j = 0u; j < vertexBuffers.size(); ++j )
+                        key.vertexElements.push_back( vertexBuffers[j]->getVertexElements() );
+
+                    StaticGeometryBatchEntry entry;
+                    entry.sourceId = *itor;
+                    entry.subMesh = subMesh;
+                    batches[key].push_back( entry );
+                }
+
+                ++itor;
+            }
+        }
+
+        if( batches.empty() )
+            return;
+
+        VaoManager *vaoManager = mSceneManager->getDestinationRenderSystem()->getVaoManager();
+
+        region.sceneNode = mSceneManager->getRootSceneNode( SCENE_STATIC )
+                               ->createChildSceneNode( SCENE_STATIC, regionCenter );
+
+        MeshPtr mesh;
+        FastArray<HlmsDatablock *> datablocks;
+        Vector3 vMin( std::numeric_limits<Real>::max() );
+        Vector3 vMax( -std::numeric_limits<Real>::max() );
+
+        StaticGeometryBatchMap::const_iterator itBatch = batches.begin();
+        StaticGeometryBatchMap::const_iterator enBatch = batches.end();
+
+        while( itBatch != enBatch )
+        {
+            const StaticGeometryBatchKey &key = itBatch->first;
+            const StaticGeometryBatchEntryArray &entries = itBatch->second;
+
+            if( !mesh )
+            {
+                mesh = MeshManager::getSingleton().createManual(
+                    "StaticGeometry/" + mName + "/" + StringConverter::toString( mNextMeshId++ ),
+                    ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME );
+                mesh->setLodStrategyName( *key.lodStrategyName );
+                mesh->_setLodValues( *key.lodValues );
+                region.meshes.push_back( mesh );
+            }
+
+            // Merge the vertices & indices of all the entries
+            const size_t numStreams = key.vertexElements.size();
+            const size_t numLods = key.lodValues->size();
+
+            vector<FastArray<uint8> >::type streamData;
+            vector<FastArray<uint32> >::type lodIndices;
+            streamData.resize( numStreams );
+            lodIndices.resize( numLods );
+            uint32 numVertices = 0u;
+
+            StaticGeometryBatchEntryArray::const_iterator itEntry = entries.begin();
+            StaticGeometryBatchEntryArray::const_iterator enEntry = entries.end();
+
+            while( itEntry != enEntry )
+            {
+                const Source &source = mSources[itEntry->sourceId];
+
+                StaticGeometryTransform transform;
+                transform.xform.makeTransform( source.position - regionCenter, source.scale,
+                                               source.orientation );
+                transform.xform.extract3x3Matrix( transform.m3x3 );
+                transform.normalMatrix = transform.m3x3.Inverse().Transpose();
+                transform.mirrored = source.scale.x * source.scale.y * source.scale.z < 0;
+
+                // LODs may or may not share the vertex buffers. Only copy each one once
+                typedef map<VertexBufferPacked *, uint32>::type BaseVertexMap;
+                BaseVertexMap baseVertices;
+
+                const VertexArrayObjectArray &srcVaos = itEntry->subMesh->mVao[VpNormal];
+
+                for( size_t lodIdx = 0u; lodIdx < numLods; ++lodIdx )
+                {
+                    const VertexArrayObject *vao = srcVaos[std::min( lodIdx, srcVaos.size() - 1u )];
+                    const VertexBufferPackedVec &vertexBuffers = vao->getVertexBuffers();
+
+                    uint32 baseVertex;
+                    BaseVertexMap::const_iterator itBase = baseVertices.find( vertexBuffers[0] );
+                    if( itBase != baseVertices.end() )
+                    {
+                        baseVertex = itBase->second;
+                    }
+                    else
+                    {
+                        baseVertex = numVertices;
+                        const size_t numSrcVertices = vertexBuffers[0]->getNumElements();
+
+                        for( size_t i = 0u; i < numStreams; ++i )
+                        {
+                            const size_t bytesPerVertex = vertexBuffers[i]->getBytesPerElement();
+                            const size_t prevSize = streamData[i].size();
+                            streamData[i].resize( prevSize + numSrcVertices * bytesPerVertex );
+                            memcpy( streamData[i].begin() + prevSize, cpuCache.get( vertexBuffers[i] ),
+                                    numSrcVertices * bytesPerVertex );
+                            transformVertices( streamData[i].begin() + prevSize, numSrcVertices,
+                                               bytesPerVertex, key.vertexElements[i], transform,
+                                               vMin, vMax );
+                        }
+
+                        numVertices += static_cast<uint32>( numSrcVertices );
+                        baseVertices[vertexBuffers[0]] = baseVertex;
+                    }
+
+                    uint8 const *indexData =
+                        vao->getIndexBuffer() ? cpuCache.get( vao->getIndexBuffer() ) : 0;
+                    appendIndices( vao, indexData, baseVertex, transform.mirrored,
+                                   lodIndices[lodIdx] );
+                }
+
+                ++itEntry;
+            }
+
+            // Now create the GPU buffers
+            SubMesh *subMesh = mesh->createSubMesh();
+
+            VertexBufferPackedVec vertexBuffers;
+            for( size_t i = 0u; i < numStreams; ++i )
+            {
+                vertexBuffers.push_back( vaoManager->createVertexBuffer(
+                    key.vertexElements[i], numVertices, BT_IMMUTABLE, streamData[i].begin(), false ) );
+                streamData[i].destroy();
+            }
+
+            const bool use32bitIndices = numVertices > 0xFFFFu;
+
+            for( size_t lodIdx = 0u; lodIdx < numLods; ++lodIdx )
+            {
+                FastArray<uint32> &indices = lodIndices[lodIdx];
+                if( indices.empty() )
+                {
+                    // A degenerate primitive, since we can't create empty buffers
+                    indices.resize( key.operationType == OT_TRIANGLE_LIST
+                                        ? 3u
+                                        : ( key.operationType == OT_LINE_LIST ? 2u : 1u ),
+                                    0u );
+                }
+
+                IndexBufferPacked *indexBuffer;
+                if( use32bitIndices )
+                {
+                    indexBuffer =
+                        vaoManager->createIndexBuffer( IndexBufferPacked::IT_32BIT, indices.size(),
+                                                       BT_IMMUTABLE, indices.begin(), false );
+                }
+                else
+                {
+                    FastArray<uint16> indices16;
+                    indices16.resize( indices.size() );
+                    for( size_t i = 0u; i < indices.size(); ++i )
+                        indices16[i] = static_cast<uint16>( indices[i] );
+                    indexBuffer =
+                        vaoManager->createIndexBuffer( IndexBufferPacked::IT_16BIT, indices16.size(),
+                                                       BT_IMMUTABLE, indices16.begin(), false );
+                }
+                indices.destroy();
+
+                VertexArrayObject *vao =
+                    vaoManager->createVertexArrayObject( vertexBuffers, indexBuffer, key.operationType );
+                subMesh->mVao[VpNormal].push_back( vao );
+            }
+
+            datablocks.push_back( key.datablock );
+
+            // Finish the Mesh if the next batch needs a different LOD schedule
+            ++itBatch;
+            if( itBatch == enBatch || key.compareLodSchedule( itBatch->first ) != 0 )
+            {
+                const Aabb aabb = Aabb::newFromExtents( vMin, vMax );
+                mesh->_setBounds( aabb, false );
+                mesh->_setBoundingSphereRadius( aabb.getRadiusOrigin() );
+                // Our buffers are BT_IMMUTABLE. Optimizing for shadow mapping would read them back
+                mesh->prepareForShadowMapping( true );
+
+                // Not created via SceneManager::createItem, so that destroyAllItems & co.
+                // can't destroy them behind our back. We own them.
+                Item *item = OGRE_NEW Item( Id::generateNewId<MovableObject>(),
+                                            &mSceneManager->_getEntityMemoryManager( SCENE_STATIC ),
+                                            mSceneManager, mesh, false );
+                for( size_t i = 0u; i < datablocks.size(); ++i )
+                    item->getSubItem( i )->setDatablock( datablocks[i] );
+                region.sceneNode->attachObject( item );
+                region.items.push_back( item );
+
+                mesh.reset();
+                datablocks.clear();
+                vMin = Vector3( std::numeric_limits<Real>::max() );
+                vMax = Vector3( -std::numeric_limits<Real>::max() );
+            }
+        }
+
+        applySettings( region );
+    }
+    //-----------------------------------------------------------------------------------
+    void StaticGeometry::build()
+    {
+        if( !mNumDirtyRegions )
+            return;
+
+        OgreProfileExhaustive( "StaticGeometry::build" );
+
+        CpuBufferCache cpuCache;
+
+        size_t numRebuilt = 0u;
+
+        RegionMap::iterator itor = mRegions.begin();
+        RegionMap::iterator endt = mRegions.end();
+
+        while( itor != endt )
+        {
+            Region &region = itor->second;
+            if( region.dirty )
+            {
+                region.dirty = false;
+
+                if( region.sources.empty() )
+                {
+                    destroyRegionGeometry( region );
+                    mRegions.erase( itor++ );
+                }
+                else
+                {
+                    buildRegion( itor->first, region, cpuCache );
+                    ++numRebuilt;
+                    ++itor;
+                }
+            }
+            else
+            {
+                ++itor;
+            }
+        }
+
+        mNumDirtyRegions = 0u;
+
+        LogManager::getSingleton().logMessage(
+            "StaticGeometry '" + mName + "': rebuilt " + StringConverter::toString( numRebuilt ) +
+                " regions out of " + StringConverter::toString( mRegions.size() ),
+            LML_TRIVIAL );
+    }
+    //-----------------------------------------------------------------------------------
+    void StaticGeometry::applySettings( Region &region )
+    {
+        FastArray<Item *>::const_iterator itor = region.items.begin();
+        FastArray<Item *>::const_iterator endt = region.items.end();
+
+        while( itor != endt )
+        {
+            Item *item = *itor;
+            item->setVisibilityFlags( mVisibilityFlags );
+            item->setQueryFlags( mQueryFlags );
+            item->setRenderQueueGroup( mRenderQueueGroup );
+            item->setCastShadows( mCastShadows );
+            item->setVisible( mVisible );
+            item->setRenderingDistance( mRenderingDistance );
+            ++itor;
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    void StaticGeometry::setVisibilityFlags( uint32 flags )
+    {
+        mVisibilityFlags = flags;
+        for( RegionMap::iterator itor = mRegions.begin(); itor != mRegions.end(); ++itor )
+            applySettings( itor->second );
+    }
+    //-----------------------------------------------------------------------------------
+    void StaticGeometry::setQueryFlags( uint32 flags )
+    {
+        mQueryFlags = flags;
+        for( RegionMap::iterator itor = mRegions.begin(); itor != mRegions.end(); ++itor )
+            applySettings( itor->second );
+    }
+    //-----------------------------------------------------------------------------------
+    void StaticGeometry::setRenderQueueGroup( uint8 queueId )
+    {
+        mRenderQueueGroup = queueId;
+        for( RegionMap::iterator itor = mRegions.begin(); itor != mRegions.end(); ++itor )
+            applySettings( itor->second );
+    }
+    //-----------------------------------------------------------------------------------
+    void StaticGeometry::setCastShadows( bool castShadows )
+    {
+        mCastShadows = castShadows;
+        for( RegionMap::iterator itor = mRegions.begin(); itor != mRegions.end(); ++itor )
+            applySettings( itor->second );
+    }
+    //-----------------------------------------------------------------------------------
+    void StaticGeometry::setVisible( bool visible )
+    {
+        mVisible = visible;
+        for( RegionMap::iterator itor = mRegions.begin(); itor != mRegions.end(); ++itor )
+            applySettings( itor->second );
+    }
+    //-----------------------------------------------------------------------------------
+    void StaticGeometry::setRenderingDistance( Real dist )
+    {
+        mRenderingDistance = dist;
+        for( RegionMap::iterator itor = mRegions.begin(); itor != mRegions.end(); ++itor )
+            applySettings( itor->second );
+    }
+}  // namespace Ogre
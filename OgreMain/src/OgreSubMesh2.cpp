@@ -303,6 +303,9 @@ namespace Ogre
                 mParent->mVaoManager->createVertexArrayObject( vertexBuffers, indexBuffer, opType );
             mVao[VpNormal].push_back( vao );
 
+            // Skinned meshes can't be culled per cluster
+            clearClusters();
+
             const bool oldValue = Mesh::msOptimizeForShadowMapping;
             Mesh::msOptimizeForShadowMapping = hadIndependentVaos;
             _prepareForShadowMapping( false );
@@ -497,6 +500,9 @@ namespace Ogre
         if( numVaoPasses == 1 )
             newSub->mVao[VpShadow] = newSub->mVao[VpNormal];
 
+        newSub->mClusters = mClusters;
+        newSub->_updateVaoClusters();
+
         return 0;
     }
     //---------------------------------------------------------------------
@@ -832,6 +838,9 @@ namespace Ogre
         // If we shared vaos, we need to share the new Vaos (and remove the dangling pointers)
         if( numVaoPasses == 1 )
             mVao[VpShadow] = mVao[VpNormal];
+
+        // The index order is preserved, thus the clusters are still valid
+        _updateVaoClusters();
     }
     //---------------------------------------------------------------------
     VertexArrayObject *SubMesh::arrangeEfficient( bool halfPos, bool halfTexCoords, bool qTangents,
@@ -1330,6 +1339,9 @@ namespace Ogre
         // If we shared vaos, we need to share the new Vaos (and remove the dangling pointers)
         if( numVaoPasses == 1 )
             mVao[VpShadow] = mVao[VpNormal];
+
+        // The index order is preserved, thus the clusters are still valid
+        _updateVaoClusters();
     }
     //---------------------------------------------------------------------
     VertexArrayObject *SubMesh::dearrangeEfficient( const VertexArrayObject *vao,
@@ -1557,4 +1569,297 @@ namespace Ogre
             VertexShadowMapHelper::useSameVaos( mParent->mVaoManager, mVao[VpNormal], mVao[VpShadow] );
         }
     }
+    //---------------------------------------------------------------------
+    void SubMesh::_updateVaoClusters()
+    {
+        const size_t numLods = mVao[VpNormal].size();
+        for( size_t i = 0; i < numLods; ++i )
+        {
+            const MeshClusterVec *clusters = 0;
+            if( i < mClusters.size() && !mClusters[i].empty() )
+                clusters = &mClusters[i];
+            mVao[VpNormal][i]->_setClusters( clusters );
+        }
+    }
+    //---------------------------------------------------------------------
+    /// Calculates the bounding sphere & normal cone of the cluster.
+    /// 'indices' must point to the first index of the cluster.
+    static void calculateClusterBounds( MeshCluster &cluster, uint32 const *indices,
+                                        const Vector3 *positions )
+    {
+        const uint32 numTriangles = cluster.indexCount / 3u;
+
+        Vector3 vMin( Vector3( std::numeric_limits<Real>::max() ) );
+        Vector3 vMax( Vector3( -std::numeric_limits<Real>::max() ) );
+        Vector3 normalSum( Vector3::ZERO );
+
+        for( uint32 i = 0; i < numTriangles; ++i )
+        {
+            const Vector3 &p0 = positions[indices[i * 3u + 0u]];
+            const Vector3 &p1 = positions[indices[i * 3u + 1u]];
+            const Vector3 &p2 = positions[indices[i * 3u + 2u]];
+
+            vMin.makeFloor( p0 );
+            vMin.makeFloor( p1 );
+            vMin.makeFloor( p2 );
+            vMax.makeCeil( p0 );
+            vMax.makeCeil( p1 );
+            vMax.makeCeil( p2 );
+
+            Vector3 normal = ( p1 - p0 ).crossProduct( p2 - p0 );
+            const Real length = normal.length();
+            if( length > Real( 1e-20 ) )
+                normalSum += normal / length;
+        }
+
+        cluster.center = ( vMin + vMax ) * 0.5f;
+        Real radiusSq = 0;
+        for( uint32 i = 0; i < numTriangles * 3u; ++i )
+            radiusSq = std::max( radiusSq, cluster.center.squaredDistance( positions[indices[i]] ) );
+        cluster.radius = Math::Sqrt( radiusSq );
+
+        // Degenerate cone by default (never culls)
+        cluster.coneApex = cluster.center;
+        cluster.coneAxis = Vector3::ZERO;
+        cluster.coneCutoff = 1.0f;
+
+        const Real axisLength = normalSum.length();
+        if( axisLength <= Real( 1e-6 ) )
+            return;
+
+        const Vector3 axis = normalSum / axisLength;
+
+        // The cone must contain all normals. Find the widest angle.
+        Real minDot = 1.0f;
+        for( uint32 i = 0; i < numTriangles; ++i )
+        {
+            const Vector3 &p0 = positions[indices[i * 3u + 0u]];
+            const Vector3 &p1 = positions[indices[i * 3u + 1u]];
+            const Vector3 &p2 = positions[indices[i * 3u + 2u]];
+
+            Vector3 normal = ( p1 - p0 ).crossProduct( p2 - p0 );
+            const Real length = normal.length();
+            if( length > Real( 1e-20 ) )
+                minDot = std::min( minDot, axis.dotProduct( normal / length ) );
+        }
+
+        // The normals are spread too much (i.e. more than ~84°). Culling would almost never
+        // succeed and the apex would be very far away. Keep the degenerate cone.
+        if( minDot <= 0.1f )
+            return;
+
+        // Move the apex back along the axis so that every triangle's plane is in front of it;
+        // this makes the test valid for a camera anywhere in space (not just far away).
+        Real maxT = 0;
+        for( uint32 i = 0; i < numTriangles; ++i )
+        {
+            const Vector3 &p0 = positions[indices[i * 3u + 0u]];
+            const Vector3 &p1 = positions[indices[i * 3u + 1u]];
+            const Vector3 &p2 = positions[indices[i * 3u + 2u]];
+
+            Vector3 normal = ( p1 - p0 ).crossProduct( p2 - p0 );
+            const Real length = normal.length();
+            if( length > Real( 1e-20 ) )
+            {
+                normal /= length;
+                // minDot > 0.1 guarantees the denominator is not near 0
+                const Real t = ( cluster.center - p0 ).dotProduct( normal ) / axis.dotProduct( normal );
+                maxT = std::max( maxT, t );
+            }
+        }
+
+        cluster.coneApex = cluster.center - axis * maxT;
+        cluster.coneAxis = axis;
+        cluster.coneCutoff = Math::Sqrt( 1.0f - minDot * minDot );
+    }
+    //---------------------------------------------------------------------
+    void SubMesh::buildClusters( uint32 maxTriangles, uint32 maxVertices )
+    {
+        OGRE_ASSERT_LOW( maxTriangles > 0u && maxVertices >= 3u );
+
+        clearClusters();
+
+        if( !mBlendIndexToBoneIndexMap.empty() || mNumPoses > 0u )
+        {
+            LogManager::getSingleton().logMessage(
+                "SubMesh::buildClusters: SubMesh from '" + mParent->getName() +
+                "' is animated. Clusters won't be built for it." );
+            return;
+        }
+
+        const size_t numLods = mVao[VpNormal].size();
+        mClusters.resize( numLods );
+
+        bool anyClusterBuilt = false;
+
+        for( size_t lodIdx = 0; lodIdx < numLods; ++lodIdx )
+        {
+            VertexArrayObject *vao = mVao[VpNormal][lodIdx];
+            IndexBufferPacked *indexBuffer = vao->getIndexBuffer();
+
+            if( !indexBuffer || vao->getOperationType() != OT_TRIANGLE_LIST ||
+                vao->getPrimitiveCount() < 3u )
+            {
+                continue;
+            }
+
+            const uint32 primStart = vao->getPrimitiveStart();
+            const uint32 primCount = vao->getPrimitiveCount() - vao->getPrimitiveCount() % 3u;
+
+            // Read the indices, converted to 32-bit
+            vector<uint32>::type indices;
+            indices.resize( primCount );
+            {
+                AsyncTicketPtr asyncTicket;
+                void const *indexData = indexBuffer->getShadowCopy();
+                if( indexData )
+                {
+                    indexData = reinterpret_cast<const uint8 *>( indexData ) +
+                                primStart * indexBuffer->getBytesPerElement();
+                }
+                else
+                {
+                    asyncTicket = indexBuffer->readRequest( primStart, primCount );
+                    indexData = asyncTicket->map();
+                }
+
+                if( indexBuffer->getIndexType() == IndexBufferPacked::IT_16BIT )
+                {
+                    const uint16 *indices16 = reinterpret_cast<const uint16 *>( indexData );
+                    for( size_t i = 0; i < primCount; ++i )
+                        indices[i] = indices16[i];
+                }
+                else
+                {
+                    memcpy( &indices[0], indexData, primCount * sizeof( uint32 ) );
+                }
+
+                if( asyncTicket )
+                    asyncTicket->unmap();
+            }
+
+            // Read the positions
+            const size_t numVertices = vao->getBaseVertexBuffer()->getNumElements();
+            vector<Vector3>::type positions;
+            positions.resize( numVertices );
+            {
+                VertexArrayObject::ReadRequestsVec readRequests;
+                readRequests.push_back( VertexArrayObject::ReadRequests( VES_POSITION ) );
+                vao->readRequests( readRequests, 0, 0, true );
+                vao->mapAsyncTickets( readRequests );
+
+                const size_t bytesPerVertex = readRequests[0].vertexBuffer->getBytesPerElement();
+                for( size_t i = 0; i < numVertices; ++i )
+                {
+                    char const *data = readRequests[0].data + i * bytesPerVertex;
+                    if( readRequests[0].type == VET_HALF4 )
+                    {
+                        const uint16 *pos16 = reinterpret_cast<const uint16 *>( data );
+                        positions[i] = Vector3( Bitwise::halfToFloat( pos16[0] ),
+                                                Bitwise::halfToFloat( pos16[1] ),
+                                                Bitwise::halfToFloat( pos16[2] ) );
+                    }
+                    else
+                    {
+                        const float *pos = reinterpret_cast<const float *>( data );
+                        positions[i] = Vector3( pos[0], pos[1], pos[2] );
+                    }
+                }
+
+                vao->unmapAsyncTickets( readRequests );
+            }
+
+            // Validate the indices before trusting them
+            for( size_t i = 0; i < primCount; ++i )
+            {
+                if( indices[i] >= numVertices )
+                {
+                    OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS,
+                                 "Index out of bounds in SubMesh from '" + mParent->getName() + "'",
+                                 "SubMesh::buildClusters" );
+                }
+            }
+
+            // Greedily split the triangles into clusters, in their current order.
+            // vertexClusterIdx[v] tells the last cluster vertex v was added to.
+            vector<uint32>::type vertexClusterIdx;
+            vertexClusterIdx.resize( numVertices, std::numeric_limits<uint32>::max() );
+
+            MeshClusterVec &clusters = mClusters[lodIdx];
+            clusters.reserve( primCount / ( maxTriangles * 3u ) + 1u );
+
+            MeshCluster cluster;
+            cluster.indexStart = primStart;
+            cluster.indexCount = 0u;
+            uint32 numClusterVertices = 0u;
+
+            for( uint32 i = 0; i < primCount; i += 3u )
+            {
+                const uint32 clusterIdx = static_cast<uint32>( clusters.size() );
+
+                uint32 numNewVertices = 0u;
+                for( uint32 j = 0; j < 3u; ++j )
+                {
+                    if( vertexClusterIdx[indices[i + j]] != clusterIdx )
+                        ++numNewVertices;
+                }
+                // Shared vertices within the same triangle are counted twice. That's fine,
+                // it only makes the limit a bit more conservative.
+
+                if( cluster.indexCount > 0u &&
+                    ( cluster.indexCount / 3u >= maxTriangles ||
+                      numClusterVertices + numNewVertices > maxVertices ) )
+                {
+                    calculateClusterBounds( cluster, &indices[cluster.indexStart - primStart],
+                                            &positions[0] );
+                    clusters.push_back( cluster );
+
+                    cluster.indexStart = primStart + i;
+                    cluster.indexCount = 0u;
+                    numClusterVertices = 0u;
+                }
+
+                const uint32 currClusterIdx = static_cast<uint32>( clusters.size() );
+                for( uint32 j = 0; j < 3u; ++j )
+                {
+                    if( vertexClusterIdx[indices[i + j]] != currClusterIdx )
+                    {
+                        vertexClusterIdx[indices[i + j]] = currClusterIdx;
+                        ++numClusterVertices;
+                    }
+                }
+
+                cluster.indexCount += 3u;
+            }
+
+            if( cluster.indexCount > 0u )
+            {
+                calculateClusterBounds( cluster, &indices[cluster.indexStart - primStart],
+                                        &positions[0] );
+                clusters.push_back( cluster );
+            }
+
+            anyClusterBuilt = true;
+        }
+
+        if( !anyClusterBuilt )
+            mClusters.clear();
+
+        _updateVaoClusters();
+    }
+    //---------------------------------------------------------------------
+    void SubMesh::clearClusters()
+    {
+        mClusters.clear();
+        _updateVaoClusters();
+    }
+    //---------------------------------------------------------------------
+    void SubMesh::_setClusters( size_t lodLevel, const MeshClusterVec &clusters )
+    {
+        if( lodLevel >= mClusters.size() )
+            mClusters.resize( lodLevel + 1u );
+        mClusters[lodLevel] = clusters;
+        // Resizing may have moved the other entries; update all the pointers
+        _updateVaoClusters();
+    }
 }  // namespace Ogre
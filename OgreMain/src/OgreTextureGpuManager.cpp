@@ -2729,6 +2729,7 @@ namespace Ogre
 
             if( bWorkGrabbed )
             {
+                OgreProfile( "TextureGpuManager::_updateTextureMultiLoadWorkerThread" );
                 OGRE_ASSERT_LOW( !loadRequest.image );
 
                 if( ogre_unlikely( !loadRequest.archive && !loadRequest.loadingListener ) )
@@ -2813,6 +2814,7 @@ namespace Ogre
         while( !mShuttingDown )
         {
             mWorkerWaitableEvent.wait();
+            OgreProfile( "TextureGpuManager::_updateStreamingWorkerThread" );
             _updateStreaming();
         }
 
@@ -0,0 +1,589 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2023 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreStableHeaders.h"
+
+#include "ParticleSystem/OgreBillboardChain2.h"
+
+#include "Math/Array/OgreArrayQuaternion.h"
+#include "Math/Array/OgreArrayVector3.h"
+#include "Math/Array/OgreArrayVector4.h"
+#include "Math/Array/OgreObjectData.h"
+#include "OgreHlms.h"
+#include "OgreHlmsManager.h"
+#include "OgreRoot.h"
+#include "OgreSceneManager.h"
+#include "Vao/OgreIndexBufferPacked.h"
+#include "Vao/OgreVaoManager.h"
+#include "Vao/OgreVertexArrayObject.h"
+
+using namespace Ogre;
+
+namespace
+{
+    /// Must match the vertex declaration in BillboardChain::createBuffers
+    struct ChainVertex
+    {
+        float position[3];
+        uint8 colour[4];
+        float uv[2];
+    };
+
+    template <typename T>
+    void fillChainIndices( T *RESTRICT_ALIAS indices, const size_t numChains, const size_t maxElements )
+    {
+        for( size_t chainIdx = 0u; chainIdx < numChains; ++chainIdx )
+        {
+            const size_t chainStart = chainIdx * maxElements * 2u;
+            for( size_t i = 0u; i < maxElements - 1u; ++i )
+            {
+                const T baseIdx = static_cast<T>( chainStart + i * 2u );
+                const T nextBaseIdx = static_cast<T>( baseIdx + 2u );
+
+                *indices++ = baseIdx;
+                *indices++ = static_cast<T>( baseIdx + 1u );
+                *indices++ = nextBaseIdx;
+                *indices++ = static_cast<T>( baseIdx + 1u );
+                *indices++ = static_cast<T>( nextBaseIdx + 1u );
+                *indices++ = nextBaseIdx;
+            }
+        }
+    }
+}  // namespace
+
+const String BillboardChain::MOVABLE_TYPE_NAME = "BillboardChain2";
+
+BillboardChain::Element::Element() : width( 0 ), texCoord( 0 ) {}
+//-----------------------------------------------------------------------------
+BillboardChain::Element::Element( const Vector3 &_position, Real _width, Real _texCoord,
+                                  const ColourValue &_colour, const Quaternion &_orientation ) :
+    position( _position ),
+    width( _width ),
+    texCoord( _texCoord ),
+    colour( _colour ),
+    orientation( _orientation )
+{
+}
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+BillboardChain::BillboardChain( IdType id, ObjectMemoryManager *objectMemoryManager,
+                                SceneManager *manager, ParticleSystemManager2 *particleSystemManager,
+                                uint32 maxElements, uint32 numberOfChains ) :
+    MovableObject( id, objectMemoryManager, manager, 10u ),
+    Renderable(),
+    mMaxElementsPerChain( std::max( maxElements, 2u ) ),
+    mNumSlotsPerChain( 0u ),
+    mPositions( 0 ),
+    mTangents( 0 ),
+    mOrientations( 0 ),
+    mWidths( 0 ),
+    mColours( 0 ),
+    mTexCoords( 0 ),
+    mTexCoordDir( TCD_U ),
+    mFaceCamera( true ),
+    mNormalBase( Vector3::UNIT_X ),
+    mVertexBuffer( 0 ),
+    mMappedVertices( 0 ),
+    mChainsAabb( Aabb::BOX_NULL ),
+    mParticleSystemManager( particleSystemManager ),
+    mGlobalIndex( std::numeric_limits<size_t>::max() )
+{
+    OGRE_ASSERT_LOW( numberOfChains > 0u );
+
+    mOtherTexCoordRange[0] = 0.0f;
+    mOtherTexCoordRange[1] = 1.0f;
+
+    mNumSlotsPerChain = alignToNextMultiple<uint32>( mMaxElementsPerChain, ARRAY_PACKED_REALS );
+
+    ChainSegment emptySegment;
+    emptySegment.head = 0u;
+    emptySegment.numElements = 0u;
+    mChainSegments.resize( numberOfChains, emptySegment );
+
+    const size_t numSlots = mNumSlotsPerChain * numberOfChains;
+    const size_t numPacks = numSlots / ARRAY_PACKED_REALS;
+
+    mPositions = reinterpret_cast<ArrayVector3 *>(
+        OGRE_MALLOC_SIMD( numSlots * sizeof( Vector3 ), MEMCATEGORY_GEOMETRY ) );
+    mTangents = reinterpret_cast<ArrayVector3 *>(
+        OGRE_MALLOC_SIMD( numSlots * sizeof( Vector3 ), MEMCATEGORY_GEOMETRY ) );
+    mOrientations = reinterpret_cast<ArrayQuaternion *>(
+        OGRE_MALLOC_SIMD( numSlots * sizeof( Quaternion ), MEMCATEGORY_GEOMETRY ) );
+    mWidths = reinterpret_cast<ArrayReal *>(
+        OGRE_MALLOC_SIMD( numSlots * sizeof( Real ), MEMCATEGORY_GEOMETRY ) );
+    mColours = reinterpret_cast<ArrayVector4 *>(
+        OGRE_MALLOC_SIMD( numSlots * sizeof( Vector4 ), MEMCATEGORY_GEOMETRY ) );
+    mTexCoords =
+        reinterpret_cast<Real *>( OGRE_MALLOC_SIMD( numSlots * sizeof( Real ), MEMCATEGORY_GEOMETRY ) );
+
+    for( size_t i = 0u; i < numPacks; ++i )
+    {
+        mPositions[i] = ArrayVector3::ZERO;
+        mTangents[i] = ArrayVector3::ZERO;
+        mOrientations[i] = ArrayQuaternion::IDENTITY;
+        mWidths[i] = ARRAY_REAL_ZERO;
+        mColours[i] = ArrayVector4::ZERO;
+    }
+    memset( mTexCoords, 0, numSlots * sizeof( Real ) );
+
+    createBuffers();
+
+    Hlms *hlms = Root::getSingleton().getHlmsManager()->getHlms( HLMS_UNLIT );
+    setDatablock( hlms->getDefaultDatablock() );
+
+    setCastShadows( false );
+
+    mRenderables.push_back( this );
+}
+//-----------------------------------------------------------------------------
+BillboardChain::~BillboardChain()
+{
+    destroyBuffers();
+
+    OGRE_FREE_SIMD( mTexCoords, MEMCATEGORY_GEOMETRY );
+    OGRE_FREE_SIMD( mColours, MEMCATEGORY_GEOMETRY );
+    OGRE_FREE_SIMD( mWidths, MEMCATEGORY_GEOMETRY );
+    OGRE_FREE_SIMD( mOrientations, MEMCATEGORY_GEOMETRY );
+    OGRE_FREE_SIMD( mTangents, MEMCATEGORY_GEOMETRY );
+    OGRE_FREE_SIMD( mPositions, MEMCATEGORY_GEOMETRY );
+
+    mTexCoords = 0;
+    mColours = 0;
+    mWidths = 0;
+    mOrientations = 0;
+    mTangents = 0;
+    mPositions = 0;
+}
+//-----------------------------------------------------------------------------
+void BillboardChain::createBuffers()
+{
+    VaoManager *vaoManager = mManager->getDestinationRenderSystem()->getVaoManager();
+
+    VertexElement2Vec vertexElements;
+    vertexElements.push_back( VertexElement2( VET_FLOAT3, VES_POSITION ) );
+    vertexElements.push_back( VertexElement2( VET_UBYTE4_NORM, VES_DIFFUSE ) );
+    vertexElements.push_back( VertexElement2( VET_FLOAT2, VES_TEXTURE_COORDINATES ) );
+
+    OGRE_ASSERT_LOW( VaoManager::calculateVertexSize( vertexElements ) == sizeof( ChainVertex ) );
+
+    const size_t numChains = mChainSegments.size();
+    const size_t numVertices = numChains * mMaxElementsPerChain * 2u;
+    const size_t numIndices = numChains * ( mMaxElementsPerChain - 1u ) * 6u;
+
+    // The contents are written every frame by _updateParallel
+    mVertexBuffer =
+        vaoManager->createVertexBuffer( vertexElements, numVertices, BT_DYNAMIC_PERSISTENT, 0, false );
+
+    // The topology never changes. Chains with less elements than the max
+    // generate degenerate triangles for the unused ones.
+    const bool bUse32BitIndices = numVertices > 0xFFFF;
+    const size_t bytesPerIndex = bUse32BitIndices ? sizeof( uint32 ) : sizeof( uint16 );
+
+    void *indexData = OGRE_MALLOC_SIMD( numIndices * bytesPerIndex, MEMCATEGORY_GEOMETRY );
+    FreeOnDestructor indexDataPtr( indexData );
+
+    if( bUse32BitIndices )
+        fillChainIndices( reinterpret_cast<uint32 *>( indexData ), numChains, mMaxElementsPerChain );
+    else
+        fillChainIndices( reinterpret_cast<uint16 *>( indexData ), numChains, mMaxElementsPerChain );
+
+    IndexBufferPacked *indexBuffer = vaoManager->createIndexBuffer(
+        bUse32BitIndices ? IndexBufferPacked::IT_32BIT : IndexBufferPacked::IT_16BIT, numIndices,
+        BT_IMMUTABLE, indexData, false );
+
+    VertexBufferPackedVec vertexBuffers;
+    vertexBuffers.push_back( mVertexBuffer );
+    VertexArrayObject *vao =
+        vaoManager->createVertexArrayObject( vertexBuffers, indexBuffer, OT_TRIANGLE_LIST );
+
+    mVaoPerLod[VpNormal].push_back( vao );
+    mVaoPerLod[VpShadow].push_back( vao );
+}
+//-----------------------------------------------------------------------------
+void BillboardChain::destroyBuffers()
+{
+    if( mVaoPerLod[VpNormal].empty() )
+        return;
+
+    VaoManager *vaoManager = mManager->getDestinationRenderSystem()->getVaoManager();
+
+    VertexArrayObject *vao = mVaoPerLod[VpNormal].back();
+
+    if( mVertexBuffer->getMappingState() != MS_UNMAPPED )
+        mVertexBuffer->unmap( UO_UNMAP_ALL );
+    mMappedVertices = 0;
+
+    vaoManager->destroyVertexBuffer( mVertexBuffer );
+    mVertexBuffer = 0;
+    vaoManager->destroyIndexBuffer( vao->getIndexBuffer() );
+    vaoManager->destroyVertexArrayObject( vao );
+
+    mVaoPerLod[VpNormal].clear();
+    mVaoPerLod[VpShadow].clear();
+}
+//-----------------------------------------------------------------------------
+size_t BillboardChain::getGlobalSlot( size_t chainIndex, size_t elementIndex ) const
+{
+    const ChainSegment &seg = mChainSegments[chainIndex];
+    const size_t slot = ( seg.head + elementIndex ) % mMaxElementsPerChain;
+    return chainIndex * mNumSlotsPerChain + slot;
+}
+//-----------------------------------------------------------------------------
+void BillboardChain::setElement( size_t globalSlot, const Element &element )
+{
+    const size_t j = globalSlot / ARRAY_PACKED_REALS;
+    const size_t idx = globalSlot % ARRAY_PACKED_REALS;
+
+    mPositions[j].setFromVector3( element.position, idx );
+    mOrientations[j].setFromQuaternion( element.orientation, idx );
+    mColours[j].setFromVector4( element.colour.toVector4(), idx );
+    reinterpret_cast<Real * RESTRICT_ALIAS>( mWidths )[globalSlot] = element.width;
+    mTexCoords[globalSlot] = element.texCoord;
+}
+//-----------------------------------------------------------------------------
+void BillboardChain::getElement( size_t globalSlot, Element &outElement ) const
+{
+    const size_t j = globalSlot / ARRAY_PACKED_REALS;
+    const size_t idx = globalSlot % ARRAY_PACKED_REALS;
+
+    Vector4 colour;
+    mPositions[j].getAsVector3( outElement.position, idx );
+    mOrientations[j].getAsQuaternion( outElement.orientation, idx );
+    mColours[j].getAsVector4( colour, idx );
+    outElement.colour = ColourValue( colour.x, colour.y, colour.z, colour.w );
+    outElement.width = reinterpret_cast<const Real * RESTRICT_ALIAS>( mWidths )[globalSlot];
+    outElement.texCoord = mTexCoords[globalSlot];
+}
+//-----------------------------------------------------------------------------
+Vector3 BillboardChain::getElementPosition( size_t chainIndex, size_t elementIndex ) const
+{
+    const size_t globalSlot = getGlobalSlot( chainIndex, elementIndex );
+    Vector3 retVal;
+    mPositions[globalSlot / ARRAY_PACKED_REALS].getAsVector3( retVal, globalSlot % ARRAY_PACKED_REALS );
+    return retVal;
+}
+//-----------------------------------------------------------------------------
+void BillboardChain::setElementPosition( size_t chainIndex, size_t elementIndex, const Vector3 &pos )
+{
+    const size_t globalSlot = getGlobalSlot( chainIndex, elementIndex );
+    mPositions[globalSlot / ARRAY_PACKED_REALS].setFromVector3( pos, globalSlot % ARRAY_PACKED_REALS );
+}
+//-----------------------------------------------------------------------------
+void BillboardChain::updateTangent( size_t chainIndex, size_t elementIndex )
+{
+    const size_t numElements = mChainSegments[chainIndex].numElements;
+
+    Vector3 tangent( Vector3::ZERO );
+    if( numElements > 1u )
+    {
+        // The head has no previous element and the tail has no next one,
+        // thus they use their only neighbour.
+        const size_t prevIdx = elementIndex == 0u ? 0u : elementIndex - 1u;
+        const size_t nextIdx = std::min( elementIndex + 1u, numElements - 1u );
+        tangent = getElementPosition( chainIndex, nextIdx ) - getElementPosition( chainIndex, prevIdx );
+    }
+
+    const size_t globalSlot = getGlobalSlot( chainIndex, elementIndex );
+    mTangents[globalSlot / ARRAY_PACKED_REALS].setFromVector3( tangent,
+                                                               globalSlot % ARRAY_PACKED_REALS );
+}
+//-----------------------------------------------------------------------------
+void BillboardChain::updateTangents( size_t chainIndex, size_t elementIndex )
+{
+    const size_t numElements = mChainSegments[chainIndex].numElements;
+    const size_t firstIdx = elementIndex == 0u ? 0u : elementIndex - 1u;
+    const size_t lastIdx = std::min( elementIndex + 1u, numElements - 1u );
+    for( size_t i = firstIdx; i <= lastIdx; ++i )
+        updateTangent( chainIndex, i );
+}
+//-----------------------------------------------------------------------------
+void BillboardChain::setOtherTextureCoordRange( Real start, Real end )
+{
+    mOtherTexCoordRange[0] = start;
+    mOtherTexCoordRange[1] = end;
+}
+//-----------------------------------------------------------------------------
+void BillboardChain::setFaceCamera( bool faceCamera, const Vector3 &normalVector )
+{
+    mFaceCamera = faceCamera;
+    mNormalBase = normalVector.normalisedCopy();
+}
+//-----------------------------------------------------------------------------
+void BillboardChain::addChainElement( size_t chainIndex, const Element &element )
+{
+    OGRE_ASSERT_LOW( chainIndex < mChainSegments.size() );
+
+    ChainSegment &seg = mChainSegments[chainIndex];
+    if( seg.numElements == 0u )
+        seg.head = 0u;
+    else
+        seg.head = ( seg.head == 0u ? mMaxElementsPerChain : seg.head ) - 1u;
+
+    // If the chain was full, the old tail got overwritten
+    seg.numElements = std::min( seg.numElements + 1u, mMaxElementsPerChain );
+
+    setElement( getGlobalSlot( chainIndex, 0u ), element );
+    updateTangents( chainIndex, 0u );
+    updateTangent( chainIndex, seg.numElements - 1u );
+}
+//-----------------------------------------------------------------------------
+void BillboardChain::removeChainElement( size_t chainIndex )
+{
+    OGRE_ASSERT_LOW( chainIndex < mChainSegments.size() );
+
+    ChainSegment &seg = mChainSegments[chainIndex];
+    if( seg.numElements == 0u )
+        return;
+
+    --seg.numElements;
+    if( seg.numElements > 0u )
+        updateTangent( chainIndex, seg.numElements - 1u );
+}
+//-----------------------------------------------------------------------------
+void BillboardChain::updateChainElement( size_t chainIndex, size_t elementIndex,
+                                         const Element &element )
+{
+    OGRE_ASSERT_LOW( chainIndex < mChainSegments.size() );
+    OGRE_ASSERT_LOW( elementIndex < mChainSegments[chainIndex].numElements );
+
+    setElement( getGlobalSlot( chainIndex, elementIndex ), element );
+    updateTangents( chainIndex, elementIndex );
+}
+//-----------------------------------------------------------------------------
+BillboardChain::Element BillboardChain::getChainElement( size_t chainIndex,
+                                                         size_t elementIndex ) const
+{
+    OGRE_ASSERT_LOW( chainIndex < mChainSegments.size() );
+    OGRE_ASSERT_LOW( elementIndex < mChainSegments[chainIndex].numElements );
+
+    Element retVal;
+    getElement( getGlobalSlot( chainIndex, elementIndex ), retVal );
+    return retVal;
+}
+//-----------------------------------------------------------------------------
+size_t BillboardChain::getNumChainElements( size_t chainIndex ) const
+{
+    OGRE_ASSERT_LOW( chainIndex < mChainSegments.size() );
+    return mChainSegments[chainIndex].numElements;
+}
+//-----------------------------------------------------------------------------
+void BillboardChain::clearChain( size_t chainIndex )
+{
+    OGRE_ASSERT_LOW( chainIndex < mChainSegments.size() );
+    mChainSegments[chainIndex].head = 0u;
+    mChainSegments[chainIndex].numElements = 0u;
+}
+//-----------------------------------------------------------------------------
+void BillboardChain::clearAllChains()
+{
+    const size_t numChains = mChainSegments.size();
+    for( size_t i = 0u; i < numChains; ++i )
+        clearChain( i );
+}
+//-----------------------------------------------------------------------------
+void BillboardChain::updateElements( Real timeSinceLast ) {}
+//-----------------------------------------------------------------------------
+void BillboardChain::_updateParallel( const Vector3 &camPos, Real timeSinceLast )
+{
+    OGRE_ASSERT_MEDIUM( mMappedVertices );
+
+    updateElements( timeSinceLast );
+
+    const Vector3 eyePos = mParentNode ? mParentNode->convertWorldToLocalPosition( camPos ) : camPos;
+
+    ArrayVector3 arrayEyePos;
+    arrayEyePos.setAll( eyePos );
+    ArrayVector3 normalBase;
+    normalBase.setAll( mNormalBase );
+
+    const size_t uIdx = mTexCoordDir == TCD_U ? 0u : 1u;
+    const size_t vIdx = 1u - uIdx;
+    const float otherTexCoord0 = static_cast<float>( mOtherTexCoordRange[0] );
+    const float otherTexCoord1 = static_cast<float>( mOtherTexCoordRange[1] );
+
+    Vector3 vMin( std::numeric_limits<Real>::max() );
+    Vector3 vMax( -std::numeric_limits<Real>::max() );
+
+    const size_t maxElements = mMaxElementsPerChain;
+    const size_t numPacksPerChain = mNumSlotsPerChain / ARRAY_PACKED_REALS;
+    const size_t numChains = mChainSegments.size();
+
+    for( size_t chainIdx = 0u; chainIdx < numChains; ++chainIdx )
+    {
+        const ChainSegment &seg = mChainSegments[chainIdx];
+
+        ChainVertex *RESTRICT_ALIAS chainVertices =
+            reinterpret_cast<ChainVertex *>( mMappedVertices ) + chainIdx * maxElements * 2u;
+
+        if( seg.numElements < 2u )
+        {
+            // Nothing to draw. Collapse all the triangles into a point.
+            memset( chainVertices, 0, maxElements * 2u * sizeof( ChainVertex ) );
+            continue;
+        }
+
+        // Keep a copy of the tail, as we must never read back from the mapped buffer
+        ChainVertex tailVertices[2];
+
+        for( size_t packIdx = 0u; packIdx < numPacksPerChain; ++packIdx )
+        {
+            const size_t arrayIdx = chainIdx * numPacksPerChain + packIdx;
+
+            const ArrayVector3 &position = mPositions[arrayIdx];
+
+            ArrayVector3 toEye;
+            if( mFaceCamera )
+                toEye = arrayEyePos - position;
+            else
+                toEye = mOrientations[arrayIdx] * normalBase;
+
+            ArrayVector3 perpendicular = mTangents[arrayIdx].crossProduct( toEye );
+            perpendicular.normalise();
+            perpendicular *= mWidths[arrayIdx];
+            perpendicular *= 0.5f;
+
+            const ArrayVector3 pos0 = position - perpendicular;
+            const ArrayVector3 pos1 = position + perpendicular;
+
+            ArrayVector4 colour = mColours[arrayIdx];
+            for( size_t i = 0u; i < 4u; ++i )
+                colour.mChunkBase[i] = Mathlib::Saturate( colour.mChunkBase[i] );
+            colour *= 255.0f;
+            colour += 0.5f;
+
+            const Real *RESTRICT_ALIAS colourChannels[4] = {
+                reinterpret_cast<const Real *>( &colour.mChunkBase[0] ),
+                reinterpret_cast<const Real *>( &colour.mChunkBase[1] ),
+                reinterpret_cast<const Real *>( &colour.mChunkBase[2] ),
+                reinterpret_cast<const Real *>( &colour.mChunkBase[3] )
+            };
+
+            const size_t firstSlot = packIdx * ARRAY_PACKED_REALS;
+            const size_t numSlots = std::min<size_t>( ARRAY_PACKED_REALS, maxElements - firstSlot );
+
+            for( size_t j = 0u; j < numSlots; ++j )
+            {
+                const size_t elementIdx = ( firstSlot + j + maxElements - seg.head ) % maxElements;
+                if( elementIdx >= seg.numElements )
+                    continue;
+
+                Vector3 scalarPos[2];
+                pos0.getAsVector3( scalarPos[0], j );
+                pos1.getAsVector3( scalarPos[1], j );
+
+                vMin.makeFloor( scalarPos[0] );
+                vMin.makeFloor( scalarPos[1] );
+                vMax.makeCeil( scalarPos[0] );
+                vMax.makeCeil( scalarPos[1] );
+
+                const float texCoord =
+                    static_cast<float>( mTexCoords[chainIdx * mNumSlotsPerChain + firstSlot + j] );
+
+                ChainVertex vertices[2];
+                for( size_t k = 0u; k < 2u; ++k )
+                {
+                    vertices[k].position[0] = static_cast<float>( scalarPos[k].x );
+                    vertices[k].position[1] = static_cast<float>( scalarPos[k].y );
+                    vertices[k].position[2] = static_cast<float>( scalarPos[k].z );
+                    for( size_t c = 0u; c < 4u; ++c )
+                        vertices[k].colour[c] = static_cast<uint8>( colourChannels[c][j] );
+                    vertices[k].uv[uIdx] = texCoord;
+                }
+                vertices[0].uv[vIdx] = otherTexCoord0;
+                vertices[1].uv[vIdx] = otherTexCoord1;
+
+                chainVertices[elementIdx * 2u + 0u] = vertices[0];
+                chainVertices[elementIdx * 2u + 1u] = vertices[1];
+
+                if( elementIdx == seg.numElements - 1u )
+                {
+                    tailVertices[0] = vertices[0];
+                    tailVertices[1] = vertices[1];
+                }
+            }
+        }
+
+        // Collapse the unused elements into the tail, so that they become degenerate triangles
+        for( size_t i = seg.numElements; i < maxElements; ++i )
+        {
+            chainVertices[i * 2u + 0u] = tailVertices[0];
+            chainVertices[i * 2u + 1u] = tailVertices[1];
+        }
+    }
+
+    if( vMin.x <= vMax.x )
+        mChainsAabb = Aabb::newFromExtents( vMin, vMax );
+    else
+        mChainsAabb = Aabb::BOX_NULL;
+}
+//-----------------------------------------------------------------------------
+void BillboardChain::_updateSerial()
+{
+    if( mMappedVertices )
+    {
+        mVertexBuffer->unmap( UO_KEEP_PERSISTENT );
+        mMappedVertices = 0;
+    }
+
+    // See ParticleSystemManager2::updateSerialPos on why we use infinite boxes
+    // instead of null ones.
+    Aabb aabb = mChainsAabb;
+    if( aabb == Aabb::BOX_NULL )
+        aabb = Aabb::BOX_INFINITE;
+
+    setLocalAabb( aabb );
+
+    if( mParentNode && aabb != Aabb::BOX_INFINITE )
+        aabb.transformAffine( mParentNode->_getFullTransform() );
+
+    mObjectData.mWorldAabb->setFromAabb( aabb, mObjectData.mIndex );
+    mObjectData.mWorldRadius[mObjectData.mIndex] = aabb.getRadius();
+}
+//-----------------------------------------------------------------------------
+const String &BillboardChain::getMovableType() const { return MOVABLE_TYPE_NAME; }
+//-----------------------------------------------------------------------------
+void BillboardChain::getRenderOperation( v1::RenderOperation &op, bool casterPass )
+{
+    OGRE_EXCEPT( Exception::ERR_NOT_IMPLEMENTED,
+                 "BillboardChain can't be placed in a V1_LEGACY/V1_FAST RenderQueue. "
+                 "Use MovableObject::setRenderQueueGroup to move it to a FAST one.",
+                 "BillboardChain::getRenderOperation" );
+}
+//-----------------------------------------------------------------------------
+void BillboardChain::getWorldTransforms( Matrix4 *xform ) const
+{
+    OGRE_EXCEPT( Exception::ERR_NOT_IMPLEMENTED,
+                 "BillboardChain can't be placed in a V1_LEGACY/V1_FAST RenderQueue. "
+                 "Use MovableObject::setRenderQueueGroup to move it to a FAST one.",
+                 "BillboardChain::getWorldTransforms" );
+}
+//-----------------------------------------------------------------------------
+const LightList &BillboardChain::getLights() const { return queryLights(); }
+//-----------------------------------------------------------------------------
+bool BillboardChain::getCastsShadows() const { return getCastShadows(); }
@@ -34,15 +34,18 @@ THE SOFTWARE.
 #include "Math/Array/OgreBooleanMask.h"
 #include "OgreRenderQueue.h"
 #include "OgreSceneManager.h"
+#include "ParticleSystem/OgreBillboardChain2.h"
 #include "ParticleSystem/OgreBillboardSet2.h"
 #include "ParticleSystem/OgreEmitter2.h"
 #include "ParticleSystem/OgreParticle2.h"
 #include "ParticleSystem/OgreParticleAffector2.h"
 #include "ParticleSystem/OgreParticleSystem2.h"
+#include "ParticleSystem/OgreRibbonTrail2.h"
 #include "Vao/OgreIndexBufferPacked.h"
 #include "Vao/OgreReadOnlyBufferPacked.h"
 #include "Vao/OgreVaoManager.h"
 #include "Vao/OgreVertexArrayObject.h"
+#include "Vao/OgreVertexBufferPacked.h"
 
 using namespace Ogre;
 
@@ -58,7 +61,8 @@ ParticleSystemManager2::ParticleSystemManager2( SceneManager *sceneManager,
     mHighestPossibleQuota32( 0u ),
     mTimeSinceLast( 0 ),
     mMaster( master ),
-    mCameraPos( Vector3::ZERO )
+    mCameraPos( Vector3::ZERO ),
+    mCameraPosSource( 0 )
 {
     if( sceneManager )
         mMemoryManager = &sceneManager->_getParticleSysDefMemoryManager();
@@ -68,6 +72,7 @@ ParticleSystemManager2::ParticleSystemManager2( SceneManager *sceneManager,
 //-----------------------------------------------------------------------------
 ParticleSystemManager2::~ParticleSystemManager2()
 {
+    destroyAllBillboardChains();
     destroyAllBillboardSets();
 
     VaoManager *vaoManager =
@@ -248,6 +253,9 @@ void ParticleSystemManager2::sortAndPrepare( ParticleSystemDef *systemDef, const
 //-----------------------------------------------------------------------------
 void ParticleSystemManager2::updateSerialPos()
 {
+    for( BillboardChain *billboardChain : mBillboardChains )
+        billboardChain->_updateSerial();
+
     for( BillboardSet *billboardSet : mBillboardSets )
     {
         if( billboardSet->mParticleGpuData )
@@ -563,6 +571,24 @@ void ParticleSystemManager2::_updateParallel02( const size_t threadIdx, const si
         }
         billboardSet->mAabb[threadIdx] = finalAabb;
     }
+
+    // Chains can't be split across threads (elements depend on their neighbours).
+    {
+        const size_t numChains = mBillboardChains.size();
+        const size_t chainsPerThread = ( numChains + numThreads - 1u ) / numThreads;
+        const size_t toAdvance = std::min( threadIdx * chainsPerThread, numChains );
+        const size_t numChainsToProcess = std::min( chainsPerThread, numChains - toAdvance );
+
+        FastArray<BillboardChain *>::const_iterator itor = mBillboardChains.begin() + toAdvance;
+        FastArray<BillboardChain *>::const_iterator endt =
+            mBillboardChains.begin() + toAdvance + numChainsToProcess;
+
+        while( itor != endt )
+        {
+            ( *itor )->_updateParallel( mCameraPos, mTimeSinceLast );
+            ++itor;
+        }
+    }
 }
 //-----------------------------------------------------------------------------
 void ParticleSystemManager2::addEmitterFactory( ParticleEmitterDefDataFactory *factory )
@@ -741,6 +767,68 @@ void ParticleSystemManager2::destroyAllBillboardSets()
     mBillboardSets.clear();
 }
 //-----------------------------------------------------------------------------
+void ParticleSystemManager2::addBillboardChain( BillboardChain *billboardChain )
+{
+    billboardChain->mGlobalIndex = mBillboardChains.size();
+    mBillboardChains.push_back( billboardChain );
+    mSceneManager->getRootSceneNode( SCENE_DYNAMIC )->attachObject( billboardChain );
+}
+//-----------------------------------------------------------------------------
+BillboardChain *ParticleSystemManager2::createBillboardChain( uint32 maxElements,
+                                                              uint32 numberOfChains )
+{
+    OGRE_ASSERT_LOW( mSceneManager );
+    BillboardChain *retVal = new BillboardChain(
+        Id::generateNewId<MovableObject>(), &mSceneManager->_getEntityMemoryManager( SCENE_DYNAMIC ),
+        mSceneManager, this, maxElements, numberOfChains );
+    addBillboardChain( retVal );
+    return retVal;
+}
+//-----------------------------------------------------------------------------
+RibbonTrail *ParticleSystemManager2::createRibbonTrail( uint32 maxElements, uint32 numberOfChains )
+{
+    OGRE_ASSERT_LOW( mSceneManager );
+    RibbonTrail *retVal = new RibbonTrail(
+        Id::generateNewId<MovableObject>(), &mSceneManager->_getEntityMemoryManager( SCENE_DYNAMIC ),
+        mSceneManager, this, maxElements, numberOfChains );
+    addBillboardChain( retVal );
+    return retVal;
+}
+//-----------------------------------------------------------------------------
+void ParticleSystemManager2::destroyBillboardChain( BillboardChain *billboardChain )
+{
+    OGRE_ASSERT_LOW(
+        billboardChain->mGlobalIndex < mBillboardChains.size() &&
+        billboardChain == *( mBillboardChains.begin() + ptrdiff_t( billboardChain->mGlobalIndex ) ) &&
+        "Double free detected, memory corruption or this BillboardChain does not belong to "
+        "this ParticleSystemManager2." );
+
+    FastArray<BillboardChain *>::iterator itor =
+        mBillboardChains.begin() + ptrdiff_t( billboardChain->mGlobalIndex );
+    itor = efficientVectorRemove( mBillboardChains, itor );
+
+    billboardChain->detachFromParent();
+    delete billboardChain;
+
+    // The chain that was at the end got swapped and has now a different index.
+    if( itor != mBillboardChains.end() )
+        ( *itor )->mGlobalIndex = static_cast<size_t>( itor - mBillboardChains.begin() );
+}
+//-----------------------------------------------------------------------------
+void ParticleSystemManager2::destroyAllBillboardChains()
+{
+    if( !mMaster )
+    {
+        OGRE_ASSERT_LOW( mBillboardChains.empty() &&
+                         "ParticleSystemManager2 owned by Root can't create BillboardChains!" );
+        return;
+    }
+
+    for( BillboardChain *billboardChain : mBillboardChains )
+        delete billboardChain;
+    mBillboardChains.clear();
+}
+//-----------------------------------------------------------------------------
 void ParticleSystemManager2::_addToRenderQueue( size_t threadIdx, size_t numThreads,
                                                 RenderQueue *renderQueue, uint8 renderQueueId,
                                                 uint32 visibilityMask, bool includeNonCasters ) const
@@ -944,7 +1032,7 @@ IndexBufferPacked *ParticleSystemManager2::_getSharedIndexBuffer( size_t maxQuot
 void ParticleSystemManager2::prepareForUpdate( const Real timeSinceLast )
 {
     mActiveParticlesLeftToSort.clear();
-    if( mActiveParticleSystemDefs.empty() && mBillboardSets.empty() )
+    if( mActiveParticleSystemDefs.empty() && mBillboardSets.empty() && mBillboardChains.empty() )
         return;
 
     mTimeSinceLast = timeSinceLast;
@@ -962,11 +1050,17 @@ void ParticleSystemManager2::prepareForUpdate( const Real timeSinceLast )
         billboardSet->mParticleGpuData = reinterpret_cast<ParticleGpuData *>(
             billboardSet->mGpuData->map( 0u, billboardSet->mGpuData->getNumElements() ) );
     }
+
+    for( BillboardChain *billboardChain : mBillboardChains )
+    {
+        billboardChain->mMappedVertices = reinterpret_cast<uint8 *>( billboardChain->mVertexBuffer->map(
+            0u, billboardChain->mVertexBuffer->getNumElements() ) );
+    }
 }
 //-----------------------------------------------------------------------------
 void ParticleSystemManager2::update()
 {
-    if( mActiveParticleSystemDefs.empty() && mBillboardSets.empty() )
+    if( mActiveParticleSystemDefs.empty() && mBillboardSets.empty() && mBillboardChains.empty() )
         return;
 
     mSceneManager->_fireParticleSystemManager2Update();
@@ -0,0 +1,319 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2023 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreStableHeaders.h"
+
+#include "ParticleSystem/OgreRibbonTrail2.h"
+
+#include "Math/Array/OgreArrayVector4.h"
+#include "OgreException.h"
+
+using namespace Ogre;
+
+const String RibbonTrail::MOVABLE_TYPE_NAME = "RibbonTrail2";
+
+RibbonTrail::RibbonTrail( IdType id, ObjectMemoryManager *objectMemoryManager, SceneManager *manager,
+                          ParticleSystemManager2 *particleSystemManager, uint32 maxElements,
+                          uint32 numberOfChains ) :
+    BillboardChain( id, objectMemoryManager, manager, particleSystemManager, maxElements,
+                    numberOfChains ),
+    mTrailLength( 0 ),
+    mElemLength( 0 ),
+    mSquaredElemLength( 0 )
+{
+    const size_t numChains = mChainSegments.size();
+    mTrackedNodes.resize( numChains, 0 );
+    mInitialColour.resize( numChains, ColourValue::White );
+    mDeltaColour.resize( numChains, ColourValue::ZERO );
+    mInitialWidth.resize( numChains, 10.0f );
+    mDeltaWidth.resize( numChains, 0.0f );
+
+    setTrailLength( 100 );
+
+    // use V as varying texture coord, so we can use 1D textures to 'smear'
+    setTextureCoordDirection( TCD_V );
+}
+//-----------------------------------------------------------------------------
+RibbonTrail::~RibbonTrail()
+{
+    // Detach listeners
+    for( Node *node : mTrackedNodes )
+    {
+        if( node )
+            node->setListener( 0 );
+    }
+}
+//-----------------------------------------------------------------------------
+void RibbonTrail::addNode( Node *n )
+{
+    FastArray<Node *>::iterator itor = std::find( mTrackedNodes.begin(), mTrackedNodes.end(),
+                                                  static_cast<Node *>( 0 ) );
+    if( itor == mTrackedNodes.end() )
+    {
+        OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS,
+                     mName + " cannot monitor any more nodes, chain count exceeded",
+                     "RibbonTrail::addNode" );
+    }
+    if( n->getListener() )
+    {
+        OGRE_EXCEPT(
+            Exception::ERR_INVALIDPARAMS,
+            mName + " cannot monitor node " + n->getName() + " since it already has a listener.",
+            "RibbonTrail::addNode" );
+    }
+
+    const size_t chainIndex = static_cast<size_t>( itor - mTrackedNodes.begin() );
+    *itor = n;
+
+    resetTrail( chainIndex, n );
+
+    n->setListener( this );
+}
+//-----------------------------------------------------------------------------
+void RibbonTrail::removeNode( const Node *n )
+{
+    FastArray<Node *>::iterator itor = std::find( mTrackedNodes.begin(), mTrackedNodes.end(), n );
+    if( itor != mTrackedNodes.end() )
+    {
+        const size_t chainIndex = static_cast<size_t>( itor - mTrackedNodes.begin() );
+        BillboardChain::clearChain( chainIndex );
+        ( *itor )->setListener( 0 );
+        *itor = 0;
+    }
+}
+//-----------------------------------------------------------------------------
+size_t RibbonTrail::getChainIndexForNode( const Node *n ) const
+{
+    FastArray<Node *>::const_iterator itor =
+        std::find( mTrackedNodes.begin(), mTrackedNodes.end(), n );
+    if( itor == mTrackedNodes.end() )
+    {
+        OGRE_EXCEPT( Exception::ERR_ITEM_NOT_FOUND, "This node is not being tracked",
+                     "RibbonTrail::getChainIndexForNode" );
+    }
+    return static_cast<size_t>( itor - mTrackedNodes.begin() );
+}
+//-----------------------------------------------------------------------------
+void RibbonTrail::setTrailLength( Real len )
+{
+    mTrailLength = len;
+    mElemLength = mTrailLength / Real( mMaxElementsPerChain );
+    mSquaredElemLength = mElemLength * mElemLength;
+}
+//-----------------------------------------------------------------------------
+void RibbonTrail::clearChain( size_t chainIndex )
+{
+    BillboardChain::clearChain( chainIndex );
+
+    // Reset if we are tracking for this chain
+    if( mTrackedNodes[chainIndex] )
+        resetTrail( chainIndex, mTrackedNodes[chainIndex] );
+}
+//-----------------------------------------------------------------------------
+void RibbonTrail::setInitialColour( size_t chainIndex, const ColourValue &col )
+{
+    OGRE_ASSERT_LOW( chainIndex < mInitialColour.size() );
+    mInitialColour[chainIndex] = col;
+}
+//-----------------------------------------------------------------------------
+const ColourValue &RibbonTrail::getInitialColour( size_t chainIndex ) const
+{
+    OGRE_ASSERT_LOW( chainIndex < mInitialColour.size() );
+    return mInitialColour[chainIndex];
+}
+//-----------------------------------------------------------------------------
+void RibbonTrail::setColourChange( size_t chainIndex, const ColourValue &valuePerSecond )
+{
+    OGRE_ASSERT_LOW( chainIndex < mDeltaColour.size() );
+    mDeltaColour[chainIndex] = valuePerSecond;
+}
+//-----------------------------------------------------------------------------
+const ColourValue &RibbonTrail::getColourChange( size_t chainIndex ) const
+{
+    OGRE_ASSERT_LOW( chainIndex < mDeltaColour.size() );
+    return mDeltaColour[chainIndex];
+}
+//-----------------------------------------------------------------------------
+void RibbonTrail::setInitialWidth( size_t chainIndex, Real width )
+{
+    OGRE_ASSERT_LOW( chainIndex < mInitialWidth.size() );
+    mInitialWidth[chainIndex] = width;
+}
+//-----------------------------------------------------------------------------
+Real RibbonTrail::getInitialWidth( size_t chainIndex ) const
+{
+    OGRE_ASSERT_LOW( chainIndex < mInitialWidth.size() );
+    return mInitialWidth[chainIndex];
+}
+//-----------------------------------------------------------------------------
+void RibbonTrail::setWidthChange( size_t chainIndex, Real widthDeltaPerSecond )
+{
+    OGRE_ASSERT_LOW( chainIndex < mDeltaWidth.size() );
+    mDeltaWidth[chainIndex] = widthDeltaPerSecond;
+}
+//-----------------------------------------------------------------------------
+Real RibbonTrail::getWidthChange( size_t chainIndex ) const
+{
+    OGRE_ASSERT_LOW( chainIndex < mDeltaWidth.size() );
+    return mDeltaWidth[chainIndex];
+}
+//-----------------------------------------------------------------------------
+void RibbonTrail::nodeDestroyed( const Node *node ) { removeNode( node ); }
+//-----------------------------------------------------------------------------
+void RibbonTrail::resetTrail( size_t chainIndex, Node *node )
+{
+    BillboardChain::clearChain( chainIndex );
+
+    Vector3 position = node->_getDerivedPositionUpdated();
+    if( mParentNode )
+        position = mParentNode->convertWorldToLocalPosition( position );
+
+    // v coord is always 0.0f
+    const Element element( position, mInitialWidth[chainIndex], 0.0f, mInitialColour[chainIndex],
+                           node->_getDerivedOrientation() );
+    // Add the start position
+    addChainElement( chainIndex, element );
+    // Add another on the same spot, this will extend
+    addChainElement( chainIndex, element );
+}
+//-----------------------------------------------------------------------------
+void RibbonTrail::updateTrail( size_t chainIndex, Node *node )
+{
+    const ChainSegment &seg = mChainSegments[chainIndex];
+
+    // Vary the head elem, but bake new version if that exceeds element len
+    Vector3 newPos = node->_getDerivedPosition();
+    if( mParentNode )
+    {
+        // Transform position to ourself space
+        newPos = mParentNode->convertWorldToLocalPosition( newPos );
+    }
+
+    // Repeat this entire process if chain is stretched beyond its natural length
+    bool done = false;
+    while( !done )
+    {
+        OGRE_ASSERT_MEDIUM( seg.numElements >= 2u );
+
+        Vector3 headPos = getElementPosition( chainIndex, 0u );
+        const Vector3 nextPos = getElementPosition( chainIndex, 1u );
+
+        Vector3 diff = newPos - nextPos;
+        const Real sqlen = diff.squaredLength();
+        if( sqlen >= mSquaredElemLength )
+        {
+            // Move existing head to mElemLength
+            headPos = nextPos + diff * ( mElemLength / Math::Sqrt( sqlen ) );
+            setElementPosition( chainIndex, 0u, headPos );
+            // Add a new element to be the new head
+            const Element newElem( newPos, mInitialWidth[chainIndex], 0.0f, mInitialColour[chainIndex],
+                                   node->_getDerivedOrientation() );
+            addChainElement( chainIndex, newElem );
+            // The old head moved; its neighbours' tangents depend on it
+            updateTangents( chainIndex, 1u );
+            // alter diff to represent new head size
+            diff = newPos - headPos;
+            // check whether another step is needed or not
+            if( diff.squaredLength() <= mSquaredElemLength )
+                done = true;
+        }
+        else
+        {
+            // Extend existing head
+            setElementPosition( chainIndex, 0u, newPos );
+            updateTangents( chainIndex, 0u );
+            done = true;
+        }
+
+        // Is this segment full?
+        if( seg.numElements == mMaxElementsPerChain )
+        {
+            // If so, shrink tail gradually to match head extension
+            const size_t tailIdx = seg.numElements - 1u;
+            const Vector3 tailPos = getElementPosition( chainIndex, tailIdx );
+            const Vector3 preTailPos = getElementPosition( chainIndex, tailIdx - 1u );
+
+            // Measure tail diff from pretail to tail
+            Vector3 taildiff = tailPos - preTailPos;
+            const Real taillen = taildiff.length();
+            if( taillen > 1e-06 )
+            {
+                const Real tailsize = mElemLength - diff.length();
+                taildiff *= tailsize / taillen;
+                setElementPosition( chainIndex, tailIdx, preTailPos + taildiff );
+                updateTangents( chainIndex, tailIdx );
+            }
+        }
+    }
+}
+//-----------------------------------------------------------------------------
+void RibbonTrail::fadeChain( size_t chainIndex, Real timeSinceLast )
+{
+    const ColourValue &deltaColour = mDeltaColour[chainIndex];
+    const Real deltaWidth = mDeltaWidth[chainIndex];
+
+    if( deltaColour == ColourValue::ZERO && deltaWidth == Real( 0 ) )
+        return;
+
+    ArrayVector4 arrayDeltaColour;
+    arrayDeltaColour.setAll( ( deltaColour * timeSinceLast ).toVector4() );
+    const ArrayReal arrayDeltaWidth = Mathlib::SetAll( deltaWidth * timeSinceLast );
+
+    // Fade all slots (including unused ones, it's harmless)
+    const size_t numPacksPerChain = mNumSlotsPerChain / ARRAY_PACKED_REALS;
+    ArrayVector4 *RESTRICT_ALIAS colours = mColours + chainIndex * numPacksPerChain;
+    ArrayReal *RESTRICT_ALIAS widths = mWidths + chainIndex * numPacksPerChain;
+
+    for( size_t i = 0u; i < numPacksPerChain; ++i )
+    {
+        widths[i] = Mathlib::Max( widths[i] - arrayDeltaWidth, ARRAY_REAL_ZERO );
+        colours[i] -= arrayDeltaColour;
+        for( size_t j = 0u; j < 4u; ++j )
+            colours[i].mChunkBase[j] = Mathlib::Saturate( colours[i].mChunkBase[j] );
+    }
+
+    // The head never fades
+    const size_t headSlot = getGlobalSlot( chainIndex, 0u );
+    reinterpret_cast<Real * RESTRICT_ALIAS>( mWidths )[headSlot] = mInitialWidth[chainIndex];
+    mColours[headSlot / ARRAY_PACKED_REALS].setFromVector4( mInitialColour[chainIndex].toVector4(),
+                                                            headSlot % ARRAY_PACKED_REALS );
+}
+//-----------------------------------------------------------------------------
+void RibbonTrail::updateElements( Real timeSinceLast )
+{
+    const size_t numChains = mChainSegments.size();
+    for( size_t chainIdx = 0u; chainIdx < numChains; ++chainIdx )
+    {
+        if( mTrackedNodes[chainIdx] )
+            updateTrail( chainIdx, mTrackedNodes[chainIdx] );
+        if( mChainSegments[chainIdx].numElements > 1u )
+            fadeChain( chainIdx, timeSinceLast );
+    }
+}
+//-----------------------------------------------------------------------------
+const String &RibbonTrail::getMovableType() const { return MOVABLE_TYPE_NAME; }
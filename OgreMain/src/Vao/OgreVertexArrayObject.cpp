@@ -55,7 +55,8 @@ namespace Ogre
         mVertexBuffers( vertexBuffers ),
         mIndexBuffer( indexBuffer ),
         mBaseVertexBuffer( 0 ),
-        mOperationType( operationType )
+        mOperationType( operationType ),
+        mClusters( 0 )
     {
         if( mVertexBuffers.empty() )
             mBaseVertexBuffer = &msDummyVertexBuffer;
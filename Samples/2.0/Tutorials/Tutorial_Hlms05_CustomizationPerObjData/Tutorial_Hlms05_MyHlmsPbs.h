@@ -84,6 +84,9 @@ namespace Ogre
         {
             // Set ourselves as our own listener.
             setListener( this );
+
+            // HlmsPbs' batched path would skip our fillBuffersForV2 override
+            setBatchedFillBuffers( false );
         }
 
         void hlmsTypeChanged( bool casterPass, CommandBuffer *commandBuffer,
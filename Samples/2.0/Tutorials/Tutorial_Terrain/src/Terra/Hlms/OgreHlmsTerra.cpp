@@ -95,6 +95,9 @@ namespace Ogre
         mReservedTexSlots = 3u;  // heightMap, terrainNormals & terrainShadows
 
         mSkipRequestSlotInChangeRS = true;
+
+        // We override fillBuffersForV2, HlmsPbs' batched path would skip it
+        setBatchedFillBuffers( false );
     }
     //-----------------------------------------------------------------------------------
     HlmsTerra::~HlmsTerra() { destroyAllBuffers(); }
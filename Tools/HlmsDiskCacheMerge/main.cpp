@@ -0,0 +1,91 @@
+#include "OgreDataStream.h"
+#include "OgreHlmsDiskCache.h"
+#include "OgreLogManager.h"
+
+#include <fstream>
+
+static bool loadCache( Ogre::HlmsDiskCache &diskCache, const char *fullPath )
+{
+    using namespace Ogre;
+
+    std::ifstream *ifs = OGRE_NEW_T( std::ifstream, MEMCATEGORY_GENERAL )(
+        fullPath, std::ios::binary | std::ios::in );
+
+    if( !ifs->is_open() )
+    {
+        fprintf( stderr, "Could not open %s\n", fullPath );
+        OGRE_DELETE_T( ifs, basic_ifstream, MEMCATEGORY_GENERAL );
+        return false;
+    }
+
+    DataStreamPtr dataStream( OGRE_NEW FileStreamDataStream( fullPath, ifs, true ) );
+    diskCache.loadFrom( dataStream );
+    return true;
+}
+
+int main( int argc, const char *argv[] )
+{
+    if( argc < 3 )
+    {
+        printf(
+            "Tool to merge multiple HlmsDiskCache files (e.g. recorded on different machines)\n"
+            "into a single deduplicated bundle.\n"
+            "All the input files must be for the same Hlms type, shader profile and templates.\n"
+            "Variants seen in more files get compiled first when the bundle is applied.\n"
+            "\n"
+            "\n"
+            "USAGE:\n"
+            "   OgreHlmsDiskCacheMerge output.bin input0.bin input1.bin ...\n" );
+        return -1;
+    }
+
+    using namespace Ogre;
+
+    LogManager *logManager = new LogManager();
+    logManager->createLog( "OgreHlmsDiskCacheMerge.log", true, true, false );
+
+    int retVal = 0;
+
+    {
+        // We don't need an HlmsManager, we're not going to apply the caches.
+        HlmsDiskCache mergedCache( 0 );
+
+        for( int i = 2; i < argc && retVal == 0; ++i )
+        {
+            HlmsDiskCache diskCache( 0 );
+            if( !loadCache( diskCache, argv[i] ) )
+                retVal = -1;
+            else if( diskCache.getNumSourceCodeEntries() == 0u && diskCache.getNumPsoEntries() == 0u )
+                printf( "%s is empty or could not be loaded. Skipping.\n", argv[i] );
+            else if( !mergedCache.mergeFrom( diskCache ) )
+                retVal = -1;
+        }
+
+        if( retVal == 0 )
+        {
+            std::fstream *ofs = OGRE_NEW_T( std::fstream, MEMCATEGORY_GENERAL )(
+                argv[1], std::ios::binary | std::ios::out | std::ios::trunc );
+
+            if( !ofs->is_open() )
+            {
+                fprintf( stderr, "Could not open %s for writing\n", argv[1] );
+                OGRE_DELETE_T( ofs, basic_fstream, MEMCATEGORY_GENERAL );
+                retVal = -1;
+            }
+            else
+            {
+                DataStreamPtr dataStream( OGRE_NEW FileStreamDataStream( argv[1], ofs, true ) );
+                mergedCache.saveTo( dataStream );
+                dataStream->close();
+
+                printf( "Saved %i shader variants and %i PSOs to %s\n",
+                        (int)mergedCache.getNumSourceCodeEntries(), (int)mergedCache.getNumPsoEntries(),
+                        argv[1] );
+            }
+        }
+    }
+
+    delete logManager;
+
+    return retVal;
+}
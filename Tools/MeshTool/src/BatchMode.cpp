@@ -0,0 +1,589 @@
+#include "BatchMode.h"
+
+#include "OgreArchive.h"
+#include "OgreArchiveManager.h"
+#include "OgreException.h"
+#include "OgrePlatformInformation.h"
+#include "OgreString.h"
+#include "OgreStringConverter.h"
+#include "OgreTimer.h"
+#include "Hash/MurmurHash3.h"
+#include "Threading/OgreThreads.h"
+
+#include "ogrestd/map.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sys/stat.h>
+
+using namespace Ogre;
+
+static const char *c_batchDatabaseHeader = "# OgreMeshTool batch database v1";
+
+struct BatchJob
+{
+    String source;
+    String dest;
+};
+
+typedef vector<BatchJob>::type BatchJobVec;
+
+struct BatchResult
+{
+    enum Status
+    {
+        Pending,
+        Built,
+        UpToDate,
+        Failed
+    };
+
+    Status            status;
+    String            error;
+    BatchStageTimings timings;
+
+    BatchResult() : status( Pending ) {}
+};
+
+typedef vector<BatchResult>::type BatchResultVec;
+
+struct BatchDatabaseEntry
+{
+    String dest;
+    String contentHash;
+    String optionsHash;
+};
+
+typedef map<String, BatchDatabaseEntry>::type BatchDatabase;
+
+BatchStageTimings::BatchStageTimings() { memset( microseconds, 0, sizeof( microseconds ) ); }
+
+const char *BatchStageTimings::getStageName( size_t stage )
+{
+    static const char *stageNames[NumStages] = { "load", "tangents", "lod", "optimize", "save" };
+    return stageNames[stage];
+}
+
+BatchOptions::BatchOptions() : numJobs( 0u ), force( false ) {}
+
+String getDefaultDestination( const String &source )
+{
+    const String::size_type extPos = source.find_last_of( '.' );
+    const String sourceExt( source.substr( extPos + 1, source.size() ) );
+
+    // dest is source minus .xml
+    if( sourceExt == "xml" )
+        return source.substr( 0, source.size() - 4 );
+
+    return source;
+}
+
+static String hashToString( const void *data, size_t sizeBytes )
+{
+    uint64 hash[2];
+    MurmurHash3_x64_128( data, static_cast<int>( sizeBytes ), 0x4d455348, hash );
+
+    char tmpBuffer[40];
+    snprintf( tmpBuffer, sizeof( tmpBuffer ), "%016llx%016llx", (unsigned long long)hash[0],
+              (unsigned long long)hash[1] );
+    return String( tmpBuffer );
+}
+
+/// Returns false if the file could not be read
+static bool hashFile( const String &path, String &outHash )
+{
+    std::ifstream file( path.c_str(), std::ios::binary | std::ios::in );
+    if( !file.is_open() )
+        return false;
+
+    vector<char>::type contents( ( std::istreambuf_iterator<char>( file ) ),
+                                 std::istreambuf_iterator<char>() );
+    outHash = hashToString( contents.empty() ? "" : &contents[0], contents.size() );
+    return true;
+}
+
+static bool fileExists( const String &path )
+{
+    struct stat tagStat;
+    return stat( path.c_str(), &tagStat ) == 0;
+}
+
+static bool isDirectory( const String &path )
+{
+    struct stat tagStat;
+    return stat( path.c_str(), &tagStat ) == 0 && ( tagStat.st_mode & S_IFDIR );
+}
+
+/// Strips characters that would break our tab/line separated files
+static String sanitize( String text )
+{
+    std::replace( text.begin(), text.end(), '\t', ' ' );
+    std::replace( text.begin(), text.end(), '\n', ' ' );
+    std::replace( text.begin(), text.end(), '\r', ' ' );
+    return text;
+}
+
+static void gatherJobs( const String &input, BatchJobVec &outJobs )
+{
+    if( isDirectory( input ) )
+    {
+        String basePath = input;
+        if( !basePath.empty() && basePath[basePath.size() - 1u] != '/' &&
+            basePath[basePath.size() - 1u] != '\\' )
+        {
+            basePath += '/';
+        }
+
+        Archive *archive = ArchiveManager::getSingleton().load( input, "FileSystem", true );
+        StringVectorPtr files = archive->find( "*.mesh", true );
+        std::sort( files->begin(), files->end() );
+
+        StringVector::const_iterator itor = files->begin();
+        StringVector::const_iterator endt = files->end();
+        while( itor != endt )
+        {
+            BatchJob job;
+            job.source = basePath + *itor;
+            job.dest = job.source;
+            outJobs.push_back( job );
+            ++itor;
+        }
+
+        ArchiveManager::getSingleton().unload( archive );
+    }
+    else
+    {
+        std::ifstream manifest( input.c_str() );
+        if( !manifest.is_open() )
+        {
+            OGRE_EXCEPT( Exception::ERR_FILE_NOT_FOUND, "Could not open batch input '" + input + "'",
+                         "gatherJobs" );
+        }
+
+        String line;
+        while( std::getline( manifest, line ) )
+        {
+            StringUtil::trim( line );
+            if( line.empty() || line[0] == '#' )
+                continue;
+
+            const StringVector entries = StringUtil::split( line, "\t" );
+            BatchJob job;
+            job.source = entries[0];
+            StringUtil::trim( job.source );
+            if( entries.size() > 1u )
+            {
+                job.dest = entries[1];
+                StringUtil::trim( job.dest );
+            }
+            if( job.dest.empty() )
+                job.dest = getDefaultDestination( job.source );
+            outJobs.push_back( job );
+        }
+    }
+}
+
+static void loadDatabase( const String &path, BatchDatabase &outDatabase )
+{
+    std::ifstream file( path.c_str() );
+    if( !file.is_open() )
+        return;
+
+    String line;
+    if( !std::getline( file, line ) || line != c_batchDatabaseHeader )
+    {
+        std::cout << "Ignoring batch database '" << path << "': unknown format" << std::endl;
+        return;
+    }
+
+    while( std::getline( file, line ) )
+    {
+        const StringVector entries = StringUtil::split( line, "\t" );
+        if( entries.size() == 4u )
+        {
+            BatchDatabaseEntry &entry = outDatabase[entries[0]];
+            entry.dest = entries[1];
+            entry.contentHash = entries[2];
+            entry.optionsHash = entries[3];
+        }
+    }
+}
+
+static void saveDatabase( const String &path, const BatchDatabase &database )
+{
+    std::ofstream file( path.c_str(), std::ios::out | std::ios::trunc );
+    if( !file.is_open() )
+    {
+        std::cout << "Could not write batch database '" << path << "'" << std::endl;
+        return;
+    }
+
+    file << c_batchDatabaseHeader << "\n";
+
+    BatchDatabase::const_iterator itor = database.begin();
+    BatchDatabase::const_iterator endt = database.end();
+    while( itor != endt )
+    {
+        file << itor->first << "\t" << itor->second.dest << "\t" << itor->second.contentHash
+             << "\t" << itor->second.optionsHash << "\n";
+        ++itor;
+    }
+}
+
+static void processJob( const BatchJob &job, BatchFileProcessor &processor, BatchResult &outResult )
+{
+    std::cout << "=== " << job.source << " -> " << job.dest << std::endl;
+    try
+    {
+        processor.processFile( job.source, job.dest, outResult.timings );
+        outResult.status = BatchResult::Built;
+    }
+    catch( Exception &e )
+    {
+        outResult.status = BatchResult::Failed;
+        outResult.error = e.getDescription();
+        std::cout << "Exception caught: " << outResult.error << std::endl;
+    }
+}
+
+static void writeResult( std::ostream &stream, const BatchJob &job, const BatchResult &result )
+{
+    stream << ( result.status == BatchResult::Built ? "ok" : "failed" );
+    for( size_t i = 0u; i < BatchStageTimings::NumStages; ++i )
+        stream << "\t" << result.timings.microseconds[i];
+    stream << "\t" << job.source << "\t" << sanitize( result.error ) << "\n";
+}
+
+/// Reads the results of a worker. Jobs missing from the report are left as Pending
+static void readResults( const String &reportFile, const BatchJobVec &jobs,
+                         const vector<size_t>::type &jobIndices, BatchResultVec &inOutResults )
+{
+    std::ifstream file( reportFile.c_str() );
+    if( !file.is_open() )
+        return;
+
+    String line;
+    size_t reportIdx = 0u;
+    while( std::getline( file, line ) && reportIdx < jobIndices.size() )
+    {
+        const StringVector entries = StringUtil::split( line, "\t" );
+        const size_t jobIdx = jobIndices[reportIdx];
+        if( entries.size() < BatchStageTimings::NumStages + 2u ||
+            entries[BatchStageTimings::NumStages + 1u] != jobs[jobIdx].source )
+        {
+            break;
+        }
+
+        BatchResult &result = inOutResults[jobIdx];
+        result.status = entries[0] == "ok" ? BatchResult::Built : BatchResult::Failed;
+        for( size_t i = 0u; i < BatchStageTimings::NumStages; ++i )
+            result.timings.microseconds[i] = StringConverter::parseUnsignedLong( entries[i + 1u] );
+        if( entries.size() > BatchStageTimings::NumStages + 2u )
+            result.error = entries[BatchStageTimings::NumStages + 2u];
+        ++reportIdx;
+    }
+}
+
+static String quoteArg( const String &arg ) { return "\"" + arg + "\""; }
+
+struct BatchWorkerProcess
+{
+    String command;
+    int    exitCode;
+};
+
+static unsigned long batchWorkerThread( ThreadHandle *threadHandle )
+{
+    BatchWorkerProcess *worker = reinterpret_cast<BatchWorkerProcess *>( threadHandle->getUserParam() );
+    worker->exitCode = system( worker->command.c_str() );
+    return 0;
+}
+
+THREAD_DECLARE( batchWorkerThread );
+
+/// Splits the jobs across worker processes, and waits for all of them
+static void runWorkers( const BatchOptions &options, const char *exePath, const BatchJobVec &jobs,
+                        const vector<size_t>::type &pendingJobs, size_t numWorkers,
+                        BatchResultVec &inOutResults )
+{
+    vector<vector<size_t>::type>::type jobsPerWorker( numWorkers );
+    // Interleave them, so that big and small assets in the same folder get spread out
+    for( size_t i = 0u; i < pendingJobs.size(); ++i )
+        jobsPerWorker[i % numWorkers].push_back( pendingJobs[i] );
+
+    String forwardedArgs;
+    for( size_t i = 0u; i < options.workerArgs.size(); ++i )
+        forwardedArgs += " " + quoteArg( options.workerArgs[i] );
+
+    vector<BatchWorkerProcess>::type workers( numWorkers );
+    for( size_t i = 0u; i < numWorkers; ++i )
+    {
+        const String prefix = options.database + ".worker" + StringConverter::toString( i );
+
+        std::ofstream jobsFile( ( prefix + ".jobs" ).c_str(), std::ios::out | std::ios::trunc );
+        for( size_t j = 0u; j < jobsPerWorker[i].size(); ++j )
+        {
+            const BatchJob &job = jobs[jobsPerWorker[i][j]];
+            jobsFile << job.source << "\t" << job.dest << "\n";
+        }
+        jobsFile.close();
+        remove( ( prefix + ".report" ).c_str() );
+
+        workers[i].command = quoteArg( exePath ) + forwardedArgs + " -batchworker " +
+                             quoteArg( prefix + ".jobs" ) + " -batchout " +
+                             quoteArg( prefix + ".report" ) + " > " + quoteArg( prefix + ".log" ) +
+                             " 2>&1";
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+        // cmd.exe strips the first and last quote of the command line
+        workers[i].command = "\"" + workers[i].command + "\"";
+#endif
+        workers[i].exitCode = 0;
+    }
+
+    std::cout << "Launching " << numWorkers << " worker processes. Their output goes to "
+              << options.database << ".worker*.log" << std::endl;
+
+    ThreadHandleVec workerThreads;
+    workerThreads.reserve( numWorkers );
+    for( size_t i = 0u; i < numWorkers; ++i )
+    {
+        workerThreads.push_back(
+            Threads::CreateThread( THREAD_GET( batchWorkerThread ), i, &workers[i] ) );
+    }
+    Threads::WaitForThreads( workerThreads );
+
+    for( size_t i = 0u; i < numWorkers; ++i )
+    {
+        const String prefix = options.database + ".worker" + StringConverter::toString( i );
+        readResults( prefix + ".report", jobs, jobsPerWorker[i], inOutResults );
+
+        bool workerSucceeded = true;
+        for( size_t j = 0u; j < jobsPerWorker[i].size(); ++j )
+        {
+            BatchResult &result = inOutResults[jobsPerWorker[i][j]];
+            if( result.status == BatchResult::Pending )
+            {
+                result.status = BatchResult::Failed;
+                result.error = "Worker process " + StringConverter::toString( i ) +
+                               " exited with code " + StringConverter::toString( workers[i].exitCode ) +
+                               " before processing this file";
+            }
+            workerSucceeded &= result.status != BatchResult::Failed;
+        }
+
+        remove( ( prefix + ".jobs" ).c_str() );
+        remove( ( prefix + ".report" ).c_str() );
+        // Keep the log around if something went wrong
+        if( workerSucceeded )
+            remove( ( prefix + ".log" ).c_str() );
+    }
+}
+
+static void printSummary( const BatchJobVec &jobs, const BatchResultVec &results, uint64 wallTimeUs )
+{
+    size_t numBuilt = 0u;
+    size_t numUpToDate = 0u;
+    size_t numFailed = 0u;
+    uint64 totals[BatchStageTimings::NumStages];
+    memset( totals, 0, sizeof( totals ) );
+
+    for( size_t i = 0u; i < results.size(); ++i )
+    {
+        if( results[i].status == BatchResult::Built )
+            ++numBuilt;
+        else if( results[i].status == BatchResult::UpToDate )
+            ++numUpToDate;
+        else
+            ++numFailed;
+
+        for( size_t j = 0u; j < BatchStageTimings::NumStages; ++j )
+            totals[j] += results[i].timings.microseconds[j];
+    }
+
+    std::cout << std::endl << "Batch summary:" << std::endl;
+    std::cout << "  " << jobs.size() << " files: " << numBuilt << " built, " << numUpToDate
+              << " up to date, " << numFailed << " failed" << std::endl;
+    std::cout << "  Wall time: " << std::fixed << std::setprecision( 2 )
+              << double( wallTimeUs ) / 1000000.0 << " s" << std::endl;
+
+    std::cout << "  Stage        CPU total (s)   Avg per built file (ms)" << std::endl;
+    for( size_t i = 0u; i < BatchStageTimings::NumStages; ++i )
+    {
+        const double avgMs = numBuilt ? double( totals[i] ) / double( numBuilt ) / 1000.0 : 0.0;
+        std::cout << "  " << std::left << std::setw( 12 ) << BatchStageTimings::getStageName( i )
+                  << std::right << std::setw( 14 ) << double( totals[i] ) / 1000000.0
+                  << std::setw( 26 ) << avgMs << std::endl;
+    }
+
+    if( numFailed )
+    {
+        std::cout << "  Failed files:" << std::endl;
+        for( size_t i = 0u; i < results.size(); ++i )
+        {
+            if( results[i].status == BatchResult::Failed )
+                std::cout << "    " << jobs[i].source << ": " << results[i].error << std::endl;
+        }
+    }
+}
+
+static void writeReport( const String &path, const BatchJobVec &jobs, const BatchResultVec &results )
+{
+    std::ofstream file( path.c_str(), std::ios::out | std::ios::trunc );
+    if( !file.is_open() )
+    {
+        std::cout << "Could not write report '" << path << "'" << std::endl;
+        return;
+    }
+
+    file << "source,dest,status";
+    for( size_t i = 0u; i < BatchStageTimings::NumStages; ++i )
+        file << "," << BatchStageTimings::getStageName( i ) << "_ms";
+    file << ",error\n";
+
+    file << std::fixed << std::setprecision( 3 );
+    for( size_t i = 0u; i < results.size(); ++i )
+    {
+        const char *status = results[i].status == BatchResult::Built      ? "built"
+                             : results[i].status == BatchResult::UpToDate ? "up_to_date"
+                                                                          : "failed";
+        file << "\"" << jobs[i].source << "\",\"" << jobs[i].dest << "\"," << status;
+        for( size_t j = 0u; j < BatchStageTimings::NumStages; ++j )
+            file << "," << double( results[i].timings.microseconds[j] ) / 1000.0;
+        String error = sanitize( results[i].error );
+        std::replace( error.begin(), error.end(), '"', '\'' );
+        file << ",\"" << error << "\"\n";
+    }
+}
+
+int runBatch( const BatchOptions &options, BatchFileProcessor &processor, const char *exePath )
+{
+    Timer timer;
+
+    BatchJobVec jobs;
+    gatherJobs( options.input, jobs );
+
+    BatchDatabase database;
+    if( !options.force )
+        loadDatabase( options.database, database );
+
+    const String optionsHash =
+        hashToString( options.optionsString.c_str(), options.optionsString.size() );
+
+    BatchResultVec results( jobs.size() );
+    vector<String>::type contentHashes( jobs.size() );
+    vector<size_t>::type pendingJobs;
+
+    for( size_t i = 0u; i < jobs.size(); ++i )
+    {
+        if( !hashFile( jobs[i].source, contentHashes[i] ) )
+        {
+            results[i].status = BatchResult::Failed;
+            results[i].error = "Could not read '" + jobs[i].source + "'";
+            continue;
+        }
+
+        BatchDatabase::const_iterator itor = database.find( jobs[i].source );
+        if( itor != database.end() && itor->second.dest == jobs[i].dest &&
+            itor->second.contentHash == contentHashes[i] && itor->second.optionsHash == optionsHash &&
+            fileExists( jobs[i].dest ) )
+        {
+            results[i].status = BatchResult::UpToDate;
+        }
+        else
+        {
+            pendingJobs.push_back( i );
+        }
+    }
+
+    std::cout << jobs.size() << " files found, " << pendingJobs.size() << " need to be rebuilt"
+              << std::endl;
+
+    size_t numWorkers = options.numJobs;
+    if( numWorkers == 0u )
+        numWorkers = std::max<size_t>( PlatformInformation::getNumLogicalCores(), 1u );
+    numWorkers = std::min( numWorkers, pendingJobs.size() );
+
+    if( numWorkers > 1u )
+    {
+        runWorkers( options, exePath, jobs, pendingJobs, numWorkers, results );
+    }
+    else
+    {
+        for( size_t i = 0u; i < pendingJobs.size(); ++i )
+            processJob( jobs[pendingJobs[i]], processor, results[pendingJobs[i]] );
+    }
+
+    for( size_t i = 0u; i < pendingJobs.size(); ++i )
+    {
+        const size_t jobIdx = pendingJobs[i];
+        if( results[jobIdx].status == BatchResult::Built )
+        {
+            BatchDatabaseEntry &entry = database[jobs[jobIdx].source];
+            entry.dest = jobs[jobIdx].dest;
+            entry.contentHash = contentHashes[jobIdx];
+            entry.optionsHash = optionsHash;
+            // When converting in place, the next run will see our output as input
+            if( jobs[jobIdx].source == jobs[jobIdx].dest )
+                hashFile( jobs[jobIdx].source, entry.contentHash );
+        }
+        else
+        {
+            database.erase( jobs[jobIdx].source );
+        }
+    }
+
+    saveDatabase( options.database, database );
+
+    printSummary( jobs, results, timer.getMicroseconds() );
+    if( !options.reportFile.empty() )
+        writeReport( options.reportFile, jobs, results );
+
+    for( size_t i = 0u; i < results.size(); ++i )
+    {
+        if( results[i].status == BatchResult::Failed )
+            return 1;
+    }
+
+    return 0;
+}
+
+int runBatchWorker( const String &jobsFile, const String &reportFile, BatchFileProcessor &processor )
+{
+    BatchJobVec jobs;
+    {
+        std::ifstream file( jobsFile.c_str() );
+        String line;
+        while( std::getline( file, line ) )
+        {
+            const StringVector entries = StringUtil::split( line, "\t" );
+            if( entries.size() == 2u )
+            {
+                BatchJob job;
+                job.source = entries[0];
+                job.dest = entries[1];
+                jobs.push_back( job );
+            }
+        }
+    }
+
+    std::ofstream report( reportFile.c_str(), std::ios::out | std::ios::trunc );
+
+    int retVal = 0;
+    for( size_t i = 0u; i < jobs.size(); ++i )
+    {
+        BatchResult result;
+        processJob( jobs[i], processor, result );
+        writeResult( report, jobs[i], result );
+        // Flush after every file, so that the parent knows how far we got if we crash
+        report.flush();
+        if( result.status == BatchResult::Failed )
+            retVal = 1;
+    }
+
+    return retVal;
+}
@@ -0,0 +1,81 @@
+#ifndef _OgreToolBatchMode_H_
+#define _OgreToolBatchMode_H_
+
+#include "OgrePrerequisites.h"
+#include "OgreStringVector.h"
+
+/// Time spent in each processing stage of a single file
+struct BatchStageTimings
+{
+    enum Stage
+    {
+        Load,
+        Tangents,
+        Lod,
+        Optimize,
+        Save,
+        NumStages
+    };
+
+    /// In microseconds
+    Ogre::uint64 microseconds[NumStages];
+
+    BatchStageTimings();
+
+    static const char *getStageName( size_t stage );
+};
+
+/// Implemented by main.cpp, which owns the serializers
+class BatchFileProcessor
+{
+public:
+    virtual ~BatchFileProcessor() {}
+
+    /** Converts a single file, leaving no resources behind afterwards.
+        Throws Ogre::Exception on failure.
+    */
+    virtual void processFile( const Ogre::String &source, const Ogre::String &dest,
+                              BatchStageTimings &outTimings ) = 0;
+};
+
+struct BatchOptions
+{
+    /// Directory (all .mesh files in it are converted in place) or manifest file
+    /// with one "source[<TAB>dest]" entry per line
+    Ogre::String input;
+    /// Sidecar database with the hashes of the inputs already processed
+    Ogre::String database;
+    /// Optional CSV file to write the per-file timings to
+    Ogre::String reportFile;
+    /// All the options that affect the output. Gets hashed; changing it rebuilds everything
+    Ogre::String optionsString;
+    /// Arguments forwarded to the worker processes
+    Ogre::StringVector workerArgs;
+    /// Number of worker processes. 0 means one per logical core
+    size_t numJobs;
+    /// Ignore the database and rebuild everything
+    bool force;
+
+    BatchOptions();
+};
+
+/// Returns where a file gets saved to when no destination was given
+Ogre::String getDefaultDestination( const Ogre::String &source );
+
+/** Converts all the files listed by options.input, skipping those which haven't changed
+    since the last run, in parallel across options.numJobs worker processes.
+    Prints a summary with per-stage timings when done.
+@param exePath
+    Path to this executable, used to launch the worker processes.
+@return
+    0 if all files were converted (or skipped) successfully.
+*/
+int runBatch( const BatchOptions &options, BatchFileProcessor &processor, const char *exePath );
+
+/** Entry point of the worker processes launched by runBatch.
+    Converts the files listed in jobsFile and writes the results to reportFile.
+*/
+int runBatchWorker( const Ogre::String &jobsFile, const Ogre::String &reportFile,
+                    BatchFileProcessor &processor );
+
+#endif
@@ -0,0 +1,1041 @@
+
+#include "OgreMesh.h"
+#include "OgreSubMesh.h"
+#include "OgreAnimation.h"
+#include "OgrePose.h"
+#include "OgreBitwise.h"
+#include "OgreStringConverter.h"
+#include "OgreVertexIndexData.h"
+#include "OgreHardwareVertexBuffer.h"
+#include "OgreHardwareBufferManager.h"
+#include "OgreVertexRemapping.h"
+
+#include "Vao/OgreAsyncTicket.h"
+#include "Vao/OgreVaoManager.h"
+#include "Vao/OgreVertexArrayObject.h"
+#include "OgreMesh2.h"
+#include "OgreSubMesh2.h"
+
+#include "ogrestd/set.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+
+#include "UpgradeOptions.h"
+
+
+using namespace Ogre;
+
+typedef vector<uint32>::type IndexVec;
+typedef vector<Vector3>::type PositionVec;
+
+/// Size of the FIFO cache used to report ACMR/ATVR and to find overdraw clusters.
+/// Conservative; it matches what most GPUs since the GeForce 3 / Radeon 9700 provide.
+static const uint32 c_statsCacheSize = 16u;
+/// Size of the LRU cache the optimizer models. Bigger than real HW caches on purpose
+/// (see Forsyth, "Linear-Speed Vertex Cache Optimisation")
+static const uint32 c_optimizerCacheSize = 32u;
+/// How much the overdraw pass may worsen the ACMR of a cluster in exchange for more clusters.
+static const float c_overdrawThreshold = 1.05f;
+
+struct VertexCacheStats
+{
+    size_t numMisses;
+    size_t numTriangles;
+    size_t numVertices;
+
+    VertexCacheStats() : numMisses( 0 ), numTriangles( 0 ), numVertices( 0 ) {}
+
+    /// Average cache miss ratio: vertex shader invocations per triangle. Optimal ~0.5
+    float getAcmr() const { return numTriangles ? float( numMisses ) / float( numTriangles ) : 0.0f; }
+    /// Average transform to vertex ratio: vertex shader invocations per vertex. Optimal 1.0
+    float getAtvr() const { return numVertices ? float( numMisses ) / float( numVertices ) : 0.0f; }
+};
+
+/** Simulates a FIFO post-transform cache. A vertex is in the cache if it was
+    inserted less than cacheSize misses ago.
+@param cacheTimestamps [in/out]
+    Must contain vertexCount entries initialized to 0. Preserved across calls
+    so that the simulation can continue where it was left.
+@param timestamp [in/out]
+    Must be initialized to cacheSize + 1
+@return
+    Number of misses for the triangle.
+*/
+static inline uint32 simulateFifoTriangle( const uint32 *triIndices, IndexVec &cacheTimestamps,
+                                           uint32 &timestamp, uint32 cacheSize )
+{
+    uint32 misses = 0;
+    for( size_t i=0; i<3u; ++i )
+    {
+        const uint32 idx = triIndices[i];
+        if( timestamp - cacheTimestamps[idx] > cacheSize )
+        {
+            cacheTimestamps[idx] = timestamp++;
+            ++misses;
+        }
+    }
+    return misses;
+}
+
+static VertexCacheStats analyzeVertexCache( const IndexVec &indices, size_t vertexCount )
+{
+    VertexCacheStats retVal;
+    retVal.numTriangles = indices.size() / 3u;
+
+    IndexVec cacheTimestamps( vertexCount, 0u );
+    uint32 timestamp = c_statsCacheSize + 1u;
+
+    for( size_t i=0; i<retVal.numTriangles; ++i )
+    {
+        retVal.numMisses += simulateFifoTriangle( &indices[i * 3u], cacheTimestamps,
+                                                  timestamp, c_statsCacheSize );
+    }
+
+    vector<bool>::type used( vertexCount, false );
+    IndexVec::const_iterator itor = indices.begin();
+    IndexVec::const_iterator endt = indices.end();
+    while( itor != endt )
+    {
+        if( !used[*itor] )
+        {
+            used[*itor] = true;
+            ++retVal.numVertices;
+        }
+        ++itor;
+    }
+
+    return retVal;
+}
+
+static float vertexScore( int32 cachePosition, uint32 remainingValence )
+{
+    // No triangle needs this vertex!
+    if( remainingValence == 0 )
+        return -1.0f;
+
+    float score = 0.0f;
+    if( cachePosition >= 0 )
+    {
+        if( cachePosition < 3 )
+        {
+            // The vertex was used in the last triangle. Fixed score so that we don't
+            // favour (nor penalize) any of the three vertices of the triangle we just added.
+            score = 0.75f;
+        }
+        else
+        {
+            const float scaler = 1.0f / float( c_optimizerCacheSize - 3u );
+            score = 1.0f - float( cachePosition - 3 ) * scaler;
+            score = powf( score, 1.5f );
+        }
+    }
+
+    // Bonus for vertices with few triangles left, so that we get rid of lone triangles
+    // instead of leaving them for later where they'd cause more misses.
+    score += 2.0f * powf( float( remainingValence ), -0.5f );
+
+    return score;
+}
+
+/** Reorders the triangles to reduce post-transform vertex cache misses.
+    Implements Tom Forsyth's "Linear-Speed Vertex Cache Optimisation", which doesn't
+    depend on the exact cache size of the GPU, and works well for both FIFO and LRU caches.
+*/
+static void optimizeVertexCache( IndexVec &indices, size_t vertexCount )
+{
+    const size_t numTriangles = indices.size() / 3u;
+    if( numTriangles == 0u )
+        return;
+
+    // Build vertex -> triangle adjacency, stored contiguously.
+    IndexVec valence( vertexCount, 0u );
+    for( size_t i=0; i<numTriangles * 3u; ++i )
+        ++valence[indices[i]];
+
+    IndexVec adjacencyOffsets( vertexCount + 1u, 0u );
+    for( size_t i=0; i<vertexCount; ++i )
+        adjacencyOffsets[i + 1u] = adjacencyOffsets[i] + valence[i];
+
+    IndexVec adjacency( numTriangles * 3u );
+    {
+        IndexVec writeOffsets( adjacencyOffsets.begin(), adjacencyOffsets.end() - 1 );
+        for( size_t i=0; i<numTriangles * 3u; ++i )
+            adjacency[writeOffsets[indices[i]]++] = static_cast<uint32>( i / 3u );
+    }
+
+    vector<int32>::type cachePosition( vertexCount, -1 );
+    vector<float>::type vertexScores( vertexCount );
+    for( size_t i=0; i<vertexCount; ++i )
+        vertexScores[i] = vertexScore( -1, valence[i] );
+
+    vector<float>::type triangleScores( numTriangles );
+    vector<bool>::type emitted( numTriangles, false );
+    for( size_t i=0; i<numTriangles; ++i )
+    {
+        triangleScores[i] = vertexScores[indices[i * 3u + 0u]] +
+                            vertexScores[indices[i * 3u + 1u]] +
+                            vertexScores[indices[i * 3u + 2u]];
+    }
+
+    IndexVec cache;
+    cache.reserve( c_optimizerCacheSize + 3u );
+    IndexVec newCache;
+    newCache.reserve( c_optimizerCacheSize + 3u );
+
+    IndexVec newIndices;
+    newIndices.reserve( indices.size() );
+
+    size_t inputCursor = 0;
+    uint32 bestTriangle = ~0u;
+
+    for( size_t emittedCount=0; emittedCount<numTriangles; ++emittedCount )
+    {
+        if( bestTriangle == ~0u )
+        {
+            // Nothing in the cache is connected to a pending triangle.
+            // Pick the next one in input order.
+            while( emitted[inputCursor] )
+                ++inputCursor;
+            bestTriangle = static_cast<uint32>( inputCursor );
+        }
+
+        const uint32 *tri = &indices[bestTriangle * 3u];
+        newIndices.push_back( tri[0] );
+        newIndices.push_back( tri[1] );
+        newIndices.push_back( tri[2] );
+        emitted[bestTriangle] = true;
+
+        // Remove the triangle from the adjacency of its vertices
+        for( size_t i=0; i<3u; ++i )
+        {
+            const uint32 vertexIdx = tri[i];
+            uint32 *adjBegin = &adjacency[adjacencyOffsets[vertexIdx]];
+            uint32 *adjEnd = adjBegin + valence[vertexIdx];
+            uint32 *found = std::find( adjBegin, adjEnd, bestTriangle );
+            if( found != adjEnd )
+            {
+                *found = *( adjEnd - 1 );
+                --valence[vertexIdx];
+            }
+        }
+
+        // Move the triangle's vertices to the front of the LRU cache
+        newCache.clear();
+        newCache.push_back( tri[0] );
+        newCache.push_back( tri[1] );
+        newCache.push_back( tri[2] );
+        IndexVec::const_iterator itor = cache.begin();
+        IndexVec::const_iterator endt = cache.end();
+        while( itor != endt )
+        {
+            if( *itor != tri[0] && *itor != tri[1] && *itor != tri[2] )
+                newCache.push_back( *itor );
+            ++itor;
+        }
+        cache.swap( newCache );
+
+        // Update the scores of the vertices in the cache (and the ones that just got evicted)
+        for( size_t i=0; i<cache.size(); ++i )
+        {
+            const uint32 vertexIdx = cache[i];
+            cachePosition[vertexIdx] = i < c_optimizerCacheSize ? static_cast<int32>( i ) : -1;
+        }
+
+        for( size_t i=0; i<cache.size(); ++i )
+        {
+            const uint32 vertexIdx = cache[i];
+            const float newScore = vertexScore( cachePosition[vertexIdx], valence[vertexIdx] );
+            const float scoreDiff = newScore - vertexScores[vertexIdx];
+            vertexScores[vertexIdx] = newScore;
+
+            const uint32 *adjBegin = &adjacency[adjacencyOffsets[vertexIdx]];
+            const uint32 *adjEnd = adjBegin + valence[vertexIdx];
+            for( const uint32 *adj = adjBegin; adj != adjEnd; ++adj )
+                triangleScores[*adj] += scoreDiff;
+        }
+
+        // Only the triangles touching the cache changed their score. Pick the best one.
+        bestTriangle = ~0u;
+        float bestScore = -1.0f;
+
+        for( size_t i=0; i<cache.size() && i<c_optimizerCacheSize; ++i )
+        {
+            const uint32 vertexIdx = cache[i];
+            const uint32 *adjBegin = &adjacency[adjacencyOffsets[vertexIdx]];
+            const uint32 *adjEnd = adjBegin + valence[vertexIdx];
+            for( const uint32 *adj = adjBegin; adj != adjEnd; ++adj )
+            {
+                if( triangleScores[*adj] > bestScore )
+                {
+                    bestScore = triangleScores[*adj];
+                    bestTriangle = *adj;
+                }
+            }
+        }
+
+        if( cache.size() > c_optimizerCacheSize )
+            cache.resize( c_optimizerCacheSize );
+    }
+
+    indices.swap( newIndices );
+}
+
+struct TriangleCluster
+{
+    size_t  start;
+    size_t  numTriangles;
+    float   sortKey;
+
+    bool operator < ( const TriangleCluster &other ) const
+    {
+        // Front-facing, outer-most clusters go first
+        return this->sortKey > other.sortKey;
+    }
+};
+
+/** Reorders the clusters of triangles produced by optimizeVertexCache so that
+    triangles more likely to occlude others are drawn first, while keeping most of
+    the vertex cache efficiency.
+    Implements the clustering & sorting from Sander, Nehab and Barczak,
+    "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw" (SIGGRAPH 2007).
+@param indices
+    Indices. Must already be optimized for the vertex cache.
+@param positions
+    Position of each vertex.
+*/
+static void optimizeOverdraw( IndexVec &indices, const PositionVec &positions )
+{
+    const size_t numTriangles = indices.size() / 3u;
+    if( numTriangles < 2u )
+        return;
+
+    const size_t vertexCount = positions.size();
+
+    // Hard boundaries: triangles where the cache is entirely flushed
+    // (all vertices miss). Splitting there doesn't cost anything.
+    vector<size_t>::type hardBoundaries;
+    {
+        IndexVec cacheTimestamps( vertexCount, 0u );
+        uint32 timestamp = c_statsCacheSize + 1u;
+        for( size_t i=0; i<numTriangles; ++i )
+        {
+            const uint32 misses = simulateFifoTriangle( &indices[i * 3u], cacheTimestamps,
+                                                        timestamp, c_statsCacheSize );
+            if( i == 0u || misses == 3u )
+                hardBoundaries.push_back( i );
+        }
+    }
+    hardBoundaries.push_back( numTriangles );
+
+    // Soft boundaries: split the hard clusters further as long as the
+    // ACMR of each piece stays below threshold times the ACMR of the whole cluster.
+    vector<TriangleCluster>::type clusters;
+    for( size_t h=0; h<hardBoundaries.size() - 1u; ++h )
+    {
+        const size_t hardStart = hardBoundaries[h];
+        const size_t hardEnd = hardBoundaries[h + 1u];
+
+        IndexVec cacheTimestamps( vertexCount, 0u );
+        uint32 timestamp = c_statsCacheSize + 1u;
+
+        size_t clusterMisses = 0;
+        for( size_t i=hardStart; i<hardEnd; ++i )
+        {
+            clusterMisses += simulateFifoTriangle( &indices[i * 3u], cacheTimestamps,
+                                                   timestamp, c_statsCacheSize );
+        }
+        const float clusterThreshold = c_overdrawThreshold * float( clusterMisses ) /
+                                       float( hardEnd - hardStart );
+
+        std::fill( cacheTimestamps.begin(), cacheTimestamps.end(), 0u );
+        timestamp = c_statsCacheSize + 1u;
+
+        size_t start = hardStart;
+        size_t misses = 0;
+        for( size_t i=hardStart; i<hardEnd; ++i )
+        {
+            misses += simulateFifoTriangle( &indices[i * 3u], cacheTimestamps,
+                                            timestamp, c_statsCacheSize );
+
+            if( i + 1u < hardEnd && float( misses ) / float( i - start + 1u ) <= clusterThreshold )
+            {
+                TriangleCluster cluster = { start, i - start + 1u, 0.0f };
+                clusters.push_back( cluster );
+
+                // Restart the cache, as if the GPU would start from scratch
+                start = i + 1u;
+                misses = 0;
+                timestamp += c_statsCacheSize + 1u;
+            }
+        }
+
+        TriangleCluster cluster = { start, hardEnd - start, 0.0f };
+        clusters.push_back( cluster );
+    }
+
+    if( clusters.size() < 2u )
+        return;
+
+    // Area weighted centroid of the whole mesh
+    Vector3 meshCentroid( Vector3::ZERO );
+    Real meshArea = 0;
+    for( size_t i=0; i<numTriangles; ++i )
+    {
+        const Vector3 &p0 = positions[indices[i * 3u + 0u]];
+        const Vector3 &p1 = positions[indices[i * 3u + 1u]];
+        const Vector3 &p2 = positions[indices[i * 3u + 2u]];
+        const Real area = ( p1 - p0 ).crossProduct( p2 - p0 ).length();
+        meshCentroid += ( p0 + p1 + p2 ) * area;
+        meshArea += area;
+    }
+    if( meshArea > Real( 0 ) )
+        meshCentroid /= meshArea * Real( 3 );
+
+    vector<TriangleCluster>::type::iterator itor = clusters.begin();
+    vector<TriangleCluster>::type::iterator endt = clusters.end();
+    while( itor != endt )
+    {
+        Vector3 clusterCentroid( Vector3::ZERO );
+        Vector3 clusterNormal( Vector3::ZERO );
+        Real clusterArea = 0;
+
+        for( size_t i=itor->start; i<itor->start + itor->numTriangles; ++i )
+        {
+            const Vector3 &p0 = positions[indices[i * 3u + 0u]];
+            const Vector3 &p1 = positions[indices[i * 3u + 1u]];
+            const Vector3 &p2 = positions[indices[i * 3u + 2u]];
+            const Vector3 normal = ( p1 - p0 ).crossProduct( p2 - p0 );
+            const Real area = normal.length();
+            clusterCentroid += ( p0 + p1 + p2 ) * area;
+            clusterNormal += normal;
+            clusterArea += area;
+        }
+
+        if( clusterArea > Real( 0 ) )
+            clusterCentroid /= clusterArea * Real( 3 );
+        clusterNormal.normalise();
+
+        const Real sortKey = ( clusterCentroid - meshCentroid ).dotProduct( clusterNormal );
+        itor->sortKey = static_cast<float>( sortKey );
+        ++itor;
+    }
+
+    std::stable_sort( clusters.begin(), clusters.end() );
+
+    IndexVec newIndices;
+    newIndices.reserve( indices.size() );
+    itor = clusters.begin();
+    while( itor != endt )
+    {
+        newIndices.insert( newIndices.end(), indices.begin() + itor->start * 3u,
+                           indices.begin() + ( itor->start + itor->numTriangles ) * 3u );
+        ++itor;
+    }
+
+    indices.swap( newIndices );
+}
+
+/// Runs the vertex cache & overdraw passes (whichever are enabled) on a triangle list.
+/// Prints the ACMR/ATVR before and after.
+static void optimizeTriangleList( IndexVec &indices, const PositionVec &positions, size_t vertexCount,
+                                  size_t subMeshIdx, size_t lodIdx )
+{
+    const VertexCacheStats before = analyzeVertexCache( indices, vertexCount );
+
+    optimizeVertexCache( indices, vertexCount );
+    if( opts.optimizeOverdraw && !positions.empty() )
+        optimizeOverdraw( indices, positions );
+
+    const VertexCacheStats after = analyzeVertexCache( indices, vertexCount );
+
+    const std::streamsize oldPrecision = std::cout.precision( 3 );
+    std::cout << "  SubMesh #" << subMeshIdx << " LOD " << lodIdx << ": " << std::fixed
+         << "ACMR " << before.getAcmr() << " -> " << after.getAcmr()
+         << "  ATVR " << before.getAtvr() << " -> " << after.getAtvr() << std::endl;
+    std::cout.unsetf( std::ios::floatfield );
+    std::cout.precision( oldPrecision );
+}
+
+static void readIndices( v1::IndexData *indexData, IndexVec &outIndices )
+{
+    outIndices.resize( indexData->indexCount );
+    if( indexData->indexCount == 0u )
+        return;
+
+    v1::HardwareIndexBuffer *indexBuffer = indexData->indexBuffer.get();
+    v1::HardwareBufferLockGuard indexLock( indexBuffer,
+                                           indexData->indexStart * indexBuffer->getIndexSize(),
+                                           indexData->indexCount * indexBuffer->getIndexSize(),
+                                           v1::HardwareBuffer::HBL_READ_ONLY );
+
+    if( indexBuffer->getType() == v1::HardwareIndexBuffer::IT_32BIT )
+    {
+        memcpy( &outIndices[0], indexLock.pData, indexData->indexCount * sizeof(uint32) );
+    }
+    else
+    {
+        const uint16 *srcData = reinterpret_cast<const uint16*>( indexLock.pData );
+        for( size_t i=0; i<indexData->indexCount; ++i )
+            outIndices[i] = srcData[i];
+    }
+}
+
+/// Writes to a new index buffer rather than in place, since LODs generated
+/// by MeshLodGenerator may share the same index buffer.
+static void writeIndices( v1::HardwareBufferManagerBase *hwManager, v1::IndexData *indexData,
+                          const IndexVec &indices )
+{
+    v1::HardwareIndexBuffer *oldBuffer = indexData->indexBuffer.get();
+    const v1::HardwareIndexBuffer::IndexType indexType = oldBuffer->getType();
+    v1::HardwareIndexBufferSharedPtr newBuffer =
+            hwManager->createIndexBuffer( indexType, indices.size(), oldBuffer->getUsage(),
+                                          oldBuffer->hasShadowBuffer() );
+
+    v1::HardwareBufferLockGuard indexLock( newBuffer, v1::HardwareBuffer::HBL_DISCARD );
+
+    if( indexType == v1::HardwareIndexBuffer::IT_32BIT )
+    {
+        memcpy( indexLock.pData, &indices[0], indices.size() * sizeof(uint32) );
+    }
+    else
+    {
+        uint16 *dstData = reinterpret_cast<uint16*>( indexLock.pData );
+        for( size_t i=0; i<indices.size(); ++i )
+            dstData[i] = static_cast<uint16>( indices[i] );
+    }
+
+    indexLock.unlock();
+
+    indexData->indexBuffer = newBuffer;
+    indexData->indexStart = 0;
+}
+
+static bool readPositions( const v1::VertexData *vertexData, PositionVec &outPositions )
+{
+    outPositions.clear();
+
+    const v1::VertexElement *posElem =
+        vertexData->vertexDeclaration->findElementBySemantic( VES_POSITION );
+    if( !posElem || ( posElem->getType() != VET_FLOAT3 && posElem->getType() != VET_HALF4 ) )
+        return false;
+
+    const v1::HardwareVertexBufferSharedPtr buf =
+            vertexData->vertexBufferBinding->getBuffer( posElem->getSource() );
+    v1::HardwareBufferLockGuard bufLock( buf, v1::HardwareBuffer::HBL_READ_ONLY );
+    const uint8 *data = reinterpret_cast<const uint8*>( bufLock.pData ) +
+                        vertexData->vertexStart * buf->getVertexSize() + posElem->getOffset();
+
+    outPositions.reserve( vertexData->vertexCount );
+    for( size_t i=0; i<vertexData->vertexCount; ++i )
+    {
+        if( posElem->getType() == VET_FLOAT3 )
+        {
+            const float *pFloat = reinterpret_cast<const float*>( data );
+            outPositions.push_back( Vector3( pFloat[0], pFloat[1], pFloat[2] ) );
+        }
+        else
+        {
+            const uint16 *pHalf = reinterpret_cast<const uint16*>( data );
+            outPositions.push_back( Vector3( Bitwise::halfToFloat( pHalf[0] ),
+                                             Bitwise::halfToFloat( pHalf[1] ),
+                                             Bitwise::halfToFloat( pHalf[2] ) ) );
+        }
+        data += buf->getVertexSize();
+    }
+
+    return true;
+}
+
+static bool readPositions( const VertexArrayObject *vao, PositionVec &outPositions )
+{
+    outPositions.clear();
+
+    size_t bufferIdx, elemOffset;
+    const VertexElement2 *vertexElement = vao->findBySemantic( VES_POSITION, bufferIdx, elemOffset );
+
+    if( !vertexElement || ( vertexElement->mType != VET_FLOAT3 && vertexElement->mType != VET_HALF4 ) )
+        return false;
+
+    VertexBufferPacked *vertexBuffer = vao->getVertexBuffers()[bufferIdx];
+    AsyncTicketPtr asyncTicket = vertexBuffer->readRequest( 0, vertexBuffer->getNumElements() );
+    const uint8 *data = reinterpret_cast<const uint8*>( asyncTicket->map() ) + elemOffset;
+
+    const uint32 bytesPerVertex = vertexBuffer->getBytesPerElement();
+
+    outPositions.reserve( vertexBuffer->getNumElements() );
+    for( size_t i=0; i<vertexBuffer->getNumElements(); ++i )
+    {
+        if( vertexElement->mType == VET_FLOAT3 )
+        {
+            const float *pFloat = reinterpret_cast<const float*>( data );
+            outPositions.push_back( Vector3( pFloat[0], pFloat[1], pFloat[2] ) );
+        }
+        else
+        {
+            const uint16 *pHalf = reinterpret_cast<const uint16*>( data );
+            outPositions.push_back( Vector3( Bitwise::halfToFloat( pHalf[0] ),
+                                             Bitwise::halfToFloat( pHalf[1] ),
+                                             Bitwise::halfToFloat( pHalf[2] ) ) );
+        }
+        data += bytesPerVertex;
+    }
+
+    asyncTicket->unmap();
+
+    return true;
+}
+
+/// Returns all the index data of the submesh: LOD 0 first, then the rest of the LODs.
+static void getLodIndexData( v1::SubMesh *subMesh, vector<v1::IndexData*>::type &outIndexData )
+{
+    outIndexData.clear();
+    outIndexData.push_back( subMesh->indexData[VpNormal] );
+    outIndexData.insert( outIndexData.end(), subMesh->mLodFaceList[VpNormal].begin(),
+                         subMesh->mLodFaceList[VpNormal].end() );
+}
+
+static void optimizeIndexOrder( v1::MeshPtr &mesh )
+{
+    v1::HardwareBufferManagerBase *hwManager = mesh->getHardwareBufferManager();
+
+    const bool edgeListWasBuilt = mesh->isEdgeListBuilt();
+    const bool hadIndependentShadowBuffers = mesh->hasIndependentShadowMappingBuffers();
+    mesh->freeEdgeList();
+    mesh->destroyShadowMappingGeom();
+
+    const unsigned numSubMeshes = mesh->getNumSubMeshes();
+
+    vector<v1::IndexData*>::type lodIndexData;
+    IndexVec indices;
+    PositionVec positions;
+
+    if( opts.optimizeVertexCache )
+    {
+        for( unsigned i=0; i<numSubMeshes; ++i )
+        {
+            v1::SubMesh *subMesh = mesh->getSubMesh( i );
+            if( subMesh->operationType != OT_TRIANGLE_LIST )
+                continue;
+
+            v1::VertexData *vertexData = subMesh->useSharedVertices ?
+                                             mesh->sharedVertexData[VpNormal] :
+                                             subMesh->vertexData[VpNormal];
+
+            if( opts.optimizeOverdraw && !readPositions( vertexData, positions ) )
+            {
+                std::cout << "  SubMesh #" << i << ": positions must be VET_FLOAT3 or VET_HALF4 "
+                        "for the overdraw pass. Skipping it." << std::endl;
+            }
+
+            getLodIndexData( subMesh, lodIndexData );
+            for( size_t lod=0; lod<lodIndexData.size(); ++lod )
+            {
+                if( lodIndexData[lod]->indexCount == 0u )
+                    continue;
+
+                readIndices( lodIndexData[lod], indices );
+                optimizeTriangleList( indices, positions, vertexData->vertexCount, i, lod );
+                writeIndices( hwManager, lodIndexData[lod], indices );
+            }
+        }
+    }
+
+    if( opts.optimizeVertexFetch )
+    {
+        // 0 for shared geometry, 1+ for submesh index + 1 (same as pose targets)
+        vector<VerticesRemapInfo>::type remapInfos( 1u + numSubMeshes );
+        vector<bool>::type canRemap( 1u + numSubMeshes, true );
+
+        remapInfos[0].initialize( mesh->sharedVertexData[VpNormal] ?
+                                      mesh->sharedVertexData[VpNormal]->vertexCount : 0, false );
+        for( unsigned i=0; i<numSubMeshes; ++i )
+        {
+            v1::SubMesh *subMesh = mesh->getSubMesh( i );
+            remapInfos[1u + i].initialize( subMesh->useSharedVertices ?
+                                               0 : subMesh->vertexData[VpNormal]->vertexCount, false );
+        }
+
+        // Mark LOD 0 of every submesh first, then the rest of the LODs. This
+        // way vertices appear in the order the highest detail LOD uses them.
+        size_t maxLods = 0;
+        for( unsigned i=0; i<numSubMeshes; ++i )
+        {
+            v1::SubMesh *subMesh = mesh->getSubMesh( i );
+            maxLods = std::max( maxLods, subMesh->mLodFaceList[VpNormal].size() + 1u );
+            if( subMesh->indexData[VpNormal]->indexCount == 0u )
+            {
+                // Non-indexed geometry depends on the vertex order
+                canRemap[subMesh->useSharedVertices ? 0 : 1u + i] = false;
+            }
+        }
+
+        for( size_t lod=0; lod<maxLods; ++lod )
+        {
+            for( unsigned i=0; i<numSubMeshes; ++i )
+            {
+                v1::SubMesh *subMesh = mesh->getSubMesh( i );
+                const size_t remapIdx = subMesh->useSharedVertices ? 0 : 1u + i;
+                getLodIndexData( subMesh, lodIndexData );
+                if( lod < lodIndexData.size() && lodIndexData[lod]->indexCount != 0u &&
+                    canRemap[remapIdx] )
+                {
+                    remapInfos[remapIdx].markUsedIndices( lodIndexData[lod] );
+                }
+            }
+        }
+
+        if( mesh->sharedVertexData[VpNormal] && canRemap[0] )
+        {
+            remapInfos[0].performVertexDataRemap( hwManager, mesh->sharedVertexData[VpNormal] );
+            remapInfos[0].performBoneAssignmentRemap( mesh.get() );
+        }
+
+        for( unsigned i=0; i<numSubMeshes; ++i )
+        {
+            v1::SubMesh *subMesh = mesh->getSubMesh( i );
+            const size_t remapIdx = subMesh->useSharedVertices ? 0 : 1u + i;
+            if( !canRemap[remapIdx] )
+                continue;
+
+            const VerticesRemapInfo &remapInfo = remapInfos[remapIdx];
+
+            if( !subMesh->useSharedVertices )
+            {
+                remapInfo.performVertexDataRemap( hwManager, subMesh->vertexData[VpNormal] );
+                remapInfo.performBoneAssignmentRemap( subMesh );
+            }
+
+            getLodIndexData( subMesh, lodIndexData );
+            for( size_t lod=0; lod<lodIndexData.size(); ++lod )
+            {
+                if( lodIndexData[lod]->indexCount != 0u )
+                    remapInfo.performIndexDataRemap( hwManager, lodIndexData[lod] );
+            }
+        }
+
+        v1::Mesh::PoseIterator poseIterator = mesh->getPoseIterator();
+        while( poseIterator.hasMoreElements() )
+        {
+            v1::Pose *pose = poseIterator.getNext();
+            if( canRemap[pose->getTarget()] )
+                remapInfos[pose->getTarget()].performPoseRemap( pose );
+        }
+
+        for( unsigned short a=0; a<mesh->getNumAnimations(); ++a )
+        {
+            v1::Animation *anim = mesh->getAnimation( a );
+            v1::Animation::VertexTrackIterator trackIt = anim->getVertexTrackIterator();
+            while( trackIt.hasMoreElements() )
+            {
+                v1::VertexAnimationTrack *track = trackIt.getNext();
+                if( canRemap[track->getHandle()] )
+                    remapInfos[track->getHandle()].performAnimationTrackRemap( hwManager, track );
+            }
+        }
+
+        for( size_t i=0; i<canRemap.size(); ++i )
+        {
+            if( !canRemap[i] )
+            {
+                std::cout << "  Vertex fetch order left untouched for "
+                     << ( i == 0 ? String( "shared geometry" ) :
+                                   "SubMesh #" + StringConverter::toString( i - 1u ) )
+                     << " because it has non-indexed geometry." << std::endl;
+            }
+        }
+    }
+
+    if( hadIndependentShadowBuffers )
+    {
+        // Regenerate them from the optimized buffers, like the v2 path does
+        const bool oldValue = v1::Mesh::msOptimizeForShadowMapping;
+        v1::Mesh::msOptimizeForShadowMapping = true;
+        mesh->prepareForShadowMapping( false );
+        v1::Mesh::msOptimizeForShadowMapping = oldValue;
+    }
+    else
+    {
+        mesh->prepareForShadowMapping( true );
+    }
+
+    if( edgeListWasBuilt )
+        mesh->buildEdgeList();
+}
+
+static void readIndices( const VertexArrayObject *vao, IndexVec &outIndices )
+{
+    IndexBufferPacked *indexBuffer = vao->getIndexBuffer();
+
+    outIndices.resize( vao->getPrimitiveCount() );
+    if( outIndices.empty() )
+        return;
+
+    AsyncTicketPtr asyncTicket = indexBuffer->readRequest( vao->getPrimitiveStart(),
+                                                           vao->getPrimitiveCount() );
+    const void *data = asyncTicket->map();
+
+    if( indexBuffer->getIndexType() == IndexBufferPacked::IT_32BIT )
+    {
+        memcpy( &outIndices[0], data, outIndices.size() * sizeof(uint32) );
+    }
+    else
+    {
+        const uint16 *srcData = reinterpret_cast<const uint16*>( data );
+        for( size_t i=0; i<outIndices.size(); ++i )
+            outIndices[i] = srcData[i];
+    }
+
+    asyncTicket->unmap();
+}
+
+static IndexBufferPacked* createIndexBuffer( VaoManager *vaoManager, const IndexBufferPacked *srcBuffer,
+                                             const IndexVec &indices )
+{
+    const IndexBufferPacked::IndexType indexType = srcBuffer->getIndexType();
+    const size_t bytesPerIndex = indexType == IndexBufferPacked::IT_16BIT ? 2u : 4u;
+
+    void *data = OGRE_MALLOC_SIMD( std::max<size_t>( indices.size(), 1u ) * bytesPerIndex,
+                                   MEMCATEGORY_GEOMETRY );
+    FreeOnDestructor dataPtrContainer( data );
+
+    if( indexType == IndexBufferPacked::IT_32BIT )
+    {
+        if( !indices.empty() )
+            memcpy( data, &indices[0], indices.size() * sizeof(uint32) );
+    }
+    else
+    {
+        uint16 *dstData = reinterpret_cast<uint16*>( data );
+        for( size_t i=0; i<indices.size(); ++i )
+            dstData[i] = static_cast<uint16>( indices[i] );
+    }
+
+    const bool keepAsShadow = srcBuffer->getShadowCopy() != 0;
+    IndexBufferPacked *retVal = vaoManager->createIndexBuffer( indexType, indices.size(),
+                                                               srcBuffer->getBufferType(),
+                                                               data, keepAsShadow );
+    if( keepAsShadow ) // Don't free the pointer ourselves
+        dataPtrContainer.ptr = 0;
+
+    return retVal;
+}
+
+static VertexBufferPacked* createRemappedVertexBuffer( VaoManager *vaoManager,
+                                                       VertexBufferPacked *srcBuffer,
+                                                       const VerticesRemapInfo &remapInfo )
+{
+    const size_t bytesPerVertex = srcBuffer->getBytesPerElement();
+
+    void *data = OGRE_MALLOC_SIMD( std::max<size_t>( remapInfo.usedCount, 1u ) * bytesPerVertex,
+                                   MEMCATEGORY_GEOMETRY );
+    FreeOnDestructor dataPtrContainer( data );
+
+    AsyncTicketPtr asyncTicket = srcBuffer->readRequest( 0, srcBuffer->getNumElements() );
+    const uint8 *srcData = reinterpret_cast<const uint8*>( asyncTicket->map() );
+
+    for( size_t oldIdx=0; oldIdx<remapInfo.indexMap.size(); ++oldIdx )
+    {
+        const unsigned newIdx = remapInfo.indexMap[oldIdx];
+        if( newIdx != VerticesRemapInfo::UnusedIdx )
+        {
+            memcpy( reinterpret_cast<uint8*>( data ) + newIdx * bytesPerVertex,
+                    srcData + oldIdx * bytesPerVertex, bytesPerVertex );
+        }
+    }
+
+    asyncTicket->unmap();
+
+    const bool keepAsShadow = srcBuffer->getShadowCopy() != 0;
+    VertexBufferPacked *retVal = vaoManager->createVertexBuffer( srcBuffer->getVertexElements(),
+                                                                 remapInfo.usedCount,
+                                                                 srcBuffer->getBufferType(),
+                                                                 data, keepAsShadow );
+    if( keepAsShadow ) // Don't free the pointer ourselves
+        dataPtrContainer.ptr = 0;
+
+    return retVal;
+}
+
+static void optimizeIndexOrder( MeshPtr &mesh )
+{
+    VaoManager *vaoManager = mesh->_getVaoManager();
+
+    const bool hadIndependentShadowVaos = mesh->hasIndependentShadowMappingVaos();
+
+    typedef set<VertexBufferPacked*>::type VertexBufferPackedSet;
+    typedef set<IndexBufferPacked*>::type IndexBufferPackedSet;
+
+    PositionVec positions;
+
+    for( unsigned i=0; i<mesh->getNumSubMeshes(); ++i )
+    {
+        SubMesh *subMesh = mesh->getSubMesh( i );
+        VertexArrayObjectArray &vaos = subMesh->mVao[VpNormal];
+
+        if( vaos.empty() )
+            continue;
+
+        bool allIndexed = true;
+        bool sameVertexBuffers = true;
+
+        // Index data of each LOD
+        vector<IndexVec>::type lodIndices( vaos.size() );
+
+        for( size_t lod=0; lod<vaos.size(); ++lod )
+        {
+            const VertexArrayObject *vao = vaos[lod];
+
+            sameVertexBuffers &= vao->getVertexBuffers() == vaos[0]->getVertexBuffers();
+
+            if( !vao->getIndexBuffer() )
+            {
+                allIndexed = false;
+                continue;
+            }
+
+            readIndices( vao, lodIndices[lod] );
+            allIndexed &= !lodIndices[lod].empty();
+
+            if( opts.optimizeVertexCache && vao->getOperationType() == OT_TRIANGLE_LIST &&
+                !lodIndices[lod].empty() )
+            {
+                positions.clear();
+                if( opts.optimizeOverdraw && !readPositions( vao, positions ) )
+                {
+                    std::cout << "  SubMesh #" << i << ": positions must be VET_FLOAT3 or VET_HALF4 "
+                            "for the overdraw pass. Skipping it." << std::endl;
+                }
+
+                optimizeTriangleList( lodIndices[lod], positions,
+                                      vao->getBaseVertexBuffer()->getNumElements(), i, lod );
+            }
+        }
+
+        bool remapVertices = opts.optimizeVertexFetch;
+        if( remapVertices && ( !allIndexed || !sameVertexBuffers || subMesh->getNumPoses() != 0u ) )
+        {
+            std::cout << "  Vertex fetch order left untouched for SubMesh #" << i
+                 << " because it has non-indexed or empty geometry, poses, or LODs"
+                    " that don't share vertex buffers." << std::endl;
+            remapVertices = false;
+        }
+
+        VertexBufferPackedVec newVertexBuffers;
+        if( remapVertices )
+        {
+            // Vertices get sorted in order of first use by LOD 0, then the rest of the LODs.
+            VerticesRemapInfo remapInfo;
+            remapInfo.initialize( vaos[0]->getBaseVertexBuffer()->getNumElements(), false );
+
+            for( size_t lod=0; lod<lodIndices.size(); ++lod )
+            {
+                if( !lodIndices[lod].empty() )
+                    remapInfo.markUsedIndices( &lodIndices[lod][0], lodIndices[lod].size() );
+            }
+
+            for( size_t lod=0; lod<lodIndices.size(); ++lod )
+            {
+                IndexVec::iterator itor = lodIndices[lod].begin();
+                IndexVec::iterator endt = lodIndices[lod].end();
+                while( itor != endt )
+                {
+                    *itor = remapInfo.indexMap[*itor];
+                    ++itor;
+                }
+            }
+
+            const VertexBufferPackedVec &vertexBuffers = vaos[0]->getVertexBuffers();
+            VertexBufferPackedVec::const_iterator itor = vertexBuffers.begin();
+            VertexBufferPackedVec::const_iterator endt = vertexBuffers.end();
+            while( itor != endt )
+            {
+                newVertexBuffers.push_back( createRemappedVertexBuffer( vaoManager, *itor, remapInfo ) );
+                ++itor;
+            }
+        }
+
+        VertexBufferPackedSet destroyedVertexBuffers;
+        IndexBufferPackedSet destroyedIndexBuffers;
+
+        for( size_t lod=0; lod<vaos.size(); ++lod )
+        {
+            VertexArrayObject *vao = vaos[lod];
+            if( !vao->getIndexBuffer() || lodIndices[lod].empty() )
+                continue; // Non-indexed or empty. It was left untouched.
+
+            IndexBufferPacked *indexBuffer = createIndexBuffer( vaoManager, vao->getIndexBuffer(),
+                                                                lodIndices[lod] );
+            vaos[lod] = vaoManager->createVertexArrayObject(
+                            remapVertices ? newVertexBuffers : vao->getVertexBuffers(),
+                            indexBuffer, vao->getOperationType() );
+
+            // LODs may share the same buffers, destroy them only once.
+            if( destroyedIndexBuffers.insert( vao->getIndexBuffer() ).second )
+                vaoManager->destroyIndexBuffer( vao->getIndexBuffer() );
+
+            if( remapVertices )
+            {
+                const VertexBufferPackedVec &vertexBuffers = vao->getVertexBuffers();
+                VertexBufferPackedVec::const_iterator itor = vertexBuffers.begin();
+                VertexBufferPackedVec::const_iterator endt = vertexBuffers.end();
+                while( itor != endt )
+                {
+                    if( destroyedVertexBuffers.insert( *itor ).second )
+                        vaoManager->destroyVertexBuffer( *itor );
+                    ++itor;
+                }
+            }
+
+            vaoManager->destroyVertexArrayObject( vao );
+        }
+
+        if( remapVertices && !subMesh->getBoneAssignments().empty() )
+        {
+            subMesh->clearBoneAssignments();
+            subMesh->_buildBoneAssignmentsFromVertexData();
+        }
+
+        // If the shadow mapping Vaos were shared, they now point to the destroyed ones.
+        if( !hadIndependentShadowVaos )
+            subMesh->mVao[VpShadow] = subMesh->mVao[VpNormal];
+
+        // Clusters are index ranges into the old index buffers. Drop them; saveMesh
+        // rebuilds them from the new order if requested.
+        if( subMesh->hasClusters() )
+        {
+            if( !opts.buildClusters )
+            {
+                std::cout << "  SubMesh #" << i << ": clusters were removed because the index "
+                        "order changed. Add 'm' to -I to rebuild them." << std::endl;
+            }
+            subMesh->clearClusters();
+        }
+    }
+
+    if( hadIndependentShadowVaos )
+    {
+        // Regenerate them from the optimized Vaos
+        const bool oldValue = Mesh::msOptimizeForShadowMapping;
+        Mesh::msOptimizeForShadowMapping = true;
+        mesh->prepareForShadowMapping( false );
+        Mesh::msOptimizeForShadowMapping = oldValue;
+    }
+}
+
+void optimizeIndexOrder( v1::MeshPtr &v1Mesh, MeshPtr &v2Mesh )
+{
+    if( !opts.optimizeVertexCache && !opts.optimizeVertexFetch )
+        return;
+
+    std::cout << "\nOptimizing index & vertex order..." << std::endl;
+
+    if( v1Mesh )
+        optimizeIndexOrder( v1Mesh );
+    if( v2Mesh )
+        optimizeIndexOrder( v2Mesh );
+
+    std::cout << "success\n";
+}
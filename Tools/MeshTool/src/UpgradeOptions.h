@@ -43,6 +43,14 @@ struct UpgradeOptions
     bool qTangents;
     bool optimizeForShadowMapping;
     bool stripShadowMapping;
+
+    bool optimizeVertexCache;
+    bool optimizeOverdraw;
+    bool optimizeVertexFetch;
+    bool buildClusters;
+
+    /// Processing many files unattended (-batch). Never prompts.
+    bool batchMode;
 };
 
 extern UpgradeOptions opts;
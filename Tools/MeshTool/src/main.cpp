@@ -39,7 +39,10 @@ THE SOFTWARE.
 
 #include "OgreMeshManager2.h"
 #include "OgreMesh2.h"
+#include "Animation/OgreSkeletonDef.h"
+#include "Animation/OgreSkeletonManager.h"
 
+#include "BatchMode.h"
 #include "UpgradeOptions.h"
 
 #ifdef OGRE_STATIC_LIB
@@ -57,6 +60,7 @@ THE SOFTWARE.
 #include "XML/OgreXMLMeshSerializer.h"
 #include "XML/OgreXMLSkeletonSerializer.h"
 
+#include <cstring>
 #include <iostream>
 #include <sstream>
 #include <sys/stat.h>
@@ -111,6 +115,12 @@ void help()
     cout << "             u converts UVs to 16-bit floats." << endl;
     cout << "             s make shadow mapping passes have their own optimized buffers. Overrides existing ones if any." << endl;
     cout << "             S strips the buffers for shadow mapping (consumes less space and memory)." << endl;
+    cout << "-I cofm    = Optimize the index & vertex order for the GPU. Applies to all LODs." << endl;
+    cout << "             c reorders triangles for the post-transform vertex cache." << endl;
+    cout << "             o also sorts triangle clusters to reduce overdraw. Implies c." << endl;
+    cout << "             f reorders vertices in order of first use, for vertex fetch locality." << endl;
+    cout << "             m builds clusters (meshlets) for per-cluster culling. v2 export only." << endl;
+    cout << "             ACMR/ATVR statistics are printed before and after." << endl;
     cout << "-U         = Performs the opposite of -O puq: Converts 16-bit half to to float and " << endl;
     cout << "             converts QTangents to Normal + Tangent + Reflection. Needed by many" << endl;
     cout << "             other options that have to read from position, normals or UVs." << endl;
@@ -119,6 +129,18 @@ void help()
     cout << "destfile   = optional name of file to write to. If you don't" << endl;
     cout << "             specify this OGRE overwrites the existing file." << endl;
     cout << endl;
+    cout << "Batch mode (replaces sourcefile & destfile):" << endl;
+    cout << "-batch input   = Converts many files with the options above. input is either a" << endl;
+    cout << "                 directory (all the .mesh files inside are converted in place) or" << endl;
+    cout << "                 a manifest file with one 'sourcefile[<TAB>destfile]' per line." << endl;
+    cout << "                 Files which didn't change since the last run are skipped." << endl;
+    cout << "                 A summary with per-stage timings is printed at the end." << endl;
+    cout << "-j jobs        = Number of worker processes. Default: one per logical core." << endl;
+    cout << "-batchdb file  = Database that keeps track of the files already converted." << endl;
+    cout << "                 Default: input.meshtooldb" << endl;
+    cout << "-batchforce    = Ignore the database and convert everything again." << endl;
+    cout << "-report file   = Also write the per-file stage timings to a CSV file." << endl;
+    cout << endl;
     cout << "Recommended params for modern DESKTOP (w/ normal mapping):" << endl;
     cout << "   OgreMeshTool -e -t -ts 4 -O puqs sourcefile [destfile]" << endl;
     cout << "Recommended params for GLES2 (w/ normal mapping):" << endl;
@@ -170,6 +192,11 @@ void parseOpts(UnaryOptionList& unOpts, BinaryOptionList& binOpts)
     opts.qTangents      = false;
     opts.optimizeForShadowMapping = false;
     opts.stripShadowMapping = false;
+    opts.optimizeVertexCache = false;
+    opts.optimizeOverdraw = false;
+    opts.optimizeVertexFetch = false;
+    opts.buildClusters = false;
+    opts.batchMode = false;
 
 
     UnaryOptionList::iterator ui = unOpts.find("-e");
@@ -368,6 +395,22 @@ void parseOpts(UnaryOptionList& unOpts, BinaryOptionList& binOpts)
         }
     }
 
+    bi = binOpts.find("-I");
+    if( !bi->second.empty() )
+    {
+        if( bi->second.find( 'c' ) != String::npos )
+            opts.optimizeVertexCache = true;
+        if( bi->second.find( 'o' ) != String::npos )
+        {
+            opts.optimizeVertexCache = true;
+            opts.optimizeOverdraw = true;
+        }
+        if( bi->second.find( 'f' ) != String::npos )
+            opts.optimizeVertexFetch = true;
+        if( bi->second.find( 'm' ) != String::npos )
+            opts.buildClusters = true;
+    }
+
     if( opts.interactive || opts.numLods || opts.lodAutoconfigure || opts.generateTangents )
         opts.unoptimizeBuffer = true;
 }
@@ -377,6 +420,7 @@ void vertexBufferReorg(v1::Mesh& mesh);
 void buildEdgeLists( v1::MeshPtr &mesh );
 void generateTangents( v1::MeshPtr &mesh );
 void recalcBounds( v1::MeshPtr &v1Mesh, MeshPtr &v2Mesh );
+void optimizeIndexOrder( v1::MeshPtr &v1Mesh, MeshPtr &v2Mesh );
 
 void printLodConfig(const LodConfig& lodConfig)
 {
@@ -441,7 +485,12 @@ void buildLod(v1::MeshPtr& mesh)
         }
 
         // otherwise only ask if not specified on command line
-        if (mesh->getNumLodLevels() > 1)
+        if( mesh->getNumLodLevels() > 1 && opts.batchMode )
+        {
+            // Nobody to ask. The command line asked for new LODs, so replace them.
+            cout << "\nMesh already contains level-of-detail information. Replacing it." << endl;
+        }
+        else if (mesh->getNumLodLevels() > 1)
         {
             do
             {
@@ -810,6 +859,17 @@ void resolveColourAmbiguities(v1::Mesh* mesh)
         {
             originalType = opts.srcColourFormat;
         }
+        else if( opts.batchMode )
+        {
+            // Nobody to ask. Leave them alone unless a conversion was requested.
+            if( opts.destColourFormatSet )
+            {
+                OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS,
+                             "The mesh has ambiguous vertex colours. Use -srcgl or -srcd3d",
+                             "resolveColourAmbiguities" );
+            }
+            return;
+        }
         else
         {
             // unknown input colour, have to ask
@@ -1076,6 +1136,12 @@ void saveMesh( const String &destination, v1::MeshPtr &v1Mesh, MeshPtr &v2Mesh,
             if( v1Mesh )
                 v2Mesh->importV1( v1Mesh.get(), false, false, false );
 
+            if( opts.buildClusters )
+            {
+                cout << "Building clusters..." << endl;
+                v2Mesh->buildClusters();
+            }
+
             cout << "Saving as a v2 mesh..." << endl;
             meshSerializer2.exportMesh( v2Mesh.get(), destination, opts.targetVersionV2, opts.endian );
         }
@@ -1118,6 +1184,231 @@ void saveMesh( const String &destination, v1::MeshPtr &v1Mesh, MeshPtr &v2Mesh,
     }
 }
 
+/// Adds the time elapsed since stageStart to the given stage, and starts the next one
+static void endStage( Timer &timer, uint64 &stageStart, BatchStageTimings &timings,
+                      BatchStageTimings::Stage stage )
+{
+    const uint64 now = timer.getMicroseconds();
+    timings.microseconds[stage] += now - stageStart;
+    stageStart = now;
+}
+
+/// Loads, processes and saves a single file according to the global options
+void convertFile( const String &source, const String &dest, v1::MeshPtr &v1Mesh, MeshPtr &v2Mesh,
+                  v1::SkeletonPtr &v1Skeleton, Ogre::MeshSerializer &meshSerializer2,
+                  v1::XMLMeshSerializer &xmlMeshSerializer,
+                  v1::XMLSkeletonSerializer &xmlSkeletonSerializer, BatchStageTimings &outTimings )
+{
+    Timer timer;
+    uint64 stageStart = timer.getMicroseconds();
+
+    if( !loadMesh( source, v1Mesh, v2Mesh, v1Skeleton, meshSerializer2,
+                   xmlMeshSerializer, xmlSkeletonSerializer ) )
+    {
+        // The contents of the XML may also be invalid
+        OGRE_EXCEPT( Exception::ERR_FILE_NOT_FOUND, "Could not open '" + source + "'", "main" );
+    }
+
+    if( opts.unoptimizeBuffer )
+    {
+        if( v1Mesh )
+        {
+            if( v1Mesh->sharedVertexData[VpNormal] )
+            {
+                cout << "v1 Mesh has shared geometry. 'Unsharing' them..." << endl;
+                v1::MeshManager::unshareVertices( v1Mesh.get() );
+                cout << "Unshare operation successful" << endl;
+            }
+            v1Mesh->dearrangeToInefficient();
+        }
+
+        if( v2Mesh )
+            v2Mesh->dearrangeToInefficient();
+    }
+
+    endStage( timer, stageStart, outTimings, BatchStageTimings::Load );
+
+    v1::Mesh* mesh = v1Mesh.get();
+
+    {
+        const String::size_type extPos = dest.find_last_of( '.' );
+        const String dstExt( dest.substr( extPos + 1, dest.size() ) );
+        if( dstExt == "xml" )
+        {
+            if( opts.optimizeBuffer )
+            {
+                cout << "-O is ignored when exporting to XML" << endl;
+            }
+            opts.optimizeBuffer = false;
+        }
+    }
+
+    if( v1Mesh )
+    {
+        vertexBufferReorg(*mesh);
+
+        // Deal with VET_COLOUR ambiguities
+        resolveColourAmbiguities(mesh);
+    }
+
+    endStage( timer, stageStart, outTimings, BatchStageTimings::Optimize );
+    buildLod( v1Mesh );
+    endStage( timer, stageStart, outTimings, BatchStageTimings::Lod );
+    buildEdgeLists( v1Mesh );
+    endStage( timer, stageStart, outTimings, BatchStageTimings::Optimize );
+    generateTangents( v1Mesh );
+    endStage( timer, stageStart, outTimings, BatchStageTimings::Tangents );
+    optimizeIndexOrder( v1Mesh, v2Mesh );
+
+    if( opts.optimizeBuffer )
+    {
+        if( v1Mesh )
+            mesh->arrangeEfficient( opts.halfPos, opts.halfTexCoords, opts.qTangents );
+        if( v2Mesh )
+            v2Mesh->arrangeEfficient( opts.halfPos, opts.halfTexCoords, opts.qTangents );
+    }
+
+    if (opts.recalcBounds)
+    {
+        recalcBounds( v1Mesh, v2Mesh );
+    }
+
+    if( opts.optimizeForShadowMapping )
+    {
+        if( v1Mesh )
+        {
+            mesh->_updateCompiledBoneAssignments();
+            v1::Mesh::msOptimizeForShadowMapping = !opts.stripShadowMapping;
+            mesh->prepareForShadowMapping( false );
+            v1::Mesh::msOptimizeForShadowMapping = false;
+        }
+
+        if( v2Mesh )
+        {
+            Mesh::msOptimizeForShadowMapping = !opts.stripShadowMapping;
+            v2Mesh->prepareForShadowMapping( false );
+            Mesh::msOptimizeForShadowMapping = false;
+        }
+    }
+
+    if( !opts.dontOptimiseAnimations && v1Skeleton )
+    {
+        v1Skeleton->optimiseAllAnimations();
+    }
+
+    endStage( timer, stageStart, outTimings, BatchStageTimings::Optimize );
+
+    saveMesh( dest, v1Mesh, v2Mesh, v1Skeleton, meshSerializer2,
+              xmlMeshSerializer, xmlSkeletonSerializer );
+    endStage( timer, stageStart, outTimings, BatchStageTimings::Save );
+}
+
+/// Destroys everything convertFile created, so that the next file can use the same names
+void releaseResources( v1::MeshPtr &v1Mesh, MeshPtr &v2Mesh, v1::SkeletonPtr &v1Skeleton )
+{
+    if( v2Mesh && v2Mesh->getSkeleton() )
+    {
+        try
+        {
+            SkeletonManager::getSingleton().remove( v2Mesh->getSkeleton()->getNameStr() );
+        }
+        catch( Exception & )
+        {
+            // Wasn't registered, nothing to remove.
+        }
+    }
+
+    v1Mesh.reset();
+    v2Mesh.reset();
+    v1Skeleton.reset();
+
+    v1::MeshManager::getSingleton().removeAll();
+    MeshManager::getSingleton().removeAll();
+    v1::OldSkeletonManager::getSingleton().removeAll();
+}
+
+class MeshToolProcessor : public BatchFileProcessor
+{
+    Ogre::MeshSerializer      &mMeshSerializer2;
+    v1::XMLMeshSerializer     &mXmlMeshSerializer;
+    v1::XMLSkeletonSerializer &mXmlSkeletonSerializer;
+
+public:
+    MeshToolProcessor( Ogre::MeshSerializer &meshSerializer2, v1::XMLMeshSerializer &xmlMeshSerializer,
+                       v1::XMLSkeletonSerializer &xmlSkeletonSerializer ) :
+        mMeshSerializer2( meshSerializer2 ),
+        mXmlMeshSerializer( xmlMeshSerializer ),
+        mXmlSkeletonSerializer( xmlSkeletonSerializer )
+    {
+    }
+
+    void processFile( const String &source, const String &dest,
+                      BatchStageTimings &outTimings ) override
+    {
+        // convertFile tweaks some options depending on the file. Don't leak them to the next one.
+        const UpgradeOptions savedOpts = opts;
+
+        v1::MeshPtr v1Mesh;
+        v1::SkeletonPtr v1Skeleton;
+        MeshPtr v2Mesh;
+
+        try
+        {
+            convertFile( source, dest, v1Mesh, v2Mesh, v1Skeleton, mMeshSerializer2,
+                         mXmlMeshSerializer, mXmlSkeletonSerializer, outTimings );
+        }
+        catch( Exception & )
+        {
+            opts = savedOpts;
+            releaseResources( v1Mesh, v2Mesh, v1Skeleton );
+            throw;
+        }
+
+        opts = savedOpts;
+        releaseResources( v1Mesh, v2Mesh, v1Skeleton );
+    }
+};
+
+static bool isBatchOption( const String &option )
+{
+    return StringUtil::startsWith( option, "-batch" ) || option == "-j" || option == "-report";
+}
+
+/// Collects the options that affect the output, to hash them and to forward them to
+/// the batch worker processes.
+static void getProcessingOptions( const UnaryOptionList &unOptList, const BinaryOptionList &binOptList,
+                                  StringVector &outArgs, String &outOptionsString )
+{
+    outOptionsString = "OgreMeshTool " + StringConverter::toString( OGRE_VERSION );
+
+    UnaryOptionList::const_iterator itUn = unOptList.begin();
+    UnaryOptionList::const_iterator enUn = unOptList.end();
+    while( itUn != enUn )
+    {
+        // Options that are also binary (i.e. -O) get forwarded along with their value
+        if( itUn->second && !isBatchOption( itUn->first ) &&
+            binOptList.find( itUn->first ) == binOptList.end() )
+        {
+            outArgs.push_back( itUn->first );
+            outOptionsString += " " + itUn->first;
+        }
+        ++itUn;
+    }
+
+    BinaryOptionList::const_iterator itBin = binOptList.begin();
+    BinaryOptionList::const_iterator enBin = binOptList.end();
+    while( itBin != enBin )
+    {
+        if( !itBin->second.empty() && !isBatchOption( itBin->first ) )
+        {
+            outArgs.push_back( itBin->first );
+            outArgs.push_back( itBin->second );
+            outOptionsString += " " + itBin->first + " " + itBin->second;
+        }
+        ++itBin;
+    }
+}
+
 #if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
     WCHAR gWorkingDir[MAX_PATH];
 #endif
@@ -1180,8 +1471,14 @@ int main(int numargs, char** args)
         pluginsPath = "plugins_tools.cfg";
 #endif
 #endif
+        // Batch workers run in parallel and would fight over the same log file.
+        // Their console output already gets redirected to a file of their own.
+        bool isBatchWorker = false;
+        for( int i = 1; i < numargs; ++i )
+            isBatchWorker |= strcmp( args[i], "-batchworker" ) == 0;
+
         logManager = OGRE_NEW LogManager();
-        logManager->createLog( "OgreMeshTool.log", true, true );
+        logManager->createLog( "OgreMeshTool.log", true, true, isBatchWorker );
         LogManager::getSingleton().getDefaultLog()->setLogDetail( LL_LOW );
         setWorkingDirectory();
         root = OGRE_NEW Ogre::Root( nullptr, pluginsPath, "", "OgreMeshTool.log" ) ;
@@ -1227,6 +1524,7 @@ int main(int numargs, char** args)
         unOptList["-U"] = false;
         unOptList["-v1"]= false;
         unOptList["-v2"]= false;
+        unOptList["-batchforce"] = false;
         binOptList["-l"] = "";
         binOptList["-d"] = "";
         binOptList["-p"] = "";
@@ -1236,128 +1534,72 @@ int main(int numargs, char** args)
         binOptList["-ts"] = "";
         binOptList["-V"] = "";
         binOptList["-O"] = "";
+        binOptList["-I"] = "";
+        binOptList["-batch"] = "";
+        binOptList["-batchdb"] = "";
+        binOptList["-j"] = "";
+        binOptList["-report"] = "";
+        binOptList["-batchworker"] = "";
+        binOptList["-batchout"] = "";
 
         int startIdx = findCommandLineOpts(numargs, args, unOptList, binOptList);
         parseOpts(unOptList, binOptList);
 
-        String source(args[startIdx]);
-
-        // Load the mesh
-        v1::MeshPtr v1Mesh;
-        v1::SkeletonPtr v1Skeleton;
-        MeshPtr v2Mesh;
+        MeshToolProcessor processor( meshSerializer2, xmlMeshSerializer, xmlSkeletonSerializer );
 
-        if( !loadMesh( source, v1Mesh, v2Mesh, v1Skeleton, meshSerializer2,
-                       xmlMeshSerializer, xmlSkeletonSerializer ) )
+        if( !binOptList["-batchworker"].empty() )
         {
-            // The contents of the XML may also be invalid
-            OGRE_EXCEPT( Exception::ERR_FILE_NOT_FOUND, "Could not open '" + source + "'", "main" );
+            opts.batchMode = true;
+            retCode = runBatchWorker( binOptList["-batchworker"], binOptList["-batchout"],
+                                      processor );
         }
-
-        if( opts.unoptimizeBuffer )
+        else if( !binOptList["-batch"].empty() )
         {
-            if( v1Mesh )
+            if( opts.interactive )
             {
-                if( v1Mesh->sharedVertexData[VpNormal] )
-                {
-                    cout << "v1 Mesh has shared geometry. 'Unsharing' them..." << endl;
-                    v1::MeshManager::unshareVertices( v1Mesh.get() );
-                    cout << "Unshare operation successful" << endl;
-                }
-                v1Mesh->dearrangeToInefficient();
+                OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS, "-i can't be used with -batch", "main" );
             }
 
-            if( v2Mesh )
-                v2Mesh->dearrangeToInefficient();
-        }
-
-        v1::Mesh* mesh = v1Mesh.get();
-
-        // Write out the converted mesh
-        String dest;
-        if (numargs == startIdx + 2)
-        {
-            dest = args[startIdx + 1];
-        }
-        else
-        {
-            const String::size_type extPos = source.find_last_of( '.' );
-            const String sourceExt( source.substr( extPos + 1, source.size() ) );
-
-            if( sourceExt == "xml" )
-            {
-                // dest is source minus .xml
-                dest = source.substr( 0, source.size() - 4 );
-            }
-            else
-            {
-                dest = source;
-            }
-        }
+            opts.batchMode = true;
 
-        {
-            const String::size_type extPos = dest.find_last_of( '.' );
-            const String dstExt( dest.substr( extPos + 1, dest.size() ) );
-            if( dstExt == "xml" )
+            BatchOptions batchOptions;
+            batchOptions.input = binOptList["-batch"];
+            batchOptions.database = binOptList["-batchdb"];
+            if( batchOptions.database.empty() )
             {
-                if( opts.optimizeBuffer )
+                String input = batchOptions.input;
+                while( !input.empty() &&
+                       ( input[input.size() - 1u] == '/' || input[input.size() - 1u] == '\\' ) )
                 {
-                    cout << "-O is ignored when exporting to XML" << endl;
+                    input.resize( input.size() - 1u );
                 }
-                opts.optimizeBuffer = false;
+                batchOptions.database = input + ".meshtooldb";
             }
-        }
+            batchOptions.reportFile = binOptList["-report"];
+            batchOptions.numJobs = StringConverter::parseSizeT( binOptList["-j"], 0 );
+            batchOptions.force = unOptList["-batchforce"];
+            getProcessingOptions( unOptList, binOptList, batchOptions.workerArgs,
+                                  batchOptions.optionsString );
 
-        if( v1Mesh )
-        {
-            vertexBufferReorg(*mesh);
-
-            // Deal with VET_COLOUR ambiguities
-            resolveColourAmbiguities(mesh);
-        }
-
-        buildLod( v1Mesh );
-        buildEdgeLists( v1Mesh );
-        generateTangents( v1Mesh );
-
-        if( opts.optimizeBuffer )
-        {
-            if( v1Mesh )
-                mesh->arrangeEfficient( opts.halfPos, opts.halfTexCoords, opts.qTangents );
-            if( v2Mesh )
-                v2Mesh->arrangeEfficient( opts.halfPos, opts.halfTexCoords, opts.qTangents );
-        }
-
-        if (opts.recalcBounds)
-        {
-            recalcBounds( v1Mesh, v2Mesh );
+            retCode = runBatch( batchOptions, processor, args[0] );
         }
-
-        if( opts.optimizeForShadowMapping )
+        else
         {
-            if( v1Mesh )
+            if( startIdx >= numargs )
             {
-                mesh->_updateCompiledBoneAssignments();
-                v1::Mesh::msOptimizeForShadowMapping = !opts.stripShadowMapping;
-                mesh->prepareForShadowMapping( false );
-                v1::Mesh::msOptimizeForShadowMapping = false;
+                OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS, "No source file specified", "main" );
             }
 
-            if( v2Mesh )
-            {
-                Mesh::msOptimizeForShadowMapping = !opts.stripShadowMapping;
-                v2Mesh->prepareForShadowMapping( false );
-                Mesh::msOptimizeForShadowMapping = false;
-            }
-        }
+            String source( args[startIdx] );
+            String dest;
+            if( numargs == startIdx + 2 )
+                dest = args[startIdx + 1];
+            else
+                dest = getDefaultDestination( source );
 
-        if( !opts.dontOptimiseAnimations && v1Skeleton )
-        {
-            v1Skeleton->optimiseAllAnimations();
+            BatchStageTimings timings;
+            processor.processFile( source, dest, timings );
         }
-
-        saveMesh( dest, v1Mesh, v2Mesh, v1Skeleton, meshSerializer2,
-                  xmlMeshSerializer, xmlSkeletonSerializer );
     }
     catch (Exception& e)
     {